@@ -732,6 +732,24 @@ static void BindTreeParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* pla
                 (*plainJsonPtr)["dev_score_calc_obj_block_size"] = size;
             });
 
+    parser.AddLongOption("dev-split-screening-sample-rate",
+                         "CPU only. Enables two-stage split search for symmetric trees if < 1: "
+                         "all split candidates are scored on a subsample of this rate, "
+                         "then the best of them are rescored on the whole sample. "
+                         "Should be in (0, 1]. Used only for learning speed tuning.")
+            .RequiredArgument("FLOAT")
+            .Handler1T<float>([plainJsonPtr](float rate) {
+                (*plainJsonPtr)["dev_split_screening_sample_rate"] = rate;
+            });
+
+    parser.AddLongOption("dev-split-screening-top-count",
+                         "CPU only. Number of split candidates rescored on the whole sample "
+                         "in two-stage split search. Should be > 0")
+            .RequiredArgument("INT")
+            .Handler1T<int>([plainJsonPtr](int count) {
+                (*plainJsonPtr)["dev_split_screening_top_count"] = count;
+            });
+
     parser.AddLongOption("dev-efb-max-buckets",
                          "CPU only. Maximum bucket count in exclusive features bundle. "
                          "Should be in an integer between 0 and 65536. "
@@ -1178,6 +1196,90 @@ static void BindSystemParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* p
             (*plainJsonPtr).InsertValue("thread_count", count);
         });
 
+    const auto numaModeHelp = TString::Join(
+        "CPU only. NUMA-aware training, must be one of: ",
+        GetEnumAllNames<ENumaMode>(),
+        ". Used only for learning speed tuning.");
+    parser.AddLongOption("dev-numa-mode", numaModeHelp)
+            .RequiredArgument("String")
+            .Handler1T<ENumaMode>([plainJsonPtr](const auto numaMode) {
+                (*plainJsonPtr)["dev_numa_mode"] = ToString(numaMode);
+            });
+
+    parser.AddLongOption("dev-numa-fake-node-count",
+                         "CPU only. Emulate NUMA topology with this node count by splitting cpus evenly, "
+                         "data pages are not moved then, 0 means use the detected topology.")
+            .RequiredArgument("INT")
+            .Handler1T<ui32>([plainJsonPtr](ui32 nodeCount) {
+                (*plainJsonPtr)["dev_numa_fake_node_count"] = nodeCount;
+            });
+
+    parser.AddLongOption("dev-fuse-distributed-round-trips",
+                         "CPU only. Multi-host training: merge consecutive master-worker jobs "
+                         "into single round trips. Used only for learning speed tuning.")
+            .RequiredArgument("bool")
+            .Handler1T<TString>([plainJsonPtr](const TString& param) {
+                (*plainJsonPtr)["dev_fuse_distributed_round_trips"] = FromString<bool>(param);
+            });
+
+    const auto histogramWireFormatHelp = TString::Join(
+        "CPU only. Multi-host training: format of split candidate histograms sent between workers, must be one of: ",
+        GetEnumAllNames<EHistogramWireFormat>(),
+        ". SparseFloat sends bucket sums as floats and may change the result. Used only for learning speed tuning.");
+    parser.AddLongOption("dev-histogram-wire-format", histogramWireFormatHelp)
+            .RequiredArgument("String")
+            .Handler1T<EHistogramWireFormat>([plainJsonPtr](const auto format) {
+                (*plainJsonPtr)["dev_histogram_wire_format"] = ToString(format);
+            });
+
+    const auto distributedModeHelp = TString::Join(
+        "CPU only. Multi-host training: how learn data is distributed between workers, must be one of: ",
+        GetEnumAllNames<EDistributedMode>(),
+        ". FeatureParallel sends all learn objects to every worker.");
+    parser.AddLongOption("dev-distributed-mode", distributedModeHelp)
+            .RequiredArgument("String")
+            .Handler1T<EDistributedMode>([plainJsonPtr](const auto mode) {
+                (*plainJsonPtr)["dev_distributed_mode"] = ToString(mode);
+            });
+
+    parser.AddLongOption("dev-distributed-quantization",
+                         "CPU only. Multi-host training: select float feature borders from approximate quantile "
+                         "sketches built by workers over their parts of the learn dataset file. May change the result. "
+                         "The master still loads the learn dataset and quantizes it with the selected borders.")
+            .RequiredArgument("bool")
+            .Handler1T<TString>([plainJsonPtr](const TString& param) {
+                (*plainJsonPtr)["dev_distributed_quantization"] = FromString<bool>(param);
+            });
+
+    parser.AddLongOption("dev-distributed-pipeline-group-count",
+                         "CPU only. Multi-host training: score split candidates by this many concurrent jobs, "
+                         "master processes the scores of each job while workers compute the next ones. "
+                         "Used only for learning speed tuning.")
+            .RequiredArgument("INT")
+            .Handler1T<ui32>([plainJsonPtr](ui32 groupCount) {
+                (*plainJsonPtr)["dev_distributed_pipeline_group_count"] = groupCount;
+            });
+
+    parser.AddLongOption("dev-distributed-rebalance-period",
+                         "CPU only. Multi-host training: every this many iterations redistribute learn objects "
+                         "between workers in proportion to their measured throughput, 0 disables rebalancing. "
+                         "The model is the same as without rebalancing only with --bootstrap-type No, otherwise "
+                         "objects get other random weights after redistribution. "
+                         "Used only for learning speed tuning.")
+            .RequiredArgument("INT")
+            .Handler1T<ui32>([plainJsonPtr](ui32 period) {
+                (*plainJsonPtr)["dev_distributed_rebalance_period"] = period;
+            });
+
+    parser.AddLongOption("dev-distributed-shared-memory",
+                         "CPU only. Multi-host training: pass messages to workers on the same host through "
+                         "shared memory instead of TCP, workers should be run with --shared-memory. Linux only. "
+                         "Only messages go through shared memory, each worker keeps its own copy of its training data.")
+            .RequiredArgument("bool")
+            .Handler1T<TString>([plainJsonPtr](const TString& param) {
+                (*plainJsonPtr)["dev_distributed_shared_memory"] = FromString<bool>(param);
+            });
+
     parser.AddLongOption("used-ram-limit", "Try to limit used memory. CPU only. WARNING: This option affects CTR memory usage only.\nAllowed suffixes: GB, MB, KB in different cases")
             .RequiredArgument("TARGET_RSS")
             .Handler1T<TString>([plainJsonPtr](const TString& param) {
@@ -69,6 +69,7 @@ int main(int argc, const char* argv[]) {
         modChooser.AddMode("roc", mode_roc, "evaluate data for roc curve");
         modChooser.AddMode("model-based-eval", mode_model_based_eval, "model-based eval");
         modChooser.AddMode("normalize-model", mode_normalize_model, "normalize model on a pool");
+        modChooser.AddMode("reshard-quantized-pool", mode_reshard_quantized_pool, "split quantized pool into shards for distributed training");
         modChooser.DisableSvnRevisionOption();
         modChooser.SetVersionHandler(PrintProgramSvnVersion);
         return modChooser.Run(argc, argv);
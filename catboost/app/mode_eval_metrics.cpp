@@ -119,6 +119,11 @@ int mode_eval_metrics(int argc, const char* argv[]) {
         .SetFlag(&calcOnParts)
         .NoArgument();
 
+    bool saveStageTimings = false;
+    parser.AddLongOption("save-stage-timings", "save seconds of model application and metrics evaluation for each eval period to stage_timings.tsv in result-dir")
+        .SetFlag(&saveStageTimings)
+        .NoArgument();
+
     parser.SetFreeArgsNum(0);
     {
         NLastGetopt::TOptsParseResult parseResult(&parser, argc, argv);
@@ -199,6 +204,10 @@ int mode_eval_metrics(int argc, const char* argv[]) {
         }
         plotCalcer.ComputeNonAdditiveMetrics(datasetParts);
     }
-    plotCalcer.SaveResult(plotParams.ResultDirectory, params.OutputPath.Path, true /*saveMetrics*/, saveStats).ClearTempFiles();
+    plotCalcer.SaveResult(plotParams.ResultDirectory, params.OutputPath.Path, true /*saveMetrics*/, saveStats);
+    if (saveStageTimings) {
+        plotCalcer.SaveStageTimings(plotParams.ResultDirectory);
+    }
+    plotCalcer.ClearTempFiles();
     return 0;
 }
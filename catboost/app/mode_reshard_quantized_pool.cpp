@@ -0,0 +1,71 @@
+#include "modes.h"
+
+#include <catboost/libs/data/loader.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/logging/logging.h>
+#include <catboost/private/libs/data_util/path_with_scheme.h>
+#include <catboost/private/libs/quantized_pool/pool.h>
+#include <catboost/private/libs/quantized_pool/serialization.h>
+#include <catboost/private/libs/quantized_pool/sharding.h>
+
+#include <library/getopt/small/last_getopt.h>
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/system/info.h>
+
+
+namespace {
+    struct TReshardParams {
+        TString InputPath;
+        TString OutputPath;
+        ui32 ShardCount = 0;
+        int ThreadCount = NSystemInfo::CachedNumberOfCpus();
+
+        void BindParserOpts(NLastGetopt::TOpts& parser) {
+            parser.AddLongOption("input-path", "quantized pool, quantized:// or sharded-quantized:// path")
+                .Required()
+                .RequiredArgument("PATH")
+                .StoreResult(&InputPath);
+            parser.AddLongOption('o', "output-path", "directory for the sharded pool, load it with sharded-quantized:// scheme")
+                .Required()
+                .RequiredArgument("PATH")
+                .StoreResult(&OutputPath);
+            parser.AddLongOption("shard-count", "shard count, use worker count of distributed training")
+                .Required()
+                .RequiredArgument("INT")
+                .StoreResult(&ShardCount);
+            parser.AddLongOption('T', "thread-count", "count of shards written in parallel (default: core count)")
+                .RequiredArgument("INT")
+                .StoreResult(&ThreadCount);
+        }
+    };
+} // anonymous namespace
+
+int mode_reshard_quantized_pool(int argc, const char* argv[]) {
+    TReshardParams params;
+
+    auto parser = NLastGetopt::TOpts();
+    parser.AddHelpOption();
+    params.BindParserOpts(parser);
+    parser.SetFreeArgsNum(0);
+    NLastGetopt::TOptsParseResult parserResult{&parser, argc, argv};
+
+    const NCB::TPathWithScheme inputPath(params.InputPath, "quantized");
+    CB_ENSURE(
+        inputPath.Scheme == "quantized" || inputPath.Scheme == "sharded-quantized",
+        "Input pool should have quantized or sharded-quantized scheme");
+    CB_ENSURE(params.ThreadCount > 0, "Thread count should be positive");
+
+    const auto pool = NCB::LoadQuantizedPool(
+        inputPath,
+        {/*LockMemory*/ false, /*Precharge*/ false, NCB::TDatasetSubset::MakeColumns()});
+    if (pool.HasStringColumns) {
+        CATBOOST_WARNING_LOG << "String DocId, GroupId and SubgroupId columns are not copied to shards" << Endl;
+    }
+
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(params.ThreadCount - 1);
+    NCB::SaveShardedQuantizedPool(pool, params.ShardCount, params.OutputPath, &localExecutor);
+
+    return 0;
+}
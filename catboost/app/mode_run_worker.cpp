@@ -11,12 +11,19 @@ namespace {
     struct TWorkerParams {
         ui32 NodePort = 0;
         ui32 ThreadCount = NSystemInfo::CachedNumberOfCpus();
+        double SlowdownFactor = 1.0;
+        bool UseSharedMemory = false;
 
         void BindParserOpts(NLastGetopt::TOpts& parser) {
             parser.AddLongOption('T', "thread-count", "worker thread count (default: core count)")
                 .StoreResult(&ThreadCount);
             parser.AddLongOption("node-port", "TCP port for this worker; default is 0")
                 .StoreResult(&NodePort);
+            parser.AddLongOption("dev-slowdown-factor", "make tensor search jobs this many times slower, for testing of load balancing; default is 1")
+                .StoreResult(&SlowdownFactor);
+            parser.AddLongOption("shared-memory", "talk to master and workers on the same host through shared memory (Linux only)")
+                .NoArgument()
+                .SetFlag(&UseSharedMemory);
         }
     };
 } // anonymous namespace
@@ -30,7 +37,7 @@ int mode_run_worker(int argc, const char* argv[]) {
     parser.SetFreeArgsNum(0);
     NLastGetopt::TOptsParseResult parserResult{&parser, argc, argv};
 
-    RunWorker(params.ThreadCount, params.NodePort);
+    RunWorker(params.ThreadCount, params.NodePort, params.SlowdownFactor, params.UseSharedMemory);
 
     return 0;
 }
@@ -0,0 +1,115 @@
+#!/usr/bin/env python
+"""
+Measures per-tree latency of multi-host CPU training with master and workers
+running as local processes on loopback, with and without fused round trips.
+"""
+
+import argparse
+import os
+import socket
+import subprocess
+import tempfile
+import time
+
+import numpy as np
+
+
+def get_free_port():
+    with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
+        s.bind(('localhost', 0))
+        return s.getsockname()[1]
+
+
+def wait_for_port(port, timeout=60):
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
+            if s.connect_ex(('localhost', port)) == 0:
+                return
+        time.sleep(0.1)
+    raise RuntimeError('Worker on port {} did not start'.format(port))
+
+
+def generate_dataset(work_dir, object_count, feature_count, seed):
+    rng = np.random.RandomState(seed)
+    features = rng.rand(object_count, feature_count)
+    logit = 4 * features[:, 0] - 2 * features[:, 1] * features[:, 2] - 1
+    target = (rng.rand(object_count) < 1 / (1 + np.exp(-logit))).astype(int)
+    train_path = os.path.join(work_dir, 'train.tsv')
+    np.savetxt(train_path, np.column_stack([target, features]), delimiter='\t', fmt='%.6g')
+    cd_path = os.path.join(work_dir, 'train.cd')
+    with open(cd_path, 'w') as cd:
+        cd.write('0\tLabel\n')
+    return train_path, cd_path
+
+
+def run_distributed_fit(catboost_path, work_dir, worker_count, fit_args):
+    ports = [get_free_port() for _ in range(worker_count)]
+    hosts_path = os.path.join(work_dir, 'hosts.txt')
+    with open(hosts_path, 'w') as hosts:
+        for port in ports:
+            hosts.write('localhost:{}\n'.format(port))
+
+    workers = [
+        subprocess.Popen([catboost_path, 'run-worker', '--node-port', str(port)], stdout=subprocess.DEVNULL)
+        for port in ports
+    ]
+    try:
+        for port in ports:
+            wait_for_port(port)
+        start = time.time()
+        subprocess.check_call(
+            [catboost_path, 'fit'] + fit_args + ['--node-type', 'Master', '--file-with-hosts', hosts_path],
+            stdout=subprocess.DEVNULL)
+        elapsed = time.time() - start
+    finally:
+        for worker in workers:
+            try:
+                worker.wait(timeout=60)
+            except subprocess.TimeoutExpired:
+                worker.kill()
+    return elapsed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--catboost', required=True, help='path to catboost binary')
+    parser.add_argument('--workers', type=int, default=2)
+    parser.add_argument('--objects', type=int, default=10000, help='small pools make round trip latency dominate')
+    parser.add_argument('--features', type=int, default=20)
+    parser.add_argument('--iterations', type=int, default=100)
+    parser.add_argument('--depth', type=int, default=6)
+    parser.add_argument('--loss-function', default='Logloss')
+    parser.add_argument('--leaf-estimation-iterations', type=int, default=10)
+    parser.add_argument('--repeats', type=int, default=3)
+    args = parser.parse_args()
+
+    work_dir = tempfile.mkdtemp(prefix='catboost_round_trips_')
+    train_path, cd_path = generate_dataset(work_dir, args.objects, args.features, seed=0)
+
+    print('workers={} objects={} depth={} leaf_estimation_iterations={}'.format(
+        args.workers, args.objects, args.depth, args.leaf_estimation_iterations))
+    for fuse_round_trips in ['false', 'true']:
+        fit_args = [
+            '-f', train_path,
+            '--column-description', cd_path,
+            '--loss-function', args.loss_function,
+            '-i', str(args.iterations),
+            '--depth', str(args.depth),
+            '--leaf-estimation-iterations', str(args.leaf_estimation_iterations),
+            '--leaf-estimation-backtracking', 'No',
+            '--boosting-type', 'Plain',
+            '--train-dir', work_dir,
+            '--dev-fuse-distributed-round-trips', fuse_round_trips,
+        ]
+        times = [
+            run_distributed_fit(args.catboost, work_dir, args.workers, fit_args)
+            for _ in range(args.repeats)
+        ]
+        best = min(times)
+        print('fuse_round_trips={}: best {:.3f} s, {:.2f} ms per tree'.format(
+            fuse_round_trips, best, 1000 * best / args.iterations))
+
+
+if __name__ == '__main__':
+    main()
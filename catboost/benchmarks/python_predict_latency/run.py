@@ -0,0 +1,74 @@
+#!/usr/bin/env python
+"""
+Measures latency of CatBoost.predict on float numpy arrays applied directly (without Pool creation)
+and through a Pool, for different batch sizes.
+"""
+
+import argparse
+import time
+
+import numpy as np
+
+from catboost import CatBoostRegressor, Pool
+
+
+def train_model(feature_count, iterations, depth, seed):
+    rng = np.random.RandomState(seed)
+    features = rng.rand(10000, feature_count).astype(np.float32)
+    target = features[:, 0] + 2 * features[:, 1] * features[:, 2] + 0.1 * rng.rand(10000)
+    model = CatBoostRegressor(iterations=iterations, depth=depth, random_seed=seed, verbose=False)
+    model.fit(features, target)
+    return model
+
+
+def measure(predict, min_time, max_repeats):
+    predict()  # warm up
+    times = []
+    total_time = 0.0
+    while (total_time < min_time) and (len(times) < max_repeats):
+        start = time.time()
+        predict()
+        times.append(time.time() - start)
+        total_time += times[-1]
+    return np.median(times)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--features', type=int, default=50)
+    parser.add_argument('--iterations', type=int, default=500)
+    parser.add_argument('--depth', type=int, default=6)
+    parser.add_argument('--batch-sizes', type=int, nargs='+', default=[1, 10, 1000, 100000])
+    parser.add_argument('--dtype', choices=['float32', 'float64'], default='float32')
+    parser.add_argument('--thread-count', type=int, default=-1)
+    parser.add_argument('--min-time', type=float, default=2.0, help='minimal measured time per batch size, seconds')
+    parser.add_argument('--max-repeats', type=int, default=10000)
+    args = parser.parse_args()
+
+    model = train_model(args.features, args.iterations, args.depth, seed=0)
+    rng = np.random.RandomState(1)
+
+    print('features={} iterations={} depth={} dtype={}'.format(
+        args.features, args.iterations, args.depth, args.dtype))
+    print('{:>10} {:>14} {:>14} {:>8}'.format('batch', 'pool, ms', 'direct, ms', 'speedup'))
+    for batch_size in args.batch_sizes:
+        data = rng.rand(batch_size, args.features).astype(args.dtype)
+
+        direct_predictions = model.predict(data, thread_count=args.thread_count)
+        pool_predictions = model.predict(Pool(data), thread_count=args.thread_count)
+        assert np.array_equal(direct_predictions, pool_predictions)
+
+        pool_time = measure(
+            lambda: model.predict(Pool(data, thread_count=args.thread_count), thread_count=args.thread_count),
+            args.min_time,
+            args.max_repeats)
+        direct_time = measure(
+            lambda: model.predict(data, thread_count=args.thread_count),
+            args.min_time,
+            args.max_repeats)
+        print('{:>10} {:>14.3f} {:>14.3f} {:>7.1f}x'.format(
+            batch_size, 1000 * pool_time, 1000 * direct_time, pool_time / direct_time))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,181 @@
+#include <catboost/libs/data/data_provider_builders.h>
+#include <catboost/libs/fstr/calc_fstr.h>
+#include <catboost/libs/fstr/shap_values.h>
+#include <catboost/libs/model/model_build_helper.h>
+
+#include <library/testing/benchmark/bench.h>
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/system/info.h>
+
+using namespace NCB;
+
+const ui32 FeatureCount = 50;
+const ui32 BorderCount = 64;
+const ui32 TreeCount = 200;
+const ui32 DocumentCount = 2000;
+const ui32 ValidationDocumentCount = 1000000;
+
+// random oblivious trees with leaf weights, features are uniform on [0, 1]
+static TFullModel MakeObliviousModel(int treeDepth) {
+    TFastRng64 rng(treeDepth);
+    TVector<TFloatFeature> floatFeatures;
+    for (auto featureIdx : xrange(FeatureCount)) {
+        TVector<float> borders;
+        for (auto borderIdx : xrange(BorderCount)) {
+            borders.push_back(float(borderIdx + 1) / (BorderCount + 1));
+        }
+        floatFeatures.emplace_back(/*hasNans*/ false, featureIdx, featureIdx, borders);
+    }
+
+    TObliviousTreeBuilder builder(floatFeatures, TVector<TCatFeature>{}, TVector<TTextFeature>{}, 1);
+    const size_t leafCount = size_t(1) << treeDepth;
+    for (auto treeIdx : xrange(TreeCount)) {
+        Y_UNUSED(treeIdx);
+        TVector<TModelSplit> splits;
+        for (auto depth : xrange(treeDepth)) {
+            Y_UNUSED(depth);
+            const ui32 featureIdx = rng.Uniform(FeatureCount);
+            splits.emplace_back(TFloatSplit(featureIdx, floatFeatures[featureIdx].Borders[rng.Uniform(BorderCount)]));
+        }
+        TVector<double> leafValues(leafCount);
+        TVector<double> leafWeights(leafCount);
+        for (auto leafIdx : xrange(leafCount)) {
+            leafValues[leafIdx] = rng.GenRandReal1() - 0.5;
+            leafWeights[leafIdx] = 1 + rng.Uniform(100);
+        }
+        builder.AddTree(splits, leafValues, leafWeights);
+    }
+
+    TFullModel model;
+    builder.Build(model.ModelTrees.GetMutable());
+    model.UpdateDynamicData();
+    return model;
+}
+
+// random features and target
+static TDataProviderPtr MakeDataset(ui32 documentCount) {
+    TFastRng64 rng(0);
+    return CreateDataProvider(
+        [&] (IRawFeaturesOrderDataVisitor* visitor) {
+            TDataMetaInfo metaInfo;
+            metaInfo.TargetType = ERawTargetType::Float;
+            metaInfo.TargetCount = 1;
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                FeatureCount,
+                TVector<ui32>{},
+                TVector<ui32>{},
+                TVector<TString>{});
+
+            visitor->Start(metaInfo, documentCount, EObjectsOrder::Undefined, {});
+            for (auto featureIdx : xrange(FeatureCount)) {
+                TVector<float> values(documentCount);
+                for (auto& value : values) {
+                    value = rng.GenRandReal1();
+                }
+                visitor->AddFloatFeature(
+                    featureIdx,
+                    MakeIntrusive<TTypeCastArrayHolder<float, float>>(std::move(values))
+                );
+            }
+            TVector<float> target(documentCount);
+            for (auto& value : target) {
+                value = rng.GenRandReal1() - 0.5;
+            }
+            visitor->AddTarget(MakeIntrusive<TTypeCastArrayHolder<float, float>>(std::move(target)));
+            visitor->Finish();
+        }
+    );
+}
+
+// UsePreCalc builds flat tables of SHAP values for all leaves, NoPreCalc runs TreeSHAP for every document
+static void CalcShapValues(int treeDepth, EPreCalcShapValues mode, size_t iterations) {
+    static const TDataProviderPtr dataset = MakeDataset(DocumentCount);
+    const TFullModel model = MakeObliviousModel(treeDepth);
+    NPar::TLocalExecutor localExecutor;
+    for (size_t i = 0; i < iterations; ++i) {
+        auto shapValues = CalcShapValuesMulti(
+            model,
+            *dataset,
+            /*fixedFeatureParams*/ Nothing(),
+            /*logPeriod*/ 0,
+            mode,
+            &localExecutor);
+        Y_DO_NOT_OPTIMIZE_AWAY(shapValues);
+    }
+}
+
+Y_CPU_BENCHMARK(ShapTablesDepth6, iface) {
+    CalcShapValues(6, EPreCalcShapValues::UsePreCalc, iface.Iterations());
+}
+
+Y_CPU_BENCHMARK(TreeShapDepth6, iface) {
+    CalcShapValues(6, EPreCalcShapValues::NoPreCalc, iface.Iterations());
+}
+
+Y_CPU_BENCHMARK(ShapTablesDepth8, iface) {
+    CalcShapValues(8, EPreCalcShapValues::UsePreCalc, iface.Iterations());
+}
+
+Y_CPU_BENCHMARK(TreeShapDepth8, iface) {
+    CalcShapValues(8, EPreCalcShapValues::NoPreCalc, iface.Iterations());
+}
+
+// precalculation of SHAP values of all leaves only: flat tables or the previous TreeSHAP for every leaf
+static void PreCalcShapValues(int treeDepth, bool useShapTables, size_t iterations) {
+    static const TDataProviderPtr dataset = MakeDataset(DocumentCount);
+    const TFullModel model = MakeObliviousModel(treeDepth);
+    NPar::TLocalExecutor localExecutor;
+    for (size_t i = 0; i < iterations; ++i) {
+        TShapPreparedTrees preparedTrees = PrepareTrees(model, dataset.Get(), EPreCalcShapValues::UsePreCalc, &localExecutor);
+        CalcShapValuesByLeaf(
+            model,
+            /*fixedFeatureParams*/ Nothing(),
+            /*logPeriod*/ 0,
+            preparedTrees.CalcInternalValues,
+            &localExecutor,
+            &preparedTrees,
+            ECalcTypeShapValues::Normal,
+            useShapTables);
+        Y_DO_NOT_OPTIMIZE_AWAY(preparedTrees);
+    }
+}
+
+Y_CPU_BENCHMARK(ShapTablesPreCalcDepth6, iface) {
+    PreCalcShapValues(6, /*useShapTables*/ true, iface.Iterations());
+}
+
+Y_CPU_BENCHMARK(PerLeafPreCalcDepth6, iface) {
+    PreCalcShapValues(6, /*useShapTables*/ false, iface.Iterations());
+}
+
+Y_CPU_BENCHMARK(ShapTablesPreCalcDepth8, iface) {
+    PreCalcShapValues(8, /*useShapTables*/ true, iface.Iterations());
+}
+
+Y_CPU_BENCHMARK(PerLeafPreCalcDepth8, iface) {
+    PreCalcShapValues(8, /*useShapTables*/ false, iface.Iterations());
+}
+
+// LossFunctionChange on a validation set of 1M documents, contributions of features come from cached leaf indexes
+static void CalcLossFunctionChange(int treeDepth, size_t iterations) {
+    static const TDataProviderPtr dataset = MakeDataset(ValidationDocumentCount);
+    TFullModel model = MakeObliviousModel(treeDepth);
+    model.ModelInfo["loss_function"] = "{\"type\": \"RMSE\"}";
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(NSystemInfo::CachedNumberOfCpus() - 1);
+    for (size_t i = 0; i < iterations; ++i) {
+        auto featureEffect = CalcFeatureEffect(model, dataset, EFstrType::LossFunctionChange, &localExecutor);
+        Y_DO_NOT_OPTIMIZE_AWAY(featureEffect);
+    }
+}
+
+Y_CPU_BENCHMARK(LossFunctionChangeDepth6, iface) {
+    CalcLossFunctionChange(6, iface.Iterations());
+}
+
+Y_CPU_BENCHMARK(LossFunctionChangeDepth10, iface) {
+    CalcLossFunctionChange(10, iface.Iterations());
+}
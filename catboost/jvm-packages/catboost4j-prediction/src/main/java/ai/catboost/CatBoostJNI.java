@@ -2,6 +2,7 @@ package ai.catboost;
 
 import javax.annotation.Nullable;
 import javax.validation.constraints.NotNull;
+import java.nio.ByteBuffer;
 
 class CatBoostJNI {
     final void catBoostHashCatFeature(
@@ -99,4 +100,32 @@ class CatBoostJNI {
             final @NotNull double[] predictions) throws CatBoostError {
         CatBoostJNIImpl.checkCall(CatBoostJNIImpl.catBoostModelPredict(handle, numericFeatures, catFeatureHashes, predictions));
     }
+
+    final void catBoostModelPredictFlat(
+            final long handle,
+            final @Nullable float[] numericFeatures,
+            final int numericFeatureCount,
+            final @Nullable int[] catFeatureHashes,
+            final int catFeatureCount,
+            final int documentCount,
+            final boolean columnMajor,
+            final @NotNull double[] predictions) throws CatBoostError {
+        CatBoostJNIImpl.checkCall(CatBoostJNIImpl.catBoostModelPredictFlat(
+                handle, numericFeatures, numericFeatureCount, catFeatureHashes, catFeatureCount, documentCount,
+                columnMajor, predictions));
+    }
+
+    final void catBoostModelPredictDirect(
+            final long handle,
+            final @Nullable ByteBuffer numericFeatures,
+            final int numericFeatureCount,
+            final @Nullable ByteBuffer catFeatureHashes,
+            final int catFeatureCount,
+            final int documentCount,
+            final boolean columnMajor,
+            final @NotNull ByteBuffer predictions) throws CatBoostError {
+        CatBoostJNIImpl.checkCall(CatBoostJNIImpl.catBoostModelPredictDirect(
+                handle, numericFeatures, numericFeatureCount, catFeatureHashes, catFeatureCount, documentCount,
+                columnMajor, predictions));
+    }
 }
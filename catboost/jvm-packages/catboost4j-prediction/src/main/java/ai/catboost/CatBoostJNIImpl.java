@@ -2,6 +2,7 @@ package ai.catboost;
 
 import javax.annotation.Nullable;
 import javax.validation.constraints.NotNull;
+import java.nio.ByteBuffer;
 
 class CatBoostJNIImpl {
     final static void checkCall(@Nullable String message) throws CatBoostError {
@@ -90,4 +91,26 @@ class CatBoostJNIImpl {
             @Nullable float[][] numericFeatures,
             @Nullable int[][] catFeatureHashes,
             @NotNull double[] predictions);
-}
\ No newline at end of file
+
+    @Nullable
+    final static native String catBoostModelPredictFlat(
+            long handle,
+            @Nullable float[] numericFeatures,
+            int numericFeatureCount,
+            @Nullable int[] catFeatureHashes,
+            int catFeatureCount,
+            int documentCount,
+            boolean columnMajor,
+            @NotNull double[] predictions);
+
+    @Nullable
+    final static native String catBoostModelPredictDirect(
+            long handle,
+            @Nullable ByteBuffer numericFeatures,
+            int numericFeatureCount,
+            @Nullable ByteBuffer catFeatureHashes,
+            int catFeatureCount,
+            int documentCount,
+            boolean columnMajor,
+            @NotNull ByteBuffer predictions);
+}
@@ -5,6 +5,8 @@ import javax.validation.constraints.NotNull;
 import java.io.ByteArrayOutputStream;
 import java.io.IOException;
 import java.io.InputStream;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 
 /**
  * CatBoost model, supports basic model application.
@@ -353,6 +355,92 @@ public class CatBoostModel implements AutoCloseable {
         return prediction;
     }
 
+    /**
+     * Apply model to a batch of objects stored in flat arrays, without per-object Java objects and without copying
+     * features on the native side. Features of object {@code i} are at {@code i * featureCount + featureIndex} in
+     * row-major layout and at {@code featureIndex * documentCount + i} in column-major layout.
+     *
+     * Arrays are pinned while model is applied, so garbage collection may be delayed for that time.
+     *
+     * @param numericFeatures     Numeric features matrix, may be null if {@code numericFeatureCount} is zero.
+     * @param numericFeatureCount Number of numeric features per object.
+     * @param catFeatureHashes    Categoric feature hashes matrix computed by {@link #hashCategoricalFeature(String)},
+     *                            may be null if {@code catFeatureCount} is zero.
+     * @param catFeatureCount     Number of categoric features per object.
+     * @param documentCount       Number of objects.
+     * @param columnMajor         Whether matrices are stored column by column.
+     * @param prediction          Model predictions, must be large enough for {@code documentCount} objects.
+     * @throws CatBoostError In case of error within native library.
+     */
+    public void predict(
+            final @Nullable float[] numericFeatures,
+            final int numericFeatureCount,
+            final @Nullable int[] catFeatureHashes,
+            final int catFeatureCount,
+            final int documentCount,
+            final boolean columnMajor,
+            final @NotNull CatBoostPredictions prediction) throws CatBoostError {
+        NativeLib.handle().catBoostModelPredictFlat(
+                handle,
+                numericFeatures,
+                numericFeatureCount,
+                catFeatureHashes,
+                catFeatureCount,
+                documentCount,
+                columnMajor,
+                prediction.getRawData());
+    }
+
+    /**
+     * Same as {@link #predict(float[], int, int[], int, int, boolean, CatBoostPredictions)}, but features and
+     * predictions are in direct buffers which are accessed by native code in place. Buffers must use native byte
+     * order and contain floats, int hashes and doubles respectively starting from their first byte, buffer positions
+     * are ignored. Predictions are written as {@code documentCount * getPredictionDimension()} doubles.
+     *
+     * @param numericFeatures     Numeric features matrix, may be null if {@code numericFeatureCount} is zero.
+     * @param numericFeatureCount Number of numeric features per object.
+     * @param catFeatureHashes    Categoric feature hashes matrix, may be null if {@code catFeatureCount} is zero.
+     * @param catFeatureCount     Number of categoric features per object.
+     * @param documentCount       Number of objects.
+     * @param columnMajor         Whether matrices are stored column by column.
+     * @param predictions         Buffer for model predictions.
+     * @throws CatBoostError In case of error within native library or if a buffer is not a direct buffer with native
+     *                       byte order.
+     */
+    public void predict(
+            final @Nullable ByteBuffer numericFeatures,
+            final int numericFeatureCount,
+            final @Nullable ByteBuffer catFeatureHashes,
+            final int catFeatureCount,
+            final int documentCount,
+            final boolean columnMajor,
+            final @NotNull ByteBuffer predictions) throws CatBoostError {
+        checkDirectBuffer(numericFeatures, "numericFeatures");
+        checkDirectBuffer(catFeatureHashes, "catFeatureHashes");
+        checkDirectBuffer(predictions, "predictions");
+        NativeLib.handle().catBoostModelPredictDirect(
+                handle,
+                numericFeatures,
+                numericFeatureCount,
+                catFeatureHashes,
+                catFeatureCount,
+                documentCount,
+                columnMajor,
+                predictions);
+    }
+
+    private static void checkDirectBuffer(final @Nullable ByteBuffer buffer, final @NotNull String name) throws CatBoostError {
+        if (buffer == null) {
+            return;
+        }
+        if (!buffer.isDirect()) {
+            throw new CatBoostError("`" + name + "` is not a direct buffer");
+        }
+        if (buffer.order() != ByteOrder.nativeOrder()) {
+            throw new CatBoostError("`" + name + "` byte order is not native");
+        }
+    }
+
     @Override
     protected void finalize() throws Throwable {
         try {
@@ -6,6 +6,7 @@
 
 #include <util/generic/cast.h>
 #include <util/generic/scope.h>
+#include <util/generic/utility.h>
 #include <util/generic/singleton.h>
 #include <util/generic/string.h>
 #include <util/stream/labeled.h>
@@ -655,5 +656,189 @@ JNIEXPORT jstring JNICALL Java_ai_catboost_CatBoostJNIImpl_catBoostModelPredict_
     Y_END_JNI_API_CALL();
 }
 
+// Objects of a row-major matrix are passed to `TFullModel::Calc` by blocks of this size, row
+// references of a block live on stack, so there are no allocations proportional to object count.
+static constexpr size_t FLAT_MATRIX_ROW_BLOCK_SIZE = 1024;
+
+static void CalcOnFlatMatrices(
+    const TFullModel& model,
+    const TConstArrayRef<float> numericFeatures,
+    const size_t numericFeatureCount,
+    const TConstArrayRef<int> catFeatures,
+    const size_t catFeatureCount,
+    const size_t documentCount,
+    const bool columnMajor,
+    const TArrayRef<double> predictions) {
+
+    const size_t modelPredictionSize = model.GetDimensionsCount();
+    const size_t minNumericFeatureCount = model.GetNumFloatFeatures();
+    const size_t minCatFeatureCount = model.GetNumCatFeatures();
+
+    CB_ENSURE(
+        numericFeatureCount >= minNumericFeatureCount,
+        LabeledOutput(numericFeatureCount, minNumericFeatureCount));
+    CB_ENSURE(
+        catFeatureCount >= minCatFeatureCount,
+        LabeledOutput(catFeatureCount, minCatFeatureCount));
+    CB_ENSURE(
+        numericFeatures.size() >= documentCount * numericFeatureCount,
+        "`numericFeatures` size is insufficient, must be at least document count * numeric feature count: "
+        LabeledOutput(numericFeatures.size(), documentCount * numericFeatureCount));
+    CB_ENSURE(
+        catFeatures.size() >= documentCount * catFeatureCount,
+        "`catFeatureHashes` size is insufficient, must be at least document count * cat feature count: "
+        LabeledOutput(catFeatures.size(), documentCount * catFeatureCount));
+    CB_ENSURE(
+        predictions.size() >= documentCount * modelPredictionSize,
+        "`prediction` size is insufficient, must be at least document count * model prediction dimension: "
+        LabeledOutput(predictions.size(), documentCount * modelPredictionSize));
+
+    if (documentCount == 0) {
+        return;
+    }
+
+    if (columnMajor) {
+        CB_ENSURE(model.ModelTrees->GetTextFeatures().empty(), "column-major layout is not supported for models with text features");
+
+        // one reference per feature, a categorical column is reinterpreted as floats as `CalcFlatTransposed` expects
+        TVector<TConstArrayRef<float>> columns(model.ModelTrees->GetFlatFeatureVectorExpectedSize());
+        for (const auto& feature : model.ModelTrees->GetFloatFeatures()) {
+            columns[feature.Position.FlatIndex] = MakeArrayRef(
+                numericFeatures.data() + feature.Position.Index * documentCount,
+                documentCount);
+        }
+        for (const auto& feature : model.ModelTrees->GetCatFeatures()) {
+            columns[feature.Position.FlatIndex] = MakeArrayRef(
+                reinterpret_cast<const float*>(catFeatures.data() + feature.Position.Index * documentCount),
+                documentCount);
+        }
+        model.CalcFlatTransposed(columns, 0, model.GetTreeCount(), predictions.first(documentCount * modelPredictionSize));
+        return;
+    }
+
+    TConstArrayRef<float> numericRows[FLAT_MATRIX_ROW_BLOCK_SIZE];
+    TConstArrayRef<int> catRows[FLAT_MATRIX_ROW_BLOCK_SIZE];
+    for (size_t blockStart = 0; blockStart < documentCount; blockStart += FLAT_MATRIX_ROW_BLOCK_SIZE) {
+        const size_t blockSize = Min(FLAT_MATRIX_ROW_BLOCK_SIZE, documentCount - blockStart);
+        for (size_t i = 0; i < blockSize; ++i) {
+            numericRows[i] = MakeArrayRef(
+                numericFeatures.data() + (blockStart + i) * numericFeatureCount,
+                numericFeatureCount);
+            catRows[i] = MakeArrayRef(
+                catFeatures.data() + (blockStart + i) * catFeatureCount,
+                catFeatureCount);
+        }
+        model.Calc(
+            MakeArrayRef(numericRows, numericFeatureCount ? blockSize : 0),
+            MakeArrayRef(catRows, catFeatureCount ? blockSize : 0),
+            predictions.subspan(blockStart * modelPredictionSize, blockSize * modelPredictionSize));
+    }
+}
+
+JNIEXPORT jstring JNICALL Java_ai_catboost_CatBoostJNIImpl_catBoostModelPredictFlat
+  (JNIEnv* jenv, jclass, jlong jhandle, jfloatArray jnumericFeatures, jint jnumericFeatureCount, jintArray jcatFeatures, jint jcatFeatureCount, jint jdocumentCount, jboolean jcolumnMajor, jdoubleArray jpredictions) {
+    Y_BEGIN_JNI_API_CALL();
+
+    const auto* const model = ToConstFullModelPtr(jhandle);
+    CB_ENSURE(model, "got nullptr model pointer");
+    CB_ENSURE(
+        jnumericFeatureCount >= 0 && jcatFeatureCount >= 0 && jdocumentCount >= 0,
+        "negative sizes: " LabeledOutput(jnumericFeatureCount, jcatFeatureCount, jdocumentCount));
+
+    // sizes are taken before entering critical regions, no JNI calls are allowed inside them
+    const size_t numericFeaturesSize = GetArraySize(jenv, jnumericFeatures);
+    const size_t catFeaturesSize = GetArraySize(jenv, jcatFeatures);
+    const size_t predictionsSize = jenv->GetArrayLength(jpredictions);
+
+    // arrays are pinned (or copied by JVMs without pinning support), input arrays are released
+    // without copying back
+    const float* numericFeatures = nullptr;
+    if (numericFeaturesSize) {
+        numericFeatures = static_cast<const float*>(jenv->GetPrimitiveArrayCritical(jnumericFeatures, nullptr));
+        CB_ENSURE(numericFeatures, "OutOfMemoryError");
+    }
+    Y_SCOPE_EXIT(jenv, jnumericFeatures, numericFeatures) {
+        if (numericFeatures) {
+            jenv->ReleasePrimitiveArrayCritical(jnumericFeatures, const_cast<float*>(numericFeatures), JNI_ABORT);
+        }
+    };
+
+    const int* catFeatures = nullptr;
+    if (catFeaturesSize) {
+        catFeatures = static_cast<const int*>(jenv->GetPrimitiveArrayCritical(jcatFeatures, nullptr));
+        CB_ENSURE(catFeatures, "OutOfMemoryError");
+    }
+    Y_SCOPE_EXIT(jenv, jcatFeatures, catFeatures) {
+        if (catFeatures) {
+            jenv->ReleasePrimitiveArrayCritical(jcatFeatures, const_cast<int*>(catFeatures), JNI_ABORT);
+        }
+    };
+
+    double* predictions = nullptr;
+    if (predictionsSize) {
+        predictions = static_cast<double*>(jenv->GetPrimitiveArrayCritical(jpredictions, nullptr));
+        CB_ENSURE(predictions, "OutOfMemoryError");
+    }
+    Y_SCOPE_EXIT(jenv, jpredictions, predictions) {
+        if (predictions) {
+            jenv->ReleasePrimitiveArrayCritical(jpredictions, predictions, 0);
+        }
+    };
+
+    CalcOnFlatMatrices(
+        *model,
+        MakeArrayRef(numericFeatures, numericFeaturesSize),
+        jnumericFeatureCount,
+        MakeArrayRef(catFeatures, catFeaturesSize),
+        jcatFeatureCount,
+        jdocumentCount,
+        jcolumnMajor == JNI_TRUE,
+        MakeArrayRef(predictions, predictionsSize));
+
+    Y_END_JNI_API_CALL();
+}
+
+template <typename T>
+static TArrayRef<T> GetDirectBufferData(JNIEnv* const jenv, const jobject buffer) {
+    if (jenv->IsSameObject(buffer, NULL) == JNI_TRUE) {
+        return {};
+    }
+
+    auto* const data = static_cast<T*>(jenv->GetDirectBufferAddress(buffer));
+    CB_ENSURE(data, "buffer is not a direct buffer");
+    const jlong capacity = jenv->GetDirectBufferCapacity(buffer);
+    CB_ENSURE(capacity >= 0, "buffer capacity is not available");
+    CB_ENSURE(
+        reinterpret_cast<uintptr_t>(data) % alignof(T) == 0,
+        "buffer address is not aligned to " << alignof(T) << " bytes");
+
+    // capacity of a ByteBuffer is in bytes
+    return MakeArrayRef(data, SafeIntegerCast<size_t>(capacity) / sizeof(T));
+}
+
+JNIEXPORT jstring JNICALL Java_ai_catboost_CatBoostJNIImpl_catBoostModelPredictDirect
+  (JNIEnv* jenv, jclass, jlong jhandle, jobject jnumericFeatures, jint jnumericFeatureCount, jobject jcatFeatures, jint jcatFeatureCount, jint jdocumentCount, jboolean jcolumnMajor, jobject jpredictions) {
+    Y_BEGIN_JNI_API_CALL();
+
+    const auto* const model = ToConstFullModelPtr(jhandle);
+    CB_ENSURE(model, "got nullptr model pointer");
+    CB_ENSURE(
+        jnumericFeatureCount >= 0 && jcatFeatureCount >= 0 && jdocumentCount >= 0,
+        "negative sizes: " LabeledOutput(jnumericFeatureCount, jcatFeatureCount, jdocumentCount));
+    CB_ENSURE(jenv->IsSameObject(jpredictions, NULL) == JNI_FALSE, "got null `predictions` buffer");
+
+    CalcOnFlatMatrices(
+        *model,
+        GetDirectBufferData<const float>(jenv, jnumericFeatures),
+        jnumericFeatureCount,
+        GetDirectBufferData<const int>(jenv, jcatFeatures),
+        jcatFeatureCount,
+        jdocumentCount,
+        jcolumnMajor == JNI_TRUE,
+        GetDirectBufferData<double>(jenv, jpredictions));
+
+    Y_END_JNI_API_CALL();
+}
+
 #undef Y_BEGIN_JNI_API_CALL
 #undef Y_END_JNI_API_CALL
@@ -6,6 +6,8 @@ import org.junit.Test;
 
 import javax.validation.constraints.NotNull;
 import java.io.*;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 
 import static org.junit.Assert.fail;
 
@@ -856,4 +858,62 @@ public class CatBoostModelTest {
             assertEqual(expected, model.predict(numericFeatures, catFeatures));
         }
     }
+
+    @Test
+    public void testSuccessfulPredictFlat() throws CatBoostError {
+        try(final CatBoostModel model = loadTestModel()) {
+            final float[] rowMajorNumericFeatures = new float[]{
+                    0.5f, 1.5f,
+                    0.7f, 6.4f,
+                    -2.0f, -1.0f};
+            final int[] rowMajorCatFeatures = new int[]{
+                    -805065478, 2136526169, 785836961,
+                    1982436109, 1400211492, 1076941191,
+                    -1883343840, -1452597217, 2122455585};
+            final float[] columnMajorNumericFeatures = new float[]{
+                    0.5f, 0.7f, -2.0f,
+                    1.5f, 6.4f, -1.0f};
+            final int[] columnMajorCatFeatures = new int[]{
+                    -805065478, 1982436109, -1883343840,
+                    2136526169, 1400211492, -1452597217,
+                    785836961, 1076941191, 2122455585};
+            final CatBoostPredictions expected = new CatBoostPredictions(3, 1, new double[]{
+                    0.04666924366060905,
+                    0.026244613740247648,
+                    0.03094452158737013});
+
+            final CatBoostPredictions prediction = new CatBoostPredictions(3, 1);
+            model.predict(rowMajorNumericFeatures, 2, rowMajorCatFeatures, 3, 3, false, prediction);
+            assertEqual(expected, prediction);
+            model.predict(columnMajorNumericFeatures, 2, columnMajorCatFeatures, 3, 3, true, prediction);
+            assertEqual(expected, prediction);
+
+            final ByteBuffer numericBuffer = ByteBuffer.allocateDirect(6 * 4).order(ByteOrder.nativeOrder());
+            numericBuffer.asFloatBuffer().put(columnMajorNumericFeatures);
+            final ByteBuffer catBuffer = ByteBuffer.allocateDirect(9 * 4).order(ByteOrder.nativeOrder());
+            catBuffer.asIntBuffer().put(columnMajorCatFeatures);
+            final ByteBuffer predictionBuffer = ByteBuffer.allocateDirect(3 * 8).order(ByteOrder.nativeOrder());
+            model.predict(numericBuffer, 2, catBuffer, 3, 3, true, predictionBuffer);
+            final double[] directPrediction = new double[3];
+            predictionBuffer.asDoubleBuffer().get(directPrediction);
+            assertEqual(expected, new CatBoostPredictions(3, 1, directPrediction));
+        }
+    }
+
+    @Test
+    public void testFailPredictFlatInsufficientFeatures() throws CatBoostError {
+        try(final CatBoostModel model = loadTestModel()) {
+            final CatBoostPredictions prediction = new CatBoostPredictions(2, 1);
+            try {
+                model.predict(new float[]{0.5f, 1.5f}, 2, new int[]{1, 2, 3, 4, 5, 6}, 3, 2, false, prediction);
+                fail();
+            } catch (CatBoostError e) {
+            }
+            try {
+                model.predict(ByteBuffer.allocate(16), 2, ByteBuffer.allocate(24), 3, 2, false, ByteBuffer.allocate(16));
+                fail();
+            } catch (CatBoostError e) {
+            }
+        }
+    }
 }
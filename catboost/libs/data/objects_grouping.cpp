@@ -5,6 +5,7 @@
 #include <util/generic/xrange.h>
 #include <util/random/shuffle.h>
 
+#include <cmath>
 #include <numeric>
 
 
@@ -331,6 +332,50 @@ TVector<TArraySubsetIndexing<ui32>> NCB::Split(
     return result;
 }
 
+TVector<TArraySubsetIndexing<ui32>> NCB::SplitByShares(
+    const TObjectsGrouping& objectsGrouping,
+    TConstArrayRef<double> shares
+) {
+    const ui32 objectCount = objectsGrouping.GetObjectCount();
+    const ui32 partCount = shares.size();
+    CB_ENSURE_INTERNAL(partCount > 0, "SplitByShares: no parts requested");
+    const double sumShares = Accumulate(shares, 0.0);
+    CB_ENSURE_INTERNAL(sumShares > 0, "SplitByShares: shares should have positive sum");
+
+    TVector<TArraySubsetIndexing<ui32>> result;
+    double cumulativeShare = 0;
+    ui32 currentPartGroupEnd = 0;
+    for (ui32 part = 0; part < partCount; ++part) {
+        CB_ENSURE_INTERNAL(shares[part] >= 0, "SplitByShares: shares should be non-negative");
+        cumulativeShare += shares[part];
+        const ui32 currentPartGroupBegin = currentPartGroupEnd;
+        if (part + 1 == partCount) {
+            currentPartGroupEnd = objectsGrouping.GetGroupCount();
+        } else {
+            const ui32 currentPartObjectEnd = Min(
+                (ui32)std::llround(objectCount * (cumulativeShare / sumShares)),
+                objectCount);
+            currentPartGroupEnd = Max(
+                currentPartGroupBegin + 1,
+                currentPartObjectEnd ?
+                    objectsGrouping.GetGroupIdxForObject(currentPartObjectEnd - 1) + 1 :
+                    0);
+        }
+        CB_ENSURE(
+            currentPartGroupEnd <= objectsGrouping.GetGroupCount() && currentPartGroupBegin < currentPartGroupEnd,
+            "Not enough objects for splitting into requested amount of parts");
+
+        TSubsetBlock<ui32> block{{currentPartGroupBegin, currentPartGroupEnd}, 0};
+        const ui32 blockSize = block.GetSize();
+        result.push_back(
+            TArraySubsetIndexing<ui32>(
+                TRangesSubset<ui32>(blockSize, TVector<TSubsetBlock<ui32>>{std::move(block)})
+            )
+        );
+    }
+    return result;
+}
+
 void NCB::TrainTestSplit(
     const TObjectsGrouping& objectsGrouping,
     double trainPart,
@@ -233,6 +233,14 @@ namespace NCB {
         bool oldCvStyle = false
     );
 
+    /* returns groups (possibly trivial groups) subsets with object counts proportional to shares,
+     * each part is a contiguous range and is not empty
+     */
+    TVector<TArraySubsetIndexing<ui32>> SplitByShares(
+        const TObjectsGrouping& objectsGrouping,
+        TConstArrayRef<double> shares
+    );
+
     void TrainTestSplit(
         const TObjectsGrouping& objectsGrouping,
         double trainPart,
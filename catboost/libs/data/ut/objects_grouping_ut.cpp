@@ -401,6 +401,50 @@ Y_UNIT_TEST_SUITE(TObjectsGrouping) {
         UNIT_ASSERT_EQUAL(result.second, expectedTestIndices);
     }
 
+    Y_UNIT_TEST(SplitByShares) {
+        auto getRangesSubset = [](ui32 begin, ui32 end) {
+            TSubsetBlock<ui32> blockBuffer;
+            blockBuffer.DstBegin = 0;
+            blockBuffer.SrcBegin = begin;
+            blockBuffer.SrcEnd = end;
+            return TArraySubsetIndexing<ui32>(
+                TRangesSubset<ui32>(blockBuffer.GetSize(), TVector<TSubsetBlock<ui32>>{blockBuffer}));
+        };
+
+        // trivial
+        {
+            const TObjectsGrouping objectsGrouping(10);
+            const auto result = SplitByShares(objectsGrouping, TVector<double>{1.0, 3.0, 1.0});
+            const TVector<TArraySubsetIndexing<ui32>> expected{
+                getRangesSubset(0, 2),
+                getRangesSubset(2, 8),
+                getRangesSubset(8, 10)
+            };
+            UNIT_ASSERT_EQUAL(result, expected);
+
+            UNIT_ASSERT_EQUAL(SplitByShares(objectsGrouping, TVector<double>{1.0, 1.0}), Split(objectsGrouping, 2));
+
+            // each part is not empty
+            const auto resultWithSmallShare = SplitByShares(objectsGrouping, TVector<double>{0.01, 1.0});
+            UNIT_ASSERT_EQUAL(resultWithSmallShare[0], getRangesSubset(0, 1));
+            UNIT_ASSERT_EXCEPTION(SplitByShares(objectsGrouping, TVector<double>{1.0, 0.0}), TCatBoostException);
+        }
+
+        // groups, parts are group ranges
+        {
+            const TObjectsGrouping objectsGrouping(
+                TVector<TGroupBounds>{{0, 1}, {1, 4}, {4, 5}, {5, 9}, {9, 10}}
+            );
+            const auto result = SplitByShares(objectsGrouping, TVector<double>{1.0, 1.0, 3.0});
+            const TVector<TArraySubsetIndexing<ui32>> expected{
+                getRangesSubset(0, 2),
+                getRangesSubset(2, 3),
+                getRangesSubset(3, 5)
+            };
+            UNIT_ASSERT_EQUAL(result, expected);
+        }
+    }
+
     Y_UNIT_TEST(QuantileSplitObjects) {
         const ui32 objectCount = 8;
         const TObjectsGrouping objectsGrouping(objectCount);
@@ -7,6 +7,7 @@
 #include "util.h"
 
 #include <catboost/private/libs/algo/apply.h>
+#include <catboost/private/libs/algo/features_data_helpers.h>
 #include <catboost/private/libs/algo/plot.h>
 #include <catboost/private/libs/algo/yetirank_helpers.h>
 #include <catboost/private/libs/algo/tree_print.h>
@@ -17,6 +18,7 @@
 #include <catboost/libs/logging/logging.h>
 #include <catboost/libs/logging/profile_info.h>
 #include <catboost/libs/loggers/logger.h>
+#include <catboost/libs/model/cpu/quantization.h>
 #include <catboost/private/libs/options/enum_helpers.h>
 #include <catboost/private/libs/options/json_helper.h>
 #include <catboost/private/libs/options/restrictions.h>
@@ -252,11 +254,110 @@ static bool TryGetObjectiveMetric(const TFullModel& model, NCatboostOptions::TLo
     return TryGetLossDescription(model, lossDescription);
 }
 
+namespace {
+    // SHAP values of a feature in the leaves of the trees which split by it
+    struct TFeatureLeafShapValues {
+        TVector<ui32> Trees;
+        TVector<size_t> TreeFirstValue; // Trees.size() + 1 offsets in Values
+        TVector<double> Values; // [tree][leafIdx][dimension]
+    };
+}
+
+static TVector<TFeatureLeafShapValues> GetFeatureLeafShapValues(
+    const TModelTrees& forest,
+    const TShapPreparedTrees& preparedTrees,
+    int featuresCount
+) {
+    const int approxDimension = forest.GetDimensionsCount();
+    TVector<TFeatureLeafShapValues> featureLeafShapValues(featuresCount);
+    for (auto& featureValues : featureLeafShapValues) {
+        featureValues.TreeFirstValue.push_back(0);
+    }
+    TVector<int> treeFeatures;
+    TVector<double> treeValues;
+    for (size_t treeIdx : xrange(forest.GetTreeCount())) {
+        GetObliviousTreeLeafShapValues(forest, preparedTrees, treeIdx, &treeFeatures, &treeValues);
+        const size_t leafCount = size_t(1) << forest.GetTreeSizes()[treeIdx];
+        for (size_t column : xrange(treeFeatures.size())) {
+            auto& featureValues = featureLeafShapValues[treeFeatures[column]];
+            featureValues.Trees.push_back(treeIdx);
+            for (size_t leafIdx : xrange(leafCount)) {
+                const double* leafValues = treeValues.data() + (leafIdx * treeFeatures.size() + column) * approxDimension;
+                featureValues.Values.insert(featureValues.Values.end(), leafValues, leafValues + approxDimension);
+            }
+            featureValues.TreeFirstValue.push_back(featureValues.Values.size());
+        }
+    }
+    return featureLeafShapValues;
+}
+
+/* Leaf indexes of documents are calculated once and stored as [treeIdx][documentIdx] in TLeafIndex
+ * (ui8 for oblivious trees of depth up to 8, ui16 otherwise), then the contribution of each feature is
+ * summed in one pass over the trees splitting by it, in the order of trees as by CalcShapValuesInternalForFeature.
+ */
+template <typename TLeafIndex>
+static void CalcFeatureContributionsByLeafIndexes(
+    const TFullModel& model,
+    const TObjectsDataProvider& objectsData,
+    ui32 begin,
+    ui32 end,
+    const TVector<TFeatureLeafShapValues>& featureLeafShapValues,
+    NPar::TLocalExecutor* localExecutor,
+    TVector<TLeafIndex>* leafIndexes,
+    TVector<TVector<TVector<double>>>* contributions // [featureIdx][dimension][documentIdx - begin]
+) {
+    const TModelTrees& forest = *model.ModelTrees;
+    const size_t treeCount = forest.GetTreeCount();
+    const int approxDimension = forest.GetDimensionsCount();
+    const ui32 documentCount = end - begin;
+
+    leafIndexes->yresize(treeCount * documentCount);
+    THolder<IFeaturesBlockIterator> featuresBlockIterator
+        = CreateFeaturesBlockIterator(model, objectsData, begin, end);
+    const ui32 documentBlockSize = NModelEvaluation::FORMULA_EVALUATION_BLOCK_SIZE;
+    TVector<NModelEvaluation::TCalcerIndexType> blockLeafIndexes(documentBlockSize * treeCount);
+    for (ui32 blockBegin = 0; blockBegin < documentCount; blockBegin += documentBlockSize) {
+        const ui32 blockEnd = Min(blockBegin + documentBlockSize, documentCount);
+        featuresBlockIterator->NextBlock(blockEnd - blockBegin);
+        auto binarizedFeaturesForBlock = MakeQuantizedFeaturesForEvaluator(model, *featuresBlockIterator, blockBegin, blockEnd);
+        model.GetCurrentEvaluator()->CalcLeafIndexes(
+            binarizedFeaturesForBlock.Get(),
+            0, treeCount,
+            MakeArrayRef(blockLeafIndexes.data(), (blockEnd - blockBegin) * treeCount)
+        );
+        for (ui32 documentIdx : xrange(blockBegin, blockEnd)) {
+            const auto* documentLeafIndexes = blockLeafIndexes.data() + (documentIdx - blockBegin) * treeCount;
+            for (size_t treeIdx : xrange(treeCount)) {
+                (*leafIndexes)[treeIdx * documentCount + documentIdx] = documentLeafIndexes[treeIdx];
+            }
+        }
+    }
+
+    contributions->resize(featureLeafShapValues.size());
+    localExecutor->ExecRange([&] (int featureIdx) {
+        const auto& featureValues = featureLeafShapValues[featureIdx];
+        auto& featureContributions = (*contributions)[featureIdx];
+        featureContributions.resize(approxDimension);
+        for (int dimension : xrange(approxDimension)) {
+            featureContributions[dimension].assign(documentCount, 0.0);
+            double* dimensionContributions = featureContributions[dimension].data();
+            for (size_t treeNum : xrange(featureValues.Trees.size())) {
+                const TLeafIndex* treeLeafIndexes = leafIndexes->data() + featureValues.Trees[treeNum] * documentCount;
+                const double* treeValues = featureValues.Values.data() + featureValues.TreeFirstValue[treeNum] + dimension;
+                for (ui32 documentIdx = 0; documentIdx < documentCount; ++documentIdx) {
+                    dimensionContributions[documentIdx] += treeValues[treeLeafIndexes[documentIdx] * approxDimension];
+                }
+            }
+        }
+    }, 0, featureLeafShapValues.size(), NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
 static TVector<std::pair<double, TFeature>> CalcFeatureEffectLossChange(
     const TFullModel& model,
     const TDataProvider& dataProvider,
     NPar::TLocalExecutor* localExecutor,
-    ECalcTypeShapValues calcType
+    ECalcTypeShapValues calcType,
+    EPreCalcShapValues mode
 )
 {
     NCatboostOptions::TLossDescription metricDescription;
@@ -285,8 +386,7 @@ static TVector<std::pair<double, TFeature>> CalcFeatureEffectLossChange(
     auto targetData = CreateModelCompatibleProcessedDataProvider(dataset, {metricDescription}, model, GetMonopolisticFreeCpuRam(), &rand, localExecutor).TargetData;
     CB_ENSURE(targetData->GetTargetDimension() <= 1, "Multi-dimensional target fstr is unimplemented yet");
 
-    TShapPreparedTrees preparedTrees = PrepareTrees(model, &dataset, EPreCalcShapValues::Auto, localExecutor, true,
-            calcType);
+    TShapPreparedTrees preparedTrees = PrepareTrees(model, &dataset, mode, localExecutor, true, calcType);
     CalcShapValuesByLeaf(
         model,
         /*fixedFeatureParams*/ Nothing(),
@@ -298,6 +398,18 @@ static TVector<std::pair<double, TFeature>> CalcFeatureEffectLossChange(
     );
     TVector<TMetricHolder> scores(featuresCount + 1);
 
+    // contributions of features are taken from cached leaf indexes when SHAP values of all leaves are precalculated
+    const TModelTrees& forest = *model.ModelTrees;
+    const bool useLeafIndexes
+        = forest.IsOblivious() && preparedTrees.CalcShapValuesByLeafForAllTrees && !forest.GetTreeSizes().empty();
+    const bool useCompactLeafIndexes
+        = useLeafIndexes && *MaxElement(forest.GetTreeSizes().begin(), forest.GetTreeSizes().end()) <= 8;
+    const TVector<TFeatureLeafShapValues> featureLeafShapValues = useLeafIndexes
+        ? GetFeatureLeafShapValues(forest, preparedTrees, featuresCount)
+        : TVector<TFeatureLeafShapValues>();
+    TVector<ui8> compactLeafIndexes;
+    TVector<ui16> leafIndexes;
+
     TConstArrayRef<TQueryInfo> targetQueriesInfo = targetData->GetGroupInfo().GetOrElse(TConstArrayRef<TQueryInfo>());
     TVector<TVector<double>> approx = ApplyModelMulti(model, objectsData, EPredictionType::RawFormulaVal, 0, 0,
                                                       localExecutor);
@@ -353,25 +465,56 @@ static TVector<std::pair<double, TFeature>> CalcFeatureEffectLossChange(
         scores.back().Add(
             metric->Eval(approx, targetData->GetOneDimensionalTarget().GetOrElse(TConstArrayRef<float>()), GetWeights(*targetData), queriesInfo, queryBegin, queryEnd, *localExecutor)
         );
-        TVector<TVector<TVector<double>>> shapValues;
-        CalcShapValuesInternalForFeature(
-            preparedTrees,
-            model,
-            0,
-            begin,
-            end,
-            featuresCount,
-            objectsData,
-            &shapValues,
-            localExecutor,
-            calcType);
+        TVector<TVector<TVector<double>>> contributions; // [featureIdx][dimension][docIdx - begin]
+        if (useCompactLeafIndexes) {
+            CalcFeatureContributionsByLeafIndexes(
+                model,
+                objectsData,
+                begin,
+                end,
+                featureLeafShapValues,
+                localExecutor,
+                &compactLeafIndexes,
+                &contributions);
+        } else if (useLeafIndexes) {
+            CalcFeatureContributionsByLeafIndexes(
+                model,
+                objectsData,
+                begin,
+                end,
+                featureLeafShapValues,
+                localExecutor,
+                &leafIndexes,
+                &contributions);
+        } else {
+            TVector<TVector<TVector<double>>> shapValues;
+            CalcShapValuesInternalForFeature(
+                preparedTrees,
+                model,
+                0,
+                begin,
+                end,
+                featuresCount,
+                objectsData,
+                &shapValues,
+                localExecutor,
+                calcType);
+            contributions.assign(featuresCount, TVector<TVector<double>>(approxDimension, TVector<double>(end - begin)));
+            for (ui32 docIdx : xrange(end - begin)) {
+                for (int featureIdx = 0; featureIdx < featuresCount; ++featureIdx) {
+                    for (int dimensionIdx = 0; dimensionIdx < approxDimension; ++dimensionIdx) {
+                        contributions[featureIdx][dimensionIdx][docIdx] = shapValues[docIdx][featureIdx][dimensionIdx];
+                    }
+                }
+            }
+        }
 
         for (int featureIdx = 0; featureIdx < featuresCount; ++featureIdx) {
             NPar::TLocalExecutor::TExecRangeParams blockParams(begin, end);
             blockParams.SetBlockCountToThreadCount();
             localExecutor->ExecRange([&](ui32 docIdx) {
                 for (int dimensionIdx = 0; dimensionIdx < approxDimension; ++dimensionIdx) {
-                    approx[dimensionIdx][docIdx] -= shapValues[docIdx - begin][featureIdx][dimensionIdx];
+                    approx[dimensionIdx][docIdx] -= contributions[featureIdx][dimensionIdx][docIdx - begin];
                 }
             }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
             scores[featureIdx].Add(
@@ -380,7 +523,7 @@ static TVector<std::pair<double, TFeature>> CalcFeatureEffectLossChange(
             );
             localExecutor->ExecRange([&](ui32 docIdx) {
                 for (int dimensionIdx = 0; dimensionIdx < approxDimension; ++dimensionIdx) {
-                    approx[dimensionIdx][docIdx] += shapValues[docIdx - begin][featureIdx][dimensionIdx];
+                    approx[dimensionIdx][docIdx] += contributions[featureIdx][dimensionIdx][docIdx - begin];
                 }
             }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
         }
@@ -431,7 +574,8 @@ TVector<std::pair<double, TFeature>> CalcFeatureEffect(
     const TDataProviderPtr dataset,
     EFstrType type,
     NPar::TLocalExecutor* localExecutor,
-    ECalcTypeShapValues calcType
+    ECalcTypeShapValues calcType,
+    EPreCalcShapValues mode
 )
 {
     type = AdjustFeatureImportanceType(type, model.GetLossFunctionName());
@@ -443,7 +587,7 @@ TVector<std::pair<double, TFeature>> CalcFeatureEffect(
             dataset,
             "Dataset is not provided for " << EFstrType::LossFunctionChange << ", choose "
                 << EFstrType::PredictionValuesChange << " fstr type explicitly or provide dataset.");
-        return CalcFeatureEffectLossChange(model, *dataset.Get(), localExecutor, calcType);
+        return CalcFeatureEffectLossChange(model, *dataset.Get(), localExecutor, calcType, mode);
     } else {
         CB_ENSURE_INTERNAL(
             type == EFstrType::PredictionValuesChange || type == EFstrType::InternalFeatureImportance,
@@ -73,7 +73,8 @@ TVector<std::pair<double, TFeature>> CalcFeatureEffect(
     const NCB::TDataProviderPtr dataset, // can be nullptr
     EFstrType type,
     NPar::TLocalExecutor* localExecutor,
-    ECalcTypeShapValues calcType = ECalcTypeShapValues::Normal
+    ECalcTypeShapValues calcType = ECalcTypeShapValues::Normal,
+    EPreCalcShapValues mode = EPreCalcShapValues::Auto // used by LossFunctionChange only
 );
 
 TVector<TFeatureEffect> CalcRegularFeatureEffect(
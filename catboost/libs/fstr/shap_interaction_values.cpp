@@ -6,6 +6,13 @@
 #include <catboost/private/libs/algo/features_data_helpers.h>
 #include <catboost/private/libs/algo/index_calcer.h>
 #include <catboost/libs/model/cpu/quantization.h>
+#include <catboost/libs/loggers/logger.h>
+#include <catboost/libs/logging/profile_info.h>
+
+#include <library/cpp/pop_count/popcount.h>
+
+#include <util/generic/hash.h>
+#include <util/generic/xrange.h>
 
 
 using namespace NCB;
@@ -379,6 +386,177 @@ static void CalcInternalShapInteractionValuesMulti(
     }
 }
 
+namespace {
+    // Shapley interaction values of all pairs of combination classes of an oblivious tree for every leaf
+    struct TObliviousTreeInteractionTable {
+        TVector<int> Players; // combination classes of the tree
+        TVector<double> Values; // [leafIdx][player1][player2][dimension]
+    };
+}
+
+/* Φ(i,j) = sum(|S|! (m - |S| - 2)! / (2 (m - 1)!) (V(S ∪ {i, j}) − V(S ∪ {i}) − V(S ∪ {j}) + V(S))) over S ⊆ P \ {i, j}
+ * and Φ(i,i) = ϕ(i) − sum(Φ(i,j)), where V are expected values of the tree given subsets of its m players P.
+ * It is the same as halved difference of SHAP values with i fixed on and fixed off restricted to one tree.
+ */
+static void CalcObliviousTreeInteractionTable(
+    const TModelTrees& forest,
+    const TShapPreparedTrees& preparedTrees,
+    size_t treeIdx,
+    TObliviousTreeInteractionTable* table
+) {
+    const int approxDimension = forest.GetDimensionsCount();
+    const size_t leafCount = size_t(1) << forest.GetTreeSizes()[treeIdx];
+    TVector<double> expectedValues; // [subset][leafIdx]
+    for (int dimension : xrange(approxDimension)) {
+        CalcObliviousTreeExpectedValuesForSubsets(forest, preparedTrees, treeIdx, dimension, &table->Players, &expectedValues);
+        const int playerCount = table->Players.size();
+        const size_t subsetCount = size_t(1) << playerCount;
+        if (dimension == 0) {
+            table->Values.assign(leafCount * playerCount * playerCount * approxDimension, 0.0);
+        }
+        const TVector<double> shapCoefficients = GetShapleySubsetSizeCoefficients(playerCount);
+        const TVector<double> interactionCoefficients
+            = playerCount > 1 ? GetShapleySubsetSizeCoefficients(playerCount - 1) : TVector<double>();
+        for (size_t leafIdx : xrange(leafCount)) {
+            const auto expectedValue = [&] (size_t subset) {
+                return expectedValues[subset * leafCount + leafIdx];
+            };
+            const auto tableValue = [&] (int player1, int player2) -> double& {
+                return table->Values[((leafIdx * playerCount + player1) * playerCount + player2) * approxDimension + dimension];
+            };
+            for (int player1 : xrange(playerCount)) {
+                const size_t bit1 = size_t(1) << player1;
+                double shapValue = 0.0;
+                for (size_t subset : xrange(subsetCount)) {
+                    if (!(subset & bit1)) {
+                        shapValue += shapCoefficients[PopCount(subset)]
+                            * (expectedValue(subset | bit1) - expectedValue(subset));
+                    }
+                }
+                tableValue(player1, player1) += shapValue;
+                for (int player2 : xrange(player1 + 1, playerCount)) {
+                    const size_t bit2 = size_t(1) << player2;
+                    double interactionEffect = 0.0;
+                    for (size_t subset : xrange(subsetCount)) {
+                        if (!(subset & (bit1 | bit2))) {
+                            interactionEffect += interactionCoefficients[PopCount(subset)] * (
+                                expectedValue(subset | bit1 | bit2) - expectedValue(subset | bit1)
+                                - expectedValue(subset | bit2) + expectedValue(subset));
+                        }
+                    }
+                    interactionEffect /= 2.0;
+                    tableValue(player1, player2) = interactionEffect;
+                    tableValue(player2, player1) = interactionEffect;
+                    tableValue(player1, player1) -= interactionEffect;
+                    tableValue(player2, player2) -= interactionEffect;
+                }
+            }
+        }
+    }
+}
+
+/* Interaction values are additive over trees and are zero for classes which do not split the same tree,
+ * so only pairs of players of each tree are visited instead of conditioning on every class.
+ * Tables of a block of trees are calculated in parallel, then documents are processed in parallel and
+ * addTreeValues(table, documentIdx, leafIdx) is called for every tree of the block,
+ * each document is processed by one thread, so accumulators of a document need no synchronization.
+ */
+template <typename TAddTreeValues>
+static void ProcessObliviousTreeInteractionTables(
+    const TFullModel& model,
+    const TShapPreparedTrees& preparedTrees,
+    const TVector<TVector<NModelEvaluation::TCalcerIndexType>>& indexes,
+    size_t documentCount,
+    int logPeriod,
+    NPar::TLocalExecutor* localExecutor,
+    const TAddTreeValues& addTreeValues
+) {
+    const TModelTrees& forest = *model.ModelTrees;
+    const size_t treeCount = forest.GetTreeCount();
+    const size_t treeBlockSize = CB_THREAD_LIMIT;
+    const size_t documentBlockSize = CB_THREAD_LIMIT; // the same as in CalcLeafIndices
+    TProfileInfo processTreesProfile(treeCount);
+    TImportanceLogger treesLogger(treeCount, "trees processed", "Processing trees...", logPeriod);
+    TVector<TObliviousTreeInteractionTable> tables(treeBlockSize);
+    for (size_t start = 0; start < treeCount; start += treeBlockSize) {
+        const size_t end = Min(start + treeBlockSize, treeCount);
+        processTreesProfile.StartIterationBlock();
+
+        NPar::TLocalExecutor::TExecRangeParams treesParams(start, end);
+        localExecutor->ExecRange([&] (size_t treeIdx) {
+            CalcObliviousTreeInteractionTable(forest, preparedTrees, treeIdx, &tables[treeIdx - start]);
+        }, treesParams, NPar::TLocalExecutor::WAIT_COMPLETE);
+
+        NPar::TLocalExecutor::TExecRangeParams documentsParams(0, documentCount);
+        localExecutor->ExecRange([&] (size_t documentIdx) {
+            const auto* documentIndexes
+                = indexes[documentIdx / documentBlockSize].data() + (documentIdx % documentBlockSize) * treeCount;
+            for (size_t treeIdx : xrange(start, end)) {
+                addTreeValues(tables[treeIdx - start], documentIdx, documentIndexes[treeIdx]);
+            }
+        }, documentsParams, NPar::TLocalExecutor::WAIT_COMPLETE);
+
+        processTreesProfile.FinishIterationBlock(end - start);
+        auto profileResults = processTreesProfile.GetProfileResults();
+        treesLogger.Log(profileResults);
+    }
+}
+
+template <typename TStorageType>
+static void CalcInternalShapInteractionValuesByTrees(
+    const TFullModel& model,
+    const size_t documentCount,
+    const TVector<TVector<NModelEvaluation::TCalcerIndexType>>& indexes,
+    const TVector<size_t>& classIndicesFirst,
+    const TVector<size_t>& classIndicesSecond,
+    int logPeriod,
+    NPar::TLocalExecutor* localExecutor,
+    const TShapPreparedTrees& preparedTrees,
+    TStorageType* shapInteractionValuesInternal
+) {
+    if (classIndicesFirst.empty() || classIndicesSecond.empty()) {
+        return;
+    }
+    const size_t classCount = preparedTrees.CombinationClassFeatures.size();
+    TVector<bool> isFirstClassIdx(classCount, false);
+    TVector<bool> isSecondClassIdx(classCount, false);
+    TVector<bool> isSameClassIdx(classCount, false);
+    FillIndices(classIndicesFirst, &isFirstClassIdx);
+    FillIndices(classIndicesSecond, &isSecondClassIdx);
+    FillIndices(IntersectClasses(classIndicesFirst, classIndicesSecond), &isSameClassIdx);
+    const int approxDimension = model.GetDimensionsCount();
+    ProcessObliviousTreeInteractionTables(
+        model,
+        preparedTrees,
+        indexes,
+        documentCount,
+        logPeriod,
+        localExecutor,
+        [&] (const TObliviousTreeInteractionTable& table, size_t documentIdx, size_t leafIdx) {
+            const int playerCount = table.Players.size();
+            const double* leafValues = table.Values.data() + leafIdx * playerCount * playerCount * approxDimension;
+            for (int player1 : xrange(playerCount)) {
+                const size_t classIdx1 = table.Players[player1];
+                if (!isFirstClassIdx[classIdx1]) {
+                    continue;
+                }
+                for (int player2 : xrange(playerCount)) {
+                    const size_t classIdx2 = table.Players[player2];
+                    const bool isNeeded = classIdx1 == classIdx2 ? isSameClassIdx[classIdx1] : isSecondClassIdx[classIdx2];
+                    if (!isNeeded) {
+                        continue;
+                    }
+                    auto& valuesBetweenClasses = GetDocumentsByClasses(shapInteractionValuesInternal, classIdx1, classIdx2);
+                    const double* values = leafValues + (player1 * playerCount + player2) * approxDimension;
+                    for (int dimension : xrange(approxDimension)) {
+                        valuesBetweenClasses[dimension][documentIdx] += values[dimension];
+                    }
+                }
+            }
+        }
+    );
+}
+
 static void FilterClassFeaturesByPair(
     std::pair<int, int> pairOfFeatures,
     TVector<TVector<int>>* combinationClassFeatures
@@ -488,19 +666,33 @@ static void CalcShapInteraction(
         localExecutor,
         &shapInteractionValuesInternal
     );   
-    CalcInternalShapInteractionValuesMulti(
-        model,
-        documentCount,
-        binarizedFeatures,
-        indexes,
-        classIndicesFirst,
-        classIndicesSecond,
-        logPeriod,
-        localExecutor,
-        preparedTrees,
-        &shapInteractionValuesInternal,
-        calcType
-    );
+    if (CanUseObliviousShapTables(*model.ModelTrees, calcType)) {
+        CalcInternalShapInteractionValuesByTrees(
+            model,
+            documentCount,
+            indexes,
+            classIndicesFirst,
+            classIndicesSecond,
+            logPeriod,
+            localExecutor,
+            *preparedTrees,
+            &shapInteractionValuesInternal
+        );
+    } else {
+        CalcInternalShapInteractionValuesMulti(
+            model,
+            documentCount,
+            binarizedFeatures,
+            indexes,
+            classIndicesFirst,
+            classIndicesSecond,
+            logPeriod,
+            localExecutor,
+            preparedTrees,
+            &shapInteractionValuesInternal,
+            calcType
+        );
+    }
     int flatFeatureCount = SafeIntegerCast<int>(dataset.MetaInfo.GetFeatureCount());
     int featuresCount = pairOfFeatures ? (pairOfFeatures->first == pairOfFeatures->second ? 1 : 2) : flatFeatureCount;
     Allocate4DimensionalVector(
@@ -593,3 +785,95 @@ TInteractionValuesFull CalcShapInteractionValuesMulti(
     }
     return shapInteractionValues;
 }
+
+/* Values of a document are accumulated in a map from pair of features to its values,
+ * pairs of classes of a tree are unpacked to pairs of their features the same way as dense values.
+ */
+TVector<TVector<TShapInteractionValue>> CalcSparseShapInteractionValuesMulti(
+    const TFullModel& model,
+    const TDataProvider& dataset,
+    int logPeriod,
+    NPar::TLocalExecutor* localExecutor
+) {
+    CB_ENSURE(
+        CanUseObliviousShapTables(*model.ModelTrees, ECalcTypeShapValues::Normal),
+        "Sparse shap interaction values are supported only for oblivious trees of depth at most 10"
+    );
+    CheckNonZeroApproxForZeroWeightLeaf(model);
+    const TShapPreparedTrees preparedTrees = PrepareTrees(
+        model,
+        &dataset,
+        EPreCalcShapValues::NoPreCalc,
+        localExecutor,
+        /*calcInternalValues*/ true
+    );
+    TVector<TIntrusivePtr<NModelEvaluation::IQuantizedData>> binarizedFeatures;
+    TVector<TVector<NModelEvaluation::TCalcerIndexType>> indexes;
+    CalcLeafIndices(model, dataset, &binarizedFeatures, &indexes);
+
+    const size_t documentCount = dataset.ObjectsGrouping->GetObjectCount();
+    const int approxDimension = model.GetDimensionsCount();
+    const auto& combinationClassFeatures = preparedTrees.CombinationClassFeatures;
+    const TVector<double> rescaleCoefficients = ContructRescaleCoefficients(combinationClassFeatures);
+
+    TVector<THashMap<std::pair<int, int>, TVector<double>>> valuesByFeaturePair(documentCount);
+    ProcessObliviousTreeInteractionTables(
+        model,
+        preparedTrees,
+        indexes,
+        documentCount,
+        logPeriod,
+        localExecutor,
+        [&] (const TObliviousTreeInteractionTable& table, size_t documentIdx, size_t leafIdx) {
+            auto& documentValues = valuesByFeaturePair[documentIdx];
+            const auto addValues = [&] (int featureIdx1, int featureIdx2, const double* values, double coefficient) {
+                auto& pairValues = documentValues[std::make_pair(Min(featureIdx1, featureIdx2), Max(featureIdx1, featureIdx2))];
+                pairValues.resize(approxDimension, 0.0);
+                for (int dimension : xrange(approxDimension)) {
+                    pairValues[dimension] += values[dimension] * coefficient;
+                }
+            };
+            const int playerCount = table.Players.size();
+            const double* leafValues = table.Values.data() + leafIdx * playerCount * playerCount * approxDimension;
+            for (int player1 : xrange(playerCount)) {
+                const int classIdx1 = table.Players[player1];
+                // main effect
+                const double* mainEffect = leafValues + (player1 * playerCount + player1) * approxDimension;
+                for (int featureIdx : combinationClassFeatures[classIdx1]) {
+                    addValues(featureIdx, featureIdx, mainEffect, 1.0 / rescaleCoefficients[classIdx1]);
+                }
+                // interaction effect, unordered pairs of features get values of both orders of classes
+                for (int player2 : xrange(player1 + 1, playerCount)) {
+                    const int classIdx2 = table.Players[player2];
+                    const double* interactionEffect = leafValues + (player1 * playerCount + player2) * approxDimension;
+                    const double coefficient = 1.0 / (rescaleCoefficients[classIdx1] * rescaleCoefficients[classIdx2]);
+                    for (int featureIdx1 : combinationClassFeatures[classIdx1]) {
+                        for (int featureIdx2 : combinationClassFeatures[classIdx2]) {
+                            if (featureIdx1 != featureIdx2) {
+                                addValues(featureIdx1, featureIdx2, interactionEffect, coefficient);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    );
+
+    TVector<TVector<TShapInteractionValue>> shapInteractionValues(documentCount);
+    NPar::TLocalExecutor::TExecRangeParams documentsParams(0, documentCount);
+    localExecutor->ExecRange([&] (size_t documentIdx) {
+        auto& documentValues = shapInteractionValues[documentIdx];
+        documentValues.reserve(valuesByFeaturePair[documentIdx].size());
+        for (auto& [featurePair, values] : valuesByFeaturePair[documentIdx]) {
+            documentValues.push_back({featurePair.first, featurePair.second, std::move(values)});
+        }
+        THashMap<std::pair<int, int>, TVector<double>>().swap(valuesByFeaturePair[documentIdx]);
+        Sort(
+            documentValues,
+            [] (const TShapInteractionValue& lhs, const TShapInteractionValue& rhs) {
+                return std::tie(lhs.FirstFeature, lhs.SecondFeature) < std::tie(rhs.FirstFeature, rhs.SecondFeature);
+            }
+        );
+    }, documentsParams, NPar::TLocalExecutor::WAIT_COMPLETE);
+    return shapInteractionValues;
+}
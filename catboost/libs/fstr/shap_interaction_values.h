@@ -24,3 +24,20 @@ TVector<TVector<TVector<TVector<double>>>> CalcShapInteractionValuesMulti(
     NPar::TLocalExecutor* localExecutor,
     ECalcTypeShapValues calcType = ECalcTypeShapValues::Normal
 );
+
+struct TShapInteractionValue {
+    int FirstFeature = 0; // FirstFeature <= SecondFeature
+    int SecondFeature = 0;
+    TVector<double> Values; // [dim]
+};
+
+/* Only pairs of features splitting the same tree, Φ(i,j) = Φ(j,i) is stored once,
+ * the expected value is not included. Requires oblivious trees of depth at most 10.
+ * returned: SparseShapInteractionValues[documentIdx], sorted by pair of features
+ */
+TVector<TVector<TShapInteractionValue>> CalcSparseShapInteractionValuesMulti(
+    const TFullModel& model,
+    const NCB::TDataProvider& dataset,
+    int logPeriod,
+    NPar::TLocalExecutor* localExecutor
+);
@@ -10,9 +10,12 @@
 #include <catboost/libs/logging/profile_info.h>
 #include <catboost/private/libs/options/restrictions.h>
 
+#include <library/cpp/pop_count/popcount.h>
+
 #include <util/generic/algorithm.h>
 #include <util/generic/cast.h>
 #include <util/generic/utility.h>
+#include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
 #include <catboost/libs/model/cpu/quantization.h>
 
@@ -39,6 +42,11 @@ namespace {
     };
 } //anonymous
 
+// tables of deeper trees need too much memory to be built, such trees are processed by TreeSHAP
+static const int MaxShapTablesTreeDepth = 10;
+// in Auto mode larger precalculated values are not used, SHAP values are calculated for each document
+static const ui64 MaxPreCalcShapValuesSize = ui64(1) << 31;
+
 static TVector<TFeaturePathElement> ExtendFeaturePath(
     const TVector<TFeaturePathElement>& oldFeaturePath,
     double zeroPathsFraction,
@@ -1068,6 +1076,289 @@ static void MapBinFeaturesToClasses(
     }
 }
 
+static bool IsFixedCombinationClass(
+    const TMaybe<TFixedFeatureParams>& fixedFeatureParams,
+    int combinationClass,
+    TFixedFeatureParams::EMode fixedFeatureMode
+) {
+    return fixedFeatureParams.Defined()
+        && fixedFeatureParams->Feature == combinationClass
+        && fixedFeatureParams->FixedFeatureMode == fixedFeatureMode;
+}
+
+// levelClasses[depth] is a combination class of the split on depth, players are not fixed classes of the tree
+static void GetObliviousTreeShapPlayers(
+    const TModelTrees& forest,
+    const TVector<int>& binFeatureCombinationClass,
+    const TMaybe<TFixedFeatureParams>& fixedFeatureParams,
+    size_t treeIdx,
+    TVector<int>* levelClasses,
+    TVector<int>* players
+) {
+    const int treeDepth = forest.GetTreeSizes()[treeIdx];
+    const int treeStartOffset = forest.GetTreeStartOffsets()[treeIdx];
+    levelClasses->resize(treeDepth);
+    players->clear();
+    for (int depth = 0; depth < treeDepth; ++depth) {
+        const int remainingDepth = treeDepth - depth - 1;
+        const int combinationClass = binFeatureCombinationClass[forest.GetTreeSplits()[treeStartOffset + remainingDepth]];
+        (*levelClasses)[depth] = combinationClass;
+        const bool isFixed
+            = IsFixedCombinationClass(fixedFeatureParams, combinationClass, TFixedFeatureParams::EMode::FixedOn)
+            || IsFixedCombinationClass(fixedFeatureParams, combinationClass, TFixedFeatureParams::EMode::FixedOff);
+        if (!isFixed && !IsIn(*players, combinationClass)) {
+            players->push_back(combinationClass);
+        }
+    }
+}
+
+TVector<double> GetShapleySubsetSizeCoefficients(int playerCount) {
+    TVector<double> coefficients(playerCount, 1.0 / Max(playerCount, 1));
+    for (int subsetSize = 1; subsetSize < playerCount; ++subsetSize) {
+        coefficients[subsetSize] = coefficients[subsetSize - 1] * subsetSize / (playerCount - subsetSize);
+    }
+    return coefficients;
+}
+
+bool CanUseObliviousShapTables(const TModelTrees& forest, ECalcTypeShapValues calcType) {
+    if (calcType != ECalcTypeShapValues::Normal || !forest.IsOblivious()) {
+        return false;
+    }
+    return AllOf(
+        forest.GetTreeSizes(),
+        [] (int treeDepth) {
+            return treeDepth <= MaxShapTablesTreeDepth;
+        }
+    );
+}
+
+static void InitObliviousShapTables(
+    const TModelTrees& forest,
+    const TVector<int>& binFeatureCombinationClass,
+    const TVector<TVector<int>>& combinationClassFeatures,
+    const TMaybe<TFixedFeatureParams>& fixedFeatureParams,
+    bool calcInternalValues,
+    TObliviousShapTables* tables
+) {
+    const size_t treeCount = forest.GetTreeCount();
+    const ui64 approxDimension = forest.GetDimensionsCount();
+    tables->TreeFirstColumn.assign(1, 0);
+    tables->ColumnFeatures.clear();
+    tables->TreeFirstValue.assign(1, 0);
+
+    TVector<int> levelClasses;
+    TVector<int> players;
+    TVector<int> columns;
+    for (size_t treeIdx = 0; treeIdx < treeCount; ++treeIdx) {
+        GetObliviousTreeShapPlayers(forest, binFeatureCombinationClass, fixedFeatureParams, treeIdx, &levelClasses, &players);
+        if (calcInternalValues) {
+            columns = players;
+        } else {
+            columns.clear();
+            for (int combinationClass : players) {
+                columns.insert(columns.end(), combinationClassFeatures[combinationClass].begin(), combinationClassFeatures[combinationClass].end());
+            }
+            SortUnique(columns);
+        }
+        tables->ColumnFeatures.insert(tables->ColumnFeatures.end(), columns.begin(), columns.end());
+        tables->TreeFirstColumn.push_back(tables->ColumnFeatures.size());
+        const ui64 leafCount = ui64(1) << forest.GetTreeSizes()[treeIdx];
+        tables->TreeFirstValue.push_back(tables->TreeFirstValue.back() + leafCount * columns.size() * approxDimension);
+    }
+    tables->Values.assign(tables->TreeFirstValue.back(), 0.0);
+}
+
+static inline TConstArrayRef<double> GetObliviousShapTableRow(
+    const TObliviousShapTables& tables,
+    size_t treeIdx,
+    size_t leafIdx,
+    int approxDimension
+) {
+    const size_t rowSize = (tables.TreeFirstColumn[treeIdx + 1] - tables.TreeFirstColumn[treeIdx]) * approxDimension;
+    return MakeArrayRef(tables.Values.data() + tables.TreeFirstValue[treeIdx] + leafIdx * rowSize, rowSize);
+}
+
+static inline TConstArrayRef<int> GetObliviousShapTableColumns(const TObliviousShapTables& tables, size_t treeIdx) {
+    return MakeArrayRef(
+        tables.ColumnFeatures.data() + tables.TreeFirstColumn[treeIdx],
+        tables.TreeFirstColumn[treeIdx + 1] - tables.TreeFirstColumn[treeIdx]);
+}
+
+/* Expected values of an oblivious tree for every leaf given every subset of players, [subset][leafIdx].
+ * Expected value given a subset S follows the leaf splits of players from S and weights both subtrees
+ * by cover for the other splits. It depends only on the bits of the leaf index of splits from S,
+ * so expected values for all leaves are calculated in place bottom-up in 2^depth.
+ * Splits on fixed on classes are always followed, splits on fixed off classes are never followed.
+ */
+static void CalcObliviousTreeExpectedValues(
+    const TModelTrees& forest,
+    const TVector<int>& levelClasses,
+    const TVector<int>& players,
+    size_t treeIdx,
+    const TVector<TVector<double>>& subtreeWeights,
+    const TMaybe<TFixedFeatureParams>& fixedFeatureParams,
+    double averageTreeApprox,
+    int dimension,
+    TVector<double>* expectedValues
+) {
+    const int approxDimension = forest.GetDimensionsCount();
+    const int treeDepth = forest.GetTreeSizes()[treeIdx];
+    const size_t leafCount = size_t(1) << treeDepth;
+    const size_t subsetCount = size_t(1) << players.size();
+    const double* leafValues = forest.GetFirstLeafPtrForTree(treeIdx);
+
+    TVector<ui32> levelPlayersMask(treeDepth, 0);
+    TVector<bool> isLevelAlwaysFollowed(treeDepth, false);
+    for (int depth = 0; depth < treeDepth; ++depth) {
+        const int combinationClass = levelClasses[depth];
+        isLevelAlwaysFollowed[depth]
+            = IsFixedCombinationClass(fixedFeatureParams, combinationClass, TFixedFeatureParams::EMode::FixedOn);
+        const auto player = Find(players, combinationClass);
+        if (player != players.end()) {
+            levelPlayersMask[depth] = ui32(1) << (player - players.begin());
+        }
+    }
+
+    expectedValues->yresize(subsetCount * leafCount);
+    for (size_t subset = 0; subset < subsetCount; ++subset) {
+        double* values = expectedValues->data() + subset * leafCount;
+        for (size_t leafIdx = 0; leafIdx < leafCount; ++leafIdx) {
+            values[leafIdx] = FuzzyEquals(1 + subtreeWeights[treeDepth][leafIdx], 1 + 0.0)
+                ? 0.0
+                : leafValues[leafIdx * approxDimension + dimension] - averageTreeApprox;
+        }
+        for (int depth = treeDepth - 1; depth >= 0; --depth) {
+            if (isLevelAlwaysFollowed[depth] || (subset & levelPlayersMask[depth])) {
+                continue;
+            }
+            const int remainingDepth = treeDepth - depth - 1;
+            const size_t levelBit = size_t(1) << remainingDepth;
+            for (size_t leafIdx = 0; leafIdx < leafCount; ++leafIdx) {
+                if (leafIdx & levelBit) {
+                    continue;
+                }
+                const size_t nodeIdx = leafIdx >> (remainingDepth + 1);
+                const double nodeWeight = subtreeWeights[depth][nodeIdx];
+                double value = 0.0;
+                if (!FuzzyEquals(1 + nodeWeight, 1 + 0.0)) {
+                    value = (subtreeWeights[depth + 1][nodeIdx * 2] * values[leafIdx]
+                        + subtreeWeights[depth + 1][nodeIdx * 2 + 1] * values[leafIdx | levelBit]) / nodeWeight;
+                }
+                values[leafIdx] = value;
+                values[leafIdx | levelBit] = value;
+            }
+        }
+    }
+}
+
+void CalcObliviousTreeExpectedValuesForSubsets(
+    const TModelTrees& forest,
+    const TShapPreparedTrees& preparedTrees,
+    size_t treeIdx,
+    int dimension,
+    TVector<int>* players,
+    TVector<double>* expectedValues
+) {
+    CB_ENSURE_INTERNAL(
+        forest.GetTreeSizes()[treeIdx] <= MaxShapTablesTreeDepth,
+        "Tree depth " << forest.GetTreeSizes()[treeIdx] << " is too large for expected values of all subsets"
+    );
+    TVector<int> levelClasses;
+    GetObliviousTreeShapPlayers(
+        forest,
+        preparedTrees.BinFeatureCombinationClass,
+        /*fixedFeatureParams*/ Nothing(),
+        treeIdx,
+        &levelClasses,
+        players
+    );
+    CalcObliviousTreeExpectedValues(
+        forest,
+        levelClasses,
+        *players,
+        treeIdx,
+        preparedTrees.SubtreeWeightsForAllTrees[treeIdx],
+        /*fixedFeatureParams*/ Nothing(),
+        preparedTrees.AverageApproxByTree[treeIdx],
+        dimension,
+        expectedValues
+    );
+}
+
+/* Exact path dependent SHAP values of every leaf of an oblivious tree.
+ * SHAP value of a player is the weighted sum of its marginal contributions over all subsets of players.
+ */
+static void CalcObliviousShapTableForTree(
+    const TModelTrees& forest,
+    const TVector<int>& binFeatureCombinationClass,
+    const TVector<TVector<int>>& combinationClassFeatures,
+    size_t treeIdx,
+    const TVector<TVector<double>>& subtreeWeights,
+    bool calcInternalValues,
+    const TMaybe<TFixedFeatureParams>& fixedFeatureParams,
+    double averageTreeApprox,
+    TObliviousShapTables* tables
+) {
+    const int approxDimension = forest.GetDimensionsCount();
+    const size_t leafCount = size_t(1) << forest.GetTreeSizes()[treeIdx];
+
+    TVector<int> levelClasses;
+    TVector<int> players;
+    GetObliviousTreeShapPlayers(forest, binFeatureCombinationClass, fixedFeatureParams, treeIdx, &levelClasses, &players);
+    const int playerCount = players.size();
+    const size_t subsetCount = size_t(1) << playerCount;
+
+    const TConstArrayRef<int> columns = GetObliviousShapTableColumns(*tables, treeIdx);
+    const size_t columnCount = columns.size();
+    // columns of a player get equal shares of its value
+    TVector<TVector<size_t>> playerColumns(playerCount);
+    for (int player = 0; player < playerCount; ++player) {
+        const TVector<int> playerFeatures = calcInternalValues
+            ? TVector<int>{players[player]}
+            : combinationClassFeatures[players[player]];
+        for (int feature : playerFeatures) {
+            playerColumns[player].push_back(Find(columns, feature) - columns.begin());
+        }
+    }
+
+    const TVector<double> subsetSizeCoefficients = GetShapleySubsetSizeCoefficients(playerCount);
+
+    TVector<double> expectedValues; // [subset][leafIdx]
+    double* treeValues = tables->Values.data() + tables->TreeFirstValue[treeIdx];
+    for (int dimension = 0; dimension < approxDimension; ++dimension) {
+        CalcObliviousTreeExpectedValues(
+            forest,
+            levelClasses,
+            players,
+            treeIdx,
+            subtreeWeights,
+            fixedFeatureParams,
+            averageTreeApprox,
+            dimension,
+            &expectedValues
+        );
+        for (size_t leafIdx = 0; leafIdx < leafCount; ++leafIdx) {
+            double* leafRow = treeValues + leafIdx * columnCount * approxDimension;
+            for (int player = 0; player < playerCount; ++player) {
+                const size_t playerBit = size_t(1) << player;
+                double shapValue = 0.0;
+                for (size_t subset = 0; subset < subsetCount; ++subset) {
+                    if (subset & playerBit) {
+                        continue;
+                    }
+                    shapValue += subsetSizeCoefficients[PopCount(subset)] * (
+                        expectedValues[(subset | playerBit) * leafCount + leafIdx]
+                        - expectedValues[subset * leafCount + leafIdx]);
+                }
+                const double columnShare = 1.0 / playerColumns[player].size();
+                for (size_t column : playerColumns[player]) {
+                    leafRow[column * approxDimension + dimension] += shapValue * columnShare;
+                }
+            }
+        }
+    }
+}
+
 void CalcShapValuesForDocumentMulti(
     const TFullModel& model,
     const TShapPreparedTrees& preparedTrees,
@@ -1083,7 +1374,15 @@ void CalcShapValuesForDocumentMulti(
     shapValues->assign(approxDimension, TVector<double>(featuresCount + 1, 0.0));
     const size_t treeCount = model.GetTreeCount();
     for (size_t treeIdx = 0; treeIdx < treeCount; ++treeIdx) {
-        if (preparedTrees.CalcShapValuesByLeafForAllTrees && model.IsOblivious()) {
+        if (!preparedTrees.ShapTables.Empty()) {
+            const auto columns = GetObliviousShapTableColumns(preparedTrees.ShapTables, treeIdx);
+            const auto row = GetObliviousShapTableRow(preparedTrees.ShapTables, treeIdx, docIndices[treeIdx], approxDimension);
+            for (size_t column = 0; column < columns.size(); ++column) {
+                for (int dimension = 0; dimension < approxDimension; ++dimension) {
+                    (*shapValues)[dimension][columns[column]] += row[column * approxDimension + dimension];
+                }
+            }
+        } else if (preparedTrees.CalcShapValuesByLeafForAllTrees && model.IsOblivious()) {
             Y_ASSERT(docIndices[treeIdx] < preparedTrees.ShapValuesByLeafForAllTrees[treeIdx].size());
             for (const TShapValue& shapValue : preparedTrees.ShapValuesByLeafForAllTrees[treeIdx][docIndices[treeIdx]]) {
                 for (int dimension = 0; dimension < approxDimension; ++dimension) {
@@ -1268,7 +1567,20 @@ static void CalcShapValuesByLeafForTreeBlock(
     NPar::TLocalExecutor::TExecRangeParams blockParams(start, end);
     localExecutor->ExecRange([&] (size_t treeIdx) {
         const bool isOblivious = forest.GetNonSymmetricStepNodes().empty() && forest.GetNonSymmetricNodeIdToLeafId().empty();
-        if (preparedTrees->CalcShapValuesByLeafForAllTrees && isOblivious) {
+        if (!preparedTrees->ShapTables.Empty()) {
+            preparedTrees->ShapValuesByLeafForAllTrees[treeIdx].clear();
+            CalcObliviousShapTableForTree(
+                forest,
+                binFeatureCombinationClass,
+                combinationClassFeatures,
+                treeIdx,
+                preparedTrees->SubtreeWeightsForAllTrees[treeIdx],
+                calcInternalValues,
+                fixedFeatureParams,
+                preparedTrees->AverageApproxByTree[treeIdx],
+                &preparedTrees->ShapTables
+            );
+        } else if (preparedTrees->CalcShapValuesByLeafForAllTrees && isOblivious) {
             const size_t leafCount = (size_t(1) << forest.GetTreeSizes()[treeIdx]);
             TVector<TVector<TShapValue>>& shapValuesByLeaf = preparedTrees->ShapValuesByLeafForAllTrees[treeIdx];
             shapValuesByLeaf.resize(leafCount);
@@ -1306,9 +1618,19 @@ static void CalcShapValuesByLeafForTreeBlock(
     }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
 }
 
-bool IsPrepareTreesCalcShapValues(
+// approximate size in bytes of SHAP values precalculated for all leaves
+static ui64 GetPreCalcShapValuesSize(const TModelTrees& forest) {
+    ui64 valueCount = 0;
+    for (int treeDepth : forest.GetTreeSizes()) {
+        valueCount += (ui64(1) << treeDepth) * treeDepth * forest.GetDimensionsCount();
+    }
+    return valueCount * sizeof(double);
+}
+
+// objectCount is Nothing if it is unknown
+static bool IsPrepareTreesCalcShapValues(
     const TFullModel& model,
-    const TDataProvider* dataset,
+    TMaybe<size_t> objectCount,
     EPreCalcShapValues mode
 ) {
     switch (mode) {
@@ -1318,7 +1640,10 @@ bool IsPrepareTreesCalcShapValues(
         case EPreCalcShapValues::NoPreCalc:
             return false;
         case EPreCalcShapValues::Auto:
-            if (dataset==nullptr) {
+            if (model.IsOblivious() && GetPreCalcShapValuesSize(*model.ModelTrees) > MaxPreCalcShapValuesSize) {
+                return false;
+            }
+            if (!objectCount) {
                 return true;
             } else {
                 if (!model.IsOblivious()) {
@@ -1327,7 +1652,7 @@ bool IsPrepareTreesCalcShapValues(
                 const size_t treeCount = model.GetTreeCount();
                 const TModelTrees& forest = *model.ModelTrees;
                 double treesAverageLeafCount = forest.GetLeafValues().size() / treeCount;
-                return treesAverageLeafCount < dataset->ObjectsGrouping->GetObjectCount();
+                return treesAverageLeafCount < *objectCount;
             }
     }
     Y_UNREACHABLE();
@@ -1403,32 +1728,18 @@ static void CalcTreeStats(
 
 static void InitPreparedTrees(
     const TFullModel& model,
-    const TDataProvider* dataset, // can be nullptr if model has LeafWeights
-    EPreCalcShapValues mode,
+    const TVector<double>& leafWeights,
+    bool calcShapValuesByLeafForAllTrees,
     bool calcInternalValues,
-    NPar::TLocalExecutor* localExecutor,
     TShapPreparedTrees* preparedTrees,
     ECalcTypeShapValues calcType
 ) {
     const size_t treeCount = model.GetTreeCount();
-    // use only if model.ModelTrees->LeafWeights is empty
-    TVector<double> leafWeights;
-    if (model.ModelTrees->GetLeafWeights().empty()) {
-        CB_ENSURE(
-                dataset,
-                "PrepareTrees requires either non-empty LeafWeights in model or provided dataset"
-        );
-        CB_ENSURE(dataset->ObjectsGrouping->GetObjectCount() != 0, "To calculate shap values, dataset must contain objects.");
-        CB_ENSURE(dataset->MetaInfo.GetFeatureCount() > 0, "To calculate shap values, dataset must contain features.");
-        leafWeights = CollectLeavesStatistics(*dataset, model, localExecutor);
-    }
 
-    preparedTrees->CalcShapValuesByLeafForAllTrees = IsPrepareTreesCalcShapValues(model, dataset, mode);
+    preparedTrees->CalcShapValuesByLeafForAllTrees = calcShapValuesByLeafForAllTrees;
 
     if (!preparedTrees->CalcShapValuesByLeafForAllTrees) {
-        TVector<double> modelLeafWeights(model.ModelTrees->GetLeafWeights().begin(), model.ModelTrees->GetLeafWeights().end());
-        preparedTrees->LeafWeightsForAllTrees
-            = modelLeafWeights.empty() ? leafWeights : modelLeafWeights;
+        preparedTrees->LeafWeightsForAllTrees = leafWeights;
     }
 
     preparedTrees->ShapValuesByLeafForAllTrees.resize(treeCount);
@@ -1489,13 +1800,27 @@ void CalcShapValuesByLeaf(
     bool calcInternalValues,
     NPar::TLocalExecutor* localExecutor,
     TShapPreparedTrees* preparedTrees,
-    ECalcTypeShapValues calcType
+    ECalcTypeShapValues calcType,
+    bool useShapTables
 ) {
     const size_t treeCount = model.GetTreeCount();
     const size_t treeBlockSize = CB_THREAD_LIMIT; // least necessary for threading
     TProfileInfo processTreesProfile(treeCount);
     TImportanceLogger treesLogger(treeCount, "trees processed", "Processing trees...", logPeriod);
 
+    if (preparedTrees->CalcShapValuesByLeafForAllTrees && useShapTables && CanUseObliviousShapTables(*model.ModelTrees, calcType)) {
+        InitObliviousShapTables(
+            *model.ModelTrees,
+            preparedTrees->BinFeatureCombinationClass,
+            preparedTrees->CombinationClassFeatures,
+            fixedFeatureParams,
+            calcInternalValues,
+            &preparedTrees->ShapTables
+        );
+    } else {
+        preparedTrees->ShapTables = TObliviousShapTables();
+    }
+
     for (size_t start = 0; start < treeCount; start += treeBlockSize) {
         size_t end = Min(start + treeBlockSize, treeCount);
 
@@ -1529,12 +1854,55 @@ TShapPreparedTrees PrepareTrees(
     TVector<double> leafWeights;
     InitLeafWeights(model, dataset, localExecutor, &leafWeights);
     TShapPreparedTrees preparedTrees;
-    InitPreparedTrees(model, dataset, mode, calcInternalValues, localExecutor, &preparedTrees, calcType);
+    InitPreparedTrees(
+        model,
+        leafWeights,
+        IsPrepareTreesCalcShapValues(
+            model,
+            dataset ? MakeMaybe<size_t>(dataset->ObjectsGrouping->GetObjectCount()) : Nothing(),
+            mode),
+        calcInternalValues,
+        &preparedTrees,
+        calcType
+    );
     const bool isMultiClass = IsMultiClassification(model);
     CalcTreeStats(*model.ModelTrees, leafWeights, isMultiClass, &preparedTrees, calcType);
     return preparedTrees;
 }
 
+TShapPreparedTrees PrepareTrees(
+    const TFullModel& model,
+    TConstArrayRef<double> leafWeights,
+    TMaybe<size_t> objectCount,
+    EPreCalcShapValues mode,
+    bool calcInternalValues,
+    ECalcTypeShapValues calcType
+) {
+    const auto& leafWeightsOfModels = model.ModelTrees->GetLeafWeights();
+    TVector<double> treesLeafWeights;
+    if (leafWeightsOfModels.empty()) {
+        CB_ENSURE(
+            leafWeights.size() == model.ModelTrees->GetLeafValues().size() / model.GetDimensionsCount(),
+            "To calculate shap values, either a model with leaf weights, or leaf weights for all leaves are required."
+        );
+        treesLeafWeights.assign(leafWeights.begin(), leafWeights.end());
+    } else {
+        treesLeafWeights.assign(leafWeightsOfModels.begin(), leafWeightsOfModels.end());
+    }
+    TShapPreparedTrees preparedTrees;
+    InitPreparedTrees(
+        model,
+        treesLeafWeights,
+        IsPrepareTreesCalcShapValues(model, objectCount, mode),
+        calcInternalValues,
+        &preparedTrees,
+        calcType
+    );
+    const bool isMultiClass = IsMultiClassification(model);
+    CalcTreeStats(*model.ModelTrees, treesLeafWeights, isMultiClass, &preparedTrees, calcType);
+    return preparedTrees;
+}
+
 TShapPreparedTrees PrepareTrees(
     const TFullModel& model,
     NPar::TLocalExecutor* localExecutor,
@@ -1563,6 +1931,50 @@ TShapPreparedTrees PrepareTrees(
     return preparedTrees;
 }
 
+void GetObliviousTreeLeafShapValues(
+    const TModelTrees& forest,
+    const TShapPreparedTrees& preparedTrees,
+    size_t treeIdx,
+    TVector<int>* features,
+    TVector<double>* values
+) {
+    CB_ENSURE_INTERNAL(
+        forest.IsOblivious() && preparedTrees.CalcShapValuesByLeafForAllTrees,
+        "SHAP values of leaves are not precalculated"
+    );
+    const int approxDimension = forest.GetDimensionsCount();
+    const size_t leafCount = size_t(1) << forest.GetTreeSizes()[treeIdx];
+    if (!preparedTrees.ShapTables.Empty()) {
+        const auto columns = GetObliviousShapTableColumns(preparedTrees.ShapTables, treeIdx);
+        features->assign(columns.begin(), columns.end());
+        values->clear();
+        values->reserve(leafCount * columns.size() * approxDimension);
+        for (size_t leafIdx : xrange(leafCount)) {
+            const auto row = GetObliviousShapTableRow(preparedTrees.ShapTables, treeIdx, leafIdx, approxDimension);
+            values->insert(values->end(), row.begin(), row.end());
+        }
+        return;
+    }
+    const auto& shapValuesByLeaf = preparedTrees.ShapValuesByLeafForAllTrees[treeIdx];
+    features->clear();
+    for (const auto& leafShapValues : shapValuesByLeaf) {
+        for (const TShapValue& shapValue : leafShapValues) {
+            features->push_back(shapValue.Feature);
+        }
+    }
+    SortUnique(*features);
+    values->assign(leafCount * features->size() * approxDimension, 0.0);
+    for (size_t leafIdx : xrange(leafCount)) {
+        for (const TShapValue& shapValue : shapValuesByLeaf[leafIdx]) {
+            const size_t column = LowerBound(features->begin(), features->end(), shapValue.Feature) - features->begin();
+            double* leafValues = values->data() + (leafIdx * features->size() + column) * approxDimension;
+            for (int dimension : xrange(approxDimension)) {
+                leafValues[dimension] += shapValue.Value[dimension];
+            }
+        }
+    }
+}
+
 void CalcShapValuesInternalForFeature(
     const TShapPreparedTrees& preparedTrees,
     const TFullModel& model,
@@ -1604,7 +2016,16 @@ void CalcShapValuesInternalForFeature(
             docShapValues.assign(featuresCount, TVector<double>(forest.GetDimensionsCount() + 1, 0.0));
             auto docIndices = MakeArrayRef(indices.data() + forest.GetTreeCount() * (documentIdx - startIdx), forest.GetTreeCount());
             for (size_t treeIdx = 0; treeIdx < forest.GetTreeCount(); ++treeIdx) {
-                if (preparedTrees.CalcShapValuesByLeafForAllTrees && model.IsOblivious()) {
+                if (!preparedTrees.ShapTables.Empty()) {
+                    const int approxDimension = forest.GetDimensionsCount();
+                    const auto columns = GetObliviousShapTableColumns(preparedTrees.ShapTables, treeIdx);
+                    const auto row = GetObliviousShapTableRow(preparedTrees.ShapTables, treeIdx, docIndices[treeIdx], approxDimension);
+                    for (size_t column = 0; column < columns.size(); ++column) {
+                        for (int dimension = 0; dimension < approxDimension; ++dimension) {
+                            docShapValues[columns[column]][dimension] += row[column * approxDimension + dimension];
+                        }
+                    }
+                } else if (preparedTrees.CalcShapValuesByLeafForAllTrees && model.IsOblivious()) {
                     for (const TShapValue& shapValue : preparedTrees.ShapValuesByLeafForAllTrees[treeIdx][docIndices[treeIdx]]) {
                         for (int dimension = 0; dimension < (int)forest.GetDimensionsCount(); ++dimension) {
                             docShapValues[shapValue.Feature][dimension] += shapValue.Value[dimension];
@@ -1878,12 +2299,55 @@ TVector<TVector<TVector<double>>> CalcShapValueWithQuantizedData(
     return swapedShapValues;
 }
 
-static void OutputShapValuesMulti(const TVector<TVector<TVector<double>>>& shapValues, TFileOutput& out) {
+TShapValuesWriter::TShapValuesWriter(
+    const TString& outputPath,
+    EShapValuesOutputFormat format,
+    ui32 topFeatureCount
+)
+    : Out(outputPath)
+    , Format(format)
+    , TopFeatureCount(topFeatureCount)
+{
+    CB_ENSURE(
+        Format != EShapValuesOutputFormat::TopKTsv || TopFeatureCount > 0,
+        "Top features count for " << Format << " SHAP values output should be positive"
+    );
+}
+
+void TShapValuesWriter::Write(const TVector<TVector<TVector<double>>>& shapValues) {
     for (const auto& shapValuesForDocument : shapValues) {
         for (const auto& shapValuesForClass : shapValuesForDocument) {
-            int valuesCount = shapValuesForClass.size();
-            for (int valueIdx = 0; valueIdx < valuesCount; ++valueIdx) {
-                out << shapValuesForClass[valueIdx] << (valueIdx + 1 == valuesCount ? '\n' : '\t');
+            const int valuesCount = shapValuesForClass.size();
+            switch (Format) {
+                case EShapValuesOutputFormat::Tsv:
+                    for (int valueIdx = 0; valueIdx < valuesCount; ++valueIdx) {
+                        Out << shapValuesForClass[valueIdx] << (valueIdx + 1 == valuesCount ? '\n' : '\t');
+                    }
+                    break;
+                case EShapValuesOutputFormat::Float32:
+                    Float32Buffer.assign(shapValuesForClass.begin(), shapValuesForClass.end());
+                    Out.Write(Float32Buffer.data(), Float32Buffer.size() * sizeof(float));
+                    break;
+                case EShapValuesOutputFormat::TopKTsv: {
+                    const int featureCount = valuesCount - 1;
+                    const int topFeatureCount = Min<int>(TopFeatureCount, featureCount);
+                    FeatureOrder.yresize(featureCount);
+                    Iota(FeatureOrder.begin(), FeatureOrder.end(), 0);
+                    PartialSort(
+                        FeatureOrder.begin(),
+                        FeatureOrder.begin() + topFeatureCount,
+                        FeatureOrder.end(),
+                        [&] (int lhs, int rhs) {
+                            return std::make_pair(-Abs(shapValuesForClass[lhs]), lhs)
+                                < std::make_pair(-Abs(shapValuesForClass[rhs]), rhs);
+                        }
+                    );
+                    for (int featureIdx : MakeArrayRef(FeatureOrder.data(), topFeatureCount)) {
+                        Out << featureIdx << ':' << shapValuesForClass[featureIdx] << '\t';
+                    }
+                    Out << featureCount << ':' << shapValuesForClass[featureCount] << '\n';
+                    break;
+                }
             }
         }
     }
@@ -1896,7 +2360,9 @@ void CalcAndOutputShapValues(
     int logPeriod,
     EPreCalcShapValues mode,
     NPar::TLocalExecutor* localExecutor,
-    ECalcTypeShapValues calcType
+    ECalcTypeShapValues calcType,
+    EShapValuesOutputFormat outputFormat,
+    ui32 topFeatureCount
 ) {
     TShapPreparedTrees preparedTrees = PrepareTrees(
         model,
@@ -1916,10 +2382,23 @@ void CalcAndOutputShapValues(
         calcType
     );
 
+    TShapValuesWriter writer(outputPath, outputFormat, topFeatureCount);
+    CalcAndOutputShapValues(model, dataset, preparedTrees, logPeriod, localExecutor, &writer, calcType);
+}
+
+void CalcAndOutputShapValues(
+    const TFullModel& model,
+    const TDataProvider& datasetPart,
+    const TShapPreparedTrees& preparedTrees,
+    int logPeriod,
+    NPar::TLocalExecutor* localExecutor,
+    TShapValuesWriter* writer,
+    ECalcTypeShapValues calcType
+) {
     CB_ENSURE_SCALE_IDENTITY(model.GetScaleAndBias(), "SHAP values");
-    const int flatFeatureCount = SafeIntegerCast<int>(dataset.MetaInfo.GetFeatureCount());
+    const int flatFeatureCount = SafeIntegerCast<int>(datasetPart.MetaInfo.GetFeatureCount());
 
-    const size_t documentCount = dataset.ObjectsGrouping->GetObjectCount();
+    const size_t documentCount = datasetPart.ObjectsGrouping->GetObjectCount();
     const size_t documentBlockSize = CB_THREAD_LIMIT; // least necessary for threading
 
     TImportanceLogger documentsLogger(documentCount, "documents processed", "Processing documents...", logPeriod);
@@ -1927,14 +2406,14 @@ void CalcAndOutputShapValues(
     TProfileInfo processDocumentsProfile(documentCount);
 
     THolder<IFeaturesBlockIterator> featuresBlockIterator
-        = CreateFeaturesBlockIterator(model, *dataset.ObjectsData, 0, documentCount);
+        = CreateFeaturesBlockIterator(model, *datasetPart.ObjectsData, 0, documentCount);
 
-    TFileOutput out(outputPath);
+    TVector<TVector<TVector<double>>> shapValuesForBlock;
     for (size_t start = 0; start < documentCount; start += documentBlockSize) {
         size_t end = Min(start + documentBlockSize, documentCount);
         processDocumentsProfile.StartIterationBlock();
 
-        TVector<TVector<TVector<double>>> shapValuesForBlock;
+        shapValuesForBlock.clear();
         shapValuesForBlock.reserve(end - start);
 
         featuresBlockIterator->NextBlock(end - start);
@@ -1952,7 +2431,7 @@ void CalcAndOutputShapValues(
             calcType
         );
 
-        OutputShapValuesMulti(shapValuesForBlock, out);
+        writer->Write(shapValuesForBlock);
 
         processDocumentsProfile.FinishIterationBlock(end - start);
         auto profileResults = processDocumentsProfile.GetProfileResults();
@@ -5,7 +5,9 @@
 #include <catboost/private/libs/options/enums.h>
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/maybe.h>
 #include <util/generic/vector.h>
+#include <util/stream/file.h>
 #include <util/stream/input.h>
 #include <util/stream/output.h>
 #include <util/system/types.h>
@@ -60,6 +62,24 @@ public:
     );
 };
 
+/* SHAP values of oblivious trees precalculated for every leaf in flat memory.
+ * In an oblivious tree the splits a document follows are determined by its leaf index,
+ * so SHAP values of a document are sums of rows of its leaves.
+ */
+struct TObliviousShapTables {
+    TVector<ui32> TreeFirstColumn; // [treeIdx], treeCount + 1 elements
+    TVector<int> ColumnFeatures; // flat feature or combination class (if internal values) of each column
+    TVector<ui64> TreeFirstValue; // [treeIdx], treeCount + 1 elements
+    TVector<double> Values; // for each tree [leafIdx][column][dimension]
+
+public:
+    bool Empty() const {
+        return TreeFirstValue.empty();
+    }
+
+    Y_SAVELOAD_DEFINE(TreeFirstColumn, ColumnFeatures, TreeFirstValue, Values);
+};
+
 struct TShapPreparedTrees {
     TVector<TVector<TVector<TShapValue>>> ShapValuesByLeafForAllTrees; // [treeIdx][leafIdx][shapFeature] trees * 2^d * d
     TVector<TVector<double>> MeanValuesForAllTrees;
@@ -71,6 +91,7 @@ struct TShapPreparedTrees {
     TVector<double> LeafWeightsForAllTrees;
     TVector<TVector<TVector<double>>> SubtreeWeightsForAllTrees;
     TVector<TVector<TVector<TVector<double>>>> SubtreeValuesForAllTrees;
+    TObliviousShapTables ShapTables; // used instead of ShapValuesByLeafForAllTrees if not empty
 
 public:
     TShapPreparedTrees() = default;
@@ -94,7 +115,8 @@ public:
         CalcInternalValues,
         LeafWeightsForAllTrees,
         SubtreeWeightsForAllTrees,
-        SubtreeValuesForAllTrees
+        SubtreeValuesForAllTrees,
+        ShapTables
     );
 };
 
@@ -136,6 +158,17 @@ TShapPreparedTrees PrepareTrees(
     ECalcTypeShapValues calcType = ECalcTypeShapValues::Normal
 );
 
+// for datasets read in parts, leafWeights are used if model has no LeafWeights,
+// objectCount is Nothing if document count is unknown
+TShapPreparedTrees PrepareTrees(
+    const TFullModel& model,
+    TConstArrayRef<double> leafWeights,
+    TMaybe<size_t> objectCount,
+    EPreCalcShapValues mode,
+    bool calcInternalValues = false,
+    ECalcTypeShapValues calcType = ECalcTypeShapValues::Normal
+);
+
 void CalcShapValuesByLeaf(
     const TFullModel& model,
     const TMaybe<TFixedFeatureParams>& fixedFeatureParams,
@@ -143,7 +176,26 @@ void CalcShapValuesByLeaf(
     bool calcInternalValues,
     NPar::TLocalExecutor* localExecutor,
     TShapPreparedTrees* preparedTrees,
-    ECalcTypeShapValues calcType = ECalcTypeShapValues::Normal
+    ECalcTypeShapValues calcType = ECalcTypeShapValues::Normal,
+    bool useShapTables = true // if false, SHAP values of each leaf are calculated by TreeSHAP as for other trees
+);
+
+// Normal calc type and oblivious trees of depth at most 10
+bool CanUseObliviousShapTables(const TModelTrees& forest, ECalcTypeShapValues calcType);
+
+// subsetSize! (playerCount - subsetSize - 1)! / playerCount! for each subsetSize < playerCount
+TVector<double> GetShapleySubsetSizeCoefficients(int playerCount);
+
+/* Expected values of an oblivious tree for every leaf given every subset of combination classes of the tree,
+ * [subset][leafIdx], subset is a mask of indices in players. Requires tree depth at most 10.
+ */
+void CalcObliviousTreeExpectedValuesForSubsets(
+    const TModelTrees& forest,
+    const TShapPreparedTrees& preparedTrees,
+    size_t treeIdx,
+    int dimension,
+    TVector<int>* players,
+    TVector<double>* expectedValues
 );
 
 // returned: ShapValues[documentIdx][dimension][feature]
@@ -181,6 +233,24 @@ TVector<TVector<TVector<double>>> CalcShapValueWithQuantizedData(
     ECalcTypeShapValues calcType = ECalcTypeShapValues::Normal
 );
 
+/* Writes SHAP values of consecutive blocks of documents, so that memory doesn't depend on document count.
+ * Values of a document are written for each dimension in order, see EShapValuesOutputFormat.
+ * In TopKTsv format expected value follows top features with index equal to flat feature count.
+ */
+class TShapValuesWriter {
+public:
+    TShapValuesWriter(const TString& outputPath, EShapValuesOutputFormat format, ui32 topFeatureCount = 0);
+
+    void Write(const TVector<TVector<TVector<double>>>& shapValues); // [documentIdx][dimension][feature]
+
+private:
+    TFileOutput Out;
+    EShapValuesOutputFormat Format;
+    ui32 TopFeatureCount;
+    TVector<float> Float32Buffer;
+    TVector<int> FeatureOrder;
+};
+
 // outputs for each document in order for each dimension in order an array of feature contributions
 void CalcAndOutputShapValues(
     const TFullModel& model,
@@ -189,9 +259,33 @@ void CalcAndOutputShapValues(
     int logPeriod,
     EPreCalcShapValues mode,
     NPar::TLocalExecutor* localExecutor,
+    ECalcTypeShapValues calcType = ECalcTypeShapValues::Normal,
+    EShapValuesOutputFormat outputFormat = EShapValuesOutputFormat::Tsv,
+    ui32 topFeatureCount = 0
+);
+
+// for datasets read in parts, preparedTrees should be already processed by CalcShapValuesByLeaf
+void CalcAndOutputShapValues(
+    const TFullModel& model,
+    const NCB::TDataProvider& datasetPart,
+    const TShapPreparedTrees& preparedTrees,
+    int logPeriod,
+    NPar::TLocalExecutor* localExecutor,
+    TShapValuesWriter* writer,
     ECalcTypeShapValues calcType = ECalcTypeShapValues::Normal
 );
 
+/* SHAP values of the features of an oblivious tree in each leaf, precalculated by CalcShapValuesByLeaf
+ * with CalcShapValuesByLeafForAllTrees. values are [leafIdx][feature][dimension], features are sorted.
+ */
+void GetObliviousTreeLeafShapValues(
+    const TModelTrees& forest,
+    const TShapPreparedTrees& preparedTrees,
+    size_t treeIdx,
+    TVector<int>* features,
+    TVector<double>* values
+);
+
 void CalcShapValuesInternalForFeature(
     const TShapPreparedTrees& preparedTrees,
     const TFullModel& model,
@@ -0,0 +1,207 @@
+#include <catboost/libs/data/data_provider_builders.h>
+#include <catboost/libs/fstr/calc_fstr.h>
+#include <catboost/libs/fstr/shap_values.h>
+#include <catboost/libs/model/model_build_helper.h>
+#include <catboost/private/libs/options/loss_description.h>
+
+#include <library/json/json_value.h>
+
+#include <library/threading/local_executor/local_executor.h>
+#include <library/unittest/registar.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/string/builder.h>
+
+// random oblivious trees with positive leaf weights, features are often repeated within a tree
+static TFullModel MakeObliviousModel(int treeDepth, int approxDimension, ui64 seed) {
+    const ui32 featureCount = 6;
+    const ui32 borderCount = 8;
+    const ui32 treeCount = 4;
+
+    TFastRng64 rng(seed);
+    TVector<TFloatFeature> floatFeatures;
+    for (auto featureIdx : xrange(featureCount)) {
+        TVector<float> borders;
+        for (auto borderIdx : xrange(borderCount)) {
+            borders.push_back(float(borderIdx + 1) / (borderCount + 1));
+        }
+        floatFeatures.emplace_back(/*hasNans*/ false, featureIdx, featureIdx, borders);
+    }
+
+    TObliviousTreeBuilder builder(floatFeatures, TVector<TCatFeature>{}, TVector<TTextFeature>{}, approxDimension);
+    const size_t leafCount = size_t(1) << treeDepth;
+    for (auto treeIdx : xrange(treeCount)) {
+        Y_UNUSED(treeIdx);
+        TVector<TModelSplit> splits;
+        for (auto depth : xrange(treeDepth)) {
+            Y_UNUSED(depth);
+            const ui32 featureIdx = rng.Uniform(featureCount);
+            splits.emplace_back(TFloatSplit(featureIdx, floatFeatures[featureIdx].Borders[rng.Uniform(borderCount)]));
+        }
+        TVector<double> leafValues(leafCount * approxDimension);
+        for (auto& leafValue : leafValues) {
+            leafValue = rng.GenRandReal1() - 0.5;
+        }
+        TVector<double> leafWeights(leafCount);
+        for (auto& leafWeight : leafWeights) {
+            leafWeight = 1 + rng.Uniform(100);
+        }
+        builder.AddTree(splits, leafValues, leafWeights);
+    }
+
+    TFullModel model;
+    builder.Build(model.ModelTrees.GetMutable());
+    model.UpdateDynamicData();
+    return model;
+}
+
+// features are uniform in [0, 1] like the borders of MakeObliviousModel, target is noisy
+static NCB::TDataProviderPtr MakeRegressionDataset(ui32 featureCount, ui32 objectCount, ui64 seed) {
+    TFastRng64 rng(seed);
+    return NCB::CreateDataProvider(
+        [&] (NCB::IRawFeaturesOrderDataVisitor* visitor) {
+            NCB::TDataMetaInfo metaInfo;
+            metaInfo.TargetType = NCB::ERawTargetType::Float;
+            metaInfo.TargetCount = 1;
+            metaInfo.FeaturesLayout = MakeIntrusive<NCB::TFeaturesLayout>(
+                featureCount,
+                TVector<ui32>{},
+                TVector<ui32>{},
+                TVector<TString>{});
+
+            visitor->Start(metaInfo, objectCount, NCB::EObjectsOrder::Undefined, {});
+            for (auto featureIdx : xrange(featureCount)) {
+                TVector<float> values(objectCount);
+                for (auto& value : values) {
+                    value = rng.GenRandReal1();
+                }
+                visitor->AddFloatFeature(
+                    featureIdx,
+                    MakeIntrusive<NCB::TTypeCastArrayHolder<float, float>>(std::move(values)));
+            }
+            TVector<float> target(objectCount);
+            for (auto& value : target) {
+                value = rng.GenRandReal1() - 0.5;
+            }
+            visitor->AddTarget(MakeIntrusive<NCB::TTypeCastArrayHolder<float, float>>(std::move(target)));
+            visitor->Finish();
+        }
+    );
+}
+
+// for each tree [leafIdx][feature][dimension] for all features of the model
+static TVector<TVector<double>> GetDenseLeafShapValues(
+    const TFullModel& model,
+    const TShapPreparedTrees& preparedTrees,
+    int featureCount
+) {
+    const int approxDimension = model.GetDimensionsCount();
+    TVector<TVector<double>> result;
+    TVector<int> features;
+    TVector<double> values;
+    for (auto treeIdx : xrange(model.GetTreeCount())) {
+        GetObliviousTreeLeafShapValues(*model.ModelTrees, preparedTrees, treeIdx, &features, &values);
+        const size_t leafCount = size_t(1) << model.ModelTrees->GetTreeSizes()[treeIdx];
+        TVector<double> treeValues(leafCount * featureCount * approxDimension, 0.0);
+        for (auto leafIdx : xrange(leafCount)) {
+            for (auto column : xrange(features.size())) {
+                for (auto dimension : xrange(approxDimension)) {
+                    treeValues[(leafIdx * featureCount + features[column]) * approxDimension + dimension]
+                        = values[(leafIdx * features.size() + column) * approxDimension + dimension];
+                }
+            }
+        }
+        result.push_back(std::move(treeValues));
+    }
+    return result;
+}
+
+Y_UNIT_TEST_SUITE(TShapValuesTest) {
+    // SHAP values of leaves from the flat tables are the same as from recursive TreeSHAP for each leaf
+    Y_UNIT_TEST(ObliviousShapTablesMatchTreeShap) {
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        for (int treeDepth : xrange(1, 11)) {
+            for (int approxDimension : {1, 3}) {
+                for (bool calcInternalValues : {false, true}) {
+                    const TFullModel model = MakeObliviousModel(treeDepth, approxDimension, /*seed*/ treeDepth);
+                    UNIT_ASSERT(CanUseObliviousShapTables(*model.ModelTrees, ECalcTypeShapValues::Normal));
+
+                    const auto calcLeafShapValues = [&] (bool useShapTables) {
+                        TShapPreparedTrees preparedTrees = PrepareTrees(
+                            model,
+                            /*dataset*/ nullptr,
+                            EPreCalcShapValues::UsePreCalc,
+                            &localExecutor,
+                            calcInternalValues
+                        );
+                        CalcShapValuesByLeaf(
+                            model,
+                            /*fixedFeatureParams*/ Nothing(),
+                            /*logPeriod*/ 0,
+                            calcInternalValues,
+                            &localExecutor,
+                            &preparedTrees,
+                            ECalcTypeShapValues::Normal,
+                            useShapTables
+                        );
+                        UNIT_ASSERT_VALUES_EQUAL(preparedTrees.ShapTables.Empty(), !useShapTables);
+                        return GetDenseLeafShapValues(model, preparedTrees, model.GetNumFloatFeatures());
+                    };
+
+                    const auto tableValues = calcLeafShapValues(/*useShapTables*/ true);
+                    const auto treeShapValues = calcLeafShapValues(/*useShapTables*/ false);
+                    const TString message = TStringBuilder() << "depth " << treeDepth
+                        << ", dimension " << approxDimension << ", internal " << calcInternalValues;
+                    UNIT_ASSERT_VALUES_EQUAL_C(tableValues.size(), treeShapValues.size(), message);
+                    for (auto treeIdx : xrange(tableValues.size())) {
+                        UNIT_ASSERT_VALUES_EQUAL_C(tableValues[treeIdx].size(), treeShapValues[treeIdx].size(), message);
+                        for (auto i : xrange(tableValues[treeIdx].size())) {
+                            UNIT_ASSERT_DOUBLES_EQUAL_C(tableValues[treeIdx][i], treeShapValues[treeIdx][i], 1e-9, message);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // LossFunctionChange from cached leaf indexes (ui8 up to depth 8, ui16 above) is the same as from per-object SHAP values
+    Y_UNIT_TEST(LossFunctionChangeByLeafIndexesMatchesGeneric) {
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        const NCB::TDataProviderPtr dataset = MakeRegressionDataset(/*featureCount*/ 6, /*objectCount*/ 500, /*seed*/ 0);
+        for (int treeDepth : {2, 6, 8, 9, 10}) {
+            TFullModel model = MakeObliviousModel(treeDepth, /*approxDimension*/ 1, /*seed*/ treeDepth);
+            NJson::TJsonValue lossDescriptionJson;
+            NCatboostOptions::ParseLossDescription("RMSE").Save(&lossDescriptionJson);
+            model.ModelInfo["loss_function"] = ToString(lossDescriptionJson);
+
+            const auto calcEffect = [&] (EPreCalcShapValues mode) {
+                const auto internalEffect = CalcFeatureEffect(
+                    model,
+                    dataset,
+                    EFstrType::LossFunctionChange,
+                    &localExecutor,
+                    ECalcTypeShapValues::Normal,
+                    mode
+                );
+                TVector<double> effect(model.GetNumFloatFeatures(), 0.0);
+                for (const auto& featureEffect : CalcRegularFeatureEffect(internalEffect, 0, model.GetNumFloatFeatures())) {
+                    effect[featureEffect.Feature.Index] = featureEffect.Score;
+                }
+                return effect;
+            };
+
+            const auto byLeafIndexes = calcEffect(EPreCalcShapValues::UsePreCalc);
+            const auto generic = calcEffect(EPreCalcShapValues::NoPreCalc);
+            const TString message = TStringBuilder() << "depth " << treeDepth;
+            UNIT_ASSERT_VALUES_EQUAL_C(byLeafIndexes.size(), generic.size(), message);
+            for (auto featureIdx : xrange(generic.size())) {
+                UNIT_ASSERT_DOUBLES_EQUAL_C(byLeafIndexes[featureIdx], generic[featureIdx], 1e-9, message);
+            }
+        }
+    }
+}
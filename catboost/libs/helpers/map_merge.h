@@ -6,12 +6,30 @@
 
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/vector.h>
 #include <util/generic/utility.h>
 #include <util/generic/ymath.h>
 
 namespace NCB {
 
+    /**
+     * Reduces values to values[0] with a tree-shaped pairwise merge:
+     *  merge(&values[i], values[i + step]) for step = 1, 2, 4, ...
+     * The order of merges depends only on values.size(), so for fixed blocking the result does not depend
+     *   on the thread count, and the floating point rounding error grows as O(log n) instead of O(n)
+     * merge(dst, add) adds add data to dst, it can modify add as it is no longer used after this call
+     */
+    template <class T, class TMergeFunc>
+    void PairwiseReduce(TArrayRef<T> values, TMergeFunc&& merge) { // void(T*, T&)
+        const size_t size = values.size();
+        for (size_t step = 1; step < size; step *= 2) {
+            for (size_t i = 0; i + step < size; i += 2 * step) {
+                merge(&values[i], values[i + step]);
+            }
+        }
+    }
+
     /**
      * Processes data in parallel by blocks then merges results
      *  if there is only one block then there's no merge
@@ -0,0 +1,257 @@
+#include "numa.h"
+
+#include "exception.h"
+
+#include <catboost/libs/logging/logging.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/ymath.h>
+#include <util/stream/file.h>
+#include <util/string/cast.h>
+#include <util/string/split.h>
+#include <util/string/strip.h>
+#include <util/system/fs.h>
+#include <util/system/align.h>
+#include <util/system/info.h>
+#include <util/system/yield.h>
+
+#include <atomic>
+#include <cstring>
+
+#if defined(_linux_)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+namespace NCB {
+
+    TVector<ui32> ParseCpuList(TStringBuf cpuList) {
+        TVector<ui32> cpus;
+        for (const auto& part : StringSplitter(StripString(cpuList)).Split(',').SkipEmpty()) {
+            const TStringBuf token = part.Token();
+            TStringBuf first;
+            TStringBuf last;
+            if (token.TrySplit('-', first, last)) {
+                const ui32 begin = FromString<ui32>(first);
+                const ui32 end = FromString<ui32>(last);
+                CB_ENSURE(begin <= end, "Bad cpu range in cpu list: " << token);
+                for (ui32 cpu = begin; cpu <= end; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            } else {
+                cpus.push_back(FromString<ui32>(token));
+            }
+        }
+        return cpus;
+    }
+
+    TNumaTopology TNumaTopology::Detect() {
+        TNumaTopology topology;
+#if defined(_linux_)
+        for (ui32 nodeIdx = 0; ; ++nodeIdx) {
+            const TString cpuListPath = "/sys/devices/system/node/node" + ToString(nodeIdx) + "/cpulist";
+            if (!NFs::Exists(cpuListPath)) {
+                break;
+            }
+            try {
+                topology.NodeCpus.push_back(ParseCpuList(TFileInput(cpuListPath).ReadAll()));
+                topology.NodeIds.push_back(nodeIdx);
+            } catch (const std::exception& e) {
+                CATBOOST_WARNING_LOG << "Can't read NUMA topology: " << e.what() << Endl;
+                topology.NodeCpus.clear();
+                topology.NodeIds.clear();
+                break;
+            }
+            // memory-only nodes do not get threads
+            if (topology.NodeCpus.back().empty()) {
+                topology.NodeCpus.pop_back();
+                topology.NodeIds.pop_back();
+            }
+        }
+#endif
+        if (topology.NodeCpus.empty()) {
+            topology = MakeFake(1, NSystemInfo::CachedNumberOfCpus());
+        }
+        return topology;
+    }
+
+    TNumaTopology TNumaTopology::MakeFake(ui32 nodeCount, ui32 cpuCount) {
+        CB_ENSURE(nodeCount > 0, "NUMA node count should be positive");
+        TNumaTopology topology;
+        topology.NodeCpus.resize(nodeCount);
+        for (auto nodeIdx : xrange(nodeCount)) {
+            const ui32 begin = (ui64)cpuCount * nodeIdx / nodeCount;
+            const ui32 end = (ui64)cpuCount * (nodeIdx + 1) / nodeCount;
+            for (auto cpu : xrange(begin, end)) {
+                topology.NodeCpus[nodeIdx].push_back(cpu);
+            }
+        }
+        return topology;
+    }
+
+    bool PinCurrentThread(TConstArrayRef<ui32> cpus) {
+        if (cpus.empty()) {
+            return false;
+        }
+#if defined(_linux_)
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        for (auto cpu : cpus) {
+            if (cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &cpuSet);
+            }
+        }
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+#else
+        return false;
+#endif
+    }
+
+    bool MovePagesToNodes(TConstArrayRef<char> memory, TConstArrayRef<ui32> nodeIds) {
+        if (nodeIds.empty()) {
+            return false;
+        }
+#if defined(_linux_) && defined(SYS_move_pages)
+        constexpr int MPOL_MF_MOVE_FLAG = 1 << 1; // MPOL_MF_MOVE from numaif.h
+        constexpr size_t BATCH_SIZE = 1024;
+
+        const size_t pageSize = NSystemInfo::GetPageSize();
+        const uintptr_t begin = AlignUp<uintptr_t>((uintptr_t)memory.data(), pageSize);
+        const uintptr_t end = AlignDown<uintptr_t>((uintptr_t)(memory.data() + memory.size()), pageSize);
+        if (begin >= end) {
+            return true;
+        }
+
+        TVector<void*> pages;
+        TVector<int> nodes;
+        TVector<int> statuses;
+        pages.reserve(BATCH_SIZE);
+        nodes.reserve(BATCH_SIZE);
+        size_t pageIdx = 0;
+        for (uintptr_t page = begin; page < end; page += pageSize, ++pageIdx) {
+            pages.push_back((void*)page);
+            nodes.push_back((int)nodeIds[pageIdx % nodeIds.size()]);
+            if ((pages.size() == BATCH_SIZE) || (page + pageSize >= end)) {
+                statuses.yresize(pages.size());
+                // pages that are not touched yet get -ENOENT status, they are placed on first touch
+                if (syscall(SYS_move_pages, 0, pages.size(), pages.data(), nodes.data(), statuses.data(), MPOL_MF_MOVE_FLAG) < 0) {
+                    return false;
+                }
+                pages.clear();
+                nodes.clear();
+            }
+        }
+        return true;
+#else
+        return false;
+#endif
+    }
+
+
+    static TVector<ui32> DistributeThreads(const TNumaTopology& topology, ui32 threadCount) {
+        const ui32 nodeCount = topology.GetNodeCount();
+        CB_ENSURE(nodeCount > 0, "NUMA topology has no nodes");
+        CB_ENSURE(threadCount >= nodeCount, "Thread count should be at least NUMA node count (" << nodeCount << ")");
+
+        ui64 totalCpuCount = 0;
+        for (const auto& cpus : topology.NodeCpus) {
+            totalCpuCount += Max<size_t>(cpus.size(), 1);
+        }
+        TVector<ui32> nodeThreadCounts(nodeCount, 1);
+        ui32 distributedCount = nodeCount;
+        for (auto nodeIdx : xrange(nodeCount)) {
+            const ui64 nodeCpuCount = Max<size_t>(topology.NodeCpus[nodeIdx].size(), 1);
+            const ui32 share = (threadCount - nodeCount) * nodeCpuCount / totalCpuCount;
+            nodeThreadCounts[nodeIdx] += share;
+            distributedCount += share;
+        }
+        for (ui32 nodeIdx = 0; distributedCount < threadCount; nodeIdx = (nodeIdx + 1) % nodeCount) {
+            ++nodeThreadCounts[nodeIdx];
+            ++distributedCount;
+        }
+        return nodeThreadCounts;
+    }
+
+    // each of the threadCount tasks waits for all others so that every executor thread runs exactly one of them
+    static void PinExecutorThreads(TConstArrayRef<ui32> cpus, int threadCount, NPar::TLocalExecutor* executor) {
+        std::atomic<int> arrivedCount(0);
+        std::atomic<int> failedCount(0);
+        auto futures = executor->ExecRangeWithFutures(
+            [&] (int /*id*/) {
+                if (!PinCurrentThread(cpus)) {
+                    ++failedCount;
+                }
+                ++arrivedCount;
+                while (arrivedCount.load() < threadCount) {
+                    ThreadYield();
+                }
+            },
+            0,
+            threadCount,
+            NPar::TLocalExecutor::HIGH_PRIORITY);
+        for (auto& future : futures) {
+            future.GetValueSync();
+        }
+        if (failedCount.load() != 0) {
+            CATBOOST_DEBUG_LOG << "Can't pin " << failedCount.load() << " threads to NUMA node cpus" << Endl;
+        }
+    }
+
+    TNumaExecutors::TNumaExecutors(const TNumaTopology& topology, ui32 threadCount, bool pinThreads)
+        : NodeIds(topology.NodeIds)
+        , NodeThreadCounts(DistributeThreads(topology, threadCount))
+    {
+        for (auto nodeIdx : xrange(topology.GetNodeCount())) {
+            NodeExecutors.push_back(MakeHolder<NPar::TLocalExecutor>());
+            NodeExecutors.back()->RunAdditionalThreads(NodeThreadCounts[nodeIdx]);
+            if (pinThreads) {
+                PinExecutorThreads(topology.NodeCpus[nodeIdx], NodeThreadCounts[nodeIdx], NodeExecutors.back().Get());
+            }
+        }
+    }
+
+    ui32 TNumaExecutors::GetNodeByKey(ui64 key) const {
+        ui64 totalThreadCount = 0;
+        for (auto nodeThreadCount : NodeThreadCounts) {
+            totalThreadCount += nodeThreadCount;
+        }
+        ui64 threadIdx = key % totalThreadCount;
+        for (auto nodeIdx : xrange(GetNodeCount())) {
+            if (threadIdx < NodeThreadCounts[nodeIdx]) {
+                return nodeIdx;
+            }
+            threadIdx -= NodeThreadCounts[nodeIdx];
+        }
+        Y_UNREACHABLE();
+    }
+
+    bool TNumaExecutors::MoveToNode(TConstArrayRef<char> memory, ui32 nodeIdx) const {
+        if (NodeIds.empty()) {
+            return false;
+        }
+        return MovePagesToNodes(memory, MakeArrayRef(&NodeIds[nodeIdx], 1));
+    }
+
+    bool TNumaExecutors::Interleave(TConstArrayRef<char> memory) const {
+        return MovePagesToNodes(memory, NodeIds);
+    }
+
+    void TNumaExecutors::InterleaveByFirstTouch(TArrayRef<char> memory) {
+        const size_t pageSize = NSystemInfo::GetPageSize();
+        const ui32 nodeCount = GetNodeCount();
+        ExecOnEachNode(
+            [&] (ui32 nodeIdx) {
+                ForEachFirstTouchPart(
+                    memory,
+                    pageSize,
+                    nodeIdx,
+                    nodeCount,
+                    [] (TArrayRef<char> part) {
+                        memset(part.data(), 0, part.size());
+                    });
+            });
+    }
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/noncopyable.h>
+#include <util/generic/ptr.h>
+#include <util/generic/strbuf.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/system/align.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    struct TNumaTopology {
+        TVector<TVector<ui32>> NodeCpus; // [nodeIdx] -> cpu ids, can be empty for fake topologies
+        TVector<ui32> NodeIds; // [nodeIdx] -> system node id, empty for fake topologies
+
+    public:
+        // reads /sys/devices/system/node on Linux, returns a single node with all cpus otherwise
+        static TNumaTopology Detect();
+
+        /* splits cpus [0, cpuCount) evenly into nodeCount contiguous parts,
+         * allows to test NUMA-aware code on a single-node machine
+         */
+        static TNumaTopology MakeFake(ui32 nodeCount, ui32 cpuCount);
+
+        ui32 GetNodeCount() const {
+            return NodeCpus.size();
+        }
+    };
+
+    // parses Linux cpu list format like "0-3,8,10-11"
+    TVector<ui32> ParseCpuList(TStringBuf cpuList);
+
+    // returns false if pinning is not supported or failed
+    bool PinCurrentThread(TConstArrayRef<ui32> cpus);
+
+    /* moves already touched pages lying entirely inside memory to system nodes nodeIds,
+     * page i of memory goes to nodeIds[i % nodeIds.size()]
+     * returns false if moving pages is not supported or failed
+     */
+    bool MovePagesToNodes(TConstArrayRef<char> memory, TConstArrayRef<ui32> nodeIds);
+
+    /* calls func for the parts of memory that node nodeIdx of nodeCount touches first to interleave pages:
+     * pages lying entirely inside memory go to nodes in turn by their index counted from the first of them,
+     * the partial pages at the unaligned head and tail of memory go to node 0
+     */
+    template <class TFunc>
+    void ForEachFirstTouchPart(TArrayRef<char> memory, size_t pageSize, ui32 nodeIdx, ui32 nodeCount, TFunc&& func) {
+        char* const begin = memory.data();
+        char* const end = begin + memory.size();
+        char* const pagesBegin = Min(AlignUp(begin, pageSize), end);
+        char* const pagesEnd = Max(AlignDown(end, pageSize), pagesBegin);
+        if (nodeIdx == 0) {
+            if (begin < pagesBegin) {
+                func(TArrayRef<char>(begin, pagesBegin));
+            }
+            if (pagesEnd < end) {
+                func(TArrayRef<char>(pagesEnd, end));
+            }
+        }
+        const size_t pageCount = (pagesEnd - pagesBegin) / pageSize;
+        for (size_t pageIdx = nodeIdx; pageIdx < pageCount; pageIdx += nodeCount) {
+            func(TArrayRef<char>(pagesBegin + pageIdx * pageSize, pageSize));
+        }
+    }
+
+
+    /* Set of local executors, one per NUMA node, with threads pinned to the cpus of their node.
+     * Memory first touched by a task running on a node's executor is allocated on this node
+     * by the default Linux policy.
+     */
+    class TNumaExecutors : public TNonCopyable {
+    public:
+        // threadCount is distributed between nodes proportionally to their cpu counts, at least 1 per node
+        TNumaExecutors(const TNumaTopology& topology, ui32 threadCount, bool pinThreads = true);
+
+        ui32 GetNodeCount() const {
+            return NodeExecutors.size();
+        }
+
+        NPar::TLocalExecutor& GetNodeExecutor(ui32 nodeIdx) {
+            return *NodeExecutors[nodeIdx];
+        }
+
+        ui32 GetNodeThreadCount(ui32 nodeIdx) const {
+            return NodeThreadCounts[nodeIdx];
+        }
+
+        /* node owning the data with this key, keys are spread between nodes proportionally to
+         * node thread counts, so consecutive keys give a balanced assignment
+         */
+        ui32 GetNodeByKey(ui64 key) const;
+
+        /* runs func(nodeIdx) on a thread of each node, waits for completion
+         * func can use GetNodeExecutor(nodeIdx) for nested parallelism
+         * exceptions are propagated
+         */
+        template <class TFunc>
+        void ExecOnEachNode(TFunc&& func) {
+            TVector<NThreading::TFuture<void>> futures;
+            for (auto nodeIdx : xrange(GetNodeCount())) {
+                auto nodeFutures = NodeExecutors[nodeIdx]->ExecRangeWithFutures(
+                    [&func, nodeIdx] (int /*id*/) {
+                        func(nodeIdx);
+                    },
+                    0,
+                    1,
+                    NPar::TLocalExecutor::HIGH_PRIORITY);
+                futures.insert(futures.end(), nodeFutures.begin(), nodeFutures.end());
+            }
+            for (auto& future : futures) {
+                future.GetValueSync();
+            }
+        }
+
+        /* moves pages of already filled memory to node nodeIdx
+         * returns false for fake topologies or if pages can't be moved
+         */
+        bool MoveToNode(TConstArrayRef<char> memory, ui32 nodeIdx) const;
+
+        // the same for interleaving pages between all nodes, for data read by all of them
+        bool Interleave(TConstArrayRef<char> memory) const;
+
+        /* fills not yet touched memory with zeros by the threads of all nodes in turn by pages,
+         * so that the pages are interleaved between nodes without moving them, see ForEachFirstTouchPart
+         */
+        void InterleaveByFirstTouch(TArrayRef<char> memory);
+
+    private:
+        TVector<ui32> NodeIds;
+        TVector<ui32> NodeThreadCounts;
+        TVector<THolder<NPar::TLocalExecutor>> NodeExecutors;
+    };
+}
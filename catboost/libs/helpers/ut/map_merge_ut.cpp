@@ -1,6 +1,8 @@
 #include <catboost/libs/helpers/map_merge.h>
 
 #include <util/generic/algorithm.h>
+#include <util/generic/string.h>
+#include <util/string/cast.h>
 #include <util/generic/vector.h>
 
 #include <library/unittest/registar.h>
@@ -96,4 +98,22 @@ Y_UNIT_TEST_SUITE(TMapMergeTest) {
             UNIT_ASSERT_EQUAL(maxLen, 6); // maxLen = 6 ("google")
         }
     }
+
+    Y_UNIT_TEST(TestPairwiseReduce) {
+        for (int size : {1, 2, 5, 8, 11}) {
+            TVector<TString> v;
+            for (int i = 0; i < size; ++i) {
+                v.push_back(ToString(i));
+            }
+            NCB::PairwiseReduce(
+                TArrayRef<TString>(v),
+                [](TString* dst, TString& add) { *dst = "(" + *dst + "+" + add + ")"; });
+            if (size == 5) {
+                UNIT_ASSERT_VALUES_EQUAL(v[0], "(((0+1)+(2+3))+4)");
+            }
+            for (int i = 0; i < size; ++i) {
+                UNIT_ASSERT(v[0].Contains(ToString(i)));
+            }
+        }
+    }
 }
@@ -0,0 +1,160 @@
+#include <catboost/libs/helpers/numa.h>
+
+#include <util/generic/xrange.h>
+#include <util/system/info.h>
+
+#include <library/unittest/registar.h>
+
+#include <atomic>
+
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(TNuma) {
+    Y_UNIT_TEST(ParseCpuList) {
+        UNIT_ASSERT_VALUES_EQUAL(ParseCpuList("0-3,8,10-11\n"), (TVector<ui32>{0, 1, 2, 3, 8, 10, 11}));
+        UNIT_ASSERT_VALUES_EQUAL(ParseCpuList("5"), (TVector<ui32>{5}));
+        UNIT_ASSERT(ParseCpuList("").empty());
+    }
+
+    Y_UNIT_TEST(MakeFake) {
+        const auto topology = TNumaTopology::MakeFake(2, 5);
+        UNIT_ASSERT_VALUES_EQUAL(topology.GetNodeCount(), 2);
+        UNIT_ASSERT_VALUES_EQUAL(topology.NodeCpus[0], (TVector<ui32>{0, 1}));
+        UNIT_ASSERT_VALUES_EQUAL(topology.NodeCpus[1], (TVector<ui32>{2, 3, 4}));
+    }
+
+    Y_UNIT_TEST(Detect) {
+        const auto topology = TNumaTopology::Detect();
+        UNIT_ASSERT(topology.GetNodeCount() > 0);
+    }
+
+    Y_UNIT_TEST(ExecOnFakeNodes) {
+        // more nodes than cpus on small machines, so some nodes can be left without cpus to pin to
+        const auto topology = TNumaTopology::MakeFake(3, 4);
+        TNumaExecutors numaExecutors(topology, /*threadCount*/ 7);
+
+        ui32 threadCount = 0;
+        for (auto nodeIdx : xrange(numaExecutors.GetNodeCount())) {
+            UNIT_ASSERT(numaExecutors.GetNodeThreadCount(nodeIdx) > 0);
+            threadCount += numaExecutors.GetNodeThreadCount(nodeIdx);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(threadCount, 7);
+
+        // keys are spread proportionally to node thread counts
+        TVector<ui32> keyCounts(numaExecutors.GetNodeCount(), 0);
+        for (auto key : xrange(7 * 100)) {
+            ++keyCounts[numaExecutors.GetNodeByKey(key)];
+        }
+        for (auto nodeIdx : xrange(numaExecutors.GetNodeCount())) {
+            UNIT_ASSERT_VALUES_EQUAL(keyCounts[nodeIdx], numaExecutors.GetNodeThreadCount(nodeIdx) * 100);
+        }
+
+        TVector<int> visitCounts(numaExecutors.GetNodeCount(), 0);
+        numaExecutors.ExecOnEachNode(
+            [&] (ui32 nodeIdx) {
+                std::atomic<int> nodeVisitCount(0);
+                numaExecutors.GetNodeExecutor(nodeIdx).ExecRange(
+                    [&] (int /*id*/) {
+                        ++nodeVisitCount;
+                    },
+                    0,
+                    10,
+                    NPar::TLocalExecutor::WAIT_COMPLETE);
+                visitCounts[nodeIdx] = nodeVisitCount.load();
+            });
+        for (auto visitCount : visitCounts) {
+            UNIT_ASSERT_VALUES_EQUAL(visitCount, 10);
+        }
+    }
+
+    Y_UNIT_TEST(Placement) {
+        TNumaExecutors fakeNumaExecutors(TNumaTopology::MakeFake(2, 2), /*threadCount*/ 2, /*pinThreads*/ false);
+
+        TVector<char> memory;
+        memory.yresize(5 * NSystemInfo::GetPageSize() + 7);
+        fakeNumaExecutors.InterleaveByFirstTouch(memory);
+        for (auto value : memory) {
+            UNIT_ASSERT_VALUES_EQUAL(value, 0);
+        }
+
+        // pages of fake nodes are not moved
+        UNIT_ASSERT(!fakeNumaExecutors.MoveToNode(memory, 1));
+        UNIT_ASSERT(!fakeNumaExecutors.Interleave(memory));
+
+        for (auto i : xrange(memory.size())) {
+            memory[i] = (char)i;
+        }
+        const auto topology = TNumaTopology::Detect();
+        // can fail in restricted environments, but must keep the data anyway
+        MovePagesToNodes(memory, topology.NodeIds);
+        for (auto i : xrange(memory.size())) {
+            UNIT_ASSERT_VALUES_EQUAL(memory[i], (char)i);
+        }
+    }
+
+    Y_UNIT_TEST(FirstTouchPartsOfMisalignedMemory) {
+        const size_t pageSize = NSystemInfo::GetPageSize();
+        const ui32 nodeCount = 3;
+        TVector<char> buffer(8 * pageSize);
+        char* const pagesBegin = AlignUp(buffer.data(), pageSize);
+        // begins 16 bytes before a page boundary and ends 7 bytes after one, as yresize'd vectors do
+        const TArrayRef<char> memory(pagesBegin + pageSize - 16, 16 + 5 * pageSize + 7);
+
+        TVector<ui32> touchCounts(memory.size(), 0);
+        for (auto nodeIdx : xrange(nodeCount)) {
+            ForEachFirstTouchPart(
+                memory,
+                pageSize,
+                nodeIdx,
+                nodeCount,
+                [&] (TArrayRef<char> part) {
+                    const size_t offset = part.data() - memory.data();
+                    for (auto i : xrange(part.size())) {
+                        ++touchCounts[offset + i];
+                    }
+                    if (part.size() == pageSize) {
+                        UNIT_ASSERT_VALUES_EQUAL((size_t)part.data() % pageSize, 0);
+                        const size_t pageIdx = (part.data() - (pagesBegin + pageSize)) / pageSize;
+                        UNIT_ASSERT_VALUES_EQUAL(pageIdx % nodeCount, nodeIdx);
+                    } else {
+                        // unaligned head or tail, none of them spans a page boundary
+                        UNIT_ASSERT_VALUES_EQUAL(nodeIdx, 0);
+                        UNIT_ASSERT(part.size() == 16 || part.size() == 7);
+                        UNIT_ASSERT_VALUES_EQUAL(
+                            AlignDown(part.data(), pageSize),
+                            AlignDown(part.data() + part.size() - 1, pageSize));
+                    }
+                });
+        }
+        for (auto touchCount : touchCounts) {
+            UNIT_ASSERT_VALUES_EQUAL(touchCount, 1);
+        }
+
+        // memory inside one page
+        ui32 partCount = 0;
+        ForEachFirstTouchPart(
+            TArrayRef<char>(pagesBegin + 1, 10),
+            pageSize,
+            /*nodeIdx*/ 0,
+            nodeCount,
+            [&] (TArrayRef<char> part) {
+                UNIT_ASSERT_VALUES_EQUAL(part.size(), 10);
+                ++partCount;
+            });
+        UNIT_ASSERT_VALUES_EQUAL(partCount, 1);
+    }
+
+    Y_UNIT_TEST(ExceptionsArePropagated) {
+        TNumaExecutors numaExecutors(TNumaTopology::MakeFake(2, 2), /*threadCount*/ 2, /*pinThreads*/ false);
+        UNIT_ASSERT_EXCEPTION(
+            numaExecutors.ExecOnEachNode(
+                [] (ui32 nodeIdx) {
+                    if (nodeIdx == 1) {
+                        ythrow yexception() << "node failure";
+                    }
+                }),
+            yexception);
+    }
+}
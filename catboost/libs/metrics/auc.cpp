@@ -1,11 +1,18 @@
 #include "auc.h"
 
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/helpers/map_merge.h>
 #include <catboost/libs/helpers/parallel_sort/parallel_sort.h>
 #include <catboost/private/libs/index_range/index_range.h>
 
+#include <library/fast_exp/fast_exp.h>
+
 #include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/vector.h>
+#include <util/generic/ymath.h>
+
+#include <array>
 
 using NMetrics::TSample;
 using NMetrics::TBinClassSample;
@@ -62,8 +69,9 @@ static double SortAndCountInversions(
     return leftCount + rightCount + mergeCount;
 }
 
+// samples equal by this order are the same, so the sorted order does not depend on blocking of the sort
 static bool CompareSamplesByPrediction(const TSample& left, const TSample& right) {
-    return std::tie(left.Prediction, left.Target) < std::tie(right.Prediction, right.Target);
+    return std::tie(left.Prediction, left.Target, left.Weight) < std::tie(right.Prediction, right.Target, right.Weight);
 }
 
 static bool CompareSamplesByTarget(const TSample& left, const TSample& right) {
@@ -78,31 +86,31 @@ static double ParallelSortAndCountInversions(
     if (samples->size() <= 1u) {
         return 0;
     }
-    const ui32 threadCount = Min((ui32)localExecutor->GetThreadCount() + 1u, (ui32)samples->size());
+    const ui32 blockCount = CeilDiv<ui32>(samples->size(), AUC_BLOCK_SIZE);
     TVector<ui32> blockSizes;
-    NCB::EquallyDivide(samples->size(), threadCount, &blockSizes);
-    TVector<ui32> startPositions(threadCount);
+    NCB::EquallyDivide(samples->size(), blockCount, &blockSizes);
+    TVector<ui32> startPositions(blockCount);
     ui32 position = 0;
-    for (ui32 i = 0; i < threadCount; ++i) {
+    for (ui32 i = 0; i < blockCount; ++i) {
         startPositions[i] = position;
         position += blockSizes[i];
     }
-    TVector<double> threadResults(threadCount, 0);
+    TVector<double> blockResults(blockCount, 0);
     NPar::ParallelFor(
         *localExecutor,
         0,
-        threadCount,
+        blockCount,
         [&](int blockId) {
             int left = startPositions[blockId];
             int right = left + blockSizes[blockId];
-            threadResults[blockId] += SortAndCountInversions(left, right, samples, aux);
+            blockResults[blockId] += SortAndCountInversions(left, right, samples, aux);
         }
     );
     double result = 0;
     while (blockSizes.size() > 1u) {
         const ui32 currentMergesCount = blockSizes.size() / 2u;
         TVector<ui32> threadsPerMergeCount;
-        NCB::EquallyDivide(threadCount, currentMergesCount, &threadsPerMergeCount);
+        NCB::EquallyDivide(blockCount, currentMergesCount, &threadsPerMergeCount);
         TVector<TMergeData> mergeData;
         for (ui32 i = 0; i < currentMergesCount; ++i) {
             TMergeData currentMerge = {
@@ -121,7 +129,7 @@ static double ParallelSortAndCountInversions(
             0,
             mergeData.size(),
             [&](int blockId) {
-                threadResults[blockId] += MergeAndCountInversions(mergeData[blockId], *samples, aux);
+                blockResults[blockId] += MergeAndCountInversions(mergeData[blockId], *samples, aux);
                 for (ui32 i = mergeData[blockId].Left1; i < mergeData[blockId].Right1; ++i) {
                     leftWeightsSum[blockId] += (*samples)[i].Weight;
                 }
@@ -163,10 +171,8 @@ static double ParallelSortAndCountInversions(
         blockSizes = newBlockSizes;
         startPositions = newStartPositions;
     }
-    for (const double& threadResult : threadResults) {
-        result += threadResult;
-    }
-    return result;
+    NCB::PairwiseReduce(TArrayRef<double>(blockResults), [] (double* dst, double add) { *dst += add; });
+    return result + blockResults[0];
 }
 
 double CalcAUC(TVector<TSample>* samples, NPar::TLocalExecutor* localExecutor, double* outWeightSum, double* outPairWeightSum) {
@@ -235,64 +241,84 @@ static bool CompareBinClassSamplesByPrediction(const TBinClassSample& left, cons
     return left.Prediction < right.Prediction;
 }
 
-double CalcBinClassAuc(
-    TVector<TBinClassSample>* positiveSamples,
-    TVector<TBinClassSample>* negativeSamples,
+// samples equal by this order are the same, so prefix sums of weights do not depend on blocking of the sort
+static bool CompareBinClassSamplesByPredictionAndWeight(const TBinClassSample& left, const TBinClassSample& right) {
+    return std::tie(left.Prediction, left.Weight) < std::tie(right.Prediction, right.Weight);
+}
+
+// sortedSamples are samples of one class sorted by prediction, otherSamples are samples of the other class
+static double CalcBinClassAucBySortedSamples(
+    TConstArrayRef<TBinClassSample> sortedSamples,
+    TConstArrayRef<TBinClassSample> otherSamples,
+    bool sortedAreNegative,
     NPar::TLocalExecutor* localExecutor
 ) {
-    if (positiveSamples->empty() || negativeSamples->empty()) {
-        return 0;
-    }
-    bool needSwap = false;
-    if (positiveSamples->size() > negativeSamples->size()) {
-        std::swap(positiveSamples, negativeSamples);
-        needSwap = true;
-    }
-    TVector<TBinClassSample> buf(positiveSamples->begin(), positiveSamples->end());
-    NCB::ParallelMergeSort(CompareBinClassSamplesByPrediction, positiveSamples, localExecutor, &buf);
-    TVector<ui32> equalPredictionPositions(positiveSamples->size());
-    for (ui32 i = positiveSamples->size(); i > 0; --i) {
+    TVector<ui32> equalPredictionPositions(sortedSamples.size());
+    for (ui32 i = sortedSamples.size(); i > 0; --i) {
         equalPredictionPositions[i - 1] = i;
-        if (i < positiveSamples->size() && (*positiveSamples)[i - 1].Prediction == (*positiveSamples)[i].Prediction) {
+        if (i < sortedSamples.size() && sortedSamples[i - 1].Prediction == sortedSamples[i].Prediction) {
             equalPredictionPositions[i - 1] = equalPredictionPositions[i];
         }
     }
-    TVector<double> prefixSumOfWeights(positiveSamples->size() + 1, 0);
-    for (ui32 i = 0; i < positiveSamples->size(); ++i) {
-        prefixSumOfWeights[i + 1] = prefixSumOfWeights[i] + (*positiveSamples)[i].Weight;
+    TVector<double> prefixSumOfWeights(sortedSamples.size() + 1, 0);
+    for (ui32 i = 0; i < sortedSamples.size(); ++i) {
+        prefixSumOfWeights[i + 1] = prefixSumOfWeights[i] + sortedSamples[i].Weight;
     }
-    const ui32 threadCount = Min((ui32)localExecutor->GetThreadCount() + 1, (ui32)negativeSamples->size());
-    NCB::TEqualRangesGenerator<ui32> rangesGenerator({0, (ui32)negativeSamples->size()}, threadCount);
-    TVector<double> weightSumData(threadCount, 0);
-    TVector<double> pairWeightSumData(threadCount, 0);
+    const NCB::TSimpleIndexRangesGenerator<ui32> rangesGenerator(
+        NCB::TIndexRange<ui32>(otherSamples.size()),
+        AUC_BLOCK_SIZE);
+    const ui32 blockCount = rangesGenerator.RangesCount();
+    TVector<double> weightSumData(blockCount, 0);
+    TVector<double> pairWeightSumData(blockCount, 0);
     NPar::ParallelFor(
         *localExecutor,
         0,
-        threadCount,
+        blockCount,
         [&](int blockId) {
             for (ui32 i : rangesGenerator.GetRange(blockId).Iter()) {
-                weightSumData[blockId] += (*negativeSamples)[i].Weight;
-                ui32 position = LowerBound(positiveSamples->begin(), positiveSamples->end(), (*negativeSamples)[i], CompareBinClassSamplesByPrediction) - positiveSamples->begin();
-                pairWeightSumData[blockId] += (*negativeSamples)[i].Weight * prefixSumOfWeights[position];
-                if (position < positiveSamples->size() && (*positiveSamples)[position].Prediction == (*negativeSamples)[i].Prediction) {
-                    pairWeightSumData[blockId] += (*negativeSamples)[i].Weight * ((prefixSumOfWeights[equalPredictionPositions[position]] - prefixSumOfWeights[position]) / 2.0);
+                weightSumData[blockId] += otherSamples[i].Weight;
+                ui32 position = LowerBound(sortedSamples.begin(), sortedSamples.end(), otherSamples[i], CompareBinClassSamplesByPrediction) - sortedSamples.begin();
+                pairWeightSumData[blockId] += otherSamples[i].Weight * prefixSumOfWeights[position];
+                if (position < sortedSamples.size() && sortedSamples[position].Prediction == otherSamples[i].Prediction) {
+                    pairWeightSumData[blockId] += otherSamples[i].Weight * ((prefixSumOfWeights[equalPredictionPositions[position]] - prefixSumOfWeights[position]) / 2.0);
                 }
             }
         }
     );
-    const double negativeWeightSum = Accumulate(weightSumData, 0.0);
-    const double pairWeightSum = Accumulate(pairWeightSumData, 0.0);
-    double positiveWeightSum = 0;
-    for (const auto& sample : *positiveSamples) {
-        positiveWeightSum += sample.Weight;
+    const auto add = [] (double* dst, double add) { *dst += add; };
+    NCB::PairwiseReduce(TArrayRef<double>(weightSumData), add);
+    NCB::PairwiseReduce(TArrayRef<double>(pairWeightSumData), add);
+    const double otherWeightSum = blockCount ? weightSumData[0] : 0.0;
+    const double pairWeightSum = blockCount ? pairWeightSumData[0] : 0.0;
+    double sortedWeightSum = 0;
+    for (const auto& sample : sortedSamples) {
+        sortedWeightSum += sample.Weight;
     }
-    double result = pairWeightSum / (positiveWeightSum * negativeWeightSum);
-    if (!needSwap) {
+    double result = pairWeightSum / (sortedWeightSum * otherWeightSum);
+    if (!sortedAreNegative) {
         result = 1 - result;
     }
     return result;
 }
 
+double CalcBinClassAuc(
+    TVector<TBinClassSample>* positiveSamples,
+    TVector<TBinClassSample>* negativeSamples,
+    NPar::TLocalExecutor* localExecutor
+) {
+    if (positiveSamples->empty() || negativeSamples->empty()) {
+        return 0;
+    }
+    bool needSwap = false;
+    if (positiveSamples->size() > negativeSamples->size()) {
+        std::swap(positiveSamples, negativeSamples);
+        needSwap = true;
+    }
+    TVector<TBinClassSample> buf(positiveSamples->begin(), positiveSamples->end());
+    NCB::ParallelMergeSort(CompareBinClassSamplesByPredictionAndWeight, positiveSamples, localExecutor, &buf);
+    return CalcBinClassAucBySortedSamples(*positiveSamples, *negativeSamples, needSwap, localExecutor);
+}
+
 double CalcBinClassAuc(
     TVector<NMetrics::TBinClassSample>* positiveSamples,
     TVector<NMetrics::TBinClassSample>* negativeSamples,
@@ -302,3 +328,161 @@ double CalcBinClassAuc(
     localExecutor.RunAdditionalThreads(threadCount - 1);
     return CalcBinClassAuc(positiveSamples, negativeSamples, &localExecutor);
 }
+
+void AddToAucHistograms(
+    TConstArrayRef<double> approx,
+    bool isExpApprox,
+    TConstArrayRef<float> target,
+    TConstArrayRef<float> weight,
+    int begin,
+    int end,
+    TArrayRef<double> positiveWeights,
+    TArrayRef<double> negativeWeights
+) {
+    Y_ASSERT(positiveWeights.size() == negativeWeights.size());
+    const ui32 binCount = positiveWeights.size();
+    constexpr int blockSize = 1024;
+    // exp(-approx) of a block, computed by vectorized FastExpInplace
+    std::array<double, blockSize> negExpApprox;
+    for (int blockBegin = begin; blockBegin < end; blockBegin += blockSize) {
+        const int blockEnd = Min(blockBegin + blockSize, end);
+        const int count = blockEnd - blockBegin;
+        if (isExpApprox) {
+            for (int i = 0; i < count; ++i) {
+                negExpApprox[i] = 1 / approx[blockBegin + i];
+            }
+        } else {
+            for (int i = 0; i < count; ++i) {
+                negExpApprox[i] = -approx[blockBegin + i];
+            }
+            FastExpInplace(negExpApprox.data(), count);
+        }
+        for (int i = 0; i < count; ++i) {
+            const int idx = blockBegin + i;
+            const double probability = 1 / (1 + negExpApprox[i]);
+            const ui32 bin = Min<ui32>(binCount - 1, static_cast<ui32>(probability * binCount));
+            const double currentTarget = target[idx];
+            CB_ENSURE(0 <= currentTarget && currentTarget <= 1, "All target values should be in the segment [0, 1], for Ranking AUC please use type=Ranking.");
+            const double currentWeight = weight.empty() ? 1.0 : weight[idx];
+            positiveWeights[bin] += currentTarget * currentWeight;
+            negativeWeights[bin] += (1 - currentTarget) * currentWeight;
+        }
+    }
+}
+
+double CalcAucByHistograms(TConstArrayRef<double> positiveWeights, TConstArrayRef<double> negativeWeights) {
+    Y_ASSERT(positiveWeights.size() == negativeWeights.size());
+    double positiveWeightSum = 0;
+    double negativeWeightSum = 0;
+    double pairWeightSum = 0;
+    for (ui32 bin = 0; bin < positiveWeights.size(); ++bin) {
+        pairWeightSum += positiveWeights[bin] * (negativeWeightSum + negativeWeights[bin] / 2.0);
+        positiveWeightSum += positiveWeights[bin];
+        negativeWeightSum += negativeWeights[bin];
+    }
+    if (positiveWeightSum == 0 || negativeWeightSum == 0) {
+        return 0;
+    }
+    return pairWeightSum / (positiveWeightSum * negativeWeightSum);
+}
+
+TStagedBinClassAucCalcer::TStagedBinClassAucCalcer(TConstArrayRef<float> target, TConstArrayRef<float> weight) {
+    TVector<TIndexedSample> positiveSamples, negativeSamples;
+    for (ui32 i = 0; i < target.size(); ++i) {
+        const double currentTarget = target[i];
+        CB_ENSURE(0 <= currentTarget && currentTarget <= 1, "All target values should be in the segment [0, 1], for Ranking AUC please use type=Ranking.");
+        const double currentWeight = weight.empty() ? 1.0 : weight[i];
+        if (currentTarget > 0) {
+            positiveSamples.push_back({0.0, currentTarget * currentWeight, i});
+        }
+        if (currentTarget < 1) {
+            negativeSamples.push_back({0.0, (1 - currentTarget) * currentWeight, i});
+        }
+    }
+    SortedAreNegative = positiveSamples.size() > negativeSamples.size();
+    SortedSamples = SortedAreNegative ? std::move(negativeSamples) : std::move(positiveSamples);
+    OtherSamples = SortedAreNegative ? std::move(positiveSamples) : std::move(negativeSamples);
+}
+
+static bool CompareIndexedSamples(
+    const TStagedBinClassAucCalcer::TIndexedSample& left,
+    const TStagedBinClassAucCalcer::TIndexedSample& right
+) {
+    return left.Prediction < right.Prediction || (left.Prediction == right.Prediction && left.Index < right.Index);
+}
+
+// Bottom-up merge of the sorted runs, takes O(n log(runCount)) for an almost sorted sequence
+static void MergeSortedRuns(
+    TVector<TStagedBinClassAucCalcer::TIndexedSample>* samples,
+    TVector<TStagedBinClassAucCalcer::TIndexedSample>* buf,
+    NPar::TLocalExecutor* localExecutor
+) {
+    TVector<ui32> runStarts = {0};
+    for (ui32 i = 1; i < samples->size(); ++i) {
+        if (CompareIndexedSamples((*samples)[i], (*samples)[i - 1])) {
+            runStarts.push_back(i);
+        }
+    }
+    runStarts.push_back(samples->size());
+    buf->yresize(samples->size());
+    while (runStarts.size() > 2) {
+        const ui32 runCount = runStarts.size() - 1;
+        NPar::ParallelFor(
+            *localExecutor,
+            0,
+            (runCount + 1) / 2,
+            [&](int mergeIdx) {
+                const ui32 left = runStarts[2 * mergeIdx];
+                const ui32 middle = runStarts[Min<ui32>(2 * mergeIdx + 1, runCount)];
+                const ui32 right = runStarts[Min<ui32>(2 * mergeIdx + 2, runCount)];
+                std::merge(
+                    samples->begin() + left,
+                    samples->begin() + middle,
+                    samples->begin() + middle,
+                    samples->begin() + right,
+                    buf->begin() + left,
+                    CompareIndexedSamples);
+            }
+        );
+        samples->swap(*buf);
+        TVector<ui32> mergedRunStarts;
+        mergedRunStarts.reserve(runCount / 2 + 2);
+        for (ui32 i = 0; i < runCount; i += 2) {
+            mergedRunStarts.push_back(runStarts[i]);
+        }
+        mergedRunStarts.push_back(samples->size());
+        runStarts.swap(mergedRunStarts);
+    }
+}
+
+double TStagedBinClassAucCalcer::Calc(TConstArrayRef<double> approx, NPar::TLocalExecutor* localExecutor) {
+    if (SortedSamples.empty() || OtherSamples.empty()) {
+        return 0;
+    }
+    NPar::ParallelFor(
+        *localExecutor,
+        0,
+        SortedSamples.size(),
+        [&](int i) {
+            SortedSamples[i].Prediction = approx[SortedSamples[i].Index];
+        }
+    );
+    MergeSortedRuns(&SortedSamples, &SortBuffer, localExecutor);
+
+    TVector<TBinClassSample> sortedSamples(SortedSamples.size());
+    TVector<TBinClassSample> otherSamples(OtherSamples.size());
+    NPar::ParallelFor(
+        *localExecutor,
+        0,
+        Max(SortedSamples.size(), OtherSamples.size()),
+        [&](int i) {
+            if ((size_t)i < SortedSamples.size()) {
+                sortedSamples[i] = TBinClassSample(SortedSamples[i].Prediction, SortedSamples[i].Weight);
+            }
+            if ((size_t)i < OtherSamples.size()) {
+                otherSamples[i] = TBinClassSample(approx[OtherSamples[i].Index], OtherSamples[i].Weight);
+            }
+        }
+    );
+    return CalcBinClassAucBySortedSamples(sortedSamples, otherSamples, SortedAreNegative, localExecutor);
+}
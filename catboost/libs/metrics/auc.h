@@ -4,8 +4,60 @@
 
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+// AUC calculations are split into blocks of this size independently of thread count,
+// so their results do not depend on it
+constexpr ui32 AUC_BLOCK_SIZE = 10000;
+
 double CalcAUC(TVector<NMetrics::TSample>* samples, NPar::TLocalExecutor* localExecutor, double* outWeightSum = nullptr, double* outPairWeightSum = nullptr);
 double CalcAUC(TVector<NMetrics::TSample>* samples, double* outWeightSum = nullptr, double* outPairWeightSum = nullptr, int threadCount = 1);
 
 double CalcBinClassAuc(TVector<NMetrics::TBinClassSample>* positiveSamples, TVector<NMetrics::TBinClassSample>* negativeSamples, NPar::TLocalExecutor* localExecutor);
 double CalcBinClassAuc(TVector<NMetrics::TBinClassSample>* positiveSamples, TVector<NMetrics::TBinClassSample>* negativeSamples, int threadCount = 1);
+
+/* Approximate AUC of binary classification by histograms of class weights over binCount equal bins
+ * of sigmoid(approx), it takes O(n) time and O(binCount) memory. Histograms of object subsets are summed,
+ * so they can be built by parts in parallel or on different hosts.
+ * Pairs of objects from the same bin count a half as ties do, so the absolute error is at most
+ * 0.5 * sum(positiveWeights[i] * negativeWeights[i]) / (sum(positiveWeights) * sum(negativeWeights)).
+ */
+void AddToAucHistograms(
+    TConstArrayRef<double> approx,
+    bool isExpApprox,
+    TConstArrayRef<float> target,
+    TConstArrayRef<float> weight, // empty if weights are not used
+    int begin,
+    int end,
+    TArrayRef<double> positiveWeights,
+    TArrayRef<double> negativeWeights);
+
+double CalcAucByHistograms(TConstArrayRef<double> positiveWeights, TConstArrayRef<double> negativeWeights);
+
+/* AUC of binary classification for gradually changing predictions of the same objects, e.g. for
+ * predictions of growing tree ranges of a model. Samples of the smaller class keep their order
+ * between calls, so each call only merges sorted runs of an almost sorted sequence instead of
+ * sorting from scratch.
+ */
+class TStagedBinClassAucCalcer {
+public:
+    struct TIndexedSample {
+        double Prediction;
+        double Weight;
+        ui32 Index;
+    };
+
+public:
+    // weight is empty if weights are not used
+    TStagedBinClassAucCalcer(TConstArrayRef<float> target, TConstArrayRef<float> weight);
+
+    double Calc(TConstArrayRef<double> approx, NPar::TLocalExecutor* localExecutor);
+
+private:
+    bool SortedAreNegative = false;
+    TVector<TIndexedSample> SortedSamples; // sorted by prediction of the previous call
+    TVector<TIndexedSample> SortBuffer;
+    TVector<TIndexedSample> OtherSamples;
+};
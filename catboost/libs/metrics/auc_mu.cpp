@@ -17,14 +17,13 @@ double CalcMuAuc(
     NPar::TLocalExecutor* localExecutor,
     const TMaybe<TVector<TVector<double>>>& misclassCostMatrix
 ) {
-    ui32 threadCount = Min((ui32)localExecutor->GetThreadCount() + 1, (ui32)target.size());
-    NCB::TEqualRangesGenerator<ui32> generator({0, (ui32)target.size()}, threadCount);
+    const NCB::TSimpleIndexRangesGenerator<ui32> generator(NCB::TIndexRange<ui32>(target.size()), AUC_BLOCK_SIZE);
     TVector<TVector<double>> dotProducts(approx);
     ui32 classCount = approx.size();
     NPar::ParallelFor(
         *localExecutor,
         0,
-        threadCount,
+        generator.RangesCount(),
         [&](int blockId) {
             for (ui32 i : generator.GetRange(blockId).Iter()) {
                 if (misclassCostMatrix) {
@@ -2,10 +2,13 @@
 #include "metric.h"
 #include "description_utils.h"
 #include "classification_utils.h"
+#include "dcg.h"
+#include "doc_comparator.h"
 #include "enums.h"
 #include "kappa.h"
 
 #include <catboost/libs/helpers/dispatch_generic_lambda.h>
+#include <catboost/libs/helpers/map_merge.h>
 #include <catboost/libs/helpers/math_utils.h>
 #include <catboost/libs/helpers/vector_helpers.h>
 #include <catboost/private/libs/options/data_processing_options.h>
@@ -1036,6 +1039,323 @@ double TWKappaMetric::GetFinalError(const TMetricHolder& error) const {
     return CalcKappa(error, ClassCount, EKappaMetricType::Weighted);
 }
 
+/* Ranking metrics */
+
+static TString QueryTopTargetsCacheKey = "Query Top Targets";
+
+namespace {
+    /* Targets of the top documents of each query of a block in the order of ranking metrics,
+     * they are sorted once per block and shared by all ranking metrics with the same top size.
+     */
+    struct TQueryTopTargets {
+        TVector<ui32> Offsets; // targets of i-th query of the block are [Offsets[i], Offsets[i + 1])
+        TVector<double> Targets;
+
+        TConstArrayRef<double> GetQueryTargets(int queryIdxInBlock) const {
+            return MakeArrayRef(Targets.data() + Offsets[queryIdxInBlock], Targets.data() + Offsets[queryIdxInBlock + 1]);
+        }
+    };
+}
+
+static size_t GetQueryTopSize(ui32 querySize, int topSize) {
+    return (topSize < 0 || querySize < static_cast<ui32>(topSize)) ? querySize : static_cast<size_t>(topSize);
+}
+
+// isIdealOrder: documents are sorted by target (as for IDCG), not by approx
+static TQueryTopTargets BuildQueryTopTargets(
+    TConstArrayRef<double> approx,
+    TConstArrayRef<double> approxDelta,
+    TConstArrayRef<float> target,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    int begin,
+    int end,
+    int topSize,
+    bool isIdealOrder
+) {
+    TQueryTopTargets result;
+    result.Offsets.reserve(end - begin + 1);
+    result.Offsets.push_back(0);
+    const auto getApprox = [&](ui32 idx) {
+        return approxDelta.empty() ? approx[idx] : approx[idx] + approxDelta[idx];
+    };
+    TVector<ui32> indices; // reused by all queries of the block
+    for (int queryIndex = begin; queryIndex < end; ++queryIndex) {
+        const ui32 queryBegin = queriesInfo[queryIndex].Begin;
+        const ui32 querySize = queriesInfo[queryIndex].End - queryBegin;
+        const size_t queryTopSize = GetQueryTopSize(querySize, topSize);
+        indices.yresize(querySize);
+        Iota(indices.begin(), indices.end(), queryBegin);
+        if (isIdealOrder) {
+            PartialSort(indices.begin(), indices.begin() + queryTopSize, indices.end(), [&](ui32 lhs, ui32 rhs) {
+                return target[lhs] > target[rhs];
+            });
+        } else {
+            PartialSort(indices.begin(), indices.begin() + queryTopSize, indices.end(), [&](ui32 lhs, ui32 rhs) {
+                return CompareDocs(getApprox(lhs), target[lhs], getApprox(rhs), target[rhs]);
+            });
+        }
+        for (auto i : xrange(queryTopSize)) {
+            result.Targets.push_back(target[indices[i]]);
+        }
+        result.Offsets.push_back(result.Targets.size());
+    }
+    return result;
+}
+
+static const TQueryTopTargets& GetQueryTopTargets(
+    const TConstArrayRef<TConstArrayRef<double>> approx,
+    const TConstArrayRef<TConstArrayRef<double>> approxDelta,
+    TConstArrayRef<float> target,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    int begin,
+    int end,
+    int topSize,
+    bool isIdealOrder,
+    TMaybe<TCache*> cache,
+    TQueryTopTargets* nonCachedHolder
+) {
+    const auto makeTopTargets = [&]() {
+        return BuildQueryTopTargets(
+            approx[0],
+            approxDelta.empty() ? TConstArrayRef<double>() : approxDelta[0],
+            target,
+            queriesInfo,
+            begin,
+            end,
+            topSize,
+            isIdealOrder);
+    };
+    if (cache.Empty()) {
+        *nonCachedHolder = makeTopTargets();
+        return *nonCachedHolder;
+    }
+    return cache.GetRef()->Get(QueryTopTargetsCacheKey, makeTopTargets, topSize, isIdealOrder);
+}
+
+static int CalcRelevantCount(TConstArrayRef<double> targets, double border) {
+    return CountIf(targets, [=](double target) { return target > border; });
+}
+
+/* NDCG@N and DCG@N */
+
+namespace {
+    struct TDcgCachingMetric: public TCachingMetric {
+        explicit TDcgCachingMetric(int topSize, ENdcgMetricType type, bool normalized, ENdcgDenominatorType denominator)
+            : TopSize(topSize)
+            , MetricType(type)
+            , Normalized(normalized)
+            , DenominatorType(denominator) {
+            UseWeights.SetDefaultValue(true);
+        }
+        TMetricHolder Eval(
+            const TConstArrayRef<TConstArrayRef<double>> approx,
+            const TConstArrayRef<TConstArrayRef<double>> approxDelta,
+            bool isExpApprox,
+            TConstArrayRef<float> target,
+            TConstArrayRef<float> weight,
+            TConstArrayRef<TQueryInfo> queriesInfo,
+            int begin,
+            int end,
+            TMaybe<TCache*> cache
+        ) const override;
+        EErrorType GetErrorType() const override {
+            return EErrorType::QuerywiseError;
+        }
+        double GetFinalError(const TMetricHolder& error) const override {
+            return error.Stats[1] != 0 ? error.Stats[0] / error.Stats[1] : 0;
+        }
+        TString GetDescription() const override;
+        void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
+        bool IsAdditiveMetric() const override {
+            return true;
+        }
+
+    private:
+        int TopSize;
+        ENdcgMetricType MetricType;
+        bool Normalized;
+        ENdcgDenominatorType DenominatorType;
+    };
+}
+
+THolder<IMetric> MakeDcgMetric(int topSize, ENdcgMetricType type, bool normalized, ENdcgDenominatorType denominator) {
+    return MakeHolder<TDcgCachingMetric>(topSize, type, normalized, denominator);
+}
+
+TMetricHolder TDcgCachingMetric::Eval(
+    const TConstArrayRef<TConstArrayRef<double>> approx,
+    const TConstArrayRef<TConstArrayRef<double>> approxDelta,
+    bool isExpApprox,
+    TConstArrayRef<float> target,
+    TConstArrayRef<float> /*weight*/,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    int begin,
+    int end,
+    TMaybe<TCache*> cache
+) const {
+    Y_ASSERT(!isExpApprox);
+    TQueryTopTargets topTargetsHolder;
+    const auto& topTargets = GetQueryTopTargets(
+        approx, approxDelta, target, queriesInfo, begin, end, TopSize, /*isIdealOrder*/ false, cache, &topTargetsHolder);
+    TQueryTopTargets idealTopTargetsHolder;
+    const auto& idealTopTargets = Normalized
+        ? GetQueryTopTargets(approx, approxDelta, target, queriesInfo, begin, end, TopSize, /*isIdealOrder*/ true, cache, &idealTopTargetsHolder)
+        : idealTopTargetsHolder;
+
+    TMetricHolder error(2);
+    for (int queryIndex = begin; queryIndex < end; ++queryIndex) {
+        const float queryWeight = UseWeights ? queriesInfo[queryIndex].Weight : 1.f;
+        const double dcg = CalcDcgSorted(topTargets.GetQueryTargets(queryIndex - begin), MetricType, Nothing(), DenominatorType);
+        if (Normalized) {
+            const double idcg = CalcDcgSorted(idealTopTargets.GetQueryTargets(queryIndex - begin), MetricType, Nothing(), DenominatorType);
+            error.Stats[0] += queryWeight * (idcg > 0 ? dcg / idcg : 0);
+        } else {
+            error.Stats[0] += queryWeight * dcg;
+        }
+        error.Stats[1] += queryWeight;
+    }
+    return error;
+}
+
+TString TDcgCachingMetric::GetDescription() const {
+    const TMetricParam<int> topSize("top", TopSize, TopSize != -1);
+    const TMetricParam<ENdcgMetricType> type("type", MetricType, true);
+    return BuildDescription(Normalized ? ELossFunction::NDCG : ELossFunction::DCG, UseWeights, topSize, type);
+}
+
+void TDcgCachingMetric::GetBestValue(EMetricBestValue* valueType, float*) const {
+    *valueType = EMetricBestValue::Max;
+}
+
+/* PrecisionAtK, RecallAtK and Mean Average Precision at K */
+
+namespace {
+    enum class ETopKMetricType {
+        PrecisionAt,
+        RecallAt,
+        MAP
+    };
+
+    struct TTopKCachingMetric: public TCachingMetric {
+        TTopKCachingMetric(ETopKMetricType type, int topSize)
+            : Type(type)
+            , TopSize(topSize) {
+            UseWeights.SetDefaultValue(true);
+        }
+        TMetricHolder Eval(
+            const TConstArrayRef<TConstArrayRef<double>> approx,
+            const TConstArrayRef<TConstArrayRef<double>> approxDelta,
+            bool isExpApprox,
+            TConstArrayRef<float> target,
+            TConstArrayRef<float> weight,
+            TConstArrayRef<TQueryInfo> queriesInfo,
+            int begin,
+            int end,
+            TMaybe<TCache*> cache
+        ) const override;
+        EErrorType GetErrorType() const override {
+            return EErrorType::QuerywiseError;
+        }
+        double GetFinalError(const TMetricHolder& error) const override {
+            return error.Stats[1] != 0 ? error.Stats[0] / error.Stats[1] : (Type == ETopKMetricType::MAP ? 0 : 1);
+        }
+        TString GetDescription() const override;
+        void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
+        bool IsAdditiveMetric() const override {
+            return true;
+        }
+
+    private:
+        const ETopKMetricType Type;
+        const int TopSize;
+        const double TargetBorder = GetDefaultTargetBorder();
+    };
+}
+
+THolder<IMetric> MakePrecisionAtKMetric(int topSize) {
+    return MakeHolder<TTopKCachingMetric>(ETopKMetricType::PrecisionAt, topSize);
+}
+
+THolder<IMetric> MakeRecallAtKMetric(int topSize) {
+    return MakeHolder<TTopKCachingMetric>(ETopKMetricType::RecallAt, topSize);
+}
+
+THolder<IMetric> MakeMAPKMetric(int topSize) {
+    return MakeHolder<TTopKCachingMetric>(ETopKMetricType::MAP, topSize);
+}
+
+TMetricHolder TTopKCachingMetric::Eval(
+    const TConstArrayRef<TConstArrayRef<double>> approx,
+    const TConstArrayRef<TConstArrayRef<double>> approxDelta,
+    bool isExpApprox,
+    TConstArrayRef<float> target,
+    TConstArrayRef<float> /*weight*/,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    int begin,
+    int end,
+    TMaybe<TCache*> cache
+) const {
+    Y_ASSERT(!isExpApprox);
+    TQueryTopTargets topTargetsHolder;
+    const auto& topTargets = GetQueryTopTargets(
+        approx, approxDelta, target, queriesInfo, begin, end, TopSize, /*isIdealOrder*/ false, cache, &topTargetsHolder);
+
+    TMetricHolder error(2);
+    for (int queryIndex = begin; queryIndex < end; ++queryIndex) {
+        const auto queryTopTargets = topTargets.GetQueryTargets(queryIndex - begin);
+        const size_t queryTopSize = queryTopTargets.size();
+        switch (Type) {
+            case ETopKMetricType::PrecisionAt: {
+                error.Stats[0] += CalcRelevantCount(queryTopTargets, TargetBorder) / static_cast<double>(queryTopSize);
+                break;
+            }
+            case ETopKMetricType::RecallAt: {
+                const auto queryBegin = queriesInfo[queryIndex].Begin;
+                const auto queryEnd = queriesInfo[queryIndex].End;
+                const int relevant = CountIf(
+                    target.begin() + queryBegin,
+                    target.begin() + queryEnd,
+                    [=](float value) { return value > TargetBorder; });
+                error.Stats[0] += relevant != 0 ? CalcRelevantCount(queryTopTargets, TargetBorder) / static_cast<double>(relevant) : 1;
+                break;
+            }
+            case ETopKMetricType::MAP: {
+                const auto queryBegin = queriesInfo[queryIndex].Begin;
+                const auto queryEnd = queriesInfo[queryIndex].End;
+                double score = 0;
+                double hits = 0;
+                for (size_t index = 0; index < queryTopSize; ++index) {
+                    if (queryTopTargets[index] > TargetBorder) {
+                        hits += 1;
+                        score += hits / (index + 1);
+                    }
+                }
+                hits = CountIf(
+                    target.begin() + queryBegin,
+                    target.begin() + queryEnd,
+                    [=](float value) { return value > TargetBorder; });
+                error.Stats[0] += hits > 0 ? score / Min<double>(hits, queryTopSize) : 0;
+                break;
+            }
+        }
+        error.Stats[1]++;
+    }
+    return error;
+}
+
+TString TTopKCachingMetric::GetDescription() const {
+    const TMetricParam<int> topSize("top", TopSize, TopSize != -1);
+    const ELossFunction lossFunction
+        = Type == ETopKMetricType::PrecisionAt ? ELossFunction::PrecisionAt
+        : Type == ETopKMetricType::RecallAt ? ELossFunction::RecallAt
+        : ELossFunction::MAP;
+    return BuildDescription(lossFunction, UseWeights, topSize, "%.3g", MakeTargetBorderParam(TargetBorder));
+}
+
+void TTopKCachingMetric::GetBestValue(EMetricBestValue* valueType, float*) const {
+    *valueType = EMetricBestValue::Max;
+}
+
 TVector<TMetricHolder> EvalErrorsWithCaching(
     const TVector<TVector<double>>& approx,
     const TVector<TVector<double>>& approxDelta,
@@ -1046,7 +1366,6 @@ TVector<TMetricHolder> EvalErrorsWithCaching(
     TConstArrayRef<const IMetric*> metrics,
     NPar::TLocalExecutor* localExecutor
 ) {
-    const auto threadCount = localExecutor->GetThreadCount() + 1;
     const auto objectCount = approx.front().size();
     const auto queryCount = queriesInfo.size();
 
@@ -1069,65 +1388,84 @@ TVector<TMetricHolder> EvalErrorsWithCaching(
                             weight, from, to, *localExecutor);
     };
 
-    TVector<TMetricHolder> errors;
-    errors.reserve(metrics.size());
+    TVector<TMetricHolder> errors(metrics.size());
 
+    // blocking does not depend on thread count to keep metric values reproducible, see ParallelEvalMetric
     NPar::TLocalExecutor::TExecRangeParams objectwiseBlockParams(0, objectCount);
-    if (!target.empty()) {
-        const auto objectwiseEffectiveBlockCount = Min(threadCount, int(ceil(double(objectCount) / GetMinBlockSize(objectCount))));
-        objectwiseBlockParams.SetBlockCount(objectwiseEffectiveBlockCount);
-    }
+    objectwiseBlockParams.SetBlockSize(GetMinBlockSize(objectCount));
 
     NPar::TLocalExecutor::TExecRangeParams querywiseBlockParams(0, queryCount);
-    if (!queriesInfo.empty()) {
-        const auto querywiseEffectiveBlockCount = Min(threadCount, int(ceil(double(queryCount) / GetMinBlockSize(objectCount))));
-        querywiseBlockParams.SetBlockCount(querywiseEffectiveBlockCount);
-    }
+    querywiseBlockParams.SetBlockSize(GetMinBlockSize(queryCount));
 
     TCache nonAdditiveCache;
     TVector<TCache> objectwiseAdditiveCache(objectwiseBlockParams.GetBlockCount());
     TVector<TCache> querywiseAdditiveCache(querywiseBlockParams.GetBlockCount());
-    TVector<TMetricHolder> objectwiseBlockResults(objectwiseBlockParams.GetBlockCount());
-    TVector<TMetricHolder> querywiseBlockResults(querywiseBlockParams.GetBlockCount());
 
+    TVector<size_t> objectwiseAdditiveMetrics;
+    TVector<size_t> querywiseAdditiveMetrics;
     for (auto i : xrange(metrics.size())) {
         auto metric = metrics[i];
-        auto cachingMetric = dynamic_cast<const TCachingMetric*>(metrics[i]);
-        auto multiMetric = dynamic_cast<const TMultiRegressionMetric*>(metrics[i]);
+        auto cachingMetric = dynamic_cast<const TCachingMetric*>(metric);
+        auto multiMetric = dynamic_cast<const TMultiRegressionMetric*>(metric);
+        auto blockwiseMetric = dynamic_cast<const TBlockwiseAdditiveMetric*>(metric);
         Y_ASSERT(cachingMetric == nullptr || multiMetric == nullptr);
 
         const bool isObjectwise = metric->GetErrorType() == EErrorType::PerObjectError;
-        if (cachingMetric && metric->IsAdditiveMetric()) {
-            const auto blockSize = isObjectwise ? objectwiseBlockParams.GetBlockSize() : querywiseBlockParams.GetBlockSize();
-            const auto blockCount = isObjectwise ? objectwiseBlockParams.GetBlockCount() : querywiseBlockParams.GetBlockCount();
-
-            auto &results = isObjectwise ? objectwiseBlockResults : querywiseBlockResults;
-            auto &cache = isObjectwise ? objectwiseAdditiveCache : querywiseAdditiveCache;
-            const auto end = isObjectwise ? objectCount : queryCount;
-
-            NPar::ParallelFor(*localExecutor, 0, blockCount, [&](auto blockId) {
-                const auto from = blockId * blockSize;
-                const auto to = Min<int>((blockId + 1) * blockSize, end);
-                results[blockId] = calcCaching(cachingMetric, from, to, &cache[blockId]);
-            });
-
-            TMetricHolder error;
-            for (const auto &blockResult : results) {
-                error.Add(blockResult);
-            }
-            errors.push_back(error);
+        if ((cachingMetric && metric->IsAdditiveMetric()) || blockwiseMetric) {
+            CB_ENSURE(!metric->NeedTarget() || target.size() == 1, "Metric [" + metric->GetDescription() + "] requires "
+                      << (target.size() > 1 ? "one-dimensional" : "") <<  "target");
+            (isObjectwise ? objectwiseAdditiveMetrics : querywiseAdditiveMetrics).push_back(i);
         } else {
             const auto end = isObjectwise ? objectCount : queryCount;
             if (cachingMetric) {
-                errors.push_back(calcCaching(cachingMetric, 0, end, &nonAdditiveCache));
+                errors[i] = calcCaching(cachingMetric, 0, end, &nonAdditiveCache);
             } else if (multiMetric) {
-                errors.push_back(calcMultiRegression(multiMetric, 0, end));
+                errors[i] = calcMultiRegression(multiMetric, 0, end);
             } else {
-                errors.push_back(calcNonCaching(metric, 0, end));
+                errors[i] = calcNonCaching(metric, 0, end);
             }
         }
     }
 
+    // additive metrics are evaluated in one pass: each block of approx, target and weight
+    // is processed by all metrics while it is in cache, blocks are the same as in ParallelEvalMetric
+    const auto calcAdditive = [&](
+        TConstArrayRef<size_t> metricIndices,
+        const NPar::TLocalExecutor::TExecRangeParams& blockParams,
+        TVector<TCache>* blockCaches
+    ) {
+        const auto blockSize = blockParams.GetBlockSize();
+        const auto blockCount = blockParams.GetBlockCount();
+        if (metricIndices.empty() || blockCount == 0) {
+            return;
+        }
+
+        TVector<TVector<TMetricHolder>> results(metricIndices.size(), TVector<TMetricHolder>(blockCount));
+        NPar::ParallelFor(*localExecutor, 0, blockCount, [&](auto blockId) {
+            const auto from = blockId * blockSize;
+            const auto to = Min<int>((blockId + 1) * blockSize, blockParams.LastId);
+            for (auto metricIdx : xrange(metricIndices.size())) {
+                auto metric = metrics[metricIndices[metricIdx]];
+                if (auto cachingMetric = dynamic_cast<const TCachingMetric*>(metric)) {
+                    results[metricIdx][blockId] = calcCaching(cachingMetric, from, to, &(*blockCaches)[blockId]);
+                } else {
+                    results[metricIdx][blockId] = dynamic_cast<const TBlockwiseAdditiveMetric*>(metric)->EvalBlock(
+                        To2DConstArrayRef<double>(approx), To2DConstArrayRef<double>(approxDelta), isExpApprox,
+                        metric->NeedTarget() ? target[0] : TConstArrayRef<float>(), weight, queriesInfo, from, to);
+                }
+            }
+        });
+
+        for (auto metricIdx : xrange(metricIndices.size())) {
+            NCB::PairwiseReduce(
+                TArrayRef<TMetricHolder>(results[metricIdx]),
+                [] (TMetricHolder* dst, const TMetricHolder& add) { dst->Add(add); });
+            errors[metricIndices[metricIdx]] = std::move(results[metricIdx][0]);
+        }
+    };
+    calcAdditive(objectwiseAdditiveMetrics, objectwiseBlockParams, &objectwiseAdditiveCache);
+    calcAdditive(querywiseAdditiveMetrics, querywiseBlockParams, &querywiseAdditiveCache);
+
     return errors;
 }
 
@@ -30,3 +30,10 @@ double CalcIDcg(
     TMaybe<double> expDecay = Nothing(),
     ui32 topSize = Max<ui32>(),
     ENdcgDenominatorType denominator = ENdcgDenominatorType::LogPosition);
+
+// Dcg of targets already sorted in the order of documents, e.g. top targets of CalcDcg or CalcIDcg
+double CalcDcgSorted(
+    TConstArrayRef<double> sortedTargets,
+    ENdcgMetricType type,
+    TMaybe<double> expDecay,
+    ENdcgDenominatorType denominator);
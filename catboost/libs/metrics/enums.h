@@ -4,7 +4,8 @@ enum class EAucType {
     Classic,
     Ranking,
     Mu,
-    OneVsAll
+    OneVsAll,
+    Approx
 };
 
 enum class EF1AverageType {
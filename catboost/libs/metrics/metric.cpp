@@ -5,13 +5,11 @@
 #include "balanced_accuracy.h"
 #include "brier_score.h"
 #include "classification_utils.h"
-#include "dcg.h"
 #include "doc_comparator.h"
 #include "hinge_loss.h"
 #include "kappa.h"
 #include "llp.h"
 #include "pfound.h"
-#include "precision_recall_at_k.h"
 #include "description_utils.h"
 #include "enums.h"
 
@@ -1857,109 +1855,6 @@ void TPFoundMetric::GetBestValue(EMetricBestValue* valueType, float*) const {
     *valueType = EMetricBestValue::Max;
 }
 
-/* NDCG@N */
-
-namespace {
-    struct TDcgMetric: public TAdditiveMetric<TDcgMetric> {
-        explicit TDcgMetric(int topSize, ENdcgMetricType type, bool normalized, ENdcgDenominatorType denominator);
-        TMetricHolder EvalSingleThread(
-                const TConstArrayRef<TConstArrayRef<double>> approx,
-                const TConstArrayRef<TConstArrayRef<double>> approxDelta,
-                bool isExpApprox,
-                TConstArrayRef<float> target,
-                TConstArrayRef<float> weight,
-                TConstArrayRef<TQueryInfo> queriesInfo,
-                int queryStartIndex,
-                int queryEndIndex
-        ) const;
-        EErrorType GetErrorType() const override;
-        double GetFinalError(const TMetricHolder& error) const override;
-        TString GetDescription() const override;
-        void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
-
-    private:
-        int TopSize;
-        ENdcgMetricType MetricType;
-        bool Normalized;
-        ENdcgDenominatorType DenominatorType;
-    };
-}
-
-THolder<IMetric> MakeDcgMetric(int topSize, ENdcgMetricType type, bool normalized, ENdcgDenominatorType denominator) {
-    return MakeHolder<TDcgMetric>(topSize, type, normalized, denominator);
-}
-
-TDcgMetric::TDcgMetric(int topSize, ENdcgMetricType type, bool normalized, ENdcgDenominatorType denominator)
-    : TopSize(topSize)
-    , MetricType(type)
-    , Normalized(normalized)
-    , DenominatorType(denominator) {
-    UseWeights.SetDefaultValue(true);
-}
-
-TMetricHolder TDcgMetric::EvalSingleThread(
-    const TConstArrayRef<TConstArrayRef<double>> approx,
-    const TConstArrayRef<TConstArrayRef<double>> approxDelta,
-    bool isExpApprox,
-    TConstArrayRef<float> target,
-    TConstArrayRef<float> /*weight*/,
-    TConstArrayRef<TQueryInfo> queriesInfo,
-    int queryStartIndex,
-    int queryEndIndex
-) const {
-    Y_ASSERT(!isExpApprox);
-    TConstArrayRef<double> approxesRef;
-    TVector<double> approxWithDelta;
-    if (approxDelta.empty()) {
-        approxesRef = approx.front();
-    } else {
-        Y_ASSERT(approx.front().size() == approxDelta.front().size());
-        approxWithDelta.yresize(approx.front().size());
-        for (size_t doc = 0; doc < approx.front().size(); ++doc) {
-            approxWithDelta[doc] = approx.front()[doc] + approxDelta.front()[doc];
-        }
-        approxesRef = approxWithDelta;
-    }
-
-    TMetricHolder error(2);
-    TVector<NMetrics::TSample> samples;
-    for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
-        const auto queryBegin = queriesInfo[queryIndex].Begin;
-        const auto queryEnd = queriesInfo[queryIndex].End;
-        const auto querySize = queryEnd - queryBegin;
-        const float queryWeight = UseWeights ? queriesInfo[queryIndex].Weight : 1.f;
-        NMetrics::TSample::FromVectors(
-            MakeArrayRef(target.data() + queryBegin, querySize),
-            MakeArrayRef(approxesRef.data() + queryBegin, querySize),
-            &samples);
-        if (Normalized) {
-            error.Stats[0] += queryWeight * CalcNdcg(samples, MetricType, TopSize, DenominatorType);
-        } else {
-            error.Stats[0] += queryWeight * CalcDcg(samples, MetricType, Nothing(), TopSize, DenominatorType);
-        }
-        error.Stats[1] += queryWeight;
-    }
-    return error;
-}
-
-TString TDcgMetric::GetDescription() const {
-    const TMetricParam<int> topSize("top", TopSize, TopSize != -1);
-    const TMetricParam<ENdcgMetricType> type("type", MetricType, true);
-    return BuildDescription(Normalized ? ELossFunction::NDCG : ELossFunction::DCG, UseWeights, topSize, type);
-}
-
-EErrorType TDcgMetric::GetErrorType() const {
-    return EErrorType::QuerywiseError;
-}
-
-double TDcgMetric::GetFinalError(const TMetricHolder& error) const {
-    return error.Stats[1] != 0 ? error.Stats[0] / error.Stats[1] : 0;
-}
-
-void TDcgMetric::GetBestValue(EMetricBestValue* valueType, float*) const {
-    *valueType = EMetricBestValue::Max;
-}
-
 /* QuerySoftMax */
 
 namespace {
@@ -2319,6 +2214,10 @@ namespace {
         TString GetDescription() const override;
         void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
 
+        EAucType GetAucType() const {
+            return Type;
+        }
+
     private:
         int PositiveClass = 1;
         EAucType Type;
@@ -2347,6 +2246,143 @@ THolder<IMetric> MakeMuAucMetric(const TMaybe<TVector<TVector<double>>>& misclas
     return MakeHolder<TAUCMetric>(misclassCostMatrix);
 }
 
+bool IsBinClassAucMetric(const IMetric& metric) {
+    const auto aucMetric = dynamic_cast<const TAUCMetric*>(&metric);
+    return aucMetric && aucMetric->GetAucType() == EAucType::Classic;
+}
+
+/* Approximate AUC */
+
+namespace {
+    struct TApproxAUCMetric: public TMetric {
+        explicit TApproxAUCMetric(ui32 binCount)
+            : BinCount(binCount) {
+            UseWeights.SetDefaultValue(false);
+        }
+
+        TMetricHolder Eval(
+            const TVector<TVector<double>>& approx,
+            TConstArrayRef<float> target,
+            TConstArrayRef<float> weight,
+            TConstArrayRef<TQueryInfo> queriesInfo,
+            int begin,
+            int end,
+            NPar::TLocalExecutor& executor) const override {
+                return Eval(To2DConstArrayRef<double>(approx), /*approxDelta*/{}, /*isExpApprox*/false, target, weight, queriesInfo, begin, end, executor);
+        }
+        TMetricHolder Eval(
+            const TConstArrayRef<TConstArrayRef<double>> approx,
+            const TConstArrayRef<TConstArrayRef<double>> approxDelta,
+            bool isExpApprox,
+            TConstArrayRef<float> target,
+            TConstArrayRef<float> weight,
+            TConstArrayRef<TQueryInfo> queriesInfo,
+            int begin,
+            int end,
+            NPar::TLocalExecutor& executor) const override;
+        TString GetDescription() const override;
+        void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
+        double GetFinalError(const TMetricHolder& error) const override;
+        TVector<TString> GetStatDescriptions() const override;
+        bool IsAdditiveMetric() const override {
+            return true;
+        }
+
+    private:
+        ui32 BinCount;
+    };
+}
+
+THolder<IMetric> MakeApproxBinClassAucMetric(ui32 binCount) {
+    CB_ENSURE(binCount > 0, "Bin count of approximate AUC should be positive");
+    return MakeHolder<TApproxAUCMetric>(binCount);
+}
+
+TMetricHolder TApproxAUCMetric::Eval(
+    const TConstArrayRef<TConstArrayRef<double>> approx,
+    const TConstArrayRef<TConstArrayRef<double>> approxDelta,
+    bool isExpApprox,
+    TConstArrayRef<float> target,
+    TConstArrayRef<float> weight,
+    TConstArrayRef<TQueryInfo> /*queriesInfo*/,
+    int begin,
+    int end,
+    NPar::TLocalExecutor& executor
+) const {
+    Y_ASSERT(approx.size() == 1);
+    const auto usedWeight = UseWeights.IsIgnored() || UseWeights ? weight : TConstArrayRef<float>();
+
+    // histograms are large, so the range is split into a few parts, not into blocks of ParallelEvalMetric;
+    // parts depend only on the range size to keep the result independent of thread count
+    const int maxPartCount = 16;
+    const int partCount = Min(maxPartCount, CeilDiv(end - begin, GetMinBlockSize(end - begin)));
+    TVector<TMetricHolder> results(partCount);
+    NPar::ParallelFor(executor, 0, partCount, [&](int partId) {
+        const int from = begin + (i64)(end - begin) * partId / partCount;
+        const int to = begin + (i64)(end - begin) * (partId + 1) / partCount;
+        TVector<double> partApprox;
+        TConstArrayRef<double> currentApprox = approx[0];
+        int offset = 0;
+        if (!approxDelta.empty()) {
+            partApprox.yresize(to - from);
+            for (int i = from; i < to; ++i) {
+                partApprox[i - from] = isExpApprox ? approx[0][i] * approxDelta[0][i] : approx[0][i] + approxDelta[0][i];
+            }
+            currentApprox = partApprox;
+            offset = from;
+        }
+        auto& stats = results[partId].Stats;
+        stats.resize(2 * BinCount);
+        AddToAucHistograms(
+            currentApprox,
+            isExpApprox,
+            target.Slice(offset),
+            usedWeight.empty() ? usedWeight : usedWeight.Slice(offset),
+            from - offset,
+            to - offset,
+            MakeArrayRef(stats.data(), BinCount),
+            MakeArrayRef(stats.data() + BinCount, BinCount));
+    });
+
+    if (results.empty()) {
+        return TMetricHolder(2 * BinCount);
+    }
+    NCB::PairwiseReduce(
+        TArrayRef<TMetricHolder>(results),
+        [] (TMetricHolder* dst, const TMetricHolder& add) { dst->Add(add); });
+    return std::move(results[0]);
+}
+
+TString TApproxAUCMetric::GetDescription() const {
+    const TMetricParam<TString> aucType("type", ToString(EAucType::Approx), /*userDefined*/true);
+    const TMetricParam<ui32> binCount("bins", BinCount, /*userDefined*/true);
+    return BuildDescription(ELossFunction::AUC, UseWeights, aucType, binCount);
+}
+
+void TApproxAUCMetric::GetBestValue(EMetricBestValue* valueType, float*) const {
+    *valueType = EMetricBestValue::Max;
+}
+
+double TApproxAUCMetric::GetFinalError(const TMetricHolder& error) const {
+    if (error.Stats.empty()) {
+        return 0;
+    }
+    const TConstArrayRef<double> stats = error.Stats;
+    return CalcAucByHistograms(stats.Slice(0, BinCount), stats.Slice(BinCount));
+}
+
+TVector<TString> TApproxAUCMetric::GetStatDescriptions() const {
+    TVector<TString> result;
+    result.reserve(2 * BinCount);
+    for (auto bin : xrange(BinCount)) {
+        result.push_back(TStringBuilder() << "PositiveWeight" << bin);
+    }
+    for (auto bin : xrange(BinCount)) {
+        result.push_back(TStringBuilder() << "NegativeWeight" << bin);
+    }
+    return result;
+}
+
 TMetricHolder TAUCMetric::Eval(
     const TConstArrayRef<TConstArrayRef<double>> approx,
     const TConstArrayRef<TConstArrayRef<double>> approxDelta,
@@ -3017,242 +3053,6 @@ void TPairAccuracyMetric::GetBestValue(EMetricBestValue* valueType, float*) cons
     *valueType = EMetricBestValue::Max;
 }
 
-/* PrecisionAtK */
-
-namespace {
-    struct TPrecisionAtKMetric: public TAdditiveMetric<TPrecisionAtKMetric> {
-        explicit TPrecisionAtKMetric(int topSize);
-        TMetricHolder EvalSingleThread(
-                const TConstArrayRef<TConstArrayRef<double>> approx,
-                const TConstArrayRef<TConstArrayRef<double>> approxDelta,
-                bool isExpApprox,
-                TConstArrayRef<float> target,
-                TConstArrayRef<float> weight,
-                TConstArrayRef<TQueryInfo> queriesInfo,
-                int queryStartIndex,
-                int queryEndIndex
-        ) const;
-        EErrorType GetErrorType() const override;
-        double GetFinalError(const TMetricHolder& error) const override;
-        TString GetDescription() const override;
-        void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
-    private:
-        const int TopSize;
-        const double TargetBorder = GetDefaultTargetBorder();
-    };
-}
-
-THolder<IMetric> MakePrecisionAtKMetric(int topSize) {
-    return MakeHolder<TPrecisionAtKMetric>(topSize);
-}
-
-TPrecisionAtKMetric::TPrecisionAtKMetric(int topSize)
-        : TopSize(topSize) {
-    UseWeights.SetDefaultValue(true);
-}
-
-TMetricHolder TPrecisionAtKMetric::EvalSingleThread(
-        const TConstArrayRef<TConstArrayRef<double>> approx,
-        const TConstArrayRef<TConstArrayRef<double>> approxDelta,
-        bool isExpApprox,
-        TConstArrayRef<float> target,
-        TConstArrayRef<float> /*weight*/,
-        TConstArrayRef<TQueryInfo> queriesInfo,
-        int queryStartIndex,
-        int queryEndIndex
-) const {
-    Y_ASSERT(approxDelta.empty());
-    Y_ASSERT(!isExpApprox);
-    TMetricHolder error(2);
-    for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
-        int queryBegin = queriesInfo[queryIndex].Begin;
-        int queryEnd = queriesInfo[queryIndex].End;
-
-        TVector<double> approxCopy(approx[0].data() + queryBegin, approx[0].data() + queryEnd);
-        TVector<float> targetCopy(target.begin() + queryBegin, target.begin() + queryEnd);
-
-        error.Stats[0] += CalcPrecisionAtK(approxCopy, targetCopy, TopSize, TargetBorder);
-        error.Stats[1]++;
-    }
-    return error;
-}
-
-EErrorType TPrecisionAtKMetric::GetErrorType() const {
-    return EErrorType::QuerywiseError;
-}
-
-double TPrecisionAtKMetric::GetFinalError(const TMetricHolder& error) const {
-    return error.Stats[1] != 0 ? error.Stats[0] / error.Stats[1] : 1;
-}
-
-TString TPrecisionAtKMetric::GetDescription() const {
-    const TMetricParam<int> topSize("top", TopSize, TopSize != -1);
-    return BuildDescription(ELossFunction::PrecisionAt, UseWeights, topSize, "%.3g", MakeTargetBorderParam(TargetBorder));
-}
-
-void TPrecisionAtKMetric::GetBestValue(EMetricBestValue* valueType, float*) const {
-    *valueType = EMetricBestValue::Max;
-}
-
-/* RecallAtK */
-
-namespace {
-    struct TRecallAtKMetric: public TAdditiveMetric<TRecallAtKMetric> {
-        explicit TRecallAtKMetric(int topSize);
-        TMetricHolder EvalSingleThread(
-                const TConstArrayRef<TConstArrayRef<double>> approx,
-                const TConstArrayRef<TConstArrayRef<double>> approxDelta,
-                bool isExpApprox,
-                TConstArrayRef<float> target,
-                TConstArrayRef<float> weight,
-                TConstArrayRef<TQueryInfo> queriesInfo,
-                int queryStartIndex,
-                int queryEndIndex
-        ) const;
-        EErrorType GetErrorType() const override;
-        double GetFinalError(const TMetricHolder& error) const override;
-        TString GetDescription() const override;
-        void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
-
-    private:
-        const int TopSize;
-        const double TargetBorder = GetDefaultTargetBorder();
-    };
-}
-
-THolder<IMetric> MakeRecallAtKMetric(int topSize) {
-    return MakeHolder<TRecallAtKMetric>(topSize);
-}
-
-TRecallAtKMetric::TRecallAtKMetric(int topSize)
-        : TopSize(topSize) {
-    UseWeights.SetDefaultValue(true);
-}
-
-TMetricHolder TRecallAtKMetric::EvalSingleThread(
-        const TConstArrayRef<TConstArrayRef<double>> approx,
-        const TConstArrayRef<TConstArrayRef<double>> approxDelta,
-        bool isExpApprox,
-        TConstArrayRef<float> target,
-        TConstArrayRef<float> /*weight*/,
-        TConstArrayRef<TQueryInfo> queriesInfo,
-        int queryStartIndex,
-        int queryEndIndex
-) const {
-    Y_ASSERT(approxDelta.empty());
-    Y_ASSERT(!isExpApprox);
-    TMetricHolder error(2);
-    for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
-        int queryBegin = queriesInfo[queryIndex].Begin;
-        int queryEnd = queriesInfo[queryIndex].End;
-
-        TVector<double> approxCopy(approx[0].data() + queryBegin, approx[0].data() + queryEnd);
-        TVector<float> targetCopy(target.begin() + queryBegin, target.begin() + queryEnd);
-
-        error.Stats[0] += CalcRecallAtK(approxCopy, targetCopy, TopSize, TargetBorder);
-        error.Stats[1]++;
-    }
-    return error;
-}
-
-EErrorType TRecallAtKMetric::GetErrorType() const {
-    return EErrorType::QuerywiseError;
-}
-
-double TRecallAtKMetric::GetFinalError(const TMetricHolder& error) const {
-    return error.Stats[1] != 0 ? error.Stats[0] / error.Stats[1] : 1;
-}
-
-TString TRecallAtKMetric::GetDescription() const {
-    const TMetricParam<int> topSize("top", TopSize, TopSize != -1);
-    return BuildDescription(ELossFunction::RecallAt, UseWeights, topSize, "%.3g", MakeTargetBorderParam(TargetBorder));
-}
-
-void TRecallAtKMetric::GetBestValue(EMetricBestValue* valueType, float*) const {
-    *valueType = EMetricBestValue::Max;
-}
-
-/* Mean Average Precision at k */
-
-namespace {
-    struct TMAPKMetric: public TAdditiveMetric<TMAPKMetric> {
-        explicit TMAPKMetric(int topSize);
-        TMetricHolder EvalSingleThread(
-                const TConstArrayRef<TConstArrayRef<double>> approx,
-                const TConstArrayRef<TConstArrayRef<double>> approxDelta,
-                bool isExpApprox,
-                TConstArrayRef<float> target,
-                TConstArrayRef<float> weight,
-                TConstArrayRef<TQueryInfo> queriesInfo,
-                int queryStartIndex,
-                int queryEndIndex
-        ) const;
-        EErrorType GetErrorType() const override;
-        double GetFinalError(const TMetricHolder& error) const override;
-        TString GetDescription() const override;
-        void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
-
-    private:
-        const int TopSize;
-        const double TargetBorder = GetDefaultTargetBorder();
-    };
-}
-
-THolder<IMetric> MakeMAPKMetric(int topSize) {
-    return MakeHolder<TMAPKMetric>(topSize);
-}
-
-TMAPKMetric::TMAPKMetric(int topSize)
-        : TopSize(topSize)
-        , TargetBorder(GetDefaultTargetBorder()) {
-    UseWeights.SetDefaultValue(true);
-}
-
-TMetricHolder TMAPKMetric::EvalSingleThread(
-        const TConstArrayRef<TConstArrayRef<double>> approx,
-        const TConstArrayRef<TConstArrayRef<double>> approxDelta,
-        bool isExpApprox,
-        TConstArrayRef<float> target,
-        TConstArrayRef<float> /*weight*/,
-        TConstArrayRef<TQueryInfo> queriesInfo,
-        int queryStartIndex,
-        int queryEndIndex
-) const {
-    Y_ASSERT(approxDelta.empty());
-    Y_ASSERT(!isExpApprox);
-    TMetricHolder error(2);
-
-    for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
-        int queryBegin = queriesInfo[queryIndex].Begin;
-        int queryEnd = queriesInfo[queryIndex].End;
-
-        TVector<double> approxCopy(approx[0].data() + queryBegin, approx[0].data() + queryEnd);
-        TVector<float> targetCopy(target.data() + queryBegin, target.data() + queryEnd);
-
-        error.Stats[0] += CalcAveragePrecisionK(approxCopy, targetCopy, TopSize, TargetBorder);
-        error.Stats[1]++;
-    }
-    return error;
-}
-
-TString TMAPKMetric::GetDescription() const {
-    const TMetricParam<int> topSize("top", TopSize, TopSize != -1);
-    return BuildDescription(ELossFunction::MAP, UseWeights, topSize, "%.3g", MakeTargetBorderParam(TargetBorder));
-}
-
-EErrorType TMAPKMetric::GetErrorType() const {
-    return EErrorType::QuerywiseError;
-}
-
-// Mean average precision at K
-double TMAPKMetric::GetFinalError(const TMetricHolder& error) const {
-    return error.Stats[1] != 0 ? error.Stats[0] / error.Stats[1] : 0;
-}
-
-void TMAPKMetric::GetBestValue(EMetricBestValue* valueType, float*) const {
-    *valueType = EMetricBestValue::Max;
-}
-
 /* Custom */
 
 namespace {
@@ -4086,7 +3886,7 @@ static TVector<THolder<IMetric>> CreateMetric(ELossFunction metric, const TMap<T
             int topSize = NCatboostOptions::GetParamOrDefault(params, "top", -1);
             auto type = NCatboostOptions::GetParamOrDefault(params, "type", ENdcgMetricType::Base);
             auto denominator = NCatboostOptions::GetParamOrDefault(params, "denominator", ENdcgDenominatorType::LogPosition);
-            result.emplace_back(new TDcgMetric(topSize, type, metric == ELossFunction::NDCG, denominator));
+            result.emplace_back(MakeDcgMetric(topSize, type, metric == ELossFunction::NDCG, denominator));
             validParams = {"top", "type", "denominator"};
             break;
         }
@@ -4106,7 +3906,7 @@ static TVector<THolder<IMetric>> CreateMetric(ELossFunction metric, const TMap<T
                 const TString name = params.at("type");
                 aucType = FromString<EAucType>(name);
                 if (approxDimension == 1) {
-                    CB_ENSURE(aucType == EAucType::Classic || aucType == EAucType::Ranking,
+                    CB_ENSURE(aucType == EAucType::Classic || aucType == EAucType::Ranking || aucType == EAucType::Approx,
                         "AUC type \"" << aucType << "\" isn't a singleclass AUC type");
                 } else {
                     CB_ENSURE(aucType == EAucType::Mu || aucType == EAucType::OneVsAll,
@@ -4122,6 +3922,12 @@ static TVector<THolder<IMetric>> CreateMetric(ELossFunction metric, const TMap<T
                     result.push_back(MakeRankingAucMetric());
                     break;
                 }
+                case EAucType::Approx: {
+                    validParams.insert("bins");
+                    const ui32 defaultBinCount = 1 << 16;
+                    result.push_back(MakeApproxBinClassAucMetric(NCatboostOptions::GetParamOrDefault(params, "bins", defaultBinCount)));
+                    break;
+                }
                 case EAucType::Mu: {
                     validParams.insert("misclass_cost_matrix");
                     TMaybe<TVector<TVector<double>>> misclassCostMatrix = Nothing();
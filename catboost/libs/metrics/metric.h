@@ -7,6 +7,7 @@
 
 #include <catboost/private/libs/data_types/pair.h>
 #include <catboost/private/libs/data_types/query.h>
+#include <catboost/libs/helpers/map_merge.h>
 #include <catboost/libs/helpers/vector_helpers.h>
 #include <catboost/private/libs/options/data_processing_options.h>
 #include <catboost/private/libs/options/enum_helpers.h>
@@ -19,6 +20,7 @@
 
 #include <util/generic/fwd.h>
 #include <util/generic/array_ref.h>
+#include <util/generic/ymath.h>
 
 #include <cmath>
 
@@ -204,17 +206,14 @@ static inline int GetMinBlockSize(int objectCount) {
     return 10000 < objectCount && objectCount < 100000 ? 1000 : 10000;
 }
 
+/* Blocks depend only on the range size and block results are summed pairwise,
+ * so metric values are bitwise identical for any executor thread count.
+ * With many threads it costs nothing, with few threads there is one extra TMetricHolder per block.
+ */
 template <typename TEvalFunction>
 static inline TMetricHolder ParallelEvalMetric(TEvalFunction eval, int minBlockSize, int begin, int end, NPar::TLocalExecutor& executor) {
-    NPar::TLocalExecutor::TExecRangeParams blockParams(begin, end);
-
-    const int threadCount = executor.GetThreadCount() + 1;
-    const int effectiveBlockCount = Min(threadCount, (int)ceil((end - begin) * 1.0 / minBlockSize));
-
-    blockParams.SetBlockCount(effectiveBlockCount);
-
-    const int blockSize = blockParams.GetBlockSize();
-    const ui32 blockCount = blockParams.GetBlockCount();
+    const int blockSize = minBlockSize;
+    const int blockCount = CeilDiv(end - begin, blockSize);
 
     TVector<TMetricHolder> results(blockCount);
     NPar::ParallelFor(executor, 0, blockCount, [&](int blockId) {
@@ -223,12 +222,13 @@ static inline TMetricHolder ParallelEvalMetric(TEvalFunction eval, int minBlockS
         results[blockId] = eval(from, to);
     });
 
-    TMetricHolder result;
-    for (int i = 0; i < results.ysize(); ++i) {
-        result.Add(results[i]);
+    if (results.empty()) {
+        return TMetricHolder();
     }
-    return result;
-
+    NCB::PairwiseReduce(
+        TArrayRef<TMetricHolder>(results),
+        [] (TMetricHolder* dst, const TMetricHolder& add) { dst->Add(add); });
+    return std::move(results[0]);
 }
 
 template <typename TImpl>
@@ -256,8 +256,28 @@ struct TAdditiveMultiRegressionMetric: public TMultiRegressionMetric {
     }
 };
 
+/* Additive metric which is evaluated by summing block results computed in a single thread,
+ * EvalErrorsWithCaching evaluates all such metrics in one pass over the same blocks.
+ */
+struct TBlockwiseAdditiveMetric: public TMetric {
+    virtual TMetricHolder EvalBlock(
+        const TConstArrayRef<TConstArrayRef<double>> approx,
+        const TConstArrayRef<TConstArrayRef<double>> approxDelta,
+        bool isExpApprox,
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weight,
+        TConstArrayRef<TQueryInfo> queriesInfo,
+        int begin,
+        int end
+    ) const = 0;
+
+    bool IsAdditiveMetric() const final {
+        return true;
+    }
+};
+
 template <class TImpl>
-struct TAdditiveMetric: public TMetric {
+struct TAdditiveMetric: public TBlockwiseAdditiveMetric {
     TMetricHolder Eval(
         const TVector<TVector<double>>& approx,
         TConstArrayRef<float> target,
@@ -282,16 +302,25 @@ struct TAdditiveMetric: public TMetric {
         NPar::TLocalExecutor& executor
     ) const final {
         const auto evalMetric = [&](int from, int to) {
-            return static_cast<const TImpl*>(this)->EvalSingleThread(
-                approx, approxDelta, isExpApprox, target, UseWeights.IsIgnored() || UseWeights ? weight : TVector<float>{}, queriesInfo, from, to
-            );
+            return EvalBlock(approx, approxDelta, isExpApprox, target, weight, queriesInfo, from, to);
         };
 
         return ParallelEvalMetric(evalMetric, GetMinBlockSize(end - begin), begin, end, executor);
     }
 
-    bool IsAdditiveMetric() const final {
-        return true;
+    TMetricHolder EvalBlock(
+        const TConstArrayRef<TConstArrayRef<double>> approx,
+        const TConstArrayRef<TConstArrayRef<double>> approxDelta,
+        bool isExpApprox,
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weight,
+        TConstArrayRef<TQueryInfo> queriesInfo,
+        int begin,
+        int end
+    ) const final {
+        return static_cast<const TImpl*>(this)->EvalSingleThread(
+            approx, approxDelta, isExpApprox, target, UseWeights.IsIgnored() || UseWeights ? weight : TVector<float>{}, queriesInfo, begin, end
+        );
     }
 };
 
@@ -359,6 +388,9 @@ THolder<IMetric> MakeBinClassAucMetric();
 THolder<IMetric> MakeRankingAucMetric();
 THolder<IMetric> MakeMultiClassAucMetric(int positiveClass);
 THolder<IMetric> MakeMuAucMetric(const TMaybe<TVector<TVector<double>>>& misclassCostMatrix = Nothing());
+THolder<IMetric> MakeApproxBinClassAucMetric(ui32 binCount);
+// metric created by MakeBinClassAucMetric, it can be computed by TStagedBinClassAucCalcer
+bool IsBinClassAucMetric(const IMetric& metric);
 
 THolder<IMetric> MakeBinClassPrecisionMetric(double predictionBorder = GetDefaultPredictionBorder());
 THolder<IMetric> MakeMultiClassPrecisionMetric(int classesCount, int positiveClass);
@@ -474,4 +474,89 @@ Y_UNIT_TEST_SUITE(AUCMetricTests) {
         TestBinClassAucRandom(2000, 1000, false, EPS);
         TestBinClassAucRandom(2000, 2000, false, EPS);
     }
+
+    Y_UNIT_TEST(StagedBinClassAucTest) {
+        const ui32 size = 2000;
+        TFastRng<ui64> rng(239);
+        TRandom rnd(239);
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(3);
+        TVector<float> target(size);
+        TVector<float> weight(size);
+        for (ui32 i = 0; i < size; ++i) {
+            target[i] = rnd(3) / 2.0f;
+            weight[i] = 1 + rnd(5);
+        }
+        TStagedBinClassAucCalcer stagedCalcer(target, weight);
+        TVector<double> approx = RandomVector(size, 100, rnd, rng);
+        for (ui32 stage = 0; stage < 10; ++stage) {
+            for (ui32 i = 0; i < size; ++i) {
+                approx[i] += rnd(2) ? 0.1 / (stage + 1) : 0.0;
+            }
+            TVector<NMetrics::TBinClassSample> positiveSamples, negativeSamples;
+            for (ui32 i = 0; i < size; ++i) {
+                if (target[i] > 0) {
+                    positiveSamples.emplace_back(approx[i], target[i] * weight[i]);
+                }
+                if (target[i] < 1) {
+                    negativeSamples.emplace_back(approx[i], (1 - target[i]) * weight[i]);
+                }
+            }
+            UNIT_ASSERT_DOUBLES_EQUAL(
+                stagedCalcer.Calc(approx, &executor),
+                CalcBinClassAuc(&positiveSamples, &negativeSamples, &executor),
+                EPS);
+        }
+    }
+
+    Y_UNIT_TEST(AucByHistogramsTest) {
+        const ui32 size = 10000;
+        const ui32 binCount = 1024;
+        TFastRng<ui64> rng(239);
+        TRandom rnd(239);
+        TVector<double> approx = RandomVector(size, size, rnd, rng);
+        TVector<float> target(size);
+        TVector<float> weight(size);
+        TVector<NMetrics::TBinClassSample> positiveSamples, negativeSamples;
+        for (ui32 i = 0; i < size; ++i) {
+            approx[i] = 10 * (approx[i] - 0.5);
+            target[i] = rnd(3) / 2.0f;
+            weight[i] = 1 + rnd(5);
+            if (target[i] > 0) {
+                positiveSamples.emplace_back(approx[i], target[i] * weight[i]);
+            }
+            if (target[i] < 1) {
+                negativeSamples.emplace_back(approx[i], (1 - target[i]) * weight[i]);
+            }
+        }
+
+        // histograms of two parts are summed
+        TVector<double> positiveWeights(binCount), negativeWeights(binCount);
+        AddToAucHistograms(approx, /*isExpApprox*/false, target, weight, 0, size / 3, positiveWeights, negativeWeights);
+        AddToAucHistograms(approx, /*isExpApprox*/false, target, weight, size / 3, size, positiveWeights, negativeWeights);
+
+        double positiveWeightSum = 0, negativeWeightSum = 0, sameBinPairWeightSum = 0;
+        for (ui32 bin = 0; bin < binCount; ++bin) {
+            positiveWeightSum += positiveWeights[bin];
+            negativeWeightSum += negativeWeights[bin];
+            sameBinPairWeightSum += positiveWeights[bin] * negativeWeights[bin];
+        }
+        const double errorBound = 0.5 * sameBinPairWeightSum / (positiveWeightSum * negativeWeightSum);
+        UNIT_ASSERT(errorBound < 1e-2);
+        UNIT_ASSERT_DOUBLES_EQUAL(
+            CalcAucByHistograms(positiveWeights, negativeWeights),
+            CalcBinClassAuc(&positiveSamples, &negativeSamples),
+            errorBound + EPS);
+
+        TVector<double> expApprox(approx);
+        for (auto& value : expApprox) {
+            value = exp(value);
+        }
+        TVector<double> expPositiveWeights(binCount), expNegativeWeights(binCount);
+        AddToAucHistograms(expApprox, /*isExpApprox*/true, target, weight, 0, size, expPositiveWeights, expNegativeWeights);
+        UNIT_ASSERT_DOUBLES_EQUAL(
+            CalcAucByHistograms(expPositiveWeights, expNegativeWeights),
+            CalcAucByHistograms(positiveWeights, negativeWeights),
+            1e-3);
+    }
 }
@@ -0,0 +1,55 @@
+#include <library/unittest/registar.h>
+#include <catboost/libs/metrics/caching_metric.h>
+#include <catboost/libs/metrics/metric.h>
+#include <catboost/libs/metrics/metric_holder.h>
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+Y_UNIT_TEST_SUITE(EvalErrorsWithCachingTest) {
+Y_UNIT_TEST(FusedAdditiveMetricsTest) {
+    TFastRng<ui64> rng(17);
+    TVector<TVector<double>> approx(1);
+    TVector<float> target;
+    TVector<float> weight;
+    TVector<TQueryInfo> queries;
+    while (target.size() < 25000) {
+        const ui32 querySize = 1 + rng.Uniform(10);
+        queries.emplace_back(target.size(), target.size() + querySize);
+        for (ui32 i = 0; i < querySize; ++i) {
+            approx[0].push_back(rng.GenRandReal1() * 4 - 2);
+            target.push_back(rng.Uniform(2));
+            weight.push_back(rng.GenRandReal1() + 0.5);
+        }
+    }
+
+    TVector<THolder<IMetric>> metrics;
+    metrics.push_back(MakeRMSEMetric());
+    metrics.push_back(MakeCrossEntropyMetric(ELossFunction::Logloss));
+    metrics.push_back(MakeBinClassAucMetric());
+    metrics.push_back(MakeQueryRMSEMetric());
+    metrics.push_back(MakeQuerySoftMaxMetric());
+    TSet<TString> validParams;
+    for (auto& metric : CreateCachingMetrics(ELossFunction::F1, {}, /*approxDimension*/1, &validParams)) {
+        metrics.push_back(std::move(metric));
+    }
+    TVector<const IMetric*> metricPtrs;
+    for (const auto& metric : metrics) {
+        metricPtrs.push_back(metric.Get());
+    }
+
+    NPar::TLocalExecutor executor;
+    executor.RunAdditionalThreads(3);
+    const auto fusedErrors = EvalErrorsWithCaching(approx, /*approxDelta*/{}, /*isExpApprox*/false, target, weight, queries, metricPtrs, &executor);
+
+    UNIT_ASSERT_VALUES_EQUAL(fusedErrors.size(), metrics.size());
+    for (auto metricIdx : xrange(metrics.size())) {
+        const auto& metric = metrics[metricIdx];
+        const auto end = metric->GetErrorType() == EErrorType::PerObjectError ? target.size() : queries.size();
+        const auto error = metric->Eval(approx, target, weight, queries, 0, end, executor);
+        UNIT_ASSERT_VALUES_EQUAL(error.Stats, fusedErrors[metricIdx].Stats);
+    }
+}
+}
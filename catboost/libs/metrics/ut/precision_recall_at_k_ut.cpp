@@ -1,6 +1,13 @@
 #include <library/unittest/registar.h>
+#include <catboost/libs/metrics/caching_metric.h>
+#include <catboost/libs/metrics/dcg.h>
 #include <catboost/libs/metrics/metric.h>
 #include <catboost/libs/metrics/metric_holder.h>
+#include <catboost/libs/metrics/precision_recall_at_k.h>
+#include <catboost/libs/metrics/sample.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
 
 Y_UNIT_TEST_SUITE(PrecisionAtKMetricTest) {
 
@@ -98,4 +105,54 @@ Y_UNIT_TEST(MAPAtKTest) {
         UNIT_ASSERT_DOUBLES_EQUAL(metric->GetFinalError(score), 0.25, 1e-3);
     }
 }
+
+Y_UNIT_TEST(FusedRankingMetricsTest) {
+    TFastRng<ui64> rng(239);
+    TVector<TVector<double>> approx(1);
+    TVector<float> target;
+    TVector<TQueryInfo> queries;
+    for (ui32 queryIdx = 0; queryIdx < 300; ++queryIdx) {
+        const ui32 querySize = 1 + rng.Uniform(20);
+        queries.emplace_back(target.size(), target.size() + querySize);
+        for (ui32 i = 0; i < querySize; ++i) {
+            approx[0].push_back(rng.Uniform(5));
+            target.push_back(rng.Uniform(3) / 2.0f);
+        }
+    }
+
+    TVector<THolder<IMetric>> metrics;
+    metrics.push_back(MakePrecisionAtKMetric(3));
+    metrics.push_back(MakeRecallAtKMetric(3));
+    metrics.push_back(MakeMAPKMetric(3));
+    metrics.push_back(MakeMAPKMetric());
+    metrics.push_back(MakeDcgMetric(3));
+    TVector<const IMetric*> metricPtrs;
+    for (const auto& metric : metrics) {
+        metricPtrs.push_back(metric.Get());
+    }
+
+    NPar::TLocalExecutor executor;
+    executor.RunAdditionalThreads(3);
+    const auto fusedErrors = EvalErrorsWithCaching(approx, /*approxDelta*/{}, /*isExpApprox*/false, target, /*weight*/{}, queries, metricPtrs, &executor);
+
+    TVector<double> expectedSums(metrics.size());
+    for (const auto& query : queries) {
+        const auto queryApprox = MakeArrayRef(approx[0].data() + query.Begin, query.End - query.Begin);
+        const auto queryTarget = MakeArrayRef(target.data() + query.Begin, query.End - query.Begin);
+        expectedSums[0] += CalcPrecisionAtK(queryApprox, queryTarget, 3, 0.5);
+        expectedSums[1] += CalcRecallAtK(queryApprox, queryTarget, 3, 0.5);
+        expectedSums[2] += CalcAveragePrecisionK(queryApprox, queryTarget, 3, 0.5);
+        expectedSums[3] += CalcAveragePrecisionK(queryApprox, queryTarget, -1, 0.5);
+        TVector<double> doubleTarget(queryTarget.begin(), queryTarget.end());
+        const auto samples = NMetrics::TSample::FromVectors(doubleTarget, TVector<double>(queryApprox.begin(), queryApprox.end()));
+        expectedSums[4] += CalcNdcg(samples, ENdcgMetricType::Base, 3);
+    }
+    for (auto metricIdx : xrange(metrics.size())) {
+        UNIT_ASSERT_DOUBLES_EQUAL(fusedErrors[metricIdx].Stats[0], expectedSums[metricIdx], 1e-9);
+        UNIT_ASSERT_DOUBLES_EQUAL(fusedErrors[metricIdx].Stats[1], queries.size(), 1e-9);
+
+        const auto error = metrics[metricIdx]->Eval(approx, target, /*weight*/{}, queries, 0, queries.size(), executor);
+        UNIT_ASSERT_VALUES_EQUAL(error.Stats, fusedErrors[metricIdx].Stats);
+    }
+}
 }
@@ -321,6 +321,31 @@ static void InitializeSamplingStructures(
         defaultCalcStatsObjBlockSize,
         GetBernoulliSampleRate(ctx->Params.ObliviousTreeOptions->BootstrapConfig)
     ); // TODO(espetrov): create only if sample rate < 1
+    if (ctx->NumaExecutors) {
+        ctx->SampledDocs.InterleaveByFirstTouch(ctx->NumaExecutors.Get());
+        if (ctx->UseTreeLevelCaching()) {
+            ctx->SmallestSplitSideDocs.InterleaveByFirstTouch(ctx->NumaExecutors.Get());
+        }
+    }
+    if (NeedToUseSplitScreening(ctx->Params)) {
+        ctx->ScreeningDocs.Create(
+            ctx->LearnProgress->Folds,
+            isPairwiseScoring,
+            data.EstimatedObjectsData.GetFeatureCount() != 0,
+            defaultCalcStatsObjBlockSize,
+            ctx->Params.ObliviousTreeOptions->DevSplitScreeningSampleRate
+        );
+    }
+}
+
+static void LogSplitScreeningStats(const TSplitScreeningStats& stats) {
+    if (stats.ScreenedLevelCount == 0) {
+        return;
+    }
+    CATBOOST_INFO_LOG << "Split screening: " << stats.ScreenedLevelCount << " tree levels, "
+        << "screening leader overturned on " << stats.LeaderOverturnedCount << ", "
+        << "winner was the last rescored candidate on " << stats.WinnerAtTopCountBoundaryCount
+        << " (increase dev_split_screening_top_count if this is frequent)" << Endl;
 }
 
 static void LogThatStoppingOccured(const TErrorTracker& errorTracker) {
@@ -374,6 +399,7 @@ static void Train(
     const auto onSaveSnapshotCallback = [&] (IOutputStream* out) {
         trainingCallbacks->OnSaveSnapshot(out);
     };
+    const ui32 rebalancePeriod = ctx->Params.SystemOptions->DevDistributedRebalancePeriod.Get();
 
     for (ui32 iter = ctx->LearnProgress->GetCurrentTrainingIterationCount();
          continueTraining && (iter < ctx->Params.BoostingOptions->IterationCount);
@@ -393,6 +419,11 @@ static void Train(
             timer.Reset();
         }
 
+        if (ctx->Params.SystemOptions->IsMaster() && rebalancePeriod && iter && (iter % rebalancePeriod == 0)) {
+            MapRebalanceWorkers(data, ctx);
+            profile.AddOperation("Rebalance workers");
+        }
+
         TrainOneIteration(data, ctx);
 
         CalcErrors(data, metricsData, iter, ctx);
@@ -453,6 +484,8 @@ static void Train(
 
     ctx->SaveProgress(onSaveSnapshotCallback);
 
+    LogSplitScreeningStats(ctx->SplitScreeningStats);
+
     if (hasTest) {
         (*testMultiApprox) = ctx->LearnProgress->TestApprox;
         if (useBestModel) {
@@ -978,6 +1011,15 @@ static void TrainModel(
     const bool haveLearnFeaturesInMemory = HaveLearnFeaturesInMemory(poolLoadOptions, catBoostOptions);
     CB_ENSURE_INTERNAL(
         haveLearnFeaturesInMemory || poolLoadOptions, "Learn dataset is not loaded, and load options are not provided");
+    if (catBoostOptions.SystemOptions->IsMaster()) {
+        InitializeMaster(catBoostOptions.SystemOptions);
+        if (haveLearnFeaturesInMemory && catBoostOptions.SystemOptions->DevDistributedQuantization.Get()) {
+            CalcFloatFeaturesQuantizationOnWorkers(
+                poolLoadOptions,
+                pools.Learn->MetaInfo,
+                quantizedFeaturesInfo.Get());
+        }
+    }
     TTrainingDataProviders trainingData = GetTrainingData(
         needInitModelApplyCompatiblePools ? pools : std::move(pools),
         /* borders */ Nothing(), // borders are already loaded to quantizedFeaturesInfo
@@ -991,7 +1033,13 @@ static void TrainModel(
         &rand,
         initModel);
     if (catBoostOptions.SystemOptions->IsMaster()) {
-        InitializeMaster(catBoostOptions.SystemOptions);
+        if (catBoostOptions.SystemOptions->DevDistributedRebalancePeriod.Get()
+            && (!haveLearnFeaturesInMemory
+                || catBoostOptions.SystemOptions->DevDistributedMode.Get() == EDistributedMode::FeatureParallel))
+        {
+            CATBOOST_WARNING_LOG << "Learn objects are not redistributed between workers "
+                "if workers load the quantized dataset themselves or in feature-parallel mode" << Endl;
+        }
         if (!haveLearnFeaturesInMemory) {
             SetTrainDataFromQuantizedPool(
                 *poolLoadOptions,
@@ -939,7 +939,13 @@ void CalcLeafValues(
     TVector<TVector<double>>* leafDeltas,
     TVector<TIndexType>* indices) {
 
-    *indices = BuildIndices(fold, tree, data, EBuildIndicesDataParts::All, ctx->LocalExecutor);
+    *indices = BuildIndices(
+        fold,
+        tree,
+        data,
+        EBuildIndicesDataParts::All,
+        ctx->LocalExecutor,
+        &ctx->LearnLeafIndices);
     const int approxDimension = ctx->LearnProgress->AveragingFold.GetApproxDimension();
     Y_VERIFY(fold.GetLearnSampleCount() == data.Learn->GetObjectCount());
     const int leafCount = GetLeafCount(tree);
@@ -971,7 +977,8 @@ void CalcApproxForLeafStruct(
         tree,
         data,
         EBuildIndicesDataParts::LearnOnly,
-        ctx->LocalExecutor);
+        ctx->LocalExecutor,
+        &ctx->LearnLeafIndices);
     const int approxDimension = ctx->LearnProgress->ApproxDimension;
     const int leafCount = GetLeafCount(tree);
     const auto treeMonotoneConstraints = GetTreeMonotoneConstraints(
@@ -1,5 +1,6 @@
 #include "calc_score_cache.h"
 
+#include <catboost/libs/helpers/numa.h>
 #include <catboost/libs/helpers/restorable_rng.h>
 #include <catboost/private/libs/options/oblivious_tree_options.h>
 
@@ -291,6 +292,32 @@ void TCalcScoreFold::Create(
     LeavesBounds.assign(1, {0, static_cast<ui32>(DocCount)});
 }
 
+template <typename TData>
+static void InterleaveVectorByFirstTouch(TVector<TData>* data, NCB::TNumaExecutors* numaExecutors) {
+    static_assert(std::is_trivially_copyable<TData>::value, "Only plain data can be zero-filled");
+    numaExecutors->InterleaveByFirstTouch(
+        TArrayRef<char>(reinterpret_cast<char*>(data->data()), data->size() * sizeof(TData)));
+}
+
+void TCalcScoreFold::InterleaveByFirstTouch(NCB::TNumaExecutors* numaExecutors) {
+    InterleaveVectorByFirstTouch<TIndexType>(&Indices, numaExecutors);
+    // Sample and SelectSmallestSplitSide resize it to at most DocCount, so memory is not reallocated
+    LearnPermutationFeaturesSubset.Get<NCB::TIndexedSubset<ui32>>().yresize(DocCount);
+    InterleaveVectorByFirstTouch(
+        &LearnPermutationFeaturesSubset.Get<NCB::TIndexedSubset<ui32>>(),
+        numaExecutors);
+    InterleaveVectorByFirstTouch<ui32>(&IndexInFold, numaExecutors);
+    InterleaveVectorByFirstTouch<float>(&LearnWeights, numaExecutors);
+    InterleaveVectorByFirstTouch<float>(&SampleWeights, numaExecutors);
+    for (int bodyTailIdx = 0; bodyTailIdx < BodyTailCount; ++bodyTailIdx) {
+        auto& bodyTail = BodyTailArr[bodyTailIdx];
+        for (int dimIdx = 0; dimIdx < ApproxDimension; ++dimIdx) {
+            InterleaveVectorByFirstTouch<double>(&bodyTail.WeightedDerivatives[dimIdx], numaExecutors);
+            InterleaveVectorByFirstTouch<double>(&bodyTail.SampleWeightedDerivatives[dimIdx], numaExecutors);
+        }
+    }
+}
+
 template <typename TSrcRef, typename TGetElementFunc, typename TDstRef>
 static inline void SetElements(
     TArrayRef<const bool> srcControlRef,
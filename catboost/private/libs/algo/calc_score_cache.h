@@ -23,6 +23,10 @@ namespace NCatboostOptions {
     class TObliviousTreeLearnerOptions;
 }
 
+namespace NCB {
+    class TNumaExecutors;
+}
+
 
 bool IsSamplingPerTree(const NCatboostOptions::TObliviousTreeLearnerOptions& fitParams);
 
@@ -236,6 +240,8 @@ public:
         int defaultCalcStatsObjBlockSize,
         float sampleRate = 1.0f
     );
+    // must be called right after Create, pages of arrays not filled yet are interleaved between NUMA nodes
+    void InterleaveByFirstTouch(NCB::TNumaExecutors* numaExecutors);
     void SelectSmallestSplitSide(
         int curDepth,
         const TCalcScoreFold& fold,
@@ -9,6 +9,7 @@
 #include "learn_context.h"
 #include "monotonic_constraint_utils.h"
 #include "nonsymmetric_index_calcer.h"
+#include "numa_placement.h"
 #include "scoring.h"
 #include "split.h"
 #include "tensor_search_helpers.h"
@@ -617,6 +618,8 @@ static void SelectCtrsToDropAfterCalc(
 static void CalcBestScore(
     const TTrainingDataProviders& data,
     const TSplitTree& currentTree,
+    const TCalcScoreFold& sampledDocs,
+    bool useTreeLevelCaching,
     ui64 randSeed,
     double scoreStDev,
     TVector<TCandidatesContext>* candidatesContexts,
@@ -640,84 +643,249 @@ static void CalcBestScore(
         }
     }
 
-    ctx->LocalExecutor->ExecRange(
-        [&] (int taskIdx) {
-            TCandidatesContext& candidatesContext = (*candidatesContexts)[tasks[taskIdx].first];
-            TCandidateList& candList = candidatesContext.CandidateList;
+    // localExecutor is used for parallelism inside the task
+    const auto calcTask = [&] (int taskIdx, NPar::TLocalExecutor* localExecutor) {
+        TCandidatesContext& candidatesContext = (*candidatesContexts)[tasks[taskIdx].first];
+        TCandidateList& candList = candidatesContext.CandidateList;
+
+        auto& candidate = candList[tasks[taskIdx].second];
+
+        const auto& splitEnsemble = candidate.Candidates[0].SplitEnsemble;
+
+        if (splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr)) {
+            const auto& proj = splitEnsemble.SplitCandidate.Ctr.Projection;
+            if (fold->GetCtrRef(proj).Feature.empty()) {
+                ComputeOnlineCTRs(
+                    data,
+                    *fold,
+                    proj,
+                    ctx,
+                    localExecutor,
+                    &fold->GetCtrRef(proj));
+            }
+        }
+        TVector<TVector<double>> allScores(candidate.Candidates.size());
+        localExecutor->ExecRange(
+            [&](int oneCandidate) {
+                THolder<IScoreCalcer> scoreCalcer;
+                if (IsPairwiseScoring(ctx->Params.LossFunctionDescription->GetLossFunction())) {
+                    scoreCalcer.Reset(new TPairwiseScoreCalcer);
+                } else {
+                    scoreCalcer = MakePointwiseScoreCalcer(
+                        ctx->Params.ObliviousTreeOptions->ScoreFunction
+                    );
+                }
 
-            auto& candidate = candList[tasks[taskIdx].second];
+                CalcStatsAndScores(
+                    *candidatesContext.LearnData,
+                    fold->GetAllCtrs(),
+                    sampledDocs,
+                    ctx->SmallestSplitSideDocs,
+                    fold,
+                    pairs,
+                    ctx->Params,
+                    candidate.Candidates[oneCandidate],
+                    currentTree.GetDepth(),
+                    useTreeLevelCaching,
+                    currTreeMonotonicConstraints,
+                    monotonicConstraints,
+                    localExecutor,
+                    &ctx->PrevTreeLevelStats,
+                    /*stats3d*/nullptr,
+                    /*pairwiseStats*/nullptr,
+                    scoreCalcer.Get());
+                scoreCalcer->GetScores().swap(allScores[oneCandidate]);
+            },
+            0,
+            candidate.Candidates.ysize(),
+            NPar::TLocalExecutor::WAIT_COMPLETE);
 
-            const auto& splitEnsemble = candidate.Candidates[0].SplitEnsemble;
+        if (splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr) && candidate.ShouldDropCtrAfterCalc) {
+            fold->GetCtrRef(splitEnsemble.SplitCandidate.Ctr.Projection).Feature.clear();
+        }
 
-            if (splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr)) {
-                const auto& proj = splitEnsemble.SplitCandidate.Ctr.Projection;
-                if (fold->GetCtrRef(proj).Feature.empty()) {
-                    ComputeOnlineCTRs(
-                        data,
-                        *fold,
-                        proj,
-                        ctx,
-                        &fold->GetCtrRef(proj));
-                }
-            }
-            TVector<TVector<double>> allScores(candidate.Candidates.size());
-            ctx->LocalExecutor->ExecRange(
-                [&](int oneCandidate) {
-                    THolder<IScoreCalcer> scoreCalcer;
-                    if (IsPairwiseScoring(ctx->Params.LossFunctionDescription->GetLossFunction())) {
-                        scoreCalcer.Reset(new TPairwiseScoreCalcer);
-                    } else {
-                        scoreCalcer = MakePointwiseScoreCalcer(
-                            ctx->Params.ObliviousTreeOptions->ScoreFunction
-                        );
-                    }
+        SetBestScore(
+            randSeed + taskIdx,
+            allScores,
+            scoreStDev,
+            candidatesContext,
+            &candidate.Candidates);
 
-                    CalcStatsAndScores(
-                        *candidatesContext.LearnData,
-                        fold->GetAllCtrs(),
-                        ctx->SampledDocs,
-                        ctx->SmallestSplitSideDocs,
-                        fold,
-                        pairs,
-                        ctx->Params,
-                        candidate.Candidates[oneCandidate],
-                        currentTree.GetDepth(),
-                        ctx->UseTreeLevelCaching(),
-                        currTreeMonotonicConstraints,
-                        monotonicConstraints,
-                        ctx->LocalExecutor,
-                        &ctx->PrevTreeLevelStats,
-                        /*stats3d*/nullptr,
-                        /*pairwiseStats*/nullptr,
-                        scoreCalcer.Get());
-                    scoreCalcer->GetScores().swap(allScores[oneCandidate]);
-                },
-                0,
-                candidate.Candidates.ysize(),
-                NPar::TLocalExecutor::WAIT_COMPLETE);
+        AddFeaturePenaltiesToBestSplits(
+            ctx,
+            data,
+            *fold,
+            candidatesContext.OneHotMaxSize,
+            &candidate.Candidates
+        );
+    };
 
-            if (splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr) && candidate.ShouldDropCtrAfterCalc) {
-                fold->GetCtrRef(splitEnsemble.SplitCandidate.Ctr.Projection).Feature.clear();
+    if (ctx->NumaExecutors) {
+        /* candidates are scored on the node their quantized columns are placed on,
+         * so their stats are allocated in node-local memory as well
+         */
+        auto& numaExecutors = *ctx->NumaExecutors;
+        TVector<TVector<int>> nodeTasks(numaExecutors.GetNodeCount());
+        for (auto taskIdx : xrange(tasks.ysize())) {
+            const auto& candidate = (*candidatesContexts)[tasks[taskIdx].first].CandidateList[tasks[taskIdx].second];
+            nodeTasks[GetNumaNode(candidate.Candidates[0].SplitEnsemble, numaExecutors)].push_back(taskIdx);
+        }
+        numaExecutors.ExecOnEachNode(
+            [&] (ui32 nodeIdx) {
+                auto& nodeExecutor = numaExecutors.GetNodeExecutor(nodeIdx);
+                nodeExecutor.ExecRange(
+                    [&] (int nodeTaskIdx) {
+                        calcTask(nodeTasks[nodeIdx][nodeTaskIdx], &nodeExecutor);
+                    },
+                    0,
+                    nodeTasks[nodeIdx].ysize(),
+                    NPar::TLocalExecutor::WAIT_COMPLETE);
+            });
+    } else {
+        ctx->LocalExecutor->ExecRange(
+            [&] (int taskIdx) {
+                calcTask(taskIdx, ctx->LocalExecutor);
+            },
+            0,
+            tasks.ysize(),
+            NPar::TLocalExecutor::WAIT_COMPLETE);
+    }
+}
+
+namespace {
+    struct TCandidatePosition {
+        size_t ContextIdx;
+        size_t SubListIdx;
+        size_t CandidateIdx;
+    };
+}
+
+/* Two-stage split search: all candidates are scored on a small subsample of the fold,
+ * then only the DevSplitScreeningTopCount best of them are rescored on ctx->SampledDocs.
+ * Candidates not rescored are removed from candidatesContexts.
+ */
+static void CalcBestScoreWithScreening(
+    const TTrainingDataProviders& data,
+    const TSplitTree& currentTree,
+    const TVector<TIndexType>& indices,
+    ui64 randSeed,
+    double scoreStDev,
+    TVector<TCandidatesContext>* candidatesContexts,
+    TFold* fold,
+    TLearnContext* ctx) {
+
+    ctx->ScreeningDocs.Sample(
+        *fold,
+        ctx->Params.ObliviousTreeOptions->BootstrapConfig->GetSamplingUnit(),
+        !ctx->LearnProgress->EstimatedFeaturesContext.OfflineEstimatedFeaturesLayout.empty(),
+        indices,
+        &ctx->LearnProgress->Rand,
+        ctx->LocalExecutor);
+
+    // noise is not needed for screening, it is added on rescoring
+    CalcBestScore(
+        data,
+        currentTree,
+        ctx->ScreeningDocs,
+        /*useTreeLevelCaching*/ false,
+        randSeed,
+        /*scoreStDev*/ 0.0,
+        candidatesContexts,
+        fold,
+        ctx);
+
+    TVector<TCandidatePosition> positions;
+    for (auto contextIdx : xrange(candidatesContexts->size())) {
+        const auto& candidateList = (*candidatesContexts)[contextIdx].CandidateList;
+        for (auto subListIdx : xrange(candidateList.size())) {
+            for (auto candidateIdx : xrange(candidateList[subListIdx].Candidates.size())) {
+                positions.push_back(TCandidatePosition{contextIdx, subListIdx, candidateIdx});
             }
+        }
+    }
+    const auto getScreeningScore = [&] (const TCandidatePosition& position) {
+        return (*candidatesContexts)[position.ContextIdx]
+            .CandidateList[position.SubListIdx]
+            .Candidates[position.CandidateIdx].BestScore.Val;
+    };
+    const size_t candidateCount = positions.size();
+    const size_t topCount = Min<size_t>(ctx->Params.ObliviousTreeOptions->DevSplitScreeningTopCount, candidateCount);
+    PartialSort(
+        positions.begin(),
+        positions.begin() + topCount,
+        positions.end(),
+        [&] (const TCandidatePosition& lhs, const TCandidatePosition& rhs) {
+            return getScreeningScore(lhs) > getScreeningScore(rhs);
+        });
+    positions.resize(topCount);
+
+    // rescored candidates are kept in their original order
+    TVector<TVector<TVector<int>>> screeningRanks(candidatesContexts->size()); // [contextIdx][subListIdx][candidateIdx]
+    for (auto contextIdx : xrange(candidatesContexts->size())) {
+        const auto& candidateList = (*candidatesContexts)[contextIdx].CandidateList;
+        screeningRanks[contextIdx].resize(candidateList.size());
+        for (auto subListIdx : xrange(candidateList.size())) {
+            screeningRanks[contextIdx][subListIdx].resize(candidateList[subListIdx].Candidates.size(), -1);
+        }
+    }
+    for (auto rank : xrange(positions.size())) {
+        const auto& position = positions[rank];
+        screeningRanks[position.ContextIdx][position.SubListIdx][position.CandidateIdx] = rank;
+    }
 
-            SetBestScore(
-                randSeed + taskIdx,
-                allScores,
-                scoreStDev,
-                candidatesContext,
-                &candidate.Candidates);
+    TVector<int> rescoredRanks; // in the order of candidates left in candidatesContexts
+    for (auto contextIdx : xrange(candidatesContexts->size())) {
+        TCandidateList& candidateList = (*candidatesContexts)[contextIdx].CandidateList;
+        TCandidateList rescoredCandidateList;
+        for (auto subListIdx : xrange(candidateList.size())) {
+            TCandidatesInfoList rescoredSubList;
+            rescoredSubList.ShouldDropCtrAfterCalc = candidateList[subListIdx].ShouldDropCtrAfterCalc;
+            for (auto candidateIdx : xrange(candidateList[subListIdx].Candidates.size())) {
+                const int rank = screeningRanks[contextIdx][subListIdx][candidateIdx];
+                if (rank != -1) {
+                    rescoredSubList.Candidates.push_back(candidateList[subListIdx].Candidates[candidateIdx]);
+                    rescoredRanks.push_back(rank);
+                }
+            }
+            if (!rescoredSubList.Candidates.empty()) {
+                rescoredCandidateList.push_back(std::move(rescoredSubList));
+            }
+        }
+        candidateList = std::move(rescoredCandidateList);
+    }
 
-            AddFeaturePenaltiesToBestSplits(
-                ctx,
-                data,
-                *fold,
-                candidatesContext.OneHotMaxSize,
-                &candidate.Candidates
-            );
-        },
-        0,
-        tasks.ysize(),
-        NPar::TLocalExecutor::WAIT_COMPLETE);
+    CalcBestScore(
+        data,
+        currentTree,
+        ctx->SampledDocs,
+        /*useTreeLevelCaching*/ false,
+        randSeed + 1,
+        scoreStDev,
+        candidatesContexts,
+        fold,
+        ctx);
+
+    double bestScore = MINIMAL_SCORE;
+    int winnerRank = -1;
+    size_t rescoredIdx = 0;
+    for (const auto& candidatesContext : *candidatesContexts) {
+        for (const auto& subList : candidatesContext.CandidateList) {
+            for (const auto& candidate : subList.Candidates) {
+                if (candidate.BestScore.Val > bestScore) {
+                    bestScore = candidate.BestScore.Val;
+                    winnerRank = rescoredRanks[rescoredIdx];
+                }
+                ++rescoredIdx;
+            }
+        }
+    }
+    auto& stats = ctx->SplitScreeningStats;
+    ++stats.ScreenedLevelCount;
+    stats.LeaderOverturnedCount += (winnerRank > 0);
+    // when all candidates are rescored nothing could be missed
+    stats.WinnerAtTopCountBoundaryCount += (topCount < candidateCount) && (winnerRank + 1 == SafeIntegerCast<int>(topCount));
+    CATBOOST_DEBUG_LOG << "Split screening: exact winner has screening rank " << winnerRank
+        << " of " << topCount << " rescored" << Endl;
 }
 
 static void DoBootstrap(
@@ -790,6 +958,7 @@ static void CalcBestScoreLeafwise(
                         *fold,
                         proj,
                         ctx,
+                        ctx->LocalExecutor,
                         &fold->GetCtrRef(proj));
                 }
             }
@@ -843,6 +1012,7 @@ static double CalcScoreStDev(
 static void CalcScores(
     const TTrainingDataProviders& data,
     const TSplitTree& currentSplitTree,
+    const TVector<TIndexType>& indices,
     const double scoreStDev,
     TVector<TCandidatesContext>* candidatesContexts, // [dataset]
     TFold* fold,
@@ -865,10 +1035,22 @@ static void CalcScores(
                 candidatesContexts,
                 fold,
                 ctx);
+        } else if (NeedToUseSplitScreening(ctx->Params)) {
+            CalcBestScoreWithScreening(
+                data,
+                currentSplitTree,
+                indices,
+                randSeed,
+                scoreStDev,
+                candidatesContexts,
+                fold,
+                ctx);
         } else {
             CalcBestScore(
                 data,
                 currentSplitTree,
+                ctx->SampledDocs,
+                ctx->UseTreeLevelCaching(),
                 randSeed,
                 scoreStDev,
                 candidatesContexts,
@@ -1042,7 +1224,7 @@ static void ProcessCtrSplit(
 
     const auto& proj = bestSplit.Ctr.Projection;
     if (fold->GetCtrRef(proj).Feature.empty()) {
-        ComputeOnlineCTRs(data, *fold, proj, ctx, &fold->GetCtrRef(proj));
+        ComputeOnlineCTRs(data, *fold, proj, ctx, ctx->LocalExecutor, &fold->GetCtrRef(proj));
         if (ctx->UseTreeLevelCaching()) {
             DropStatsForProjection(*fold, *ctx, proj, &ctx->PrevTreeLevelStats);
         }
@@ -1090,7 +1272,7 @@ static TSplitTree GreedyTensorSearchOblivious(
         }
         profile.AddOperation(TStringBuilder() << "Bootstrap, depth " << curDepth);
 
-        CalcScores(data, currentSplitTree, scoreStDev, &candidatesContexts, fold, ctx);
+        CalcScores(data, currentSplitTree, *indices, scoreStDev, &candidatesContexts, fold, ctx);
 
         const size_t maxFeatureValueCount = CalcMaxFeatureValueCount(*fold, candidatesContexts);
 
@@ -1121,6 +1303,7 @@ static TSplitTree GreedyTensorSearchOblivious(
             *ctx->Layout,
             &ctx->LearnProgress->UsedFeatures);
 
+        int redundantIdx = -1;
         if (ctx->Params.SystemOptions->IsSingleHost()) {
             SetPermutedIndices(
                 bestSplit,
@@ -1144,18 +1327,15 @@ static TSplitTree GreedyTensorSearchOblivious(
             }
         } else {
             Y_ASSERT(bestSplit.Type != ESplitType::OnlineCtr);
-            MapSetIndices(bestSplit, ctx);
+            redundantIdx = MapSetIndicesAndGetRedundantSplitIdx(bestSplit, ctx);
         }
         currentSplitTree.AddSplit(bestSplit);
         CATBOOST_INFO_LOG << BuildDescription(*ctx->Layout, bestSplit) << " score " << bestScore << "\n";
 
         profile.AddOperation(TStringBuilder() << "Select best split " << curDepth);
 
-        int redundantIdx = -1;
         if (ctx->Params.SystemOptions->IsSingleHost()) {
             redundantIdx = GetRedundantSplitIdx(GetIsLeafEmpty(curDepth + 1, *indices));
-        } else {
-            redundantIdx = MapGetRedundantSplitIdx(ctx);
         }
         if (redundantIdx != -1) {
             currentSplitTree.DeleteSplit(redundantIdx);
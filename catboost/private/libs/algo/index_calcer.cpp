@@ -29,13 +29,13 @@ static inline ui16 GetFeatureSplitIdx(const TSplit& split) {
 }
 
 
-template <typename TCount, typename TCmpOp, int VectorWidth>
+template <typename TCount, typename TCmpOp, int VectorWidth, typename TIndex>
 inline void UpdateIndicesKernel(
     const ui32* permutation,
     const TCount* histogram,
     TCmpOp cmpOp,
     int level,
-    TIndexType* indices) {
+    TIndex* indices) {
 
     Y_ASSERT(VectorWidth == 4);
     const ui32 perm0 = permutation[0];
@@ -46,10 +46,10 @@ inline void UpdateIndicesKernel(
     const TCount hist1 = histogram[perm1];
     const TCount hist2 = histogram[perm2];
     const TCount hist3 = histogram[perm3];
-    const TIndexType idx0 = indices[0];
-    const TIndexType idx1 = indices[1];
-    const TIndexType idx2 = indices[2];
-    const TIndexType idx3 = indices[3];
+    const TIndex idx0 = indices[0];
+    const TIndex idx1 = indices[1];
+    const TIndex idx2 = indices[2];
+    const TIndex idx3 = indices[3];
     indices[0] = idx0 + cmpOp(hist0) * level;
     indices[1] = idx1 + cmpOp(hist1) * level;
     indices[2] = idx2 + cmpOp(hist2) * level;
@@ -57,20 +57,20 @@ inline void UpdateIndicesKernel(
 }
 
 
-template <typename TCount, typename TCmpOp>
+template <typename TCount, typename TCmpOp, typename TIndex>
 inline void UpdateIndicesForSplit(
     const ui32* permutation,
     const TCount* histogram,
     TIndexRange<ui32> indexRange,
     TCmpOp cmpOp,
     int level,
-    TIndexType* indices) {
+    TIndex* indices) {
 
     constexpr int vectorWidth = 4;
 
     ui32 doc;
     for (doc = indexRange.Begin; doc + vectorWidth <= indexRange.End; doc += vectorWidth) {
-        UpdateIndicesKernel<TCount, TCmpOp, vectorWidth>(
+        UpdateIndicesKernel<TCount, TCmpOp, vectorWidth, TIndex>(
             permutation + doc,
             histogram,
             cmpOp,
@@ -84,22 +84,22 @@ inline void UpdateIndicesForSplit(
 }
 
 
-template <typename TCount, typename TCmpOp, int VectorWidth>
+template <typename TCount, typename TCmpOp, int VectorWidth, typename TIndex>
 inline void UpdateIndicesKernel(
     const TCount* histogram,
     TCmpOp cmpOp,
     int level,
-    TIndexType* indices) {
+    TIndex* indices) {
 
     Y_ASSERT(VectorWidth == 4);
     const TCount hist0 = histogram[0];
     const TCount hist1 = histogram[1];
     const TCount hist2 = histogram[2];
     const TCount hist3 = histogram[3];
-    const TIndexType idx0 = indices[0];
-    const TIndexType idx1 = indices[1];
-    const TIndexType idx2 = indices[2];
-    const TIndexType idx3 = indices[3];
+    const TIndex idx0 = indices[0];
+    const TIndex idx1 = indices[1];
+    const TIndex idx2 = indices[2];
+    const TIndex idx3 = indices[3];
     indices[0] = idx0 + cmpOp(hist0) * level;
     indices[1] = idx1 + cmpOp(hist1) * level;
     indices[2] = idx2 + cmpOp(hist2) * level;
@@ -107,19 +107,19 @@ inline void UpdateIndicesKernel(
 }
 
 
-template <typename TCount, typename TCmpOp>
+template <typename TCount, typename TCmpOp, typename TIndex>
 inline void UpdateIndicesForSplit(
     const TCount* histogram,
     TIndexRange<ui32> indexRange,
     TCmpOp cmpOp,
     int level,
-    TIndexType* indices) {
+    TIndex* indices) {
 
     constexpr int vectorWidth = 4;
 
     ui32 doc;
     for (doc = indexRange.Begin; doc + vectorWidth <= indexRange.End; doc += vectorWidth) {
-        UpdateIndicesKernel<TCount, TCmpOp, vectorWidth>(
+        UpdateIndicesKernel<TCount, TCmpOp, vectorWidth, TIndex>(
             histogram + doc,
             cmpOp,
             level,
@@ -130,13 +130,13 @@ inline void UpdateIndicesForSplit(
     }
 }
 
-template <typename TColumn, class TCmpOp>
+template <typename TColumn, class TCmpOp, typename TIndex>
 inline void ScheduleUpdateIndicesForSplit(
     const ui32* columnIndexingPtr, // can be nullptr
     const TColumn& column,
     TCmpOp cmpOp,
     int level,
-    TIndexType* indices,
+    TIndex* indices,
     TVector<std::function<void(TIndexRange<ui32>)>>* updateBlockCallbacks) {
     if (const auto* columnData
             = dynamic_cast<const TCompressedValuesHolderImpl<TColumn>*>(&column))
@@ -178,7 +178,7 @@ inline void ScheduleUpdateIndicesForSplit(
 }
 
 
-template <typename TColumn, class TCmpOp>
+template <typename TColumn, class TCmpOp, typename TIndex>
 void ScheduleUpdateIndicesForSplit(
     TMaybe<TExclusiveBundleIndex> maybeExclusiveBundleIndex,
     TMaybe<TPackedBinaryIndex> maybeBinaryIndex,
@@ -191,7 +191,7 @@ void ScheduleUpdateIndicesForSplit(
     std::function<const IFeaturesGroupArray*(ui32)>&& getFeaturesGroup,
     TCmpOp cmpOp,
     int level,
-    TIndexType* indices,
+    TIndex* indices,
     TVector<std::function<void(TIndexRange<ui32>)>>* updateBlockCallbacks) {
 
     auto scheduleUpdateIndicesForSplit = [&] (const auto& column, auto&& cmpOp) {
@@ -246,6 +246,39 @@ static TConstArrayRef<ui8> GetCtrValues(const TSplit& split, const TOnlineCTR& c
 }
 
 
+// returns nullptr for full subset
+static const ui32* GetColumnIndexing(
+    const TFeaturesArraySubsetIndexing& subsetIndexing,
+    TIndexedSubsetCache* indexedSubsetCache,
+    NPar::TLocalExecutor* localExecutor) {
+
+    if (GetIf<TFullSubset<ui32>>(&subsetIndexing)) {
+        return nullptr;
+    } else if (const TIndexedSubset<ui32>* indexedSubset = GetIf<TIndexedSubset<ui32>>(&subsetIndexing)) {
+        return indexedSubset->data();
+    } else {
+        // blocks
+
+        TIndexedSubsetCache::insert_ctx insertCtx;
+        auto it = indexedSubsetCache->find(&subsetIndexing, insertCtx);
+        if (it != indexedSubsetCache->end()) {
+            return it->second.data();
+        }
+        TIndexedSubset<ui32> columnsIndexingStorage;
+        columnsIndexingStorage.yresize(subsetIndexing.Size());
+        subsetIndexing.ParallelForEach(
+            [&](ui32 idx, ui32 srcIdx) { columnsIndexingStorage[idx] = srcIdx; },
+            localExecutor);
+        const ui32* columnIndexing = columnsIndexingStorage.data();
+        indexedSubsetCache->emplace_direct(
+            insertCtx,
+            &subsetIndexing,
+            std::move(columnsIndexingStorage));
+        return columnIndexing;
+    }
+}
+
+
 void GetObjectsDataAndIndexing(
     const TTrainingDataProviders& trainingData,
     const TFold& fold,
@@ -277,53 +310,31 @@ void GetObjectsDataAndIndexing(
         }
     } else {
         // test
-
-        const TFeaturesArraySubsetIndexing& subsetIndexing = (*objectsData)->GetFeaturesArraySubsetIndexing();
-        if (GetIf<TFullSubset<ui32>>(&subsetIndexing)) {
-            *columnIndexing = nullptr;
-        } else if (const TIndexedSubset<ui32>* indexedSubset = GetIf<TIndexedSubset<ui32>>(&subsetIndexing)) {
-            *columnIndexing = indexedSubset->data();
-        } else {
-            // blocks
-
-            TIndexedSubsetCache::insert_ctx insertCtx;
-            auto it = indexedSubsetCache->find(&subsetIndexing, insertCtx);
-            if (it != indexedSubsetCache->end()) {
-                *columnIndexing = it->second.data();
-            } else {
-                TIndexedSubset<ui32> columnsIndexingStorage;
-                columnsIndexingStorage.yresize(subsetIndexing.Size());
-                subsetIndexing.ParallelForEach(
-                    [&](ui32 idx, ui32 srcIdx) { columnsIndexingStorage[idx] = srcIdx; },
-                    localExecutor);
-                *columnIndexing = columnsIndexingStorage.data();
-                indexedSubsetCache->emplace_direct(
-                    insertCtx,
-                    &subsetIndexing,
-                    std::move(columnsIndexingStorage));
-            }
-        }
-
+        *columnIndexing = GetColumnIndexing(
+            (*objectsData)->GetFeaturesArraySubsetIndexing(),
+            indexedSubsetCache,
+            localExecutor);
     }
 }
 
 
+template <typename TIndex>
 static void UpdateIndices(
     bool initIndices,
     TConstArrayRef<TUpdateIndicesForSplitParams> params,
     ui32 onlineCtrObjectOffset,
     const TTrainingDataProviders& trainingData,
-    const TFold& fold,
+    const TFold* fold, // nullptr - learn objects in their original order, no online splits allowed
     ui32 objectSubsetIdx, // 0 - learn, 1+ - test (subtract 1 for testIndex)
     NPar::TLocalExecutor* localExecutor,
-    TArrayRef<TIndexType> indices) {
+    TArrayRef<TIndex> indices) {
 
-    TIndexType defaultIndexValue = 0;
+    TIndex defaultIndexValue = 0;
 
     TVector<std::function<void(TIndexRange<ui32>)>> updateBlockCallbacks;
     TIndexedSubsetCache indexedSubsetCache;
 
-    TIndexType* indicesData = indices.data();
+    TIndex* indicesData = indices.data();
 
     for (const auto& splitParams : params) {
         const ui32 splitWeight = 1 << splitParams.Depth;
@@ -350,16 +361,27 @@ static void UpdateIndices(
         } else {
             TQuantizedForCPUObjectsDataProviderPtr objectsDataProvider;
             const ui32* columnIndexing;
-            GetObjectsDataAndIndexing(
-                trainingData,
-                fold,
-                split.Type == ESplitType::EstimatedFeature,
-                split.IsOnline(),
-                objectSubsetIdx,
-                &indexedSubsetCache,
-                localExecutor,
-                &objectsDataProvider,
-                &columnIndexing);
+            if (fold) {
+                GetObjectsDataAndIndexing(
+                    trainingData,
+                    *fold,
+                    split.Type == ESplitType::EstimatedFeature,
+                    split.IsOnline(),
+                    objectSubsetIdx,
+                    &indexedSubsetCache,
+                    localExecutor,
+                    &objectsDataProvider,
+                    &columnIndexing);
+            } else {
+                Y_ASSERT(!split.IsOnline() && (objectSubsetIdx == 0));
+                objectsDataProvider = (split.Type == ESplitType::EstimatedFeature) ?
+                    trainingData.EstimatedObjectsData.Learn
+                    : trainingData.Learn->ObjectsData;
+                columnIndexing = GetColumnIndexing(
+                    objectsDataProvider->GetFeaturesArraySubsetIndexing(),
+                    &indexedSubsetCache,
+                    localExecutor);
+            }
 
             auto scheduleUpdateIndicesForSplit = [&] (
                 auto maybeExclusiveBundleIndex,
@@ -470,10 +492,10 @@ void SetPermutedIndices(
         TConstArrayRef<TUpdateIndicesForSplitParams>(&params, 1),
         /*onlineCtrObjectOffset*/ 0,
         trainingData,
-        fold,
+        &fold,
         0, // learn
         localExecutor,
-        *indices);
+        MakeArrayRef(*indices));
 }
 
 TVector<bool> GetIsLeafEmpty(int curDepth, const TVector<TIndexType>& indices) {
@@ -565,7 +587,7 @@ static void BuildIndicesForDataset(
         params,
         docOffset,
         trainingData,
-        fold,
+        &fold,
         objectSubsetIdx,
         localExecutor,
         MakeArrayRef(indices, sampleCount));
@@ -603,12 +625,88 @@ static void BuildIndicesForDataset(
 }
 
 
+bool TLearnLeafIndices::Build(
+    const TVariant<TSplitTree, TNonSymmetricTreeStructure>& tree,
+    const TTrainingDataProviders& trainingData,
+    NPar::TLocalExecutor* localExecutor) {
+
+    Clear();
+
+    const TSplitTree* splitTree = GetIf<TSplitTree>(&tree);
+    if (!splitTree) {
+        return false;
+    }
+    TVector<TUpdateIndicesForSplitParams> params;
+    params.reserve(splitTree->GetDepth());
+    for (auto splitIdx : xrange(splitTree->GetDepth())) {
+        const auto& split = splitTree->Splits[splitIdx];
+        if (split.IsOnline()) {
+            return false;
+        }
+        params.push_back({(ui32)splitIdx, split, /*OnlineCtr*/ nullptr});
+    }
+
+    const auto buildIndices = [&] (auto indexTypeTag) {
+        using TIndex = decltype(indexTypeTag);
+
+        TVector<TIndex> indices;
+        indices.yresize(trainingData.Learn->GetObjectCount());
+        UpdateIndices(
+            /*initIndices*/ true,
+            params,
+            /*onlineCtrObjectOffset*/ 0,
+            trainingData,
+            /*fold*/ nullptr,
+            /*objectSubsetIdx*/ 0, // learn
+            localExecutor,
+            MakeArrayRef(indices));
+        Indices = std::move(indices);
+    };
+    if (splitTree->GetDepth() <= 8) {
+        buildIndices(ui8());
+    } else {
+        Y_ASSERT(splitTree->GetDepth() <= 16);
+        buildIndices(ui16());
+    }
+    IsBuiltFlag = true;
+    return true;
+}
+
+void TLearnLeafIndices::Clear() {
+    Indices = TVector<ui8>();
+    IsBuiltFlag = false;
+}
+
+void TLearnLeafIndices::GetPermuted(
+    TConstArrayRef<ui32> learnPermutation,
+    NPar::TLocalExecutor* localExecutor,
+    TArrayRef<TIndexType> indices) const {
+
+    CB_ENSURE_INTERNAL(IsBuiltFlag, "Learn leaf indices have not been built");
+    Y_ASSERT(learnPermutation.size() == indices.size());
+
+    Visit(
+        [&] (const auto& srcIndices) {
+            const auto* srcIndicesData = srcIndices.data();
+            NPar::ParallelFor(
+                *localExecutor,
+                0,
+                SafeIntegerCast<int>(indices.size()),
+                [=] (int i) {
+                    indices[i] = srcIndicesData[learnPermutation[i]];
+                });
+        },
+        Indices);
+}
+
+
 TVector<TIndexType> BuildIndices(
     const TFold& fold,
     const TVariant<TSplitTree, TNonSymmetricTreeStructure>& tree,
     const TTrainingDataProviders& trainingData,
     EBuildIndicesDataParts dataParts,
-    NPar::TLocalExecutor* localExecutor) {
+    NPar::TLocalExecutor* localExecutor,
+    const TLearnLeafIndices* learnLeafIndices) {
 
     ui32 learnSampleCount
         = (dataParts == EBuildIndicesDataParts::TestOnly) ? 0 : trainingData.Learn->GetObjectCount();
@@ -620,7 +718,12 @@ TVector<TIndexType> BuildIndices(
     TVector<TIndexType> indices;
     indices.yresize(learnSampleCount + tailSampleCount);
 
-    if (dataParts != EBuildIndicesDataParts::TestOnly) {
+    if ((dataParts != EBuildIndicesDataParts::TestOnly) && learnLeafIndices && learnLeafIndices->IsBuilt()) {
+        learnLeafIndices->GetPermuted(
+            fold.GetLearnPermutationArray(),
+            localExecutor,
+            MakeArrayRef(indices.data(), learnSampleCount));
+    } else if (dataParts != EBuildIndicesDataParts::TestOnly) {
         BuildIndicesForDataset(
             tree,
             trainingData,
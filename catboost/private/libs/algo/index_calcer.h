@@ -7,6 +7,7 @@
 #include <catboost/private/libs/options/restrictions.h>
 
 #include <util/generic/hash.h>
+#include <util/generic/variant.h>
 #include <util/generic/vector.h>
 #include <util/system/types.h>
 
@@ -60,12 +61,45 @@ enum class EBuildIndicesDataParts {
 };
 
 
+/*
+ * Leaf indices of learn objects in their original (unpermuted) order.
+ * For oblivious trees without online splits the split bits don't depend on the fold permutation,
+ * so they are computed once per tree in a single fused pass and then gathered
+ * into the permuted order of every fold instead of rebuilding them for each fold.
+ * Indices are stored as ui8 for depth <= 8 and as ui16 otherwise.
+ */
+class TLearnLeafIndices {
+public:
+    // returns false if the tree is not supported (non-symmetric or has online splits)
+    bool Build(
+        const TVariant<TSplitTree, TNonSymmetricTreeStructure>& tree,
+        const NCB::TTrainingDataProviders& trainingData,
+        NPar::TLocalExecutor* localExecutor);
+
+    void Clear();
+
+    bool IsBuilt() const {
+        return IsBuiltFlag;
+    }
+
+    void GetPermuted(
+        TConstArrayRef<ui32> learnPermutation,
+        NPar::TLocalExecutor* localExecutor,
+        TArrayRef<TIndexType> indices) const;
+
+private:
+    TVariant<TVector<ui8>, TVector<ui16>> Indices;
+    bool IsBuiltFlag = false;
+};
+
+
 TVector<TIndexType> BuildIndices(
     const TFold& fold, // can be empty
     const TVariant<TSplitTree, TNonSymmetricTreeStructure>& tree,
     const NCB::TTrainingDataProviders& trainingData,
     EBuildIndicesDataParts dataParts,
-    NPar::TLocalExecutor* localExecutor);
+    NPar::TLocalExecutor* localExecutor,
+    const TLearnLeafIndices* learnLeafIndices = nullptr); // if built, used for learn part
 
 TVector<TIndexType> BuildIndicesForBinTree(
     const TFullModel& model,
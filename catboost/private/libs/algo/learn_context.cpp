@@ -6,6 +6,8 @@
 #include "calc_score_cache.h"
 
 #include "helpers.h"
+#include "leafwise_scoring.h"
+#include "numa_placement.h"
 #include "online_ctr.h"
 
 #include <catboost/libs/helpers/checksum.h>
@@ -30,6 +32,7 @@
 #include <util/folder/path.h>
 #include <util/stream/file.h>
 #include <util/system/fs.h>
+#include <util/system/info.h>
 
 
 using namespace NCB;
@@ -355,6 +358,36 @@ TLearnContext::TLearnContext(
 
     const ui32 maxBodyTailCount = Max(1, GetMaxBodyTailCount(LearnProgress->Folds));
     UseTreeLevelCachingFlag = NeedToUseTreeLevelCaching(Params, maxBodyTailCount, LearnProgress->ApproxDimension);
+
+    InitNumaExecutors(data);
+}
+
+void TLearnContext::InitNumaExecutors(const TTrainingDataProviders& data) {
+    const auto& systemOptions = Params.SystemOptions.Get();
+    if (systemOptions.DevNumaMode.Get() == ENumaMode::None || !systemOptions.IsSingleHost()) {
+        return;
+    }
+    const ui32 fakeNodeCount = systemOptions.DevNumaFakeNodeCount.Get();
+    const NCB::TNumaTopology topology = fakeNodeCount
+        ? NCB::TNumaTopology::MakeFake(fakeNodeCount, NSystemInfo::CachedNumberOfCpus())
+        : NCB::TNumaTopology::Detect();
+    const ui32 threadCount = systemOptions.NumThreads.Get();
+    if (topology.GetNodeCount() < 2 || threadCount < topology.GetNodeCount()) {
+        CATBOOST_WARNING_LOG << "NUMA-aware training is disabled: " << topology.GetNodeCount()
+            << " NUMA nodes found for " << threadCount << " threads" << Endl;
+        return;
+    }
+    CATBOOST_INFO_LOG << "NUMA-aware training on " << topology.GetNodeCount() << " nodes" << Endl;
+    /* node threads are used instead of LocalExecutor ones for scoring, LocalExecutor threads are idle then,
+     * so no more than thread_count threads are busy at a time
+     */
+    NumaExecutors = MakeHolder<NCB::TNumaExecutors>(topology, threadCount);
+
+    PlaceQuantizedColumnsOnNumaNodes(*data.Learn->ObjectsData, *NumaExecutors);
+    for (const auto& fold : LearnProgress->Folds) {
+        InterleaveFoldOnNumaNodes(fold, *NumaExecutors);
+    }
+    InterleaveFoldOnNumaNodes(LearnProgress->AveragingFold, *NumaExecutors);
 }
 
 
@@ -800,6 +833,15 @@ bool TLearnContext::GetHasWeights() const {
     return HasWeights;
 }
 
+bool NeedToUseSplitScreening(const NCatboostOptions::TCatBoostOptions& params) {
+    // leafwise scoring and distributed mode are not supported yet
+    return params.ObliviousTreeOptions->DevSplitScreeningSampleRate.Get() < 1.0f
+        && params.ObliviousTreeOptions->GrowPolicy == EGrowPolicy::SymmetricTree
+        && params.SystemOptions->IsSingleHost()
+        && !IsPairwiseScoring(params.LossFunctionDescription->GetLossFunction())
+        && !IsLeafwiseScoringApplicable(params);
+}
+
 bool NeedToUseTreeLevelCaching(
     const NCatboostOptions::TCatBoostOptions& params,
     ui32 maxBodyTailCount,
@@ -807,8 +849,10 @@ bool NeedToUseTreeLevelCaching(
 
     const ui32 maxLeafCount = 1 << params.ObliviousTreeOptions->MaxDepth;
     // TODO(nikitxskv): Pairwise scoring doesn't use statistics from previous tree level. Need to fix it.
+    // Split screening rescores only a part of candidates, so previous level stats are incomplete.
     return (
         IsSamplingPerTree(params.ObliviousTreeOptions) &&
+        !NeedToUseSplitScreening(params) &&
         !IsPairwiseScoring(params.LossFunctionDescription->GetLossFunction()) &&
         maxLeafCount * approxDimension * maxBodyTailCount < 64 * 1 * 10);
 }
@@ -3,12 +3,14 @@
 #include "calc_score_cache.h"
 #include "ctr_helper.h"
 #include "fold.h"
+#include "index_calcer.h"
 #include "online_ctr.h"
 #include "split.h"
 
 #include <catboost/private/libs/algo_helpers/custom_objective_descriptor.h>
 #include <catboost/libs/data/data_provider.h>
 #include <catboost/libs/data/features_layout.h>
+#include <catboost/libs/helpers/numa.h>
 #include <catboost/libs/helpers/restorable_rng.h>
 #include <catboost/private/libs/labels/label_converter.h>
 #include <catboost/libs/loggers/catboost_logger_helpers.h>
@@ -180,6 +182,13 @@ public:
 
 
 
+struct TSplitScreeningStats {
+    ui64 ScreenedLevelCount = 0;
+    ui64 LeaderOverturnedCount = 0; // exact winner is not the best candidate on the screening sample
+    ui64 WinnerAtTopCountBoundaryCount = 0; // exact winner is the last one rescored, some better ones might be missed
+};
+
+
 /************************************************************************/
 /* Class for storing learn specific data structures like:               */
 /* prng, learn progress and target classifiers                          */
@@ -208,6 +217,9 @@ public:
     bool UseTreeLevelCaching() const;
     bool GetHasWeights() const;
 
+private:
+    void InitNumaExecutors(const NCB::TTrainingDataProviders& data);
+
 public:
     THolder<TLearnProgress> LearnProgress;
     NCatboostOptions::TOutputFilesOptions OutputOptions;
@@ -215,7 +227,11 @@ public:
 
     TCalcScoreFold SmallestSplitSideDocs;
     TCalcScoreFold SampledDocs;
+    TCalcScoreFold ScreeningDocs; // used only if NeedToUseSplitScreening
+    TSplitScreeningStats SplitScreeningStats;
     TBucketStatsCache PrevTreeLevelStats;
+    TLearnLeafIndices LearnLeafIndices; // for the tree selected at the current iteration
+    THolder<NCB::TNumaExecutors> NumaExecutors; // non-null only if NUMA-aware training is enabled
     TProfileInfo Profile;
 
 private:
@@ -223,6 +239,8 @@ private:
     bool HasWeights;
 };
 
+bool NeedToUseSplitScreening(const NCatboostOptions::TCatBoostOptions& params);
+
 bool NeedToUseTreeLevelCaching(
     const NCatboostOptions::TCatBoostOptions& params,
     ui32 maxBodyTailCount,
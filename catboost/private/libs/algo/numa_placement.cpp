@@ -0,0 +1,137 @@
+#include "numa_placement.h"
+
+#include "fold.h"
+
+#include <catboost/libs/data/columns.h>
+#include <catboost/libs/data/composite_columns.h>
+#include <catboost/libs/helpers/compression.h>
+#include <catboost/libs/logging/logging.h>
+
+#include <util/generic/xrange.h>
+
+
+using namespace NCB;
+
+
+ui32 GetNumaNode(const TSplitEnsemble& splitEnsemble, const TNumaExecutors& numaExecutors) {
+    switch (splitEnsemble.Type) {
+        case ESplitEnsembleType::OneFeature:
+            if (splitEnsemble.SplitCandidate.Type == ESplitType::OnlineCtr) {
+                // online ctr values are first touched by the threads of the node that scores them
+                return numaExecutors.GetNodeByKey(splitEnsemble.SplitCandidate.Ctr.Projection.GetHash());
+            }
+            return numaExecutors.GetNodeByKey(splitEnsemble.SplitCandidate.FeatureIdx);
+        case ESplitEnsembleType::BinarySplits:
+            return numaExecutors.GetNodeByKey(splitEnsemble.BinarySplitsPackRef.PackIdx);
+        case ESplitEnsembleType::ExclusiveBundle:
+            return numaExecutors.GetNodeByKey(splitEnsemble.ExclusiveFeaturesBundleRef.BundleIdx);
+        case ESplitEnsembleType::FeaturesGroup:
+            return numaExecutors.GetNodeByKey(splitEnsemble.FeaturesGroupRef.GroupIdx);
+    }
+    Y_UNREACHABLE();
+}
+
+
+// sparse columns are left in place
+template <class TColumn>
+static bool MoveColumnToNumaNode(const TColumn& column, ui32 nodeIdx, const TNumaExecutors& numaExecutors) {
+    const auto* denseColumn = dynamic_cast<const TCompressedValuesHolderImpl<TColumn>*>(&column);
+    if (!denseColumn) {
+        return false;
+    }
+    const TCompressedArray& compressedArray = *denseColumn->GetCompressedData().GetSrc();
+    const size_t byteSize
+        = TIndexHelper<ui64>(compressedArray.GetBitsPerKey()).CompressedSize(compressedArray.GetSize())
+            * sizeof(ui64);
+    return numaExecutors.MoveToNode(TConstArrayRef<char>(compressedArray.GetRawPtr(), byteSize), nodeIdx);
+}
+
+template <EFeatureType FeatureType>
+static bool IsFeatureInAggregatedColumn(
+    const TQuantizedForCPUObjectsDataProvider& learnObjectsData,
+    TFeatureIdx<FeatureType> featureIdx
+) {
+    return learnObjectsData.IsFeaturePackedBinary(featureIdx)
+        || learnObjectsData.IsFeatureInExclusiveBundle(featureIdx)
+        || learnObjectsData.GetFeatureToFeaturesGroupIndex(featureIdx).Defined();
+}
+
+void PlaceQuantizedColumnsOnNumaNodes(
+    const TQuantizedForCPUObjectsDataProvider& learnObjectsData,
+    const TNumaExecutors& numaExecutors
+) {
+    const auto& featuresLayout = *learnObjectsData.GetFeaturesLayout();
+    ui32 movedCount = 0;
+    ui32 columnCount = 0;
+    const auto moveColumn = [&] (const auto& column, const TSplitEnsemble& splitEnsemble) {
+        ++columnCount;
+        if (MoveColumnToNumaNode(column, GetNumaNode(splitEnsemble, numaExecutors), numaExecutors)) {
+            ++movedCount;
+        }
+    };
+
+    for (auto floatFeatureIdx : xrange(featuresLayout.GetFloatFeatureCount())) {
+        if (IsFeatureInAggregatedColumn(learnObjectsData, TFloatFeatureIdx(floatFeatureIdx))) {
+            continue;
+        }
+        if (const auto column = learnObjectsData.GetNonPackedFloatFeature(floatFeatureIdx)) {
+            TSplitCandidate splitCandidate;
+            splitCandidate.Type = ESplitType::FloatFeature;
+            splitCandidate.FeatureIdx = floatFeatureIdx;
+            moveColumn(**column, TSplitEnsemble(std::move(splitCandidate)));
+        }
+    }
+    // all ctrs read categorical columns too, place them as for one-hot splits
+    for (auto catFeatureIdx : xrange(featuresLayout.GetCatFeatureCount())) {
+        if (IsFeatureInAggregatedColumn(learnObjectsData, TCatFeatureIdx(catFeatureIdx))) {
+            continue;
+        }
+        if (const auto column = learnObjectsData.GetNonPackedCatFeature(catFeatureIdx)) {
+            TSplitCandidate splitCandidate;
+            splitCandidate.Type = ESplitType::OneHotFeature;
+            splitCandidate.FeatureIdx = catFeatureIdx;
+            moveColumn(**column, TSplitEnsemble(std::move(splitCandidate)));
+        }
+    }
+    for (auto packIdx : xrange<ui32>(learnObjectsData.GetBinaryFeaturesPacksSize())) {
+        moveColumn(
+            learnObjectsData.GetBinaryFeaturesPack(packIdx),
+            TSplitEnsemble(TBinarySplitsPackRef{packIdx}));
+    }
+    for (auto bundleIdx : xrange<ui32>(learnObjectsData.GetExclusiveFeatureBundlesSize())) {
+        moveColumn(
+            learnObjectsData.GetExclusiveFeaturesBundle(bundleIdx),
+            TSplitEnsemble(TExclusiveFeaturesBundleRef{bundleIdx}));
+    }
+    for (auto groupIdx : xrange<ui32>(learnObjectsData.GetFeaturesGroupsSize())) {
+        moveColumn(
+            learnObjectsData.GetFeaturesGroup(groupIdx),
+            TSplitEnsemble(TFeaturesGroupRef{groupIdx}));
+    }
+    CATBOOST_DEBUG_LOG << "Quantized columns moved to NUMA nodes: " << movedCount << " of " << columnCount << Endl;
+}
+
+
+template <class T>
+static void InterleaveVector(const TVector<T>& data, const TNumaExecutors& numaExecutors) {
+    numaExecutors.Interleave(TConstArrayRef<char>((const char*)data.data(), data.size() * sizeof(T)));
+}
+
+void InterleaveFoldOnNumaNodes(const TFold& fold, const TNumaExecutors& numaExecutors) {
+    InterleaveVector(fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>(), numaExecutors);
+    InterleaveVector(fold.SampleWeights, numaExecutors);
+    for (const auto& target : fold.LearnTarget) {
+        InterleaveVector(target, numaExecutors);
+    }
+    for (const auto& bodyTail : fold.BodyTailArr) {
+        for (const auto& approx : bodyTail.Approx) {
+            InterleaveVector(approx, numaExecutors);
+        }
+        for (const auto& derivatives : bodyTail.WeightedDerivatives) {
+            InterleaveVector(derivatives, numaExecutors);
+        }
+        for (const auto& derivatives : bodyTail.SampleWeightedDerivatives) {
+            InterleaveVector(derivatives, numaExecutors);
+        }
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "split.h"
+
+#include <catboost/libs/data/objects.h>
+#include <catboost/libs/helpers/numa.h>
+
+#include <util/system/types.h>
+
+
+class TFold;
+
+
+/* In FeatureParallel NUMA mode all candidates of the same split ensemble are scored on the node returned
+ * by this function, so candidates reading the same quantized column are scored on the same node.
+ */
+ui32 GetNumaNode(const TSplitEnsemble& splitEnsemble, const NCB::TNumaExecutors& numaExecutors);
+
+// moves pages of dense quantized columns to the nodes that score their split ensembles
+void PlaceQuantizedColumnsOnNumaNodes(
+    const NCB::TQuantizedForCPUObjectsDataProvider& learnObjectsData,
+    const NCB::TNumaExecutors& numaExecutors
+);
+
+// fold data is read when scoring candidates of all nodes, so its pages are interleaved between nodes
+void InterleaveFoldOnNumaNodes(const TFold& fold, const NCB::TNumaExecutors& numaExecutors);
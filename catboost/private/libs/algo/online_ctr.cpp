@@ -537,6 +537,7 @@ void ComputeOnlineCTRs(
     const TFold& fold,
     const TProjection& proj,
     const TLearnContext* ctx,
+    NPar::TLocalExecutor* localExecutor,
     TOnlineCTR* dst) {
 
     const TCtrHelper& ctrHelper = ctx->CtrsHelper;
@@ -564,7 +565,7 @@ void ComputeOnlineCTRs(
             CopyCatColumnToHash(
                 **data.Learn->ObjectsData->GetCatFeature(*catFeatureIdx),
                 fold.LearnPermutationFeaturesSubset,
-                ctx->LocalExecutor,
+                localExecutor,
                 hashArrView.data()
             );
         }
@@ -576,7 +577,7 @@ void ComputeOnlineCTRs(
             CopyCatColumnToHash(
                 **data.Test[testIdx]->ObjectsData->GetCatFeature(*catFeatureIdx),
                 data.Test[testIdx]->ObjectsData->GetFeaturesArraySubsetIndexing(),
-                ctx->LocalExecutor,
+                localExecutor,
                 hashArrView.data() + docOffset
             );
             docOffset += testSampleCount;
@@ -585,7 +586,7 @@ void ComputeOnlineCTRs(
             quantizedFeaturesInfo.GetUniqueValuesCounts(TCatFeatureIdx(proj.CatFeatures[0])).OnLearnOnly
         );
     } else {
-        ParallelFill<ui64>(/*fillValue*/0, /*blockSize*/Nothing(), ctx->LocalExecutor, MakeArrayRef(hashArr));
+        ParallelFill<ui64>(/*fillValue*/0, /*blockSize*/Nothing(), localExecutor, MakeArrayRef(hashArr));
         CalcHashes(
             proj,
             *data.Learn->ObjectsData,
@@ -593,7 +594,7 @@ void ComputeOnlineCTRs(
             nullptr,
             hashArr.begin(),
             hashArr.begin() + learnSampleCount,
-            ctx->LocalExecutor);
+            localExecutor);
         for (size_t docOffset = learnSampleCount, testIdx = 0;
              docOffset < totalSampleCount && testIdx < data.Test.size();
              ++testIdx)
@@ -606,7 +607,7 @@ void ComputeOnlineCTRs(
                 nullptr,
                 hashArr.begin() + docOffset,
                 hashArr.begin() + docOffset + testSampleCount,
-                ctx->LocalExecutor);
+                localExecutor);
             docOffset += testSampleCount;
         }
         size_t approxBucketsCount = 1;
@@ -658,7 +659,7 @@ void ComputeOnlineCTRs(
         counterCTRDenominator = *MaxElement(counterCTRTotal.begin(), counterCTRTotal.end());
     }
 
-    ctx->LocalExecutor->ExecRange(
+    localExecutor->ExecRange(
         [&] (ui32 ctrIdx) {
             const ECtrType ctrType = ctrInfo[ctrIdx].Type;
             const ui32 classifierId = ctrInfo[ctrIdx].TargetClassifierIdx;
@@ -684,7 +685,7 @@ void ComputeOnlineCTRs(
                     priors,
                     ctrBorderCount,
                     &dst->Feature[ctrIdx],
-                    ctx->LocalExecutor);
+                    localExecutor);
 
             } else if (ctrType == ECtrType::BinarizedTargetMeanValue) {
                 CalcOnlineCTRMean(
@@ -64,6 +64,7 @@ void ComputeOnlineCTRs(
     const TFold& fold,
     const TProjection& proj,
     const TLearnContext* ctx,
+    NPar::TLocalExecutor* localExecutor,
     TOnlineCTR* dst
 );
 
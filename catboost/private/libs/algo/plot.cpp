@@ -19,6 +19,7 @@
 #include <util/stream/fwd.h>
 #include <util/string/builder.h>
 #include <util/system/file.h>
+#include <util/system/hp_timer.h>
 #include <util/system/yassert.h>
 #include <util/ysaveload.h>
 
@@ -69,6 +70,7 @@ TMetricsPlotCalcer::TMetricsPlotCalcer(
     }
     AdditiveMetricPlots.resize(AdditiveMetrics.ysize(), TVector<TMetricHolder>(Iterations.ysize()));
     NonAdditiveMetricPlots.resize(NonAdditiveMetrics.ysize(), TVector<TMetricHolder>(Iterations.ysize()));
+    StageTimings.resize(Iterations.size());
 }
 
 void TMetricsPlotCalcer::ComputeAdditiveMetric(
@@ -262,6 +264,7 @@ TMetricsPlotCalcer& TMetricsPlotCalcer::ProceedDataSet(
 
     for (ui32 iterationIndex = beginIterationIndex; iterationIndex < endIterationIndex; ++iterationIndex) {
         end = Iterations[iterationIndex] + 1;
+        THPTimer timer;
         modelCalcerOnPool.ApplyModelMulti(
             EPredictionType::InternalRawFormulaVal,
             begin,
@@ -271,14 +274,17 @@ TMetricsPlotCalcer& TMetricsPlotCalcer::ProceedDataSet(
         Append(NextApproxBuffer, 0, &CurApproxBuffer);
 
         if (isAdditiveMetrics) {
+            StageTimings[iterationIndex].ApplySeconds += timer.PassedReset();
             ComputeAdditiveMetric(
                 CurApproxBuffer,
                 target,
                 weights,
                 groupInfos,
                 iterationIndex);
+            StageTimings[iterationIndex].MetricsSeconds += timer.Passed();
         } else {
             SaveApproxToFile(iterationIndex, CurApproxBuffer);
+            StageTimings[iterationIndex].ApplySeconds += timer.Passed();
         }
         begin = end;
     }
@@ -294,17 +300,10 @@ void TMetricsPlotCalcer::ComputeNonAdditiveMetrics(ui32 begin, ui32 end) {
     CB_ENSURE(target.size() == 1, "Multitarget metrics are not supported yet");
 
     for (auto idx : xrange(begin, end)) {
+        THPTimer timer;
         auto approx = LoadApprox(idx);
-        auto results = EvalErrorsWithCaching(
-            approx,
-            /*approxDelts*/{},
-            /*isExpApprox*/false,
-            To2DConstArrayRef<float>(target),
-            weights,
-            {},
-            NonAdditiveMetrics,
-            &Executor
-        );
+        auto results = EvalNonAdditiveMetrics(approx, target, weights);
+        StageTimings[idx].MetricsSeconds += timer.Passed();
 
         for (auto metricId : xrange(NonAdditiveMetrics.size())) {
             NonAdditiveMetricPlots[metricId][idx] = results[metricId];
@@ -376,6 +375,7 @@ void TMetricsPlotCalcer::ComputeNonAdditiveMetrics(const TVector<TProcessedDataP
     auto startDocIdx = GetStartDocIdx(datasetParts);
     for (ui32 iterationIndex = 0; iterationIndex < Iterations.size(); ++iterationIndex) {
         int end = Iterations[iterationIndex] + 1;
+        THPTimer timer;
         for (int poolPartIdx = 0; poolPartIdx < modelCalcers.ysize(); ++poolPartIdx) {
             auto& calcer = modelCalcers[poolPartIdx];
             calcer.ApplyModelMulti(
@@ -386,24 +386,70 @@ void TMetricsPlotCalcer::ComputeNonAdditiveMetrics(const TVector<TProcessedDataP
                 &NextApproxBuffer);
             Append(NextApproxBuffer, startDocIdx[poolPartIdx], &curApprox);
         }
+        StageTimings[iterationIndex].ApplySeconds += timer.PassedReset();
+
+        auto results = EvalNonAdditiveMetrics(curApprox, allTargets, allWeights);
+        StageTimings[iterationIndex].MetricsSeconds += timer.Passed();
+
+        for (auto metricId : xrange(NonAdditiveMetrics.size())) {
+            NonAdditiveMetricPlots[metricId][iterationIndex] = results[metricId];
+        }
+
+        begin = end;
+    }
+}
+
+TVector<TMetricHolder> TMetricsPlotCalcer::EvalNonAdditiveMetrics(
+    const TVector<TVector<double>>& approx,
+    const TVector<TVector<float>>& target,
+    TConstArrayRef<float> weights
+) {
+    if (StagedAucCalcers.empty()) {
+        StagedAucCalcers.resize(NonAdditiveMetrics.size());
+        for (auto metricId : xrange(NonAdditiveMetrics.size())) {
+            const auto& metric = *NonAdditiveMetrics[metricId];
+            if (IsBinClassAucMetric(metric) && approx.size() == 1) {
+                StagedAucCalcers[metricId] = MakeHolder<TStagedBinClassAucCalcer>(
+                    target[0],
+                    metric.UseWeights ? weights : TConstArrayRef<float>());
+            }
+        }
+    }
 
-        auto results = EvalErrorsWithCaching(
-            curApprox,
+    TVector<const IMetric*> otherMetrics;
+    for (auto metricId : xrange(NonAdditiveMetrics.size())) {
+        if (!StagedAucCalcers[metricId]) {
+            otherMetrics.push_back(NonAdditiveMetrics[metricId]);
+        }
+    }
+    TVector<TMetricHolder> otherResults;
+    if (!otherMetrics.empty()) {
+        otherResults = EvalErrorsWithCaching(
+            approx,
             /*approxDelts*/{},
             /*isExpApprox*/false,
-            To2DConstArrayRef<float>(allTargets),
-            allWeights,
+            To2DConstArrayRef<float>(target),
+            weights,
             {},
-            NonAdditiveMetrics,
+            otherMetrics,
             &Executor
         );
+    }
 
-        for (auto metricId : xrange(NonAdditiveMetrics.size())) {
-            NonAdditiveMetricPlots[metricId][iterationIndex] = results[metricId];
+    TVector<TMetricHolder> results;
+    results.reserve(NonAdditiveMetrics.size());
+    auto otherResult = otherResults.begin();
+    for (auto metricId : xrange(NonAdditiveMetrics.size())) {
+        if (StagedAucCalcers[metricId]) {
+            TMetricHolder error(2);
+            error.Stats[0] = StagedAucCalcers[metricId]->Calc(approx[0], &Executor);
+            error.Stats[1] = 1.0;
+            results.push_back(std::move(error));
+        } else {
+            results.push_back(std::move(*otherResult++));
         }
-
-        begin = end;
     }
+    return results;
 }
 
 TString TMetricsPlotCalcer::GetApproxFileName(ui32 plotLineIndex) {
@@ -590,3 +636,20 @@ TMetricsPlotCalcer& TMetricsPlotCalcer::SaveResult(
     }
     return *this;
 }
+
+TMetricsPlotCalcer& TMetricsPlotCalcer::SaveStageTimings(const TString& resultDir) {
+    TFsPath trainDirPath(resultDir);
+    if (!resultDir.empty() && !trainDirPath.Exists()) {
+        trainDirPath.MkDirs();
+    }
+
+    TOFStream timingsStream(JoinFsPaths(resultDir, "stage_timings.tsv"));
+    const char sep = '\t';
+    timingsStream << "iter" << sep << "apply_seconds" << sep << "metrics_seconds" << "\n";
+    for (auto i : xrange(Iterations.size())) {
+        timingsStream << Iterations[i] << sep
+            << StageTimings[i].ApplySeconds << sep
+            << StageTimings[i].MetricsSeconds << "\n";
+    }
+    return *this;
+}
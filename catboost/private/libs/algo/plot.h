@@ -2,6 +2,7 @@
 
 #include <catboost/libs/data/data_provider.h>
 #include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/metrics/auc.h>
 #include <catboost/libs/metrics/metric.h>
 #include <catboost/libs/metrics/metric_holder.h>
 #include <catboost/libs/model/fwd.h>
@@ -61,6 +62,10 @@ public:
         bool saveMetrics,
         bool saveStats
     );
+
+    // Writes seconds spent on model application and on metrics evaluation for each plot point
+    TMetricsPlotCalcer& SaveStageTimings(const TString& resultDir);
+
     TVector<TVector<double>> GetMetricsScore();
 
     void ClearTempFiles() {
@@ -113,6 +118,13 @@ private:
 
     void ComputeNonAdditiveMetrics(ui32 begin, ui32 end);
 
+    // approx contains all objects, calls should follow the order of plot points
+    TVector<TMetricHolder> EvalNonAdditiveMetrics(
+        const TVector<TVector<double>>& approx,
+        const TVector<TVector<float>>& target,
+        TConstArrayRef<float> weights
+    );
+
     void ComputeAdditiveMetric(
         const TVector<TVector<double>>& approx,
         NCB::TMaybeData<TConstArrayRef<TConstArrayRef<float>>> target,
@@ -174,6 +186,11 @@ private:
         ui32 CumulativePoolSize = 0;
     };
 
+    struct TStageTimings {
+        double ApplySeconds = 0;
+        double MetricsSeconds = 0;
+    };
+
 private:
     const TFullModel& Model;
     NPar::TLocalExecutor& Executor;
@@ -188,6 +205,7 @@ private:
     TVector<const IMetric*> NonAdditiveMetrics;
     TVector<TVector<TMetricHolder>> AdditiveMetricPlots;
     TVector<TVector<TMetricHolder>> NonAdditiveMetricPlots;
+    TVector<TStageTimings> StageTimings;
     TVector<ui32> AdditiveMetricsIndices;
     TVector<ui32> NonAdditiveMetricsIndices;
     TVector<ui32> Iterations;
@@ -197,6 +215,8 @@ private:
     THolder<IInputStream> LastApproxes;
 
     TNonAdditiveMetricData NonAdditiveMetricsData;
+    // calcers reusing the order of the previous plot point, for each non-additive metric or nullptr
+    TVector<THolder<TStagedBinClassAucCalcer>> StagedAucCalcers;
 
     TVector<double> FlatApproxBuffer;
     TVector<TVector<double>> CurApproxBuffer;
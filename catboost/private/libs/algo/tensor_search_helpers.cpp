@@ -613,24 +613,14 @@ void CalcWeightedDerivatives(
         } else {
             localExecutor->ExecRangeWithThrow(
                 [&](int blockId) {
-                    TVector<double> curApprox(approxDimension);
-                    TVector<double> curDelta(approxDimension);
-                    NPar::TLocalExecutor::BlockedLoopBody(
-                        blockParams,
-                        [&](int z) {
-                            for (int dim = 0; dim < approxDimension; ++dim) {
-                                curApprox[dim] = approx[dim][z];
-                            }
-                            error.CalcDersMulti(
-                                curApprox,
-                                target[z],
-                                weight.empty() ? 1 : weight[z],
-                                &curDelta,
-                                nullptr);
-                            for (int dim = 0; dim < approxDimension; ++dim) {
-                                (*weightedDerivatives)[dim][z] = curDelta[dim];
-                            }
-                        })(blockId);
+                    const int blockOffset = blockId * blockParams.GetBlockSize();
+                    error.CalcFirstDerMultiRange(
+                        blockOffset,
+                        Min<int>(blockParams.GetBlockSize(), tailFinish - blockOffset),
+                        approx,
+                        target.data(),
+                        weight.empty() ? nullptr : weight.data(),
+                        *weightedDerivatives);
                 },
                 0,
                 blockParams.GetBlockCount(),
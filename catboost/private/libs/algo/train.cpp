@@ -147,7 +147,8 @@ void CalcApproxesLeafwise(
         tree,
         data,
         EBuildIndicesDataParts::All,
-        ctx->LocalExecutor
+        ctx->LocalExecutor,
+        &ctx->LearnLeafIndices
     );
     auto statistics = BuildSubset(
         *indices,
@@ -275,7 +276,7 @@ void TrainOneIteration(const NCB::TTrainingDataProviders& data, TLearnContext* c
 
             public:
                 void DoTask(TLearnContext* ctx) {
-                    ComputeOnlineCTRs(*data, *Fold, Projection, ctx, Ctr);
+                    ComputeOnlineCTRs(*data, *Fold, Projection, ctx, ctx->LocalExecutor, Ctr);
                 }
             };
 
@@ -312,6 +313,9 @@ void TrainOneIteration(const NCB::TTrainingDataProviders& data, TLearnContext* c
         TVector<double> sumLeafWeights; // [leafId]
 
         if (ctx->Params.SystemOptions->IsSingleHost()) {
+            ctx->LearnLeafIndices.Build(bestTree, data, ctx->LocalExecutor);
+            profile.AddOperation("Build learn leaf indices shared by folds");
+
             const TVector<ui64> randomSeeds = GenRandUI64Vector(foldCount, ctx->LearnProgress->Rand.GenRand());
             ctx->LocalExecutor->ExecRangeWithThrow(
                 [&](int foldId) {
@@ -389,6 +393,7 @@ void TrainOneIteration(const NCB::TTrainingDataProviders& data, TLearnContext* c
                 ctx->LearnProgress.Get(),
                 ctx->LocalExecutor
             );
+            ctx->LearnLeafIndices.Clear();
         } else {
             const bool isMultiRegression = dynamic_cast<const TMultiDerCalcer*>(error.Get()) != nullptr;
 
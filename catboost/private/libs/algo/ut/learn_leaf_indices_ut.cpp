@@ -0,0 +1,161 @@
+#include <catboost/libs/data/data_provider.h>
+#include <catboost/libs/data/data_provider_builders.h>
+#include <catboost/libs/data/visitor.h>
+#include <catboost/private/libs/algo/data.h>
+#include <catboost/private/libs/algo/fold.h>
+#include <catboost/private/libs/algo/index_calcer.h>
+#include <catboost/private/libs/algo/split.h>
+#include <catboost/private/libs/labels/label_converter.h>
+
+#include <library/threading/local_executor/local_executor.h>
+#include <library/unittest/registar.h>
+
+#include <util/folder/dirut.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/string/builder.h>
+
+using namespace NCB;
+
+Y_UNIT_TEST_SUITE(LearnLeafIndicesTest) {
+    // float features with quantized values in [0, binCount)
+    TTrainingDataProviderPtr CreateTrainingData(
+        const TVector<TVector<ui8>>& quantizedFloatFeatures,
+        ui8 binCount,
+        const TVector<float>& target) {
+
+        auto dataProviderPtr = CreateDataProvider<IQuantizedFeaturesDataVisitor>(
+            [&] (IQuantizedFeaturesDataVisitor* visitor) {
+                const ui32 featureCount = quantizedFloatFeatures.size();
+
+                TDataMetaInfo metaInfo;
+                metaInfo.TargetType = ERawTargetType::Float;
+                metaInfo.TargetCount = 1;
+                metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                    featureCount,
+                    TVector<ui32>{},
+                    TVector<TString>{}
+                );
+
+                TPoolQuantizationSchema schema;
+                for (auto featureIdx : xrange(featureCount)) {
+                    schema.FeatureIndices.push_back(featureIdx);
+                    schema.Borders.emplace_back();
+                    schema.Borders[featureIdx].yresize(binCount - 1);
+                    // actual border values does not matter here
+                    Iota(schema.Borders[featureIdx].begin(), schema.Borders[featureIdx].end(), 0.0f);
+                    schema.NanModes.push_back(ENanMode::Forbidden);
+                }
+
+                visitor->Start(metaInfo, target.size(), EObjectsOrder::Undefined, {}, schema);
+                for (auto featureIdx : xrange(featureCount)) {
+                    auto holder = TMaybeOwningArrayHolder<const ui8>::CreateNonOwning(quantizedFloatFeatures[featureIdx]);
+                    visitor->AddFloatFeaturePart(featureIdx, 0, 8, holder);
+                }
+                visitor->AddTargetPart(0, {target.data(), target.size() * sizeof(float)});
+                visitor->Finish();
+            }
+        );
+
+        NCatboostOptions::TCatBoostOptions catBoostOptions(ETaskType::CPU);
+        TLabelConverter labelConverter;
+        NPar::TLocalExecutor localExecutor;
+        TRestorableFastRng64 rand(0);
+        TMaybe<float> targetBorder = catBoostOptions.DataProcessingOptions->TargetBorder;
+        return GetTrainingData(
+            std::move(dataProviderPtr),
+            true,
+            "learn",
+            Nothing(),
+            true,
+            false,
+            GetSystemTempDir(),
+            nullptr,
+            &catBoostOptions,
+            &labelConverter,
+            &targetBorder,
+            &localExecutor,
+            &rand).Get();
+    }
+
+    // shared indices gathered into the fold order must match indices built for the fold directly
+    Y_UNIT_TEST(MatchesPerFoldIndices) {
+        const ui32 objectCount = 1000;
+        const ui32 featureCount = 12;
+        const ui8 binCount = 16;
+
+        TFastRng64 rng(17);
+        TVector<TVector<ui8>> quantizedFloatFeatures(featureCount, TVector<ui8>(objectCount));
+        for (auto& feature : quantizedFloatFeatures) {
+            for (auto& bin : feature) {
+                bin = rng.Uniform(binCount);
+            }
+        }
+        TVector<float> target(objectCount);
+        for (auto& value : target) {
+            value = rng.GenRandReal1();
+        }
+
+        TTrainingDataProviders trainingData;
+        trainingData.Learn = CreateTrainingData(quantizedFloatFeatures, binCount, target);
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+        TRestorableFastRng64 rand(0);
+
+        TVector<TFold> folds(3);
+        for (auto& fold : folds) {
+            fold.LearnPermutation = NCB::Shuffle(trainingData.Learn->ObjectsGrouping, /*permuteBlockSize*/ 1, &rand);
+            fold.LearnPermutationFeaturesSubset = Compose(
+                trainingData.Learn->ObjectsData->GetFeaturesArraySubsetIndexing(),
+                fold.LearnPermutation->GetObjectsIndexing()
+            );
+        }
+
+        for (int depth : xrange(1, 11)) {
+            TSplitTree tree;
+            for (auto splitIdx : xrange(depth)) {
+                Y_UNUSED(splitIdx);
+                TSplitCandidate candidate;
+                candidate.Type = ESplitType::FloatFeature;
+                candidate.FeatureIdx = rng.Uniform(featureCount);
+                tree.AddSplit(TSplit(candidate, rng.Uniform(binCount - 1)));
+            }
+
+            TLearnLeafIndices learnLeafIndices;
+            UNIT_ASSERT(learnLeafIndices.Build(tree, trainingData, &localExecutor));
+
+            for (auto foldIdx : xrange(folds.size())) {
+                const auto& fold = folds[foldIdx];
+                const TString message = TStringBuilder() << "depth " << depth << ", fold " << foldIdx;
+
+                const TVector<TIndexType> expectedIndices = BuildIndices(
+                    fold,
+                    tree,
+                    trainingData,
+                    EBuildIndicesDataParts::LearnOnly,
+                    &localExecutor);
+
+                TVector<TIndexType> indicesBySplits(objectCount, 0);
+                for (auto curDepth : xrange(1, depth + 1)) {
+                    SetPermutedIndices(tree.Splits[curDepth - 1], trainingData, curDepth, fold, &indicesBySplits, &localExecutor);
+                }
+                UNIT_ASSERT_VALUES_EQUAL_C(indicesBySplits, expectedIndices, message);
+
+                const TVector<TIndexType> sharedIndices = BuildIndices(
+                    fold,
+                    tree,
+                    trainingData,
+                    EBuildIndicesDataParts::LearnOnly,
+                    &localExecutor,
+                    &learnLeafIndices);
+                UNIT_ASSERT_VALUES_EQUAL_C(sharedIndices, expectedIndices, message);
+
+                TVector<TIndexType> permutedIndices(objectCount);
+                learnLeafIndices.GetPermuted(fold.GetLearnPermutationArray(), &localExecutor, permutedIndices);
+                UNIT_ASSERT_VALUES_EQUAL_C(permutedIndices, expectedIndices, message);
+            }
+        }
+    }
+}
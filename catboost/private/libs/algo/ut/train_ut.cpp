@@ -6,9 +6,12 @@
 #include <library/threading/local_executor/local_executor.h>
 
 #include <util/random/fast.h>
+#include <util/generic/string.h>
 #include <util/generic/vector.h>
 #include <util/generic/xrange.h>
 
+#include <cmath>
+
 
 using namespace NCB;
 
@@ -139,4 +142,193 @@ Y_UNIT_TEST_SUITE(TTrainTest) {
             );
         }
     }
+
+    Y_UNIT_TEST(TestSplitScreening) {
+        const size_t docCount = 1000;
+        const ui32 factorCount = 20;
+
+        TReallyFastRng32 rng(123);
+
+        TVector<TVector<float>> docFeatures(docCount, TVector<float>(factorCount)); // [objectIdx][featureIdx]
+        for (size_t i = 0; i < docCount; ++i) {
+            for (size_t j = 0; j < factorCount; ++j) {
+                docFeatures[i][j] = rng.GenRandReal2();
+            }
+        }
+
+        const auto createDataProviders = [&] (const TVector<float>& target) {
+            TDataProviders dataProviders;
+            dataProviders.Learn = CreateDataProvider(
+                [&] (IRawObjectsOrderDataVisitor* visitor) {
+                    TDataMetaInfo metaInfo;
+                    metaInfo.TargetType = ERawTargetType::Float;
+                    metaInfo.TargetCount = 1;
+                    metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                        factorCount,
+                        TVector<ui32>{},
+                        TVector<ui32>{},
+                        TVector<TString>{});
+
+                    visitor->Start(false, metaInfo, false, docCount, EObjectsOrder::Undefined, {});
+                    visitor->StartNextBlock(docCount);
+                    for (auto objectIdx : xrange(docCount)) {
+                        visitor->AddAllFloatFeatures(objectIdx, docFeatures[objectIdx]);
+                        visitor->AddTarget(objectIdx, target[objectIdx]);
+                    }
+                    visitor->Finish();
+                }
+            );
+            return dataProviders;
+        };
+
+        const auto train = [&] (const TDataProviders& dataProviders, int depth, float screeningSampleRate, ui32 screeningTopCount) {
+            NJson::TJsonValue plainFitParams;
+            plainFitParams.InsertValue("random_seed", 5);
+            plainFitParams.InsertValue("iterations", 20);
+            plainFitParams.InsertValue("depth", depth);
+            // small enough for the step structure of the target to dominate the residuals in all trees
+            plainFitParams.InsertValue("learning_rate", 0.03);
+            plainFitParams.InsertValue("random_strength", 0);
+            plainFitParams.InsertValue("bootstrap_type", "No");
+            plainFitParams.InsertValue("boosting_type", "Plain");
+            plainFitParams.InsertValue("train_dir", ".");
+            plainFitParams.InsertValue("thread_count", 1);
+            plainFitParams.InsertValue("dev_split_screening_sample_rate", screeningSampleRate);
+            plainFitParams.InsertValue("dev_split_screening_top_count", screeningTopCount);
+
+            TFullModel model;
+            TrainModel(
+                plainFitParams,
+                nullptr,
+                Nothing(),
+                Nothing(),
+                dataProviders,
+                /*initModel*/ Nothing(),
+                /*initLearnProgress*/ nullptr,
+                "",
+                &model,
+                /*evalResultPtrs*/ {}
+            );
+            UNIT_ASSERT_VALUES_EQUAL(model.GetTreeCount(), 20);
+            return model;
+        };
+
+        {
+            TVector<float> target(docCount);
+            for (auto i : xrange(docCount)) {
+                target[i] = docFeatures[i][0] + 0.5 * docFeatures[i][1] + 0.1 * rng.GenRandReal2();
+            }
+            const TDataProviders dataProviders = createDataProviders(target);
+
+            // all candidates are rescored, so the trees are the same as without screening
+            UNIT_ASSERT(
+                train(dataProviders, /*depth*/ 4, /*screeningSampleRate*/ 0.3f, /*screeningTopCount*/ factorCount)
+                == train(dataProviders, /*depth*/ 4, /*screeningSampleRate*/ 1.0f, /*screeningTopCount*/ 1)
+            );
+        }
+        {
+            // the best feature at every level is far ahead of the others even on the screening sample,
+            // so the screening leader is the exact winner and rescoring finds the same border
+            TVector<float> target(docCount);
+            for (auto i : xrange(docCount)) {
+                target[i] = 4 * (docFeatures[i][3] > 0.5f) + 2 * (docFeatures[i][7] > 0.3f)
+                    + (docFeatures[i][11] > 0.7f) + 0.001 * rng.GenRandReal2();
+            }
+            const TDataProviders dataProviders = createDataProviders(target);
+
+            UNIT_ASSERT(
+                train(dataProviders, /*depth*/ 3, /*screeningSampleRate*/ 0.3f, /*screeningTopCount*/ 1)
+                == train(dataProviders, /*depth*/ 3, /*screeningSampleRate*/ 1.0f, /*screeningTopCount*/ 1)
+            );
+        }
+    }
+
+    Y_UNIT_TEST(TestThreadCountIndependence) {
+        // large enough for several blocks in stats calculation, bootstrap and metric evaluation
+        const size_t learnDocCount = 30000;
+        const size_t testDocCount = 20000;
+        const ui32 factorCount = 10;
+
+        TReallyFastRng32 rng(321);
+
+        const auto createDataProvider = [&] (size_t docCount) {
+            TVector<TVector<float>> docFeatures(docCount, TVector<float>(factorCount));
+            TVector<float> target(docCount);
+            for (auto i : xrange(docCount)) {
+                for (auto j : xrange(factorCount)) {
+                    docFeatures[i][j] = rng.GenRandReal2();
+                }
+                const double logit = 4 * docFeatures[i][0] - 2 * docFeatures[i][1] * docFeatures[i][2] - 1;
+                target[i] = rng.GenRandReal2() < 1 / (1 + std::exp(-logit)) ? 1.0f : 0.0f;
+            }
+            return CreateDataProvider(
+                [&] (IRawObjectsOrderDataVisitor* visitor) {
+                    TDataMetaInfo metaInfo;
+                    metaInfo.TargetType = ERawTargetType::Float;
+                    metaInfo.TargetCount = 1;
+                    metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                        factorCount,
+                        TVector<ui32>{},
+                        TVector<ui32>{},
+                        TVector<TString>{});
+
+                    visitor->Start(false, metaInfo, false, docCount, EObjectsOrder::Undefined, {});
+                    visitor->StartNextBlock(docCount);
+                    for (auto objectIdx : xrange(docCount)) {
+                        visitor->AddAllFloatFeatures(objectIdx, docFeatures[objectIdx]);
+                        visitor->AddTarget(objectIdx, target[objectIdx]);
+                    }
+                    visitor->Finish();
+                }
+            );
+        };
+
+        TDataProviders dataProviders;
+        dataProviders.Learn = createDataProvider(learnDocCount);
+        dataProviders.Test.push_back(createDataProvider(testDocCount));
+
+        const auto train = [&] (const TString& lossFunction, const TString& evalMetric, int threadCount) {
+            NJson::TJsonValue plainFitParams;
+            plainFitParams.InsertValue("loss_function", lossFunction);
+            plainFitParams.InsertValue("eval_metric", evalMetric);
+            plainFitParams.InsertValue("use_best_model", true);
+            plainFitParams.InsertValue("random_seed", 7);
+            plainFitParams.InsertValue("iterations", 30);
+            plainFitParams.InsertValue("depth", 6);
+            plainFitParams.InsertValue("bootstrap_type", "Bernoulli");
+            plainFitParams.InsertValue("subsample", 0.8);
+            plainFitParams.InsertValue("train_dir", ".");
+            plainFitParams.InsertValue("thread_count", threadCount);
+
+            TFullModel model;
+            TEvalResult evalResult;
+            TrainModel(
+                plainFitParams,
+                nullptr,
+                Nothing(),
+                Nothing(),
+                dataProviders,
+                /*initModel*/ Nothing(),
+                /*initLearnProgress*/ nullptr,
+                "",
+                &model,
+                {&evalResult}
+            );
+            return model;
+        };
+
+        // eval metric chooses the best iteration
+        const TVector<std::pair<TString, TString>> lossAndEvalMetrics = {
+            {"Logloss", "AUC"},
+            {"Logloss", "AUC:type=Ranking"},
+            {"MultiClass", "AUC:type=Mu"}
+        };
+        for (const auto& [lossFunction, evalMetric] : lossAndEvalMetrics) {
+            const TFullModel singleThreadModel = train(lossFunction, evalMetric, 1);
+            for (int threadCount : {4, 16}) {
+                // bitwise comparison of splits and leaf values
+                UNIT_ASSERT_C(train(lossFunction, evalMetric, threadCount) == singleThreadModel, evalMetric);
+            }
+        }
+    }
 }
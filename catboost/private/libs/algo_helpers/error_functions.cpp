@@ -1,5 +1,7 @@
 #include "error_functions.h"
 
+#include <catboost/libs/helpers/dispatch_generic_lambda.h>
+
 #include <util/generic/xrange.h>
 #include <util/random/normal.h>
 
@@ -499,6 +501,377 @@ void TCrossEntropyError::CalcDersRange(
     }
 }
 
+void IDerCalcer::CalcFirstDerMultiRange(
+    int start,
+    int count,
+    TConstArrayRef<TVector<double>> approxes,
+    const float* targets,
+    const float* weights,
+    TArrayRef<TVector<double>> firstDers
+) const {
+    const int approxDimension = approxes.size();
+    TVector<double> curApprox(approxDimension);
+    TVector<double> curDer(approxDimension);
+    for (int docId = start; docId < start + count; ++docId) {
+        for (int dim = 0; dim < approxDimension; ++dim) {
+            curApprox[dim] = approxes[dim][docId];
+        }
+        CalcDersMulti(curApprox, targets[docId], weights ? weights[docId] : 1, &curDer, /*der2*/ nullptr);
+        for (int dim = 0; dim < approxDimension; ++dim) {
+            firstDers[dim][docId] = curDer[dim];
+        }
+    }
+}
+
+// Objects are processed in blocks of this size so that the temporaries stay in L1
+// and MultiClass exponents are computed by one FastExpInplace call (AVX2/SSE2 kernel selected at runtime)
+static constexpr int DersBlockSize = 64;
+
+template <bool CalcThirdDer, bool UseTDers>
+static void ApplyWeightsToDersRange(
+    int start,
+    int count,
+    const float* weights,
+    TDers* ders,
+    double* firstDers
+) {
+    if (weights == nullptr) {
+        return;
+    }
+#pragma clang loop vectorize_width(4) interleave_count(2)
+    for (int i = start; i < start + count; ++i) {
+        if (UseTDers) {
+            ders[i].Der1 *= weights[i];
+            ders[i].Der2 *= weights[i];
+            if (CalcThirdDer) {
+                ders[i].Der3 *= weights[i];
+            }
+        } else {
+            firstDers[i] *= weights[i];
+        }
+    }
+}
+
+template <bool CalcThirdDer, bool UseTDers, bool HasDelta>
+static void CalcPoissonDerRangeImpl(
+    int start,
+    int count,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    TDers* ders,
+    double* firstDers
+) {
+    Y_ASSERT(HasDelta == (approxDeltas != nullptr));
+#pragma clang loop vectorize_width(4) interleave_count(2)
+    for (int i = start; i < start + count; ++i) {
+        double expApprox = approxes[i];
+        if (HasDelta) {
+            expApprox *= approxDeltas[i];
+        }
+        if (UseTDers) {
+            ders[i].Der1 = targets[i] - expApprox;
+            ders[i].Der2 = -expApprox;
+            if (CalcThirdDer) {
+                ders[i].Der3 = -expApprox;
+            }
+        } else {
+            firstDers[i] = targets[i] - expApprox;
+        }
+    }
+    ApplyWeightsToDersRange<CalcThirdDer, UseTDers>(start, count, weights, ders, firstDers);
+}
+
+void TPoissonError::CalcFirstDerRange(
+    int start,
+    int count,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    double* ders
+) const {
+    DispatchGenericLambda(
+        [&] (auto hasDelta) {
+            CalcPoissonDerRangeImpl</*CalcThirdDer*/ false, /*UseTDers*/ false, decltype(hasDelta)::value>(
+                start,
+                count,
+                approxes,
+                approxDeltas,
+                targets,
+                weights,
+                nullptr,
+                ders);
+        },
+        approxDeltas != nullptr);
+}
+
+void TPoissonError::CalcDersRange(
+    int start,
+    int count,
+    bool calcThirdDer,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    TDers* ders
+) const {
+    DispatchGenericLambda(
+        [&] (auto calcThirdDer, auto hasDelta) {
+            CalcPoissonDerRangeImpl<decltype(calcThirdDer)::value, /*UseTDers*/ true, decltype(hasDelta)::value>(
+                start,
+                count,
+                approxes,
+                approxDeltas,
+                targets,
+                weights,
+                ders,
+                nullptr);
+        },
+        calcThirdDer,
+        approxDeltas != nullptr);
+}
+
+template <bool CalcThirdDer, bool UseTDers, bool HasDelta>
+static void CalcQuantileDerRangeImpl(
+    double alpha,
+    double delta,
+    int start,
+    int count,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    TDers* ders,
+    double* firstDers
+) {
+    Y_ASSERT(HasDelta == (approxDeltas != nullptr));
+#pragma clang loop vectorize_width(4) interleave_count(2)
+    for (int i = start; i < start + count; ++i) {
+        double approx = approxes[i];
+        if (HasDelta) {
+            approx += approxDeltas[i];
+        }
+        const double diff = targets[i] - approx;
+        const double der = Abs(diff) < delta ? 0.0 : (diff > 0 ? alpha : -(1 - alpha));
+        if (UseTDers) {
+            ders[i].Der1 = der;
+            ders[i].Der2 = TQuantileError::QUANTILE_DER2_AND_DER3;
+            if (CalcThirdDer) {
+                ders[i].Der3 = TQuantileError::QUANTILE_DER2_AND_DER3;
+            }
+        } else {
+            firstDers[i] = der;
+        }
+    }
+    ApplyWeightsToDersRange<CalcThirdDer, UseTDers>(start, count, weights, ders, firstDers);
+}
+
+void TQuantileError::CalcFirstDerRange(
+    int start,
+    int count,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    double* ders
+) const {
+    DispatchGenericLambda(
+        [&] (auto hasDelta) {
+            CalcQuantileDerRangeImpl</*CalcThirdDer*/ false, /*UseTDers*/ false, decltype(hasDelta)::value>(
+                Alpha,
+                Delta,
+                start,
+                count,
+                approxes,
+                approxDeltas,
+                targets,
+                weights,
+                nullptr,
+                ders);
+        },
+        approxDeltas != nullptr);
+}
+
+void TQuantileError::CalcDersRange(
+    int start,
+    int count,
+    bool calcThirdDer,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    TDers* ders
+) const {
+    DispatchGenericLambda(
+        [&] (auto calcThirdDer, auto hasDelta) {
+            CalcQuantileDerRangeImpl<decltype(calcThirdDer)::value, /*UseTDers*/ true, decltype(hasDelta)::value>(
+                Alpha,
+                Delta,
+                start,
+                count,
+                approxes,
+                approxDeltas,
+                targets,
+                weights,
+                ders,
+                nullptr);
+        },
+        calcThirdDer,
+        approxDeltas != nullptr);
+}
+
+template <bool CalcThirdDer, bool UseTDers, bool HasDelta>
+static void CalcTweedieDerRangeImpl(
+    double variancePower,
+    int start,
+    int count,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    TDers* ders,
+    double* firstDers
+) {
+    Y_ASSERT(HasDelta == (approxDeltas != nullptr));
+    const double power1 = 1 - variancePower;
+    const double power2 = 2 - variancePower;
+    std::array<double, DersBlockSize> exp1;
+    std::array<double, DersBlockSize> exp2;
+    for (int blockStart = start; blockStart < start + count; blockStart += DersBlockSize) {
+        const int blockCount = Min(DersBlockSize, start + count - blockStart);
+        for (int i = 0; i < blockCount; ++i) {
+            double approx = approxes[blockStart + i];
+            if (HasDelta) {
+                approx += approxDeltas[blockStart + i];
+            }
+            // std::exp, not FastExpInplace: the fast one is less accurate and would change trained models
+            exp1[i] = std::exp(power1 * approx);
+            exp2[i] = std::exp(power2 * approx);
+        }
+#pragma clang loop vectorize_width(4) interleave_count(2)
+        for (int i = 0; i < blockCount; ++i) {
+            const double targetExp1 = targets[blockStart + i] * exp1[i];
+            if (UseTDers) {
+                ders[blockStart + i].Der1 = targetExp1 - exp2[i];
+                ders[blockStart + i].Der2 = targetExp1 * power1 - exp2[i] * power2;
+                if (CalcThirdDer) {
+                    ders[blockStart + i].Der3 = targetExp1 * Sqr(power1) - exp2[i] * Sqr(power2);
+                }
+            } else {
+                firstDers[blockStart + i] = targetExp1 - exp2[i];
+            }
+        }
+    }
+    ApplyWeightsToDersRange<CalcThirdDer, UseTDers>(start, count, weights, ders, firstDers);
+}
+
+void TTweedieError::CalcFirstDerRange(
+    int start,
+    int count,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    double* ders
+) const {
+    DispatchGenericLambda(
+        [&] (auto hasDelta) {
+            CalcTweedieDerRangeImpl</*CalcThirdDer*/ false, /*UseTDers*/ false, decltype(hasDelta)::value>(
+                VariancePower,
+                start,
+                count,
+                approxes,
+                approxDeltas,
+                targets,
+                weights,
+                nullptr,
+                ders);
+        },
+        approxDeltas != nullptr);
+}
+
+void TTweedieError::CalcDersRange(
+    int start,
+    int count,
+    bool calcThirdDer,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    TDers* ders
+) const {
+    DispatchGenericLambda(
+        [&] (auto calcThirdDer, auto hasDelta) {
+            CalcTweedieDerRangeImpl<decltype(calcThirdDer)::value, /*UseTDers*/ true, decltype(hasDelta)::value>(
+                VariancePower,
+                start,
+                count,
+                approxes,
+                approxDeltas,
+                targets,
+                weights,
+                ders,
+                nullptr);
+        },
+        calcThirdDer,
+        approxDeltas != nullptr);
+}
+
+void TMultiClassError::CalcFirstDerMultiRange(
+    int start,
+    int count,
+    TConstArrayRef<TVector<double>> approxes,
+    const float* targets,
+    const float* weights,
+    TArrayRef<TVector<double>> firstDers
+) const {
+    const int approxDimension = approxes.size();
+    std::array<double, DersBlockSize> maxApprox;
+    std::array<double, DersBlockSize> sumExpApprox;
+    for (int blockStart = start; blockStart < start + count; blockStart += DersBlockSize) {
+        const int blockCount = Min(DersBlockSize, start + count - blockStart);
+        std::copy(approxes[0].begin() + blockStart, approxes[0].begin() + blockStart + blockCount, maxApprox.begin());
+        for (int dim = 1; dim < approxDimension; ++dim) {
+            const double* approx = approxes[dim].data() + blockStart;
+            for (int i = 0; i < blockCount; ++i) {
+                maxApprox[i] = Max(maxApprox[i], approx[i]);
+            }
+        }
+        std::fill(sumExpApprox.begin(), sumExpApprox.begin() + blockCount, 0.0);
+        for (int dim = 0; dim < approxDimension; ++dim) {
+            const double* approx = approxes[dim].data() + blockStart;
+            double* der = firstDers[dim].data() + blockStart;
+            for (int i = 0; i < blockCount; ++i) {
+                der[i] = approx[i] - maxApprox[i];
+            }
+            FastExpInplace(der, blockCount);
+            for (int i = 0; i < blockCount; ++i) {
+                sumExpApprox[i] += der[i];
+            }
+        }
+        for (int dim = 0; dim < approxDimension; ++dim) {
+            double* der = firstDers[dim].data() + blockStart;
+#pragma clang loop vectorize_width(4) interleave_count(2)
+            for (int i = 0; i < blockCount; ++i) {
+                der[i] = -der[i] / sumExpApprox[i];
+            }
+        }
+        for (int i = 0; i < blockCount; ++i) {
+            firstDers[static_cast<int>(targets[blockStart + i])][blockStart + i] += 1;
+        }
+        if (weights != nullptr) {
+            for (int dim = 0; dim < approxDimension; ++dim) {
+                double* der = firstDers[dim].data() + blockStart;
+                for (int i = 0; i < blockCount; ++i) {
+                    der[i] *= weights[blockStart + i];
+                }
+            }
+        }
+    }
+}
+
 void TQuerySoftMaxError::CalcDersForSingleQuery(
     int start,
     int offset,
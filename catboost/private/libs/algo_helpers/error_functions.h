@@ -111,6 +111,18 @@ public:
         CB_ENSURE(false, "Not implemented");
     }
 
+    /* Weighted first derivatives for docs [start, start + count) of a multidimensional approx.
+     * approxes and firstDers are stored as [dimensionIdx][docIdx].
+     */
+    virtual void CalcFirstDerMultiRange(
+        int start,
+        int count,
+        TConstArrayRef<TVector<double>> approxes,
+        const float* targets,
+        const float* weights,
+        TArrayRef<TVector<double>> firstDers
+    ) const;
+
     virtual void CalcDersForQueries(
         int /*queryStartIndex*/,
         int /*queryEndIndex*/,
@@ -298,6 +310,27 @@ public:
         CB_ENSURE(isExpApprox == false, "Approx format does not match");
     }
 
+    void CalcFirstDerRange(
+        int start,
+        int count,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        double* ders
+    ) const override;
+
+    void CalcDersRange(
+        int start,
+        int count,
+        bool calcThirdDer,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        TDers* ders
+    ) const override;
+
 private:
     double CalcDer(double approx, float target) const override {
         const double val = target - approx;
@@ -454,6 +487,27 @@ public:
         CB_ENSURE(isExpApprox == true, "Approx format does not match");
     }
 
+    void CalcFirstDerRange(
+        int start,
+        int count,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        double* ders
+    ) const override;
+
+    void CalcDersRange(
+        int start,
+        int count,
+        bool calcThirdDer,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        TDers* ders
+    ) const override;
+
 private:
     double CalcDer(double approxExp, float target) const override {
         return target - approxExp;
@@ -476,6 +530,15 @@ public:
         CB_ENSURE(isExpApprox == false, "Approx format does not match");
     }
 
+    void CalcFirstDerMultiRange(
+        int start,
+        int count,
+        TConstArrayRef<TVector<double>> approxes,
+        const float* targets,
+        const float* weights,
+        TArrayRef<TVector<double>> firstDers
+    ) const override;
+
     void CalcDersMulti(
         const TVector<double>& approx,
         float target,
@@ -1098,6 +1161,27 @@ public:
         CB_ENSURE(isExpApprox == false, "Approx format does not match");
     }
 
+    void CalcFirstDerRange(
+        int start,
+        int count,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        double* ders
+    ) const override;
+
+    void CalcDersRange(
+        int start,
+        int count,
+        bool calcThirdDer,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        TDers* ders
+    ) const override;
+
 private:
     double CalcDer(double approx, float target) const override {
         double der = target * std::exp((1 - VariancePower) * approx);
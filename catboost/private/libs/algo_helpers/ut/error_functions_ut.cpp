@@ -0,0 +1,174 @@
+#include <library/unittest/registar.h>
+#include <catboost/private/libs/algo_helpers/error_functions.h>
+
+#include <util/random/fast.h>
+
+#include <cmath>
+
+namespace {
+    struct TDersTestData {
+        TVector<double> Approxes;
+        TVector<double> ApproxDeltas;
+        TVector<float> Targets;
+        TVector<float> Weights;
+    };
+}
+
+static TDersTestData GenerateData(int count, bool isExpApprox, bool isIntegerTarget, ui64 seed) {
+    TFastRng64 rng(seed);
+    TDersTestData data;
+    for (int i = 0; i < count; ++i) {
+        const double approx = 4 * rng.GenRandReal1() - 2;
+        const double approxDelta = rng.GenRandReal1() - 0.5;
+        data.Approxes.push_back(isExpApprox ? std::exp(approx) : approx);
+        data.ApproxDeltas.push_back(isExpApprox ? std::exp(approxDelta) : approxDelta);
+        data.Targets.push_back(isIntegerTarget ? rng.Uniform(5) : 3 * rng.GenRandReal1());
+        data.Weights.push_back(rng.GenRandReal1() + 0.5);
+    }
+    return data;
+}
+
+template <class TReferenceDers>
+static void CheckDersRange(
+    const IDerCalcer& error,
+    const TDersTestData& data,
+    bool useDeltas,
+    bool useWeights,
+    double relativeTolerance,
+    TReferenceDers&& calcReferenceDers // (updatedApprox, target) -> TDers
+) {
+    // odd start and count exercise block tails
+    const int start = 3;
+    const int count = data.Approxes.ysize() - 2 * start;
+    const double* approxDeltas = useDeltas ? data.ApproxDeltas.data() : nullptr;
+    const float* weights = useWeights ? data.Weights.data() : nullptr;
+
+    TVector<TDers> ders(data.Approxes.size());
+    TVector<double> firstDers(data.Approxes.size());
+    error.CalcDersRange(start, count, /*calcThirdDer*/ true, data.Approxes.data(), approxDeltas, data.Targets.data(), weights, ders.data());
+    error.CalcFirstDerRange(start, count, data.Approxes.data(), approxDeltas, data.Targets.data(), weights, firstDers.data());
+
+    for (int i = start; i < start + count; ++i) {
+        double approx = data.Approxes[i];
+        if (useDeltas) {
+            approx = UpdateApprox(error.GetIsExpApprox(), approx, data.ApproxDeltas[i]);
+        }
+        const double w = useWeights ? data.Weights[i] : 1.0;
+        const TDers expected = calcReferenceDers(approx, data.Targets[i]);
+        UNIT_ASSERT_DOUBLES_EQUAL(ders[i].Der1, w * expected.Der1, relativeTolerance * (1 + Abs(expected.Der1)));
+        UNIT_ASSERT_DOUBLES_EQUAL(ders[i].Der2, w * expected.Der2, relativeTolerance * (1 + Abs(expected.Der2)));
+        UNIT_ASSERT_DOUBLES_EQUAL(ders[i].Der3, w * expected.Der3, relativeTolerance * (1 + Abs(expected.Der3)));
+        UNIT_ASSERT_DOUBLES_EQUAL(firstDers[i], ders[i].Der1, 1e-12 * (1 + Abs(expected.Der1)));
+    }
+}
+
+template <class TReferenceDers>
+static void CheckDersRangeAllModes(
+    const IDerCalcer& error,
+    bool isIntegerTarget,
+    TReferenceDers&& calcReferenceDers,
+    double relativeTolerance = 1e-9
+) {
+    const auto data = GenerateData(/*count*/ 1000, error.GetIsExpApprox(), isIntegerTarget, /*seed*/ 0);
+    for (bool useDeltas : {false, true}) {
+        for (bool useWeights : {false, true}) {
+            CheckDersRange(error, data, useDeltas, useWeights, relativeTolerance, calcReferenceDers);
+        }
+    }
+}
+
+Y_UNIT_TEST_SUITE(ErrorFunctionsDersRangeTest) {
+    Y_UNIT_TEST(CrossEntropy) {
+        for (bool isExpApprox : {false, true}) {
+            CheckDersRangeAllModes(
+                TCrossEntropyError(isExpApprox),
+                /*isIntegerTarget*/ false,
+                [=] (double approx, float target) {
+                    const double p = isExpApprox ? approx / (1 + approx) : 1 / (1 + std::exp(-approx));
+                    return TDers{target - p, -p * (1 - p), -p * (1 - p) * (1 - 2 * p)};
+                });
+        }
+    }
+
+    Y_UNIT_TEST(Poisson) {
+        CheckDersRangeAllModes(
+            TPoissonError(/*isExpApprox*/ true),
+            /*isIntegerTarget*/ true,
+            [] (double expApprox, float target) {
+                return TDers{target - expApprox, -expApprox, -expApprox};
+            });
+    }
+
+    Y_UNIT_TEST(Quantile) {
+        const double alpha = 0.3;
+        CheckDersRangeAllModes(
+            TQuantileError(alpha, /*delta*/ 1e-6, /*isExpApprox*/ false),
+            /*isIntegerTarget*/ false,
+            [=] (double approx, float target) {
+                return TDers{target - approx > 0 ? alpha : -(1 - alpha), 0.0, 0.0};
+            });
+    }
+
+    Y_UNIT_TEST(Tweedie) {
+        const double variancePower = 1.5;
+        CheckDersRangeAllModes(
+            TTweedieError(variancePower, /*isExpApprox*/ false),
+            /*isIntegerTarget*/ false,
+            [=] (double approx, float target) {
+                const double exp1 = std::exp((1 - variancePower) * approx);
+                const double exp2 = std::exp((2 - variancePower) * approx);
+                return TDers{
+                    target * exp1 - exp2,
+                    target * exp1 * (1 - variancePower) - exp2 * (2 - variancePower),
+                    target * exp1 * Sqr(1 - variancePower) - exp2 * Sqr(2 - variancePower)};
+            },
+            // the same std::exp as in per-object CalcDer, so trained models do not change
+            /*relativeTolerance*/ 1e-14);
+    }
+
+    Y_UNIT_TEST(MultiClass) {
+        const int approxDimension = 5;
+        const int docCount = 1000;
+        TFastRng64 rng(0);
+        TVector<TVector<double>> approxes(approxDimension, TVector<double>(docCount));
+        for (auto& approx : approxes) {
+            for (auto& value : approx) {
+                value = 10 * rng.GenRandReal1() - 5;
+            }
+        }
+        TVector<float> targets(docCount);
+        TVector<float> weights(docCount);
+        for (int docId = 0; docId < docCount; ++docId) {
+            targets[docId] = rng.Uniform(approxDimension);
+            weights[docId] = rng.GenRandReal1() + 0.5;
+        }
+
+        const TMultiClassError error(/*isExpApprox*/ false);
+        for (bool useWeights : {false, true}) {
+            const float* weightsData = useWeights ? weights.data() : nullptr;
+            TVector<TVector<double>> ders(approxDimension, TVector<double>(docCount));
+            error.CalcFirstDerMultiRange(1, docCount - 2, approxes, targets.data(), weightsData, ders);
+
+            TVector<double> curApprox(approxDimension);
+            for (int docId = 1; docId < docCount - 1; ++docId) {
+                double maxApprox = approxes[0][docId];
+                for (int dim = 0; dim < approxDimension; ++dim) {
+                    curApprox[dim] = approxes[dim][docId];
+                    maxApprox = Max(maxApprox, curApprox[dim]);
+                }
+                double sumExp = 0;
+                for (int dim = 0; dim < approxDimension; ++dim) {
+                    sumExp += std::exp(curApprox[dim] - maxApprox);
+                }
+                const double w = useWeights ? weights[docId] : 1.0;
+                for (int dim = 0; dim < approxDimension; ++dim) {
+                    double expected = -std::exp(curApprox[dim] - maxApprox) / sumExp;
+                    if (dim == static_cast<int>(targets[docId])) {
+                        expected += 1;
+                    }
+                    UNIT_ASSERT_DOUBLES_EQUAL(ders[dim][docId], w * expected, 1e-9);
+                }
+            }
+        }
+    }
+}
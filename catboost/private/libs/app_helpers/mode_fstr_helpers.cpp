@@ -1,17 +1,23 @@
 #include "mode_fstr_helpers.h"
+#include "proceed_pool_in_blocks.h"
 
 #include <catboost/libs/data/load_data.h>
 #include <catboost/libs/data/model_dataset_compatibility.h>
 #include <catboost/libs/fstr/compare_documents.h>
 #include <catboost/libs/fstr/output_fstr.h>
+#include <catboost/libs/fstr/shap_interaction_values.h>
 #include <catboost/libs/fstr/shap_values.h>
+#include <catboost/libs/fstr/util.h>
 #include <catboost/libs/logging/logging.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/model/model.h>
+#include <catboost/private/libs/data_util/line_data_reader.h>
 
 #include <util/folder/path.h>
 #include <util/generic/ptr.h>
 #include <util/generic/serialized_enum.h>
+#include <util/generic/xrange.h>
+#include <util/stream/file.h>
 #include <util/string/cast.h>
 #include <util/system/yassert.h>
 
@@ -65,6 +71,74 @@ namespace {
     };
 }
 
+/* Dataset is read and processed in parts of ShapReadBlockSize documents, so that neither the dataset
+ * nor SHAP values are kept in memory as a whole. Leaf weights are collected by an additional pass
+ * if the model has no leaf weights.
+ */
+static void CalcAndOutputShapValuesInBlocks(
+    const TFullModel& model,
+    const NCB::TAnalyticalModeCommonParams& params,
+    NPar::TLocalExecutor* localExecutor) {
+
+    if (model.HasCategoricalFeatures()) {
+        CB_ENSURE(params.ColumnarPoolFormatParams.CdFilePath.Inited(),
+                  "Model has categorical features. Specify column_description file with correct categorical features.");
+    }
+    CB_ENSURE(params.ShapReadBlockSize > 0, "SHAP values read block size should be positive");
+
+    TVector<double> leafWeights;
+    // used by Auto mode to choose between precalculation for all leaves and calculation for each document
+    TMaybe<size_t> objectCount;
+    if (model.ModelTrees->GetLeafWeights().empty()) {
+        TSetLoggingSilent inThisScope;
+        leafWeights.resize(model.ModelTrees->GetLeafValues().size() / model.GetDimensionsCount());
+        objectCount = 0;
+        ReadAndProceedPoolInBlocks(params, params.ShapReadBlockSize, [&](const NCB::TDataProviderPtr datasetPart) {
+            CheckModelAndDatasetCompatibility(model, *datasetPart->ObjectsData.Get());
+            const auto leafWeightsForPart = CollectLeavesStatistics(*datasetPart, model, localExecutor);
+            for (auto leafIdx : xrange(leafWeights.size())) {
+                leafWeights[leafIdx] += leafWeightsForPart[leafIdx];
+            }
+            *objectCount += datasetPart->ObjectsGrouping->GetObjectCount();
+        }, localExecutor);
+    } else if (NCB::TLineDataReaderFactory::Has(params.InputPath.Scheme)) {
+        // lines are counted without parsing
+        objectCount = NCB::GetLineDataReader(params.InputPath, params.ColumnarPoolFormatParams.DsvFormat)
+            ->GetDataLineCount();
+    }
+
+    TShapPreparedTrees preparedTrees = PrepareTrees(
+        model,
+        leafWeights,
+        objectCount,
+        EPreCalcShapValues::Auto,
+        /*calcInternalValues*/ false,
+        params.ShapCalcType);
+    CalcShapValuesByLeaf(
+        model,
+        /*fixedFeatureParams*/ Nothing(),
+        params.Verbose,
+        preparedTrees.CalcInternalValues,
+        localExecutor,
+        &preparedTrees,
+        params.ShapCalcType);
+
+    TShapValuesWriter writer(params.OutputPath.Path, params.ShapOutputFormat, params.ShapTopFeatureCount);
+    TSetLoggingSilent silentLoading; // only progress of SHAP values calculation is logged
+    ReadAndProceedPoolInBlocks(params, params.ShapReadBlockSize, [&](const NCB::TDataProviderPtr datasetPart) {
+        TSetLoggingVerbose verboseCalculation;
+        CheckModelAndDatasetCompatibility(model, *datasetPart->ObjectsData.Get());
+        CalcAndOutputShapValues(
+            model,
+            *datasetPart,
+            preparedTrees,
+            params.Verbose,
+            localExecutor,
+            &writer,
+            params.ShapCalcType);
+    }, localExecutor);
+}
+
 void NCB::PrepareFstrModeParamsParser(
     NCB::TAnalyticalModeCommonParams* paramsPtr,
     NLastGetopt::TOpts* parserPtr) {
@@ -92,6 +166,23 @@ void NCB::PrepareFstrModeParamsParser(
                     calcType + " shap calculation type is not supported");
         });
 
+    const auto shapOutputFormatDescription =
+            TString::Join("SHAP values output format. Should be one of: ", GetEnumAllNames<EShapValuesOutputFormat>());
+    parser.AddLongOption("shap-output-format", shapOutputFormatDescription)
+        .DefaultValue("Tsv")
+        .Handler1T<TString>([&params](const TString& outputFormat) {
+            CB_ENSURE(TryFromString<EShapValuesOutputFormat>(outputFormat, params.ShapOutputFormat),
+                    outputFormat + " shap output format is not supported");
+        });
+    parser.AddLongOption("shap-top-k", "Count of features with maximal absolute SHAP values for TopKTsv output format")
+        .RequiredArgument("INT")
+        .DefaultValue(ToString(params.ShapTopFeatureCount))
+        .StoreResult(&params.ShapTopFeatureCount);
+    parser.AddLongOption("shap-read-block-size", "Count of documents read and processed at once for SHAP values")
+        .RequiredArgument("INT")
+        .DefaultValue(ToString(params.ShapReadBlockSize))
+        .StoreResult(&params.ShapReadBlockSize);
+
     parser.AddLongOption("verbose", "Log writing period")
         .DefaultValue("0")
         .Handler1T<TString>([&params](const TString& verbose) {
@@ -101,6 +192,29 @@ void NCB::PrepareFstrModeParamsParser(
     parser.SetFreeArgsNum(0);
 }
 
+/* Only pairs of features splitting the same tree are written, one line per pair:
+ * documentIdx, first and second feature indices (first <= second) and values for all dimensions.
+ */
+static void CalcAndOutputSparseShapInteractionValues(
+    const TFullModel& model,
+    const NCB::TDataProvider& dataset,
+    const TString& outputPath,
+    int logPeriod,
+    NPar::TLocalExecutor* localExecutor) {
+
+    const auto shapInteractionValues = CalcSparseShapInteractionValuesMulti(model, dataset, logPeriod, localExecutor);
+    TFileOutput out(outputPath);
+    for (auto documentIdx : xrange(shapInteractionValues.size())) {
+        for (const auto& value : shapInteractionValues[documentIdx]) {
+            out << documentIdx << '\t' << value.FirstFeature << '\t' << value.SecondFeature;
+            for (double dimensionValue : value.Values) {
+                out << '\t' << dimensionValue;
+            }
+            out << '\n';
+        }
+    }
+}
+
 void NCB::ModeFstrSingleHost(const NCB::TAnalyticalModeCommonParams& params) {
 
     NCatboostOptions::ValidatePoolParams(params.InputPath, params.ColumnarPoolFormatParams);
@@ -146,13 +260,15 @@ void NCB::ModeFstrSingleHost(const NCB::TAnalyticalModeCommonParams& params) {
             CalcAndOutputInteraction(model, fstrPathPtr, internalFstrPathPtr);
             break;
         case EFstrType::ShapValues:
-            CalcAndOutputShapValues(model,
-                                    *poolLoader(),
-                                    params.OutputPath.Path,
-                                    params.Verbose,
-                                    EPreCalcShapValues::Auto,
-                                    localExecutor.Get(),
-                                    params.ShapCalcType);
+            CalcAndOutputShapValuesInBlocks(model, params, localExecutor.Get());
+            break;
+        case EFstrType::ShapInteractionValues:
+            CalcAndOutputSparseShapInteractionValues(
+                model,
+                *poolLoader(),
+                params.OutputPath.Path,
+                params.Verbose,
+                localExecutor.Get());
             break;
         case EFstrType::PredictionDiff:
             CalcAndOutputPredictionDiff(
@@ -24,6 +24,62 @@ namespace NCB {
         return count;
     }
 
+    TFilePartLineDataReader::TFilePartLineDataReader(
+        const TLineDataReaderArgs& args,
+        ui32 partIdx,
+        ui32 partCount
+    )
+        : Args(args)
+        , PartIdx(partIdx)
+        , PartCount(partCount)
+        , File(args.PathWithScheme.Path, OpenExisting | RdOnly | Seq)
+    {
+        CB_ENSURE(partIdx < partCount, "TFilePartLineDataReader: part index " << partIdx << " is out of range");
+        ui64 dataBegin = 0;
+        if (Args.Format.HasHeader) {
+            TIFStream headerStream(File);
+            TString header;
+            dataBegin = headerStream.ReadLine(header);
+            CB_ENSURE(dataBegin, "TFilePartLineDataReader: no header in file");
+            Header = std::move(header);
+        }
+        const ui64 dataSize = (ui64)File.GetLength() - dataBegin;
+        const ui64 partBegin = dataBegin + dataSize * partIdx / partCount;
+        PartEnd = dataBegin + dataSize * (partIdx + 1) / partCount;
+
+        // the line containing the last byte of the previous part belongs to the previous part
+        Position = (partBegin > dataBegin) ? partBegin - 1 : partBegin;
+        File.Seek(Position, sSet);
+        IFStream = MakeHolder<TIFStream>(File);
+        if (partBegin > dataBegin) {
+            TString tail;
+            Position += IFStream->ReadTo(tail, '\n');
+        }
+    }
+
+    ui64 TFilePartLineDataReader::GetDataLineCount() {
+        TFilePartLineDataReader partReader(Args, PartIdx, PartCount);
+        ui64 lineCount = 0;
+        TString line;
+        while (partReader.ReadLine(&line)) {
+            ++lineCount;
+        }
+        return lineCount;
+    }
+
+    bool TFilePartLineDataReader::ReadLine(TString* line) {
+        if (Position >= PartEnd) {
+            return false;
+        }
+        const size_t readSize = IFStream->ReadLine(*line);
+        if (!readSize) {
+            return false;
+        }
+        LineOffset = Position;
+        Position += readSize;
+        return true;
+    }
+
     TLineDataReaderFactory::TRegistrator<TFileLineDataReader> DefLineDataReaderReg("");
     TLineDataReaderFactory::TRegistrator<TFileLineDataReader> FileLineDataReaderReg("file");
     TLineDataReaderFactory::TRegistrator<TFileLineDataReader> DsvLineDataReaderReg("dsv");
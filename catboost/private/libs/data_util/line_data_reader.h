@@ -10,6 +10,7 @@
 #include <util/generic/string.h>
 
 #include <util/stream/file.h>
+#include <util/system/file.h>
 
 
 
@@ -97,4 +98,38 @@ namespace NCB {
         bool HeaderProcessed;
     };
 
+    /* Data lines of a file (after the header, if present) are split to partCount parts of about the same
+       size in bytes, the reader returns lines that start in part partIdx, so parts contain each line once.
+       Lines of the preceding parts are not scanned, the reader seeks to the part begin.
+    */
+    class TFilePartLineDataReader : public ILineDataReader {
+    public:
+        TFilePartLineDataReader(const TLineDataReaderArgs& args, ui32 partIdx, ui32 partCount);
+
+        // scans the part
+        ui64 GetDataLineCount() override;
+
+        TMaybe<TString> GetHeader() override {
+            return Header;
+        }
+
+        bool ReadLine(TString* line) override;
+
+        // offset in file of the line returned by the last ReadLine call
+        ui64 GetLineOffset() const {
+            return LineOffset;
+        }
+
+    private:
+        TLineDataReaderArgs Args;
+        ui32 PartIdx;
+        ui32 PartCount;
+        TFile File;
+        THolder<TIFStream> IFStream;
+        TMaybe<TString> Header;
+        ui64 PartEnd = 0;
+        ui64 Position = 0;
+        ui64 LineOffset = 0;
+    };
+
 }
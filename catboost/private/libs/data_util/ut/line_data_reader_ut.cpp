@@ -0,0 +1,82 @@
+#include <catboost/private/libs/data_util/line_data_reader.h>
+
+#include <util/generic/xrange.h>
+#include <util/stream/file.h>
+#include <util/string/cast.h>
+#include <util/system/mktemp.h>
+#include <util/system/tempfile.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+
+
+static TVector<TString> ReadAllParts(const TString& path, bool hasHeader, ui32 partCount) {
+    TLineDataReaderArgs args{TPathWithScheme(path), TDsvFormatOptions{hasHeader}};
+    TVector<TString> lines;
+    for (auto partIdx : xrange(partCount)) {
+        TFilePartLineDataReader reader(args, partIdx, partCount);
+        if (hasHeader) {
+            UNIT_ASSERT_VALUES_EQUAL(*reader.GetHeader(), "f0\tf1");
+        }
+        const ui64 lineCountBefore = lines.size();
+        TString line;
+        while (reader.ReadLine(&line)) {
+            lines.push_back(line);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(reader.GetDataLineCount(), lines.size() - lineCountBefore);
+    }
+    return lines;
+}
+
+
+Y_UNIT_TEST_SUITE(TFilePartLineDataReaderTest) {
+    Y_UNIT_TEST(PartsContainEachLineOnce) {
+        TVector<TString> expectedLines;
+        for (auto lineIdx : xrange(100)) {
+            // lines of different length
+            expectedLines.push_back(ToString(lineIdx) + "\t" + TString(lineIdx % 7, 'x'));
+        }
+        for (bool hasHeader : {false, true}) {
+            for (bool hasLastLineBreak : {false, true}) {
+                for (TStringBuf lineBreak : {TStringBuf("\n"), TStringBuf("\r\n")}) {
+                    TTempFile file(MakeTempName());
+                    {
+                        TOFStream out(file.Name());
+                        if (hasHeader) {
+                            out << "f0\tf1" << lineBreak;
+                        }
+                        for (auto lineIdx : xrange(expectedLines.size())) {
+                            out << expectedLines[lineIdx];
+                            if (hasLastLineBreak || (lineIdx + 1 < expectedLines.size())) {
+                                out << lineBreak;
+                            }
+                        }
+                    }
+                    for (ui32 partCount : {1, 2, 3, 7, 100, 1000}) {
+                        UNIT_ASSERT_EQUAL(ReadAllParts(file.Name(), hasHeader, partCount), expectedLines);
+                    }
+                }
+            }
+        }
+    }
+
+    Y_UNIT_TEST(LineOffsets) {
+        TTempFile file(MakeTempName());
+        TOFStream(file.Name()).Write("a\nbb\nccc\n");
+        TFilePartLineDataReader reader(TLineDataReaderArgs{TPathWithScheme(file.Name()), {}}, 1, 2);
+        TString line;
+        UNIT_ASSERT(reader.ReadLine(&line));
+        UNIT_ASSERT_VALUES_EQUAL(line, "ccc");
+        UNIT_ASSERT_VALUES_EQUAL(reader.GetLineOffset(), 5);
+        UNIT_ASSERT(!reader.ReadLine(&line));
+    }
+
+    Y_UNIT_TEST(EmptyData) {
+        TTempFile file(MakeTempName());
+        TOFStream(file.Name()).Write("f0\tf1\n");
+        const auto lines = ReadAllParts(file.Name(), /*hasHeader*/ true, 3);
+        UNIT_ASSERT(lines.empty());
+    }
+}
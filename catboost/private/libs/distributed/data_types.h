@@ -6,6 +6,7 @@
 #include <catboost/private/libs/algo/pairwise_scoring.h>
 #include <catboost/private/libs/algo/score_calcers.h>
 #include <catboost/private/libs/algo/target_classifier.h>
+#include <catboost/private/libs/algo/tensor_search_helpers.h>
 #include <catboost/private/libs/algo_helpers/online_predictor.h>
 #include <catboost/libs/data/data_provider.h>
 #include <catboost/libs/helpers/restorable_rng.h>
@@ -15,6 +16,7 @@
 #include <catboost/private/libs/options/enums.h>
 #include <catboost/private/libs/options/load_options.h>
 #include <catboost/private/libs/options/restrictions.h>
+#include <catboost/private/libs/quantization/quantile_sketch.h>
 
 #include <library/binsaver/bin_saver.h>
 #include <library/json/json_value.h>
@@ -24,6 +26,12 @@
 #include <util/generic/maybe.h>
 #include <util/generic/ptr.h>
 #include <util/generic/singleton.h>
+#include <util/datetime/base.h>
+#include <util/system/guard.h>
+#include <util/system/hp_timer.h>
+#include <util/system/spinlock.h>
+
+#include <atomic>
 
 #define SHARED_ID_TRAIN_DATA                (0xd66d480)
 
@@ -65,6 +73,7 @@ namespace NCatboostDistributed {
         ui32 AllDocCount;
         double SumAllWeights;
         EHessianType HessianType;
+        bool IsRebuild; // after learn objects redistribution, worker random generators continue their sequences
 
     public:
         TPlainFoldBuilderParams() = default;
@@ -76,7 +85,8 @@ namespace NCatboostDistributed {
             TrainParams,
             AllDocCount,
             SumAllWeights,
-            HessianType);
+            HessianType,
+            IsRebuild);
     };
 
     struct TDatasetLoaderParams {
@@ -99,6 +109,117 @@ namespace NCatboostDistributed {
             RandomSeed);
     };
 
+    /* Raw learn dataset file is split to parts of about the same size in bytes,
+     * each worker seeks to its part and builds sketches of the lines in it
+     */
+    struct TQuantileSketchBuilderParams {
+        NCatboostOptions::TPoolLoadParams PoolLoadOptions;
+        TVector<ui32> FloatFeatureIdxByColumn; // Max<ui32>() for other and ignored columns
+        ui32 FloatFeatureCount;
+
+    public:
+        TQuantileSketchBuilderParams() = default;
+
+        SAVELOAD(PoolLoadOptions, FloatFeatureIdxByColumn, FloatFeatureCount);
+    };
+
+    // what is needed to select best splits of candidates in feature-parallel mode, [dataset] as in TCandidatesContext
+    struct TFeatureParallelCandidates {
+        TVector<TCandidateList> CandidateLists;
+        TVector<TVector<TVector<ui32>>> SelectedFeaturesInBundles;
+        TVector<TVector<NCB::TBinaryFeaturesPack>> PerBinaryPackMasks;
+        TVector<TVector<TVector<ui32>>> SelectedFeaturesInGroups;
+        double ScoreStDev = 0;
+        ui64 RandSeed = 0;
+
+    public:
+        SAVELOAD(
+            CandidateLists,
+            SelectedFeaturesInBundles,
+            PerBinaryPackMasks,
+            SelectedFeaturesInGroups,
+            ScoreStDev,
+            RandSeed);
+    };
+
+    // tensor search of one tree on a worker, in seconds
+    struct TWorkerTimeStats {
+        double WallTime = 0; // from the start until the end of the last job
+        double BusyTime = 0; // when at least one job runs
+
+    public:
+        SAVELOAD(WallTime, BusyTime);
+    };
+
+    // jobs of one tree can run concurrently, so busy time is the length of the union of their intervals
+    class TTensorSearchTimer {
+    public:
+        void Restart() {
+            TGuard<TAdaptiveLock> guard(Lock);
+            Timer.Reset();
+            ActiveJobCount = 0;
+            Stats = TWorkerTimeStats();
+        }
+
+        void StartJob() {
+            TGuard<TAdaptiveLock> guard(Lock);
+            if (ActiveJobCount++ == 0) {
+                BusyStart = Timer.Passed();
+            }
+        }
+
+        void FinishJob() {
+            TGuard<TAdaptiveLock> guard(Lock);
+            if (--ActiveJobCount == 0) {
+                Stats.WallTime = Timer.Passed();
+                Stats.BusyTime += Stats.WallTime - BusyStart;
+            }
+        }
+
+        TWorkerTimeStats GetStats() const {
+            TGuard<TAdaptiveLock> guard(Lock);
+            return Stats;
+        }
+
+        // artificial throttling of the worker to test load balancing: jobs take this many times longer
+        void SetSlowdownFactor(double slowdownFactor) {
+            SlowdownFactor = slowdownFactor;
+        }
+
+        double GetSlowdownFactor() const {
+            return SlowdownFactor;
+        }
+
+    private:
+        mutable TAdaptiveLock Lock;
+        THPTimer Timer;
+        int ActiveJobCount = 0;
+        double BusyStart = 0;
+        TWorkerTimeStats Stats;
+        double SlowdownFactor = 1.0;
+    };
+
+    class TTensorSearchJobGuard {
+    public:
+        explicit TTensorSearchJobGuard(TTensorSearchTimer* timer)
+            : Timer(timer)
+        {
+            Timer->StartJob();
+        }
+
+        ~TTensorSearchJobGuard() {
+            const double slowdownFactor = Timer->GetSlowdownFactor();
+            if (slowdownFactor > 1.0) {
+                Sleep(TDuration::Seconds((slowdownFactor - 1.0) * JobTimer.Passed()));
+            }
+            Timer->FinishJob();
+        }
+
+    private:
+        TTensorSearchTimer* Timer;
+        THPTimer JobTimer;
+    };
+
     struct TLocalTensorSearchData {
         // part of TLearnContext used by GreedyTensorSearch
         TCalcScoreFold SampledDocs;
@@ -119,6 +240,11 @@ namespace NCatboostDistributed {
         TArray2D<double> PairwiseBuckets;
         int GradientIteration;
 
+        // sizes of split candidate histograms computed and sent by TRemoteBinCalcer for the current tree
+        std::atomic<ui64> HistogramRawBytes = 0;
+        std::atomic<ui64> HistogramSentBytes = 0;
+        TTensorSearchTimer TensorSearchTimer;
+
         // Starting point for gradient walker
         TVector<TVector<double>> BacktrackingStart;
 
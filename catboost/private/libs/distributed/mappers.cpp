@@ -15,11 +15,16 @@
 #include <catboost/private/libs/algo_helpers/approx_calcer_multi_helpers.h>
 #include <catboost/private/libs/algo_helpers/error_functions.h>
 #include <catboost/libs/data/load_data.h>
+#include <catboost/libs/data/loader.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/parallel_tasks.h>
 #include <catboost/libs/helpers/query_info_helper.h>
 #include <catboost/libs/helpers/vector_helpers.h>
+#include <catboost/private/libs/data_util/line_data_reader.h>
 #include <catboost/private/libs/index_range/index_range.h>
+#include <catboost/private/libs/quantized_pool/sharding.h>
+
+#include <library/string_utils/csv/csv.h>
 
 #include <util/generic/ymath.h>
 
@@ -45,6 +50,11 @@ namespace NCatboostDistributed {
     }
 
 
+    // in feature-parallel mode workers hold the same objects and must make the same random choices
+    static ui64 GetRandomSeedOffset(bool isFeatureParallel, int hostId) {
+        return isFeatureParallel ? 0 : hostId;
+    }
+
     static NJson::TJsonValue GetJson(const TString& string) {
         NJson::TJsonValue json;
         const bool isJson = ReadJsonTree(string, &json);
@@ -58,38 +68,18 @@ namespace NCatboostDistributed {
     ) {
         const ui32 groupCount = objectsGrouping.GetGroupCount();
         const ui32 objectCount = objectsGrouping.GetObjectCount();
-        TVector<NCB::TIndexRange<ui32>> result;
-        if (groupCount == objectCount) {
-            CB_ENSURE(objectCount >= workerCount, "Pool must contain at least " << workerCount << " objects");
-            for (ui32 workerIdx : xrange(workerCount)) {
-                const ui32 workerStart = CeilDiv(objectCount, workerCount) * workerIdx;
-                const ui32 workerEnd = Min(workerStart + CeilDiv(objectCount, workerCount), objectCount);
-                result.emplace_back(workerStart, workerEnd);
-            }
-        } else {
-            CB_ENSURE(groupCount >= workerCount, "Pool must contain at least " << workerCount << " groups");
+        TVector<ui32> groupBegins;
+        if (groupCount != objectCount) {
+            groupBegins.reserve(groupCount);
             ui32 previousGroupEnd = 0;
             for (const auto& groupIdx : xrange(groupCount)) {
                 CB_ENSURE(objectsGrouping.GetGroup(groupIdx).Begin == previousGroupEnd, "Groups must follow each other without gaps");
+                groupBegins.push_back(previousGroupEnd);
                 previousGroupEnd = objectsGrouping.GetGroup(groupIdx).End;
             }
-            for (ui32 workerIdx : xrange(workerCount)) {
-                const ui32 workerStartGroup = CeilDiv(groupCount, workerCount) * workerIdx;
-                const ui32 workerEndGroup = Min(workerStartGroup + CeilDiv(groupCount, workerCount), groupCount);
-                if (workerEndGroup == groupCount) {
-                    result.emplace_back(
-                        objectsGrouping.GetGroup(workerStartGroup).Begin,
-                        objectCount
-                    );
-                } else {
-                    result.emplace_back(
-                        objectsGrouping.GetGroup(workerStartGroup).Begin,
-                        objectsGrouping.GetGroup(workerEndGroup).Begin
-                    );
-                }
-            }
         }
-        return result;
+        // the same split as for shards of sharded quantized pools
+        return NCB::SplitObjectsByGroups(groupBegins, objectCount, workerCount);
     }
 
     void TDatasetLoader::DoMap(
@@ -98,16 +88,22 @@ namespace NCatboostDistributed {
         TInput* params,
         TOutput* /*unused*/
     ) const {
+        NCatboostOptions::TCatBoostOptions catBoostOptions(ETaskType::CPU);
+        catBoostOptions.Load(GetJson(params->TrainOptions));
+        catBoostOptions.SystemOptions->FileWithHosts->clear();
+        const bool isFeatureParallel
+            = catBoostOptions.SystemOptions->DevDistributedMode.Get() == EDistributedMode::FeatureParallel;
+
         auto& localData = TLocalTensorSearchData::GetRef();
         if (localData.Rand == nullptr) {
-            localData.Rand = new TRestorableFastRng64(params->RandomSeed + hostId);
+            localData.Rand = new TRestorableFastRng64(params->RandomSeed + GetRandomSeedOffset(isFeatureParallel, hostId));
         }
 
         const int workerCount = ctx->GetHostIdCount();
         CATBOOST_DEBUG_LOG << "Worker count " << workerCount << Endl;
-        const auto workerParts = WorkaroundSplit(params->ObjectsGrouping, workerCount);
-        const ui32 loadStart = workerParts[hostId].Begin;
-        const ui32 loadEnd = workerParts[hostId].End;
+        const auto workerParts = WorkaroundSplit(params->ObjectsGrouping, isFeatureParallel ? 1 : workerCount);
+        const ui32 loadStart = workerParts[isFeatureParallel ? 0 : hostId].Begin;
+        const ui32 loadEnd = workerParts[isFeatureParallel ? 0 : hostId].End;
 
         const auto poolLoadOptions = params->PoolLoadOptions;
         TProfileInfo profile;
@@ -123,9 +119,6 @@ namespace NCatboostDistributed {
             &profile
         );
 
-        NCatboostOptions::TCatBoostOptions catBoostOptions(ETaskType::CPU);
-        catBoostOptions.Load(GetJson(params->TrainOptions));
-        catBoostOptions.SystemOptions->FileWithHosts->clear();
         TLabelConverter labelConverter;
         auto quantizedFeaturesInfo = MakeIntrusive<NCB::TQuantizedFeaturesInfo>(
             params->FeaturesLayout,
@@ -151,6 +144,92 @@ namespace NCatboostDistributed {
         CATBOOST_DEBUG_LOG << "Done for worker " << hostId << Endl;
     }
 
+    void TQuantileSketchBuilder::DoMap(
+        NPar::IUserContext* ctx,
+        int hostId,
+        TInput* params,
+        TOutput* sketches
+    ) const {
+        const int workerCount = ctx->GetHostIdCount();
+        const auto& format = params->PoolLoadOptions.ColumnarPoolFormatParams.DsvFormat;
+        const char quote = format.IgnoreCsvQuoting ? '\0' : '"';
+        const auto& floatFeatureIdxByColumn = params->FloatFeatureIdxByColumn;
+        const ui32 floatFeatureCount = params->FloatFeatureCount;
+        TVector<bool> isFeatureUsed(floatFeatureCount, false);
+        for (auto floatFeatureIdx : floatFeatureIdxByColumn) {
+            if (floatFeatureIdx != Max<ui32>()) {
+                isFeatureUsed[floatFeatureIdx] = true;
+            }
+        }
+
+        CATBOOST_DEBUG_LOG << "Build quantile sketches of learn dataset part " << hostId << " of " << workerCount << Endl;
+        NCB::TFilePartLineDataReader lineReader(
+            NCB::TLineDataReaderArgs{params->PoolLoadOptions.LearnSetPath, format},
+            hostId,
+            workerCount);
+
+        sketches->assign(floatFeatureCount, NCB::TQuantileSketch());
+        const ui64 blockSize = 10000;
+        TVector<TString> lines(blockSize);
+        TVector<ui64> lineOffsets(blockSize);
+        TVector<float> values; // [lineIdx in block][floatFeatureIdx]
+        ui64 lineCount = 0;
+        while (true) {
+            ui64 blockLineCount = 0;
+            while (blockLineCount < blockSize && lineReader.ReadLine(&lines[blockLineCount])) {
+                lineOffsets[blockLineCount] = lineReader.GetLineOffset();
+                ++blockLineCount;
+            }
+            if (blockLineCount == 0) {
+                break;
+            }
+            lineCount += blockLineCount;
+            values.yresize(blockLineCount * floatFeatureCount);
+            NPar::ParallelFor(
+                0,
+                blockLineCount,
+                [&] (ui32 lineIdx) {
+                    float* lineValues = values.data() + (ui64)lineIdx * floatFeatureCount;
+                    auto splitter = NCsvFormat::CsvSplitter(lines[lineIdx], format.Delimiter, quote);
+                    ui32 columnIdx = 0;
+                    do {
+                        const TStringBuf token = splitter.Consume();
+                        CB_ENSURE(
+                            columnIdx < floatFeatureIdxByColumn.size(),
+                            "Line at byte offset " << lineOffsets[lineIdx] << ": wrong column count"
+                        );
+                        const ui32 floatFeatureIdx = floatFeatureIdxByColumn[columnIdx];
+                        if (floatFeatureIdx != Max<ui32>()) {
+                            CB_ENSURE(
+                                NCB::TryParseFloatFeatureValue(token, lineValues + floatFeatureIdx),
+                                "Line at byte offset " << lineOffsets[lineIdx] << ", column " << columnIdx
+                                << ": value cannot be parsed as float"
+                            );
+                        }
+                        ++columnIdx;
+                    } while (splitter.Step());
+                    CB_ENSURE(
+                        columnIdx == floatFeatureIdxByColumn.size(),
+                        "Line at byte offset " << lineOffsets[lineIdx] << ": wrong column count"
+                    );
+                });
+            NPar::ParallelFor(
+                0,
+                floatFeatureCount,
+                [&] (ui32 floatFeatureIdx) {
+                    if (!isFeatureUsed[floatFeatureIdx]) {
+                        return;
+                    }
+                    auto& sketch = (*sketches)[floatFeatureIdx];
+                    for (auto lineIdx : xrange(blockLineCount)) {
+                        sketch.Add(values[lineIdx * floatFeatureCount + floatFeatureIdx]);
+                    }
+                });
+        }
+        CATBOOST_DEBUG_LOG << "Sketches of " << lineCount << " lines are built by worker " << hostId << Endl;
+        CATBOOST_DEBUG_LOG << "Done for worker " << hostId << Endl;
+    }
+
     void TPlainFoldBuilder::DoMap(
         NPar::IUserContext* ctx,
         int hostId,
@@ -159,15 +238,20 @@ namespace NCatboostDistributed {
     ) const {
         NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
         auto& localData = TLocalTensorSearchData::GetRef();
-        if (localData.Rand == nullptr) { // may be set by TDatasetLoader
-            localData.Rand = new TRestorableFastRng64(params->RandomSeed + hostId);
-        }
-
         auto trainParamsJson = GetJson(params->TrainParams);
         UpdateUndefinedClassLabels(localData.ClassLabelsFromDataset, &trainParamsJson);
         localData.Params.Load(trainParamsJson);
 
         const auto& trainParams = localData.Params;
+        const ui64 randomSeedOffset = GetRandomSeedOffset(
+            trainParams.SystemOptions->DevDistributedMode.Get() == EDistributedMode::FeatureParallel,
+            hostId);
+        if (localData.Rand == nullptr) { // may be set by TDatasetLoader
+            localData.Rand = new TRestorableFastRng64(params->RandomSeed + randomSeedOffset);
+        }
+        // random numbers used before learn objects redistribution must not repeat after fold rebuild
+        const ui64 prevRandCallCount
+            = (params->IsRebuild && localData.Progress) ? localData.Progress->Rand.GetCallCount() : 0;
 
         const NCB::TTrainingDataProviders& trainingDataProviders = GetTrainData(trainData);
 
@@ -183,7 +267,7 @@ namespace NCatboostDistributed {
             trainingDataProviders,
             params->ApproxDimension,
             TLabelConverter(), // unused in case of localData
-            params->RandomSeed + hostId,
+            params->RandomSeed + randomSeedOffset,
             /*initRand*/ localData.Rand.Get(),
             foldsCreationParams,
             /*datasetsCanContainBaseline*/ true,
@@ -195,6 +279,10 @@ namespace NCatboostDistributed {
             /*initModel*/ Nothing(),
             /*initModelApplyCompatiblePools*/ NCB::TDataProviders(),
             &NPar::LocalExecutor());
+        const ui64 randCallCount = localData.Progress->Rand.GetCallCount();
+        if (randCallCount < prevRandCallCount) {
+            localData.Progress->Rand.Advance(prevRandCallCount - randCallCount);
+        }
         Y_ASSERT(localData.Progress->AveragingFold.BodyTailArr.ysize() == 1);
 
         localData.HessianType = params->HessianType;
@@ -286,9 +374,17 @@ namespace NCatboostDistributed {
         NPar::IUserContext* /*ctx*/,
         int /*hostId*/,
         TInput* /*unused*/,
-        TOutput* /*unused*/
+        TOutput* prevTreeTimeStats
     ) const {
         auto& localData = TLocalTensorSearchData::GetRef();
+        if (localData.HistogramRawBytes != 0) {
+            CATBOOST_DEBUG_LOG << "Split candidate histograms of the previous tree: " << localData.HistogramRawBytes.load()
+                << " bytes, sent " << localData.HistogramSentBytes.load() << " bytes" << Endl;
+        }
+        *prevTreeTimeStats = localData.TensorSearchTimer.GetStats();
+        localData.TensorSearchTimer.Restart();
+        localData.HistogramRawBytes = 0;
+        localData.HistogramSentBytes = 0;
         localData.Depth = 0;
         Fill(localData.Indices.begin(), localData.Indices.end(), 0);
         if (localData.UseTreeLevelCaching) {
@@ -302,6 +398,7 @@ namespace NCatboostDistributed {
         TInput* /*unused*/,
         TOutput* /*unused*/
     ) const {
+        TTensorSearchJobGuard jobGuard(&TLocalTensorSearchData::GetRef().TensorSearchTimer);
         auto& localData = TLocalTensorSearchData::GetRef();
         Bootstrap(
             localData.Params,
@@ -455,6 +552,7 @@ namespace NCatboostDistributed {
         TInput* candidate,
         TOutput* bucketStats
     ) const {
+        TTensorSearchJobGuard jobGuard(&TLocalTensorSearchData::GetRef().TensorSearchTimer);
         NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
         auto& localData = TLocalTensorSearchData::GetRef();
         auto calcPairwiseStats = [&](const TCandidateInfo& candidate, TPairwiseStats* pairwiseStats) {
@@ -486,6 +584,7 @@ namespace NCatboostDistributed {
         TInput* bucketStats,
         TOutput* scores
     ) const {
+        TTensorSearchJobGuard jobGuard(&TLocalTensorSearchData::GetRef().TensorSearchTimer);
         const auto& localData = TLocalTensorSearchData::GetRef();
         const int bucketCount = (*bucketStats)[0].DerSums[0].ysize();
         const auto getScores =
@@ -510,37 +609,56 @@ namespace NCatboostDistributed {
         TInput* candidatesInfoList,
         TOutput* bucketStats
     ) const {
+        TTensorSearchJobGuard jobGuard(&TLocalTensorSearchData::GetRef().TensorSearchTimer);
         NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
         auto calcStats3D = [&](const TCandidateInfo& candidate, TStats3D* stats3D) {
             CalcStats3D(trainData, candidate, stats3D);
         };
-        MapVector(calcStats3D, candidatesInfoList->Candidates, bucketStats);
+        TStats4D stats;
+        MapVector(calcStats3D, candidatesInfoList->Candidates, &stats);
+
+        auto& localData = TLocalTensorSearchData::GetRef();
+        localData.HistogramRawBytes += GetPlainByteCount(stats);
+        *bucketStats = PackStats(std::move(stats), localData.Params.SystemOptions->DevHistogramWireFormat);
+        localData.HistogramSentBytes += bucketStats->GetByteCount();
     }
 
-    // vector<TStats4D> -> TStats4D
+    // vector<TPackedStats4D> -> TPackedStats4D, the result is packed in the format of the inputs
     void TRemoteBinCalcer::DoReduce(TVector<TOutput>* statsFromAllWorkers, TOutput* stats) const {
         const int workerCount = statsFromAllWorkers->ysize();
-        const int bucketCount = (*statsFromAllWorkers)[0].ysize();
-        stats->yresize(bucketCount);
+        const auto format = (*statsFromAllWorkers)[0].Format;
+        TVector<TStats4D> unpackedStats(workerCount);
+        NPar::ParallelFor(
+            0,
+            workerCount,
+            [&] (int workerIdx) {
+                unpackedStats[workerIdx] = UnpackStats(std::move((*statsFromAllWorkers)[workerIdx]));
+            });
+        const int bucketCount = unpackedStats[0].ysize();
+        TStats4D reducedStats;
+        reducedStats.yresize(bucketCount);
         NPar::ParallelFor(
             0,
             bucketCount,
             [&] (int bucketIdx) {
-                (*stats)[bucketIdx] = (*statsFromAllWorkers)[0][bucketIdx];
+                reducedStats[bucketIdx] = unpackedStats[0][bucketIdx];
                 for (int workerIdx = 1; workerIdx < workerCount; ++workerIdx) {
-                    (*stats)[bucketIdx].Add((*statsFromAllWorkers)[workerIdx][bucketIdx]);
+                    reducedStats[bucketIdx].Add(unpackedStats[workerIdx][bucketIdx]);
                 }
             });
+        *stats = PackStats(std::move(reducedStats), format);
     }
 
     // TStats4D -> TVector<TVector<double>> [subcandidate][bucket]
     void TRemoteScoreCalcer::DoMap(
         NPar::IUserContext* /*ctx*/,
         int /*hostId*/,
-        TInput* bucketStats,
+        TInput* packedBucketStats,
         TOutput* scores
     ) const {
+        TTensorSearchJobGuard jobGuard(&TLocalTensorSearchData::GetRef().TensorSearchTimer);
         const auto& localData = TLocalTensorSearchData::GetRef();
+        const TStats4D bucketStats = UnpackStats(std::move(*packedBucketStats));
         const auto getScores =
             [&] (const TStats3D& candidateStats3D, TVector<double>* candidateScores) {
                 *candidateScores = GetScores(candidateStats3D,
@@ -549,20 +667,78 @@ namespace NCatboostDistributed {
                                              localData.AllDocCount,
                                              localData.Params);
             };
-        MapVector(getScores, *bucketStats, scores);
+        MapVector(getScores, bucketStats, scores);
     }
 
-    void TLeafIndexSetter::DoMap(
+    void TFeatureParallelBestSplitFinder::DoMap(
         NPar::IUserContext* ctx,
         int hostId,
-        TInput* bestSplit,
-        TOutput* /*unused*/
+        TInput* candidates,
+        TOutput* bestSplits
     ) const {
-        Y_ASSERT(bestSplit->Type != ESplitType::OnlineCtr);
-        auto& localData = TLocalTensorSearchData::GetRef();
+        TTensorSearchJobGuard jobGuard(&TLocalTensorSearchData::GetRef().TensorSearchTimer);
         NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
+        const auto& localData = TLocalTensorSearchData::GetRef();
+        const NCB::TTrainingDataProviders& trainingData = GetTrainData(trainData);
+        const int workerCount = ctx->GetHostIdCount();
+        const int datasetCount = candidates->CandidateLists.ysize();
+        bestSplits->resize(datasetCount);
+        for (auto datasetIdx : xrange(datasetCount)) {
+            const auto& candidateList = candidates->CandidateLists[datasetIdx];
+            auto& datasetBestSplits = (*bestSplits)[datasetIdx];
+            datasetBestSplits.resize(candidateList.size());
+            if (candidateList.empty()) {
+                continue;
+            }
+
+            TCandidatesContext candidatesContext;
+            candidatesContext.LearnData = candidateList[0].Candidates[0].SplitEnsemble.IsEstimated
+                ? trainingData.EstimatedObjectsData.Learn
+                : trainingData.Learn->ObjectsData;
+            candidatesContext.OneHotMaxSize = localData.Params.CatFeatureParams->OneHotMaxSize;
+            candidatesContext.BundlesMetaData = candidatesContext.LearnData->GetExclusiveFeatureBundlesMetaData();
+            candidatesContext.FeaturesGroupsMetaData = candidatesContext.LearnData->GetFeaturesGroupsMetaData();
+            candidatesContext.SelectedFeaturesInBundles = candidates->SelectedFeaturesInBundles[datasetIdx];
+            candidatesContext.PerBinaryPackMasks = candidates->PerBinaryPackMasks[datasetIdx];
+            candidatesContext.SelectedFeaturesInGroups = candidates->SelectedFeaturesInGroups[datasetIdx];
+
+            NPar::ParallelFor(
+                0,
+                candidateList.ysize(),
+                [&] (int candidateIdx) {
+                    const auto& candidate = candidateList[candidateIdx];
+                    if (GetCandidateOwner(candidate, workerCount) != hostId) {
+                        return;
+                    }
+                    const int subcandidateCount = candidate.Candidates.ysize();
+                    TVector<TVector<double>> scores(subcandidateCount);
+                    for (auto subcandidateIdx : xrange(subcandidateCount)) {
+                        TStats3D stats3D;
+                        CalcStats3D(trainData, candidate.Candidates[subcandidateIdx], &stats3D);
+                        scores[subcandidateIdx] = GetScores(
+                            stats3D,
+                            localData.Depth,
+                            localData.SumAllWeights,
+                            localData.AllDocCount,
+                            localData.Params);
+                    }
+                    auto& subcandidates = datasetBestSplits[candidateIdx].Candidates;
+                    subcandidates = candidate.Candidates;
+                    SetBestScore(
+                        candidates->RandSeed + candidateIdx,
+                        scores,
+                        candidates->ScoreStDev,
+                        candidatesContext,
+                        &subcandidates);
+                });
+        }
+    }
+
+    static void SetLeafIndices(const TSplit& bestSplit, NPar::TCtxPtr<TTrainData> trainData) {
+        Y_ASSERT(bestSplit.Type != ESplitType::OnlineCtr);
+        auto& localData = TLocalTensorSearchData::GetRef();
         SetPermutedIndices(
-            *bestSplit,
+            bestSplit,
             GetTrainData(trainData),
             localData.Depth + 1,
             localData.Progress->AveragingFold,
@@ -579,23 +755,44 @@ namespace NCatboostDistributed {
         }
     }
 
-    void TEmptyLeafFinder::DoMap(
-        NPar::IUserContext* /*ctx*/,
-        int /*hostId*/,
-        TInput* /*unused*/,
-        TOutput* isLeafEmpty
-    ) const {
+    static void FindEmptyLeaves(TIsLeafEmpty* isLeafEmpty) {
         auto& localData = TLocalTensorSearchData::GetRef();
         *isLeafEmpty = GetIsLeafEmpty(localData.Depth + 1, localData.Indices);
         ++localData.Depth; // tree level completed
     }
 
-    void TBucketSimpleUpdater::DoMap(
+    void TLeafIndexSetter::DoMap(
+        NPar::IUserContext* ctx,
+        int hostId,
+        TInput* bestSplit,
+        TOutput* /*unused*/
+    ) const {
+        TTensorSearchJobGuard jobGuard(&TLocalTensorSearchData::GetRef().TensorSearchTimer);
+        SetLeafIndices(*bestSplit, NPar::TCtxPtr<TTrainData>(ctx, SHARED_ID_TRAIN_DATA, hostId));
+    }
+
+    void TEmptyLeafFinder::DoMap(
         NPar::IUserContext* /*ctx*/,
         int /*hostId*/,
         TInput* /*unused*/,
-        TOutput* sums
+        TOutput* isLeafEmpty
+    ) const {
+        TTensorSearchJobGuard jobGuard(&TLocalTensorSearchData::GetRef().TensorSearchTimer);
+        FindEmptyLeaves(isLeafEmpty);
+    }
+
+    void TLeafIndexSetterAndEmptyLeafFinder::DoMap(
+        NPar::IUserContext* ctx,
+        int hostId,
+        TInput* bestSplit,
+        TOutput* isLeafEmpty
     ) const {
+        TTensorSearchJobGuard jobGuard(&TLocalTensorSearchData::GetRef().TensorSearchTimer);
+        SetLeafIndices(*bestSplit, NPar::TCtxPtr<TTrainData>(ctx, SHARED_ID_TRAIN_DATA, hostId));
+        FindEmptyLeaves(isLeafEmpty);
+    }
+
+    static void CalcBucketsSimple(std::pair<TSums, TArray2D<double>>* sums) {
         auto& localData = TLocalTensorSearchData::GetRef();
         const int approxDimension = localData.Progress->ApproxDimension;
         Y_ASSERT(approxDimension == 1);
@@ -629,18 +826,24 @@ namespace NCatboostDistributed {
         *sums = std::make_pair(localData.Buckets, localData.PairwiseBuckets);
     }
 
-    void TCalcApproxStarter::DoMap(
-        NPar::IUserContext* ctx,
-        int hostId,
-        TInput* splitTree,
-        TOutput* /*unused*/
+    void TBucketSimpleUpdater::DoMap(
+        NPar::IUserContext* /*ctx*/,
+        int /*hostId*/,
+        TInput* /*unused*/,
+        TOutput* sums
     ) const {
+        CalcBucketsSimple(sums);
+    }
+
+    static void StartCalcApprox(
+        const TVariant<TSplitTree, TNonSymmetricTreeStructure>& splitTree,
+        NPar::TCtxPtr<TTrainData> trainData
+    ) {
         auto& localData = TLocalTensorSearchData::GetRef();
         const auto& error = BuildError(localData.Params, /*custom objective*/Nothing());
-        NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
         localData.Indices = BuildIndices(
             localData.Progress->AveragingFold,
-            *splitTree,
+            splitTree,
             GetTrainData(trainData),
             EBuildIndicesDataParts::LearnOnly,
             &NPar::LocalExecutor());
@@ -654,24 +857,49 @@ namespace NCatboostDistributed {
         for (auto& dimensionDelta : localData.ApproxDeltas) {
             Fill(dimensionDelta.begin(), dimensionDelta.end(), GetNeutralApprox(localData.StoreExpApprox));
         }
-        localData.Buckets.resize(GetLeafCount(*splitTree));
+        localData.Buckets.resize(GetLeafCount(splitTree));
         Fill(localData.Buckets.begin(), localData.Buckets.end(), TSum());
-        localData.MultiBuckets.resize(GetLeafCount(*splitTree));
+        localData.MultiBuckets.resize(GetLeafCount(splitTree));
         Fill(
             localData.MultiBuckets.begin(),
             localData.MultiBuckets.end(),
             TSumMulti(approxDimension, error->GetHessianType()));
-        localData.PairwiseBuckets.SetSizes(GetLeafCount(*splitTree), GetLeafCount(*splitTree));
+        localData.PairwiseBuckets.SetSizes(GetLeafCount(splitTree), GetLeafCount(splitTree));
         localData.PairwiseBuckets.FillZero();
         localData.GradientIteration = 0;
     }
 
-    void TDeltaSimpleUpdater::DoMap(
-        NPar::IUserContext* /*unused*/,
-        int /*unused*/,
-        TInput* leafValues,
+    static TVector<double> GetLeafWeights(NPar::TCtxPtr<TTrainData> trainData) {
+        auto& localData = TLocalTensorSearchData::GetRef();
+        const size_t leafCount = localData.Buckets.size();
+        return SumLeafWeights(
+            leafCount,
+            localData.Indices,
+            localData.Progress->AveragingFold.GetLearnPermutationArray(),
+            GetWeights(*GetTrainData(trainData).Learn->TargetData));
+    }
+
+    void TCalcApproxStarter::DoMap(
+        NPar::IUserContext* ctx,
+        int hostId,
+        TInput* splitTree,
         TOutput* /*unused*/
     ) const {
+        StartCalcApprox(*splitTree, NPar::TCtxPtr<TTrainData>(ctx, SHARED_ID_TRAIN_DATA, hostId));
+    }
+
+    void TCalcApproxStarterAndLeafWeightsGetter::DoMap(
+        NPar::IUserContext* ctx,
+        int hostId,
+        TInput* splitTree,
+        TOutput* leafWeights
+    ) const {
+        NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
+        StartCalcApprox(*splitTree, trainData);
+        *leafWeights = GetLeafWeights(trainData);
+    }
+
+    static void UpdateDeltasSimple(TVector<TVector<double>>* leafValues) {
         auto& localData = TLocalTensorSearchData::GetRef();
         UpdateApproxDeltas(
             localData.StoreExpApprox,
@@ -683,12 +911,26 @@ namespace NCatboostDistributed {
         ++localData.GradientIteration; // gradient iteration completed
     }
 
-    void TApproxUpdater::DoMap(
+    void TDeltaSimpleUpdater::DoMap(
         NPar::IUserContext* /*unused*/,
         int /*unused*/,
-        TInput* averageLeafValues,
+        TInput* leafValues,
         TOutput* /*unused*/
     ) const {
+        UpdateDeltasSimple(leafValues);
+    }
+
+    void TDeltaAndBucketSimpleUpdater::DoMap(
+        NPar::IUserContext* /*ctx*/,
+        int /*hostId*/,
+        TInput* leafValues,
+        TOutput* sums
+    ) const {
+        UpdateDeltasSimple(leafValues);
+        CalcBucketsSimple(sums);
+    }
+
+    static void UpdateApproxes(const TVector<TVector<double>>& averageLeafValues) {
         auto& localData = TLocalTensorSearchData::GetRef();
         if (localData.StoreExpApprox) {
             UpdateBodyTailApprox</*StoreExpApprox*/true>(
@@ -711,11 +953,30 @@ namespace NCatboostDistributed {
             };
         UpdateApprox(
             updateAvrgApprox,
-            *averageLeafValues,
+            averageLeafValues,
             &localData.Progress->AvrgApprox,
             &NPar::LocalExecutor());
     }
 
+    void TApproxUpdater::DoMap(
+        NPar::IUserContext* /*unused*/,
+        int /*unused*/,
+        TInput* averageLeafValues,
+        TOutput* /*unused*/
+    ) const {
+        UpdateApproxes(*averageLeafValues);
+    }
+
+    void TDeltaSimpleAndApproxUpdater::DoMap(
+        NPar::IUserContext* /*unused*/,
+        int /*unused*/,
+        TInput* leafValuesAndAverageLeafValues,
+        TOutput* /*unused*/
+    ) const {
+        UpdateDeltasSimple(&leafValuesAndAverageLeafValues->first);
+        UpdateApproxes(leafValuesAndAverageLeafValues->second);
+    }
+
     void TDerivativeSetter::DoMap(
         NPar::IUserContext* /*ctx*/,
         int /*hostId*/,
@@ -734,12 +995,7 @@ namespace NCatboostDistributed {
             &NPar::LocalExecutor());
     }
 
-    void TBucketMultiUpdater::DoMap(
-        NPar::IUserContext* /*ctx*/,
-        int /*hostId*/,
-        TInput* /*unused*/,
-        TOutput* sums
-    ) const {
+    static void CalcBucketsMulti(std::pair<TMultiSums, TUnusedInitializedParam>* sums) {
         auto& localData = TLocalTensorSearchData::GetRef();
         const auto error = BuildError(localData.Params, /*custom objective*/Nothing());
         const auto estimationMethod = localData.Params.ObliviousTreeOptions->LeavesEstimationMethod;
@@ -759,22 +1015,55 @@ namespace NCatboostDistributed {
         *sums = std::make_pair(localData.MultiBuckets, TUnusedInitializedParam());
     }
 
-    void TDeltaMultiUpdater::DoMap(
+    void TBucketMultiUpdater::DoMap(
         NPar::IUserContext* /*ctx*/,
         int /*hostId*/,
-        TInput* leafValues,
-        TOutput* /*unused*/
+        TInput* /*unused*/,
+        TOutput* sums
     ) const {
+        CalcBucketsMulti(sums);
+    }
+
+    static void UpdateDeltasMulti(const TVector<TVector<double>>& leafValues) {
         auto& localData = TLocalTensorSearchData::GetRef();
         UpdateApproxDeltasMulti(
             localData.Indices,
             localData.Progress->AveragingFold.BodyTailArr[0].BodyFinish,
-            MakeConstArrayRef(*leafValues),
+            MakeConstArrayRef(leafValues),
             &localData.ApproxDeltas,
             &NPar::LocalExecutor());
         ++localData.GradientIteration; // gradient iteration completed
     }
 
+    void TDeltaMultiUpdater::DoMap(
+        NPar::IUserContext* /*ctx*/,
+        int /*hostId*/,
+        TInput* leafValues,
+        TOutput* /*unused*/
+    ) const {
+        UpdateDeltasMulti(*leafValues);
+    }
+
+    void TDeltaAndBucketMultiUpdater::DoMap(
+        NPar::IUserContext* /*ctx*/,
+        int /*hostId*/,
+        TInput* leafValues,
+        TOutput* sums
+    ) const {
+        UpdateDeltasMulti(*leafValues);
+        CalcBucketsMulti(sums);
+    }
+
+    void TDeltaMultiAndApproxUpdater::DoMap(
+        NPar::IUserContext* /*unused*/,
+        int /*unused*/,
+        TInput* leafValuesAndAverageLeafValues,
+        TOutput* /*unused*/
+    ) const {
+        UpdateDeltasMulti(leafValuesAndAverageLeafValues->first);
+        UpdateApproxes(leafValuesAndAverageLeafValues->second);
+    }
+
     void TErrorCalcer::DoMap(
         NPar::IUserContext* ctx,
         int hostId,
@@ -821,14 +1110,7 @@ namespace NCatboostDistributed {
         TInput* /*unused*/,
         TOutput* leafWeights
     ) const {
-        auto& localData = TLocalTensorSearchData::GetRef();
-        NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
-        const size_t leafCount = localData.Buckets.size();
-        *leafWeights = SumLeafWeights(
-            leafCount,
-            localData.Indices,
-            localData.Progress->AveragingFold.GetLearnPermutationArray(),
-            GetWeights(*GetTrainData(trainData).Learn->TargetData));
+        *leafWeights = GetLeafWeights(NPar::TCtxPtr<TTrainData>(ctx, SHARED_ID_TRAIN_DATA, hostId));
     }
 
     void TLeafWeightsGetter::DoReduce(TVector<TOutput>* inLeafWeightsFromWorkers, TOutput* outTotalLeafWeights) const {
@@ -1068,3 +1350,14 @@ REGISTER_SAVELOAD_NM_CLASS(0xd66d4e4, NCatboostDistributed, TQuantileArraySplitt
 REGISTER_SAVELOAD_NM_CLASS(0xd66d4e5, NCatboostDistributed, TQuantileEqualWeightsCalcer);
 
 REGISTER_SAVELOAD_NM_CLASS(0xd66d4e6, NCatboostDistributed, TArmijoStartPointBackupper);
+
+REGISTER_SAVELOAD_NM_CLASS(0xd66d4e7, NCatboostDistributed, TLeafIndexSetterAndEmptyLeafFinder);
+REGISTER_SAVELOAD_NM_CLASS(0xd66d4e8, NCatboostDistributed, TCalcApproxStarterAndLeafWeightsGetter);
+REGISTER_SAVELOAD_NM_CLASS(0xd66d4e9, NCatboostDistributed, TDeltaAndBucketSimpleUpdater);
+REGISTER_SAVELOAD_NM_CLASS(0xd66d4ea, NCatboostDistributed, TDeltaAndBucketMultiUpdater);
+REGISTER_SAVELOAD_NM_CLASS(0xd66d4eb, NCatboostDistributed, TDeltaSimpleAndApproxUpdater);
+REGISTER_SAVELOAD_NM_CLASS(0xd66d4ec, NCatboostDistributed, TDeltaMultiAndApproxUpdater);
+
+REGISTER_SAVELOAD_NM_CLASS(0xd66d4ed, NCatboostDistributed, TFeatureParallelBestSplitFinder);
+
+REGISTER_SAVELOAD_NM_CLASS(0xd66d4ee, NCatboostDistributed, TQuantileSketchBuilder);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "data_types.h"
+#include "packed_stats.h"
 
 #include <catboost/libs/helpers/vector_helpers.h>
 #include <catboost/private/libs/algo/tensor_search_helpers.h>
@@ -17,6 +18,10 @@ namespace NCatboostDistributed {
         OBJECT_NOCOPY_METHODS(TDatasetLoader);
         void DoMap(NPar::IUserContext* ctx, int hostId, TInput* params, TOutput* /*unused*/) const final;
     };
+    class TQuantileSketchBuilder: public NPar::TMapReduceCmd<TQuantileSketchBuilderParams, TVector<NCB::TQuantileSketch>> {
+        OBJECT_NOCOPY_METHODS(TQuantileSketchBuilder);
+        void DoMap(NPar::IUserContext* ctx, int hostId, TInput* params, TOutput* sketches) const final;
+    };
     class TPlainFoldBuilder: public NPar::TMapReduceCmd<TPlainFoldBuilderParams, TUnusedInitializedParam> {
         OBJECT_NOCOPY_METHODS(TPlainFoldBuilder);
         void DoMap(NPar::IUserContext* ctx, int hostId, TInput* params, TOutput* /*unused*/) const final;
@@ -29,13 +34,14 @@ namespace NCatboostDistributed {
         OBJECT_NOCOPY_METHODS(TApproxReconstructor);
         void DoMap(NPar::IUserContext* ctx, int hostId, TInput* forest, TOutput* /*unused*/) const final;
     };
-    class TTensorSearchStarter: public NPar::TMapReduceCmd<TUnusedInitializedParam, TUnusedInitializedParam> {
+    // returns time stats of the previous tree
+    class TTensorSearchStarter: public NPar::TMapReduceCmd<TUnusedInitializedParam, TWorkerTimeStats> {
         OBJECT_NOCOPY_METHODS(TTensorSearchStarter);
         void DoMap(
             NPar::IUserContext* /*ctx*/,
             int /*hostId*/,
             TInput* /*unused*/,
-            TOutput* /*unused*/) const final;
+            TOutput* prevTreeTimeStats) const final;
     };
     class TBootstrapMaker: public NPar::TMapReduceCmd<TUnusedInitializedParam, TUnusedInitializedParam> {
         OBJECT_NOCOPY_METHODS(TBootstrapMaker);
@@ -84,15 +90,26 @@ namespace NCatboostDistributed {
         OBJECT_NOCOPY_METHODS(TRemotePairwiseScoreCalcer);
         void DoMap(NPar::IUserContext* ctx, int hostId, TInput* bucketStats, TOutput* scores) const final;
     };
-    class TRemoteBinCalcer: public NPar::TMapReduceCmd<TCandidatesInfoList, TStats4D> { // [subcand]
+    class TRemoteBinCalcer: public NPar::TMapReduceCmd<TCandidatesInfoList, TPackedStats4D> { // [subcand]
         OBJECT_NOCOPY_METHODS(TRemoteBinCalcer);
         void DoMap(NPar::IUserContext* ctx, int hostId, TInput* candidatesInfoList, TOutput* bucketStats) const final;
         void DoReduce(TVector<TOutput>* statsFromAllWorkers, TOutput* bucketStats) const final;
     };
-    class TRemoteScoreCalcer: public NPar::TMapReduceCmd<TStats4D, TVector<TVector<double>>> {
+    class TRemoteScoreCalcer: public NPar::TMapReduceCmd<TPackedStats4D, TVector<TVector<double>>> {
         OBJECT_NOCOPY_METHODS(TRemoteScoreCalcer);
         void DoMap(NPar::IUserContext* ctx, int hostId, TInput* bucketStats, TOutput* scores) const final;
     };
+
+    // feature-parallel mode: the worker that scores the candidate, does not change between tree levels
+    inline int GetCandidateOwner(const TCandidatesInfoList& candidate, int workerCount) {
+        return candidate.Candidates[0].SplitEnsemble.GetHash() % workerCount;
+    }
+
+    // [dataset][candidate], only candidates owned by the worker have subcandidates with best splits set
+    class TFeatureParallelBestSplitFinder: public NPar::TMapReduceCmd<TFeatureParallelCandidates, TVector<TCandidateList>> {
+        OBJECT_NOCOPY_METHODS(TFeatureParallelBestSplitFinder);
+        void DoMap(NPar::IUserContext* ctx, int hostId, TInput* candidates, TOutput* bestSplits) const final;
+    };
     class TLeafIndexSetter: public NPar::TMapReduceCmd<TSplit, TUnusedInitializedParam> {
         OBJECT_NOCOPY_METHODS(TLeafIndexSetter);
         void DoMap(
@@ -151,6 +168,61 @@ namespace NCatboostDistributed {
         OBJECT_NOCOPY_METHODS(TDeltaMultiUpdater);
         void DoMap(NPar::IUserContext* ctx, int hostId, TInput* leafValues, TOutput* /*unused*/) const final;
     };
+
+    /* Composite mappers below do the work of several mappers above in a single master-worker
+     * round trip, in the order given by their names
+     */
+    class TLeafIndexSetterAndEmptyLeafFinder: public NPar::TMapReduceCmd<TSplit, TIsLeafEmpty> {
+        OBJECT_NOCOPY_METHODS(TLeafIndexSetterAndEmptyLeafFinder);
+        void DoMap(
+            NPar::IUserContext* ctx,
+            int hostId,
+            TInput* bestSplit,
+            TOutput* isLeafEmpty) const final;
+    };
+    class TCalcApproxStarterAndLeafWeightsGetter
+        : public NPar::TMapReduceCmd<TVariant<TSplitTree, TNonSymmetricTreeStructure>, TVector<double>> {
+
+        OBJECT_NOCOPY_METHODS(TCalcApproxStarterAndLeafWeightsGetter);
+        void DoMap(NPar::IUserContext* ctx, int hostId, TInput* splitTree, TOutput* leafWeights) const final;
+    };
+    class TDeltaAndBucketSimpleUpdater
+        : public NPar::TMapReduceCmd<TVector<TVector<double>>, std::pair<TSums, TArray2D<double>>> {
+
+        OBJECT_NOCOPY_METHODS(TDeltaAndBucketSimpleUpdater);
+        void DoMap(NPar::IUserContext* /*ctx*/, int /*hostId*/, TInput* leafValues, TOutput* sums) const final;
+    };
+    class TDeltaAndBucketMultiUpdater
+        : public NPar::TMapReduceCmd<TVector<TVector<double>>, std::pair<TMultiSums, TUnusedInitializedParam>> {
+
+        OBJECT_NOCOPY_METHODS(TDeltaAndBucketMultiUpdater);
+        void DoMap(NPar::IUserContext* /*ctx*/, int /*hostId*/, TInput* leafValues, TOutput* sums) const final;
+    };
+    // input is (leaf values of the last gradient iteration, average leaf values)
+    class TDeltaSimpleAndApproxUpdater
+        : public NPar::TMapReduceCmd<
+            std::pair<TVector<TVector<double>>, TVector<TVector<double>>>,
+            TUnusedInitializedParam> {
+
+        OBJECT_NOCOPY_METHODS(TDeltaSimpleAndApproxUpdater);
+        void DoMap(
+            NPar::IUserContext* /*ctx*/,
+            int /*hostId*/,
+            TInput* leafValuesAndAverageLeafValues,
+            TOutput* /*unused*/) const final;
+    };
+    class TDeltaMultiAndApproxUpdater
+        : public NPar::TMapReduceCmd<
+            std::pair<TVector<TVector<double>>, TVector<TVector<double>>>,
+            TUnusedInitializedParam> {
+
+        OBJECT_NOCOPY_METHODS(TDeltaMultiAndApproxUpdater);
+        void DoMap(
+            NPar::IUserContext* /*ctx*/,
+            int /*hostId*/,
+            TInput* leafValuesAndAverageLeafValues,
+            TOutput* /*unused*/) const final;
+    };
     class TErrorCalcer: public NPar::TMapReduceCmd<bool, THashMap<TString, TMetricHolder>> {
         OBJECT_NOCOPY_METHODS(TErrorCalcer);
         void DoMap(NPar::IUserContext* ctx, int hostId, TInput* useAveragingFold, TOutput* additiveStats) const final;
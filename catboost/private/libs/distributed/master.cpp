@@ -15,7 +15,9 @@
 #include <catboost/private/libs/options/json_helper.h>
 
 #include <library/par/par_settings.h>
+#include <library/par/par_shm.h>
 
+#include <util/string/join.h>
 #include <util/system/yassert.h>
 
 
@@ -25,6 +27,16 @@ using namespace NCB;
 struct TMasterEnvironment {
     TObj<NPar::IRootEnvironment> RootEnvironment = nullptr;
     TObj<NPar::IEnvironment> SharedTrainData = nullptr;
+    EDistributedMode Mode = EDistributedMode::DataParallel;
+
+    // learn object counts of workers if learn objects were split by master, empty otherwise
+    TVector<ui32> WorkerObjectCounts;
+    // tensor search busy time of workers since the last rebalancing check, in seconds
+    TVector<double> WorkerBusyTimes;
+    ui32 WorkerBusyTimesTreeCount = 0;
+    // stats of the tree before the learn objects split change describe the previous split
+    bool SkipNextTimeStats = false;
+    ui64 PlainFoldRandomSeed = 0;
 
     Y_DECLARE_SINGLETON_FRIEND();
 
@@ -39,6 +51,7 @@ void InitializeMaster(const NCatboostOptions::TSystemOptions& systemOptions) {
 
     // avoid Netliba
     NPar::TParNetworkSettings::GetRef().RequesterType = NPar::TParNetworkSettings::ERequesterType::NEH;
+    NPar::TParNetworkSettings::GetRef().UseSharedMemoryForLocalHosts = systemOptions.DevDistributedSharedMemory;
     TMasterEnvironment::GetRef().RootEnvironment = NPar::RunMaster(
         systemOptions.NodePort,
         systemOptions.NumThreads,
@@ -48,10 +61,28 @@ void InitializeMaster(const NCatboostOptions::TSystemOptions& systemOptions) {
     const int workerCount = TMasterEnvironment::GetRef().RootEnvironment->GetSlaveCount();
     const auto& workerMapping = TMasterEnvironment::GetRef().RootEnvironment->MakeHostIdMapping(workerCount);
     TMasterEnvironment::GetRef().SharedTrainData = TMasterEnvironment::GetRef().RootEnvironment->CreateEnvironment(SHARED_ID_TRAIN_DATA, workerMapping);
+    TMasterEnvironment::GetRef().Mode = systemOptions.DevDistributedMode;
+}
+
+static bool IsFeatureParallel() {
+    return TMasterEnvironment::GetRef().Mode == EDistributedMode::FeatureParallel;
+}
+
+/* In feature-parallel mode all workers hold all learn objects and keep the same per-object state,
+ * so sums over objects are taken from one of them
+ */
+template <typename TOutput>
+static void SelectOutputsToReduce(TVector<TOutput>* outputsFromAllWorkers) {
+    if (IsFeatureParallel()) {
+        outputsFromAllWorkers->resize(1);
+    }
 }
 
 void FinalizeMaster(TLearnContext* ctx) {
     Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
+    if (NPar::TParNetworkSettings::GetRef().UseSharedMemoryForLocalHosts) {
+        CATBOOST_INFO_LOG << "Messages sent through shared memory: " << NPar::GetSharedMemoryMessageCount() << Endl;
+    }
     if (TMasterEnvironment::GetRef().RootEnvironment != nullptr) {
         TMasterEnvironment::GetRef().RootEnvironment->Stop();
     }
@@ -86,13 +117,98 @@ void SetTrainDataFromQuantizedPool(
     );
 }
 
+bool CalcFloatFeaturesQuantizationOnWorkers(
+    const NCatboostOptions::TPoolLoadParams* poolLoadOptions,
+    const NCB::TDataMetaInfo& learnMetaInfo,
+    NCB::TQuantizedFeaturesInfo* quantizedFeaturesInfo
+) {
+    if (!poolLoadOptions
+        || poolLoadOptions->CvParams.Initialized()
+        || !IsIn({"", "dsv"}, poolLoadOptions->LearnSetPath.Scheme)
+        || !learnMetaInfo.ColumnsInfo)
+    {
+        CATBOOST_WARNING_LOG << "Distributed quantization is supported only for learn dataset in dsv file, "
+            "float feature borders are selected on master" << Endl;
+        return false;
+    }
+
+    auto& featuresLayout = *quantizedFeaturesInfo->GetFeaturesLayout();
+    const auto featuresMetaInfo = featuresLayout.GetExternalFeaturesMetaInfo();
+    TQuantileSketchBuilderParams params;
+    params.PoolLoadOptions = *poolLoadOptions;
+    params.FloatFeatureCount = featuresLayout.GetFloatFeatureCount();
+    TVector<ui32> flatFeatureIdxByFloatFeatureIdx(params.FloatFeatureCount);
+    ui32 flatFeatureIdx = 0;
+    for (const auto& column : learnMetaInfo.ColumnsInfo->Columns) {
+        ui32 floatFeatureIdx = Max<ui32>();
+        if (IsFactorColumn(column.Type)) {
+            if ((column.Type == EColumn::Num) && featuresMetaInfo[flatFeatureIdx].IsAvailable) {
+                const auto perTypeFeatureIdx = featuresLayout.GetInternalFeatureIdx<EFeatureType::Float>(flatFeatureIdx);
+                if (!quantizedFeaturesInfo->HasQuantization(perTypeFeatureIdx)) {
+                    floatFeatureIdx = *perTypeFeatureIdx;
+                    flatFeatureIdxByFloatFeatureIdx[floatFeatureIdx] = flatFeatureIdx;
+                }
+            }
+            ++flatFeatureIdx;
+        }
+        params.FloatFeatureIdxByColumn.push_back(floatFeatureIdx);
+    }
+
+    const int workerCount = TMasterEnvironment::GetRef().RootEnvironment->GetSlaveCount();
+    auto workerSketches = ApplyMapper<TQuantileSketchBuilder>(
+        workerCount,
+        TMasterEnvironment::GetRef().SharedTrainData,
+        params);
+
+    // merge in worker order for reproducible borders
+    for (auto floatFeatureIdx : params.FloatFeatureIdxByColumn) {
+        if (floatFeatureIdx == Max<ui32>()) {
+            continue;
+        }
+        auto& sketch = workerSketches[0][floatFeatureIdx];
+        for (auto workerIdx : xrange(1, workerCount)) {
+            sketch.Merge(workerSketches[workerIdx][floatFeatureIdx]);
+        }
+        const ui32 featureId = flatFeatureIdxByFloatFeatureIdx[floatFeatureIdx];
+        ENanMode nanMode;
+        NSplitSelection::TQuantization quantization;
+        CalcQuantizationAndNanModeFromSketch(
+            sketch,
+            quantizedFeaturesInfo->GetFloatFeatureBinarization(featureId),
+            featureId,
+            &nanMode,
+            &quantization);
+        if (quantization.Borders.empty()) {
+            CATBOOST_DEBUG_LOG << "Float Feature #" << featureId << " is empty" << Endl;
+            featuresLayout.IgnoreExternalFeature(featureId);
+        }
+        quantizedFeaturesInfo->SetNanMode(TFloatFeatureIdx(floatFeatureIdx), nanMode);
+        quantizedFeaturesInfo->SetQuantization(TFloatFeatureIdx(floatFeatureIdx), std::move(quantization));
+    }
+    return true;
+}
+
 void SetTrainDataFromMaster(
     const TTrainingDataProviders& trainData,
     ui64 cpuUsedRamLimit,
-    NPar::TLocalExecutor* localExecutor
+    NPar::TLocalExecutor* localExecutor,
+    TConstArrayRef<double> workerShares
 ) {
     const int workerCount = TMasterEnvironment::GetRef().RootEnvironment->GetSlaveCount();
-    auto workerParts = Split(*trainData.Learn->ObjectsGrouping, (ui32)workerCount);
+    auto& workerObjectCounts = TMasterEnvironment::GetRef().WorkerObjectCounts;
+    workerObjectCounts.clear();
+    if (IsFeatureParallel()) {
+        for (int workerIdx = 0; workerIdx < workerCount; ++workerIdx) {
+            TMasterEnvironment::GetRef().SharedTrainData->SetContextData(
+                workerIdx,
+                new NCatboostDistributed::TTrainData(trainData),
+                NPar::DELETE_RAW_DATA); // only workers
+        }
+        return;
+    }
+    auto workerParts = workerShares.empty() ?
+        Split(*trainData.Learn->ObjectsGrouping, (ui32)workerCount) :
+        SplitByShares(*trainData.Learn->ObjectsGrouping, workerShares);
     for (int workerIdx = 0; workerIdx < workerCount; ++workerIdx) {
         const TObjectsGroupingSubset objectsGroupingSubset = NCB::GetSubset(
             trainData.Learn->ObjectsGrouping,
@@ -117,6 +233,7 @@ void SetTrainDataFromMaster(
             = trainData.EstimatedObjectsData.FeatureEstimators;
         workerTrainData.EstimatedObjectsData.QuantizedEstimatedFeaturesInfo
             = trainData.EstimatedObjectsData.QuantizedEstimatedFeaturesInfo;
+        workerObjectCounts.push_back(workerTrainData.Learn->GetObjectCount());
 
         TMasterEnvironment::GetRef().SharedTrainData->SetContextData(
             workerIdx,
@@ -125,9 +242,7 @@ void SetTrainDataFromMaster(
     }
 }
 
-void MapBuildPlainFold(TLearnContext* ctx) {
-    Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
-
+static void BuildPlainFoldOnWorkers(ui64 randomSeed, bool isRebuild, TLearnContext* ctx) {
     NJson::TJsonValue jsonParams;
     ctx->Params.Save(&jsonParams);
     const auto& metricOptions = ctx->Params.MetricOptions;
@@ -150,16 +265,23 @@ void MapBuildPlainFold(TLearnContext* ctx) {
         TMasterEnvironment::GetRef().SharedTrainData,
         TPlainFoldBuilderParams({
             ctx->CtrsHelper.GetTargetClassifiers(),
-            ctx->LearnProgress->Rand.GenRand(),
+            randomSeed,
             ctx->LearnProgress->ApproxDimension,
             WriteTJsonValue(jsonParams),
             plainFold.GetLearnSampleCount(),
             plainFold.GetSumWeight(),
-            ctx->LearnProgress->HessianType
+            ctx->LearnProgress->HessianType,
+            isRebuild
         })
     );
 }
 
+void MapBuildPlainFold(TLearnContext* ctx) {
+    Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
+    TMasterEnvironment::GetRef().PlainFoldRandomSeed = ctx->LearnProgress->Rand.GenRand();
+    BuildPlainFoldOnWorkers(TMasterEnvironment::GetRef().PlainFoldRandomSeed, /*isRebuild*/ false, ctx);
+}
+
 void MapRestoreApproxFromTreeStruct(TLearnContext* ctx) {
     Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
     ApplyMapper<TApproxReconstructor>(
@@ -170,7 +292,78 @@ void MapRestoreApproxFromTreeStruct(TLearnContext* ctx) {
 
 void MapTensorSearchStart(TLearnContext* ctx) {
     Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
-    ApplyMapper<TTensorSearchStarter>(TMasterEnvironment::GetRef().RootEnvironment->GetSlaveCount(), TMasterEnvironment::GetRef().SharedTrainData);
+    const auto prevTreeTimeStats = ApplyMapper<TTensorSearchStarter>(
+        TMasterEnvironment::GetRef().RootEnvironment->GetSlaveCount(),
+        TMasterEnvironment::GetRef().SharedTrainData);
+    if (prevTreeTimeStats[0].WallTime == 0) {
+        return;
+    }
+    auto& environment = TMasterEnvironment::GetRef();
+    if (environment.SkipNextTimeStats) {
+        environment.SkipNextTimeStats = false;
+    } else if (!environment.WorkerObjectCounts.empty()) {
+        environment.WorkerBusyTimes.resize(prevTreeTimeStats.size(), 0.0);
+        for (auto workerIdx : xrange(prevTreeTimeStats.size())) {
+            environment.WorkerBusyTimes[workerIdx] += prevTreeTimeStats[workerIdx].BusyTime;
+        }
+        ++environment.WorkerBusyTimesTreeCount;
+    }
+    TStringBuilder idleFractions;
+    for (const auto& timeStats : prevTreeTimeStats) {
+        const double idleFraction = 1 - timeStats.BusyTime / Max(timeStats.WallTime, 1e-9);
+        idleFractions << " " << FloatToString(idleFraction, PREC_NDIGITS, 3);
+    }
+    CATBOOST_DEBUG_LOG << "Worker idle time fractions in tensor search of the previous tree:" << idleFractions << Endl;
+}
+
+// rebalance only if the slowest worker is expected to become faster by this fraction
+static constexpr double MinRebalancingGain = 0.1;
+
+void MapRebalanceWorkers(const TTrainingDataProviders& trainData, TLearnContext* ctx) {
+    Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
+    auto& environment = TMasterEnvironment::GetRef();
+    const TVector<double> busyTimes = std::move(environment.WorkerBusyTimes);
+    const ui32 treeCount = environment.WorkerBusyTimesTreeCount;
+    environment.WorkerBusyTimes.clear();
+    environment.WorkerBusyTimesTreeCount = 0;
+    const TVector<ui32> objectCounts = environment.WorkerObjectCounts;
+    if (objectCounts.empty() || treeCount == 0 || busyTimes.size() != objectCounts.size()) {
+        return;
+    }
+
+    const int workerCount = objectCounts.ysize();
+    TVector<double> throughputs(workerCount); // objects per second of tensor search
+    for (auto workerIdx : xrange(workerCount)) {
+        if (busyTimes[workerIdx] <= 0) {
+            return;
+        }
+        throughputs[workerIdx] = objectCounts[workerIdx] / busyTimes[workerIdx];
+    }
+    // tensor search of a tree waits for the slowest worker
+    const double currentTreeTime = *MaxElement(busyTimes.begin(), busyTimes.end()) / treeCount;
+    const double balancedTreeTime = Accumulate(objectCounts, 0.0) / Accumulate(throughputs, 0.0) / treeCount;
+    TStringBuilder throughputsDescription;
+    for (auto throughput : throughputs) {
+        throughputsDescription << " " << FloatToString(throughput, PREC_NDIGITS, 3);
+    }
+    CATBOOST_DEBUG_LOG << "Worker throughputs in tensor search, objects per second:" << throughputsDescription << Endl;
+    if (balancedTreeTime > (1 - MinRebalancingGain) * currentTreeTime) {
+        return;
+    }
+
+    SetTrainDataFromMaster(
+        trainData,
+        ParseMemorySizeDescription(ctx->Params.SystemOptions->CpuUsedRamLimit.Get()),
+        ctx->LocalExecutor,
+        throughputs);
+    BuildPlainFoldOnWorkers(environment.PlainFoldRandomSeed, /*isRebuild*/ true, ctx);
+    MapRestoreApproxFromTreeStruct(ctx);
+    environment.SkipNextTimeStats = true;
+
+    CATBOOST_NOTICE_LOG << "Learn objects redistributed between workers: ["
+        << JoinSeq(", ", objectCounts) << "] -> [" << JoinSeq(", ", environment.WorkerObjectCounts) << "]"
+        << ", expected tensor search time per tree " << FloatToString(currentTreeTime, PREC_NDIGITS, 3)
+        << " s -> " << FloatToString(balancedTreeTime, PREC_NDIGITS, 3) << " s" << Endl;
 }
 
 void MapBootstrap(TLearnContext* ctx) {
@@ -180,9 +373,10 @@ void MapBootstrap(TLearnContext* ctx) {
 
 double MapCalcDerivativesStDevFromZero(ui32 learnSampleCount, TLearnContext* ctx) {
     Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
-    const TVector<double> sumsFromWorkers = ApplyMapper<TDerivativesStDevFromZeroCalcer>(
+    TVector<double> sumsFromWorkers = ApplyMapper<TDerivativesStDevFromZeroCalcer>(
         TMasterEnvironment::GetRef().RootEnvironment->GetSlaveCount(),
         TMasterEnvironment::GetRef().SharedTrainData);
+    SelectOutputsToReduce(&sumsFromWorkers);
     const double sum2 = Accumulate(sumsFromWorkers, 0.0);
     return sqrt(sum2 / learnSampleCount);
 }
@@ -258,42 +452,65 @@ void MapGenericRemoteCalcScore(
 
     // Flatten candidateLists from all contexts to ensure even parallelization
     TCandidateList allCandidatesList;
-    for (auto& candidatesContext : *candidatesContexts) {
+    TVector<std::pair<int, int>> contextAndCandidateIndices; // [idx in allCandidatesList]
+    for (auto contextIdx : xrange(candidatesContexts->ysize())) {
+        const auto& candidateList = (*candidatesContexts)[contextIdx].CandidateList;
         allCandidatesList.insert(
             allCandidatesList.end(),
-            candidatesContext.CandidateList.begin(),
-            candidatesContext.CandidateList.end());
+            candidateList.begin(),
+            candidateList.end());
+        for (auto candidateIdx : xrange(candidateList.ysize())) {
+            contextAndCandidateIndices.emplace_back(contextIdx, candidateIdx);
+        }
+    }
+
+    /* Candidates are split into groups scored by separate jobs, workers run them concurrently,
+     * so best splits of a group are set while the next groups are computed and sent
+     */
+    const int candidateCount = allCandidatesList.ysize();
+    const int groupCount = Max(
+        1,
+        Min<int>(ctx->Params.SystemOptions->DevDistributedPipelineGroupCount.Get(), candidateCount));
+    const auto getGroupBegin = [=] (int groupIdx) {
+        return (int)((i64)candidateCount * groupIdx / groupCount);
+    };
+    TVector<NPar::TJobDescription> jobs(groupCount);
+    TVector<THolder<NPar::TJobExecutor>> executors;
+    for (auto groupIdx : xrange(groupCount)) {
+        TCandidateList groupCandidatesList(
+            allCandidatesList.begin() + getGroupBegin(groupIdx),
+            allCandidatesList.begin() + getGroupBegin(groupIdx + 1));
+        NPar::Map(&jobs[groupIdx], new TBinCalcMapper(), &groupCandidatesList);
+        NPar::RemoteMap(&jobs[groupIdx], new TScoreCalcMapper);
+        executors.push_back(
+            MakeHolder<NPar::TJobExecutor>(&jobs[groupIdx], TMasterEnvironment::GetRef().SharedTrainData));
     }
 
-    NPar::TJobDescription job;
-    NPar::Map(&job, new TBinCalcMapper(), &allCandidatesList);
-    NPar::RemoteMap(&job, new TScoreCalcMapper);
-    NPar::TJobExecutor exec(&job, TMasterEnvironment::GetRef().SharedTrainData);
-    TVector<typename TScoreCalcMapper::TOutput> allScores;
-    exec.GetRemoteMapResults(&allScores);
-    // set best split for each candidate
-    Y_ASSERT(allCandidatesList.size() == allScores.size());
     const ui64 randSeed = ctx->LearnProgress->Rand.GenRand();
+    for (auto groupIdx : xrange(groupCount)) {
+        const int groupBegin = getGroupBegin(groupIdx);
+        TVector<typename TScoreCalcMapper::TOutput> groupScores;
+        executors[groupIdx]->GetRemoteMapResults(&groupScores);
+        Y_ASSERT(groupScores.ysize() == getGroupBegin(groupIdx + 1) - groupBegin);
 
-    size_t allScoresOffset = 0;
-    for (auto& candidatesContext : *candidatesContexts) {
-        auto& candidateList = candidatesContext.CandidateList;
+        // set best split for each candidate
         ctx->LocalExecutor->ExecRange(
-            [&] (int candidateIdx) {
-                auto& candidates = candidateList[candidateIdx].Candidates;
+            [&] (int idxInGroup) {
+                const auto [contextIdx, candidateIdx] = contextAndCandidateIndices[groupBegin + idxInGroup];
+                auto& candidatesContext = (*candidatesContexts)[contextIdx];
+                auto& candidates = candidatesContext.CandidateList[candidateIdx].Candidates;
                 Y_VERIFY(candidates.size() > 0);
 
                 SetBestScore(
                     randSeed + candidateIdx,
-                    allScores[allScoresOffset + candidateIdx],
+                    groupScores[idxInGroup],
                     scoreStDev,
                     candidatesContext,
                     &candidates);
             },
             0,
-            candidateList.ysize(),
+            groupScores.ysize(),
             NPar::TLocalExecutor::WAIT_COMPLETE);
-        allScoresOffset += candidateList.size();
     }
 }
 
@@ -308,11 +525,49 @@ void MapRemotePairwiseCalcScore(
         ctx);
 }
 
+// each candidate is scored by the worker that owns it, only the best splits are sent to master
+static void MapFeatureParallelCalcScore(
+    double scoreStDev,
+    TVector<TCandidatesContext>* candidatesContexts,
+    TLearnContext* ctx) {
+
+    Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
+
+    TFeatureParallelCandidates candidates;
+    for (const auto& candidatesContext : *candidatesContexts) {
+        candidates.CandidateLists.push_back(candidatesContext.CandidateList);
+        candidates.SelectedFeaturesInBundles.push_back(candidatesContext.SelectedFeaturesInBundles);
+        candidates.PerBinaryPackMasks.push_back(candidatesContext.PerBinaryPackMasks);
+        candidates.SelectedFeaturesInGroups.push_back(candidatesContext.SelectedFeaturesInGroups);
+    }
+    candidates.ScoreStDev = scoreStDev;
+    candidates.RandSeed = ctx->LearnProgress->Rand.GenRand();
+
+    const int workerCount = TMasterEnvironment::GetRef().RootEnvironment->GetSlaveCount();
+    const auto bestSplitsFromAllWorkers = ApplyMapper<TFeatureParallelBestSplitFinder>(
+        workerCount,
+        TMasterEnvironment::GetRef().SharedTrainData,
+        candidates);
+    for (auto datasetIdx : xrange(candidatesContexts->size())) {
+        auto& candidateList = (*candidatesContexts)[datasetIdx].CandidateList;
+        for (auto candidateIdx : xrange(candidateList.size())) {
+            auto& candidate = candidateList[candidateIdx];
+            const int ownerIdx = GetCandidateOwner(candidate, workerCount);
+            candidate.Candidates = bestSplitsFromAllWorkers[ownerIdx][datasetIdx][candidateIdx].Candidates;
+            Y_VERIFY(candidate.Candidates.size() > 0);
+        }
+    }
+}
+
 void MapRemoteCalcScore(
     double scoreStDev,
     TVector<TCandidatesContext>* candidatesContexts,
     TLearnContext* ctx) {
 
+    if (IsFeatureParallel()) {
+        MapFeatureParallelCalcScore(scoreStDev, candidatesContexts, ctx);
+        return;
+    }
     MapGenericRemoteCalcScore<TRemoteBinCalcer, TRemoteScoreCalcer>(
         scoreStDev,
         candidatesContexts,
@@ -325,17 +580,37 @@ void MapSetIndices(const TSplit& bestSplit, TLearnContext* ctx) {
     ApplyMapper<TLeafIndexSetter>(workerCount, TMasterEnvironment::GetRef().SharedTrainData, bestSplit);
 }
 
+static int ReduceAndGetRedundantSplitIdx(TVector<TIsLeafEmpty>* isLeafEmptyFromAllWorkers) {
+    auto& isLeafEmpty = (*isLeafEmptyFromAllWorkers)[0];
+    for (int workerIdx = 1; workerIdx < isLeafEmptyFromAllWorkers->ysize(); ++workerIdx) {
+        for (int leafIdx = 0; leafIdx < isLeafEmpty.ysize(); ++leafIdx) {
+            isLeafEmpty[leafIdx] &= (*isLeafEmptyFromAllWorkers)[workerIdx][leafIdx];
+        }
+    }
+    return GetRedundantSplitIdx(isLeafEmpty);
+}
+
 int MapGetRedundantSplitIdx(TLearnContext* ctx) {
     Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
     const int workerCount = TMasterEnvironment::GetRef().RootEnvironment->GetSlaveCount();
     TVector<TEmptyLeafFinder::TOutput> isLeafEmptyFromAllWorkers
         = ApplyMapper<TEmptyLeafFinder>(workerCount, TMasterEnvironment::GetRef().SharedTrainData); // poll workers
-    for (int workerIdx = 1; workerIdx < workerCount; ++workerIdx) {
-        for (int leafIdx = 0; leafIdx < isLeafEmptyFromAllWorkers[0].ysize(); ++leafIdx) {
-            isLeafEmptyFromAllWorkers[0][leafIdx] &= isLeafEmptyFromAllWorkers[workerIdx][leafIdx];
-        }
+    return ReduceAndGetRedundantSplitIdx(&isLeafEmptyFromAllWorkers);
+}
+
+int MapSetIndicesAndGetRedundantSplitIdx(const TSplit& bestSplit, TLearnContext* ctx) {
+    Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
+    if (!ctx->Params.SystemOptions->DevFuseDistributedRoundTrips) {
+        MapSetIndices(bestSplit, ctx);
+        return MapGetRedundantSplitIdx(ctx);
     }
-    return GetRedundantSplitIdx(isLeafEmptyFromAllWorkers[0]);
+    const int workerCount = TMasterEnvironment::GetRef().RootEnvironment->GetSlaveCount();
+    TVector<TLeafIndexSetterAndEmptyLeafFinder::TOutput> isLeafEmptyFromAllWorkers
+        = ApplyMapper<TLeafIndexSetterAndEmptyLeafFinder>(
+            workerCount,
+            TMasterEnvironment::GetRef().SharedTrainData,
+            bestSplit);
+    return ReduceAndGetRedundantSplitIdx(&isLeafEmptyFromAllWorkers);
 }
 
 static THashMap<TString, TMetricHolder> CalcAdditiveStats(bool useAveragingFold) {
@@ -347,9 +622,10 @@ static THashMap<TString, TMetricHolder> CalcAdditiveStats(bool useAveragingFold)
         TMasterEnvironment::GetRef().SharedTrainData,
         useAveragingFold);
     Y_ASSERT(additiveStatsFromAllWorkers.size() == workerCount);
+    SelectOutputsToReduce(&additiveStatsFromAllWorkers);
 
     auto& additiveStats = additiveStatsFromAllWorkers[0];
-    for (size_t workerIdx : xrange<size_t>(1, workerCount)) {
+    for (size_t workerIdx : xrange<size_t>(1, additiveStatsFromAllWorkers.size())) {
         const auto& workerAdditiveStats = additiveStatsFromAllWorkers[workerIdx];
         for (auto& [description, stats] : additiveStats) {
             Y_ASSERT(workerAdditiveStats.contains(description));
@@ -488,19 +764,41 @@ void MapSetApproxes(
     using TPairwiseBuckets = typename TApproxDefs::TPairwiseBuckets;
     using TBucketUpdater = typename TApproxDefs::TBucketUpdater;
     using TDeltaUpdater = typename TApproxDefs::TDeltaUpdater;
+    using TDeltaAndBucketUpdater = typename TApproxDefs::TDeltaAndBucketUpdater;
+    using TDeltaAndApproxUpdater = typename TApproxDefs::TDeltaAndApproxUpdater;
 
     Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
     const int workerCount = TMasterEnvironment::GetRef().RootEnvironment->GetSlaveCount();
-    ApplyMapper<TCalcApproxStarter>(workerCount, TMasterEnvironment::GetRef().SharedTrainData, splitTree);
+    const bool fuseRoundTrips = ctx->Params.SystemOptions->DevFuseDistributedRoundTrips;
+    // [workerIdx][leafIdx], leaf weights depend only on leaf indices, so they are known after the start
+    TVector<TVector<double>> leafWeightsFromAllWorkers;
+    if (fuseRoundTrips) {
+        leafWeightsFromAllWorkers = ApplyMapper<TCalcApproxStarterAndLeafWeightsGetter>(
+            workerCount,
+            TMasterEnvironment::GetRef().SharedTrainData,
+            splitTree);
+    } else {
+        ApplyMapper<TCalcApproxStarter>(workerCount, TMasterEnvironment::GetRef().SharedTrainData, splitTree);
+    }
     const int gradientIterations = ctx->Params.ObliviousTreeOptions->LeavesEstimationIterations;
     const int approxDimension = ctx->LearnProgress->ApproxDimension;
     const int leafCount = GetLeafCount(splitTree);
     const auto lossFunction = ctx->Params.LossFunctionDescription;
     const auto estimationMethod = ctx->Params.ObliviousTreeOptions->LeavesEstimationMethod;
 
+    /* Without backtracking leaf deltas of a gradient iteration are not needed on workers
+     * until the next request, so they are sent together with it
+     */
+    TVector<TVector<double>> pendingLeafDeltas;
     if (estimationMethod == ELeavesEstimation::Exact) {
         UpdateLeavesExact<TDeltaUpdater>(error, leafCount, averageLeafValues, ctx);
     } else {
+        bool haveBacktrackingObjective;
+        double minimizationSign;
+        TVector<THolder<IMetric>> lossFunction;
+        CreateBacktrackingObjective(*ctx, &haveBacktrackingObjective, &minimizationSign, &lossFunction);
+        const bool deferLeafDeltas = fuseRoundTrips && !haveBacktrackingObjective;
+
         TVector<TSum> buckets(leafCount, TSum(approxDimension, error.GetHessianType()));
         const auto leafUpdaterFunc = [&] (
             bool recalcLeafWeights,
@@ -512,7 +810,14 @@ void MapSetApproxes(
             }
             TPairwiseBuckets pairwiseBuckets;
             TApproxDefs::SetPairwiseBucketsSize(leafCount, &pairwiseBuckets);
-            const auto bucketsFromAllWorkers = ApplyMapper<TBucketUpdater>(workerCount, TMasterEnvironment::GetRef().SharedTrainData);
+            auto bucketsFromAllWorkers = pendingLeafDeltas.empty()
+                ? ApplyMapper<TBucketUpdater>(workerCount, TMasterEnvironment::GetRef().SharedTrainData)
+                : ApplyMapper<TDeltaAndBucketUpdater>(
+                    workerCount,
+                    TMasterEnvironment::GetRef().SharedTrainData,
+                    pendingLeafDeltas);
+            pendingLeafDeltas.clear();
+            SelectOutputsToReduce(&bucketsFromAllWorkers);
             // reduce across workers
             for (const auto& workerBuckets : bucketsFromAllWorkers) {
                 const auto& singleBuckets = workerBuckets.first;
@@ -537,13 +842,13 @@ void MapSetApproxes(
             const TVector<TVector<double>>& leafValues,
             TVector<TVector<double>>* /*approxesPlaceholder*/
         ) {
-            ApplyMapper<TDeltaUpdater>(workerCount, TMasterEnvironment::GetRef().SharedTrainData, leafValues);
+            if (deferLeafDeltas) {
+                pendingLeafDeltas = leafValues;
+            } else {
+                ApplyMapper<TDeltaUpdater>(workerCount, TMasterEnvironment::GetRef().SharedTrainData, leafValues);
+            }
         };
 
-        bool haveBacktrackingObjective;
-        double minimizationSign;
-        TVector<THolder<IMetric>> lossFunction;
-        CreateBacktrackingObjective(*ctx, &haveBacktrackingObjective, &minimizationSign, &lossFunction);
         const auto lossCalcerFunc = [&] (const TVector<TVector<double>>& /*approxPlaceholder*/) {
             CB_ENSURE_INTERNAL(
                 haveBacktrackingObjective,
@@ -573,8 +878,10 @@ void MapSetApproxes(
             averageLeafValues);
     }
 
-    // [workerIdx][dimIdx][leafIdx]
-    const auto leafWeightsFromAllWorkers = ApplyMapper<TLeafWeightsGetter>(workerCount, TMasterEnvironment::GetRef().SharedTrainData);
+    if (!fuseRoundTrips) {
+        leafWeightsFromAllWorkers = ApplyMapper<TLeafWeightsGetter>(workerCount, TMasterEnvironment::GetRef().SharedTrainData);
+    }
+    SelectOutputsToReduce(&leafWeightsFromAllWorkers);
     sumLeafWeights->resize(leafCount);
     for (const auto& workerLeafWeights : leafWeightsFromAllWorkers) {
         AddElementwise(workerLeafWeights, sumLeafWeights);
@@ -587,7 +894,14 @@ void MapSetApproxes(
         averageLeafValues);
 
     // update learn approx and average approx
-    ApplyMapper<TApproxUpdater>(workerCount, TMasterEnvironment::GetRef().SharedTrainData, *averageLeafValues);
+    if (pendingLeafDeltas.empty()) {
+        ApplyMapper<TApproxUpdater>(workerCount, TMasterEnvironment::GetRef().SharedTrainData, *averageLeafValues);
+    } else {
+        ApplyMapper<TDeltaAndApproxUpdater>(
+            workerCount,
+            TMasterEnvironment::GetRef().SharedTrainData,
+            std::make_pair(pendingLeafDeltas, *averageLeafValues));
+    }
     // update test
     const auto indices = BuildIndices(
         /*unused fold*/{ },
@@ -610,6 +924,8 @@ struct TSetApproxesSimpleDefs {
     using TPairwiseBuckets = TArray2D<double>;
     using TBucketUpdater = NCatboostDistributed::TBucketSimpleUpdater;
     using TDeltaUpdater = NCatboostDistributed::TDeltaSimpleUpdater;
+    using TDeltaAndBucketUpdater = NCatboostDistributed::TDeltaAndBucketSimpleUpdater;
+    using TDeltaAndApproxUpdater = NCatboostDistributed::TDeltaSimpleAndApproxUpdater;
 
 public:
     static void SetPairwiseBucketsSize(size_t leafCount, TPairwiseBuckets* pairwiseBuckets) {
@@ -642,6 +958,8 @@ struct TSetApproxesMultiDefs {
     using TPairwiseBuckets = NCatboostDistributed::TUnusedInitializedParam;
     using TBucketUpdater = NCatboostDistributed::TBucketMultiUpdater;
     using TDeltaUpdater = NCatboostDistributed::TDeltaMultiUpdater;
+    using TDeltaAndBucketUpdater = NCatboostDistributed::TDeltaAndBucketMultiUpdater;
+    using TDeltaAndApproxUpdater = NCatboostDistributed::TDeltaMultiAndApproxUpdater;
 
 public:
     static void SetPairwiseBucketsSize(size_t /*leafCount*/, TPairwiseBuckets* /*pairwiseBuckets*/) {}
@@ -19,13 +19,28 @@ void SetTrainDataFromQuantizedPool(
     const NCB::TFeaturesLayout& featuresLayout,
     TRestorableFastRng64* rand
 );
+/* Selects borders and nan modes of float features without quantization in quantizedFeaturesInfo
+ * from quantile sketches built by workers over parts of the learn dataset file.
+ * Returns false if the learn dataset is not a dsv file, borders are selected on master then.
+ */
+bool CalcFloatFeaturesQuantizationOnWorkers(
+    const NCatboostOptions::TPoolLoadParams* poolLoadOptions, // can be nullptr
+    const NCB::TDataMetaInfo& learnMetaInfo,
+    NCB::TQuantizedFeaturesInfo* quantizedFeaturesInfo);
+// learn objects are split between workers in proportion to workerShares, evenly if it is empty
 void SetTrainDataFromMaster(
     const NCB::TTrainingDataProviders& trainData,
     ui64 cpuUsedRamLimit,
-    NPar::TLocalExecutor* localExecutor);
+    NPar::TLocalExecutor* localExecutor,
+    TConstArrayRef<double> workerShares = {});
 void MapBuildPlainFold(TLearnContext* ctx);
 void MapRestoreApproxFromTreeStruct(TLearnContext* ctx);
 void MapTensorSearchStart(TLearnContext* ctx);
+/* Redistributes learn objects between workers in proportion to their tensor search throughput
+ * measured since the previous call, if it is expected to noticeably speed up training.
+ * Worker folds and approxes are rebuilt then. No-op if learn objects were not split by master.
+ */
+void MapRebalanceWorkers(const NCB::TTrainingDataProviders& trainData, TLearnContext* ctx);
 void MapBootstrap(TLearnContext* ctx);
 double MapCalcDerivativesStDevFromZero(ui32 learnSampleCount, TLearnContext* ctx);
 void MapCalcScore(
@@ -43,6 +58,8 @@ void MapRemotePairwiseCalcScore(
     TLearnContext* ctx);
 void MapSetIndices(const TSplit& bestSplit, TLearnContext* ctx);
 int MapGetRedundantSplitIdx(TLearnContext* ctx);
+// MapSetIndices and MapGetRedundantSplitIdx in a single round trip if dev_fuse_distributed_round_trips is set
+int MapSetIndicesAndGetRedundantSplitIdx(const TSplit& bestSplit, TLearnContext* ctx);
 void MapCalcErrors(TLearnContext* ctx);
 
 template <typename TMapper>
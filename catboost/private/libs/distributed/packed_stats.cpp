@@ -0,0 +1,114 @@
+#include "packed_stats.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <library/blockcodecs/codecs.h>
+
+#include <util/generic/xrange.h>
+#include <util/stream/buffer.h>
+#include <util/stream/mem.h>
+#include <util/ysaveload.h>
+
+
+namespace NCatboostDistributed {
+
+    static const char* const StatsCodecName = "lz4";
+
+    static bool IsEmpty(const TBucketStats& bucketStats) {
+        return bucketStats.SumWeightedDelta == 0 && bucketStats.SumWeight == 0
+            && bucketStats.SumDelta == 0 && bucketStats.Count == 0;
+    }
+
+    template <class TValue>
+    static void SaveNonEmptyBuckets(const TVector<TBucketStats>& stats, IOutputStream* output) {
+        const ui32 bucketCount = stats.size();
+        TVector<ui8> isNonEmpty((bucketCount + 7) / 8, 0);
+        for (auto bucketIdx : xrange(bucketCount)) {
+            if (!IsEmpty(stats[bucketIdx])) {
+                isNonEmpty[bucketIdx / 8] |= 1 << (bucketIdx % 8);
+            }
+        }
+        ::Save(output, bucketCount);
+        SaveArray(output, isNonEmpty.data(), isNonEmpty.size());
+        for (auto bucketIdx : xrange(bucketCount)) {
+            if (!IsEmpty(stats[bucketIdx])) {
+                const auto& bucket = stats[bucketIdx];
+                const TValue values[] = {
+                    (TValue)bucket.SumWeightedDelta,
+                    (TValue)bucket.SumWeight,
+                    (TValue)bucket.SumDelta,
+                    (TValue)bucket.Count
+                };
+                SaveArray(output, values, Y_ARRAY_SIZE(values));
+            }
+        }
+    }
+
+    template <class TValue>
+    static void LoadNonEmptyBuckets(IInputStream* input, TVector<TBucketStats>* stats) {
+        ui32 bucketCount = 0;
+        ::Load(input, bucketCount);
+        TVector<ui8> isNonEmpty((bucketCount + 7) / 8);
+        LoadArray(input, isNonEmpty.data(), isNonEmpty.size());
+        stats->assign(bucketCount, TBucketStats{0, 0, 0, 0});
+        for (auto bucketIdx : xrange(bucketCount)) {
+            if (isNonEmpty[bucketIdx / 8] & (1 << (bucketIdx % 8))) {
+                TValue values[4];
+                LoadArray(input, values, Y_ARRAY_SIZE(values));
+                (*stats)[bucketIdx] = TBucketStats{values[0], values[1], values[2], values[3]};
+            }
+        }
+    }
+
+    TPackedStats4D PackStats(TVector<TStats3D>&& stats, EHistogramWireFormat format) {
+        TPackedStats4D packedStats;
+        packedStats.Format = format;
+        packedStats.Stats = std::move(stats);
+        if (format == EHistogramWireFormat::Plain) {
+            return packedStats;
+        }
+        TBufferOutput rawData;
+        for (auto& stats3D : packedStats.Stats) {
+            if (format == EHistogramWireFormat::SparseFloat) {
+                SaveNonEmptyBuckets<float>(stats3D.Stats, &rawData);
+            } else {
+                SaveNonEmptyBuckets<double>(stats3D.Stats, &rawData);
+            }
+            stats3D.Stats.clear();
+            stats3D.Stats.shrink_to_fit();
+        }
+        const auto& buffer = rawData.Buffer();
+        NBlockCodecs::Codec(StatsCodecName)->Encode(TStringBuf(buffer.Data(), buffer.Size()), packedStats.Data);
+        return packedStats;
+    }
+
+    TVector<TStats3D> UnpackStats(TPackedStats4D&& packedStats) {
+        if (packedStats.Format == EHistogramWireFormat::Plain) {
+            return std::move(packedStats.Stats);
+        }
+        TString rawData;
+        NBlockCodecs::Codec(StatsCodecName)->Decode(packedStats.Data, rawData);
+        TMemoryInput input(rawData.data(), rawData.size());
+        for (auto& stats3D : packedStats.Stats) {
+            if (packedStats.Format == EHistogramWireFormat::SparseFloat) {
+                LoadNonEmptyBuckets<float>(&input, &stats3D.Stats);
+            } else {
+                LoadNonEmptyBuckets<double>(&input, &stats3D.Stats);
+            }
+        }
+        CB_ENSURE(input.Exhausted(), "Packed split candidate histograms have trailing data");
+        return std::move(packedStats.Stats);
+    }
+
+    ui64 GetPlainByteCount(const TVector<TStats3D>& stats) {
+        ui64 byteCount = 0;
+        for (const auto& stats3D : stats) {
+            byteCount += sizeof(TStats3D) + stats3D.Stats.size() * sizeof(TBucketStats);
+        }
+        return byteCount;
+    }
+
+    ui64 TPackedStats4D::GetByteCount() const {
+        return GetPlainByteCount(Stats) + Data.size();
+    }
+}
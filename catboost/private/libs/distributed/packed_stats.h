@@ -0,0 +1,37 @@
+#pragma once
+
+#include <catboost/private/libs/algo/calc_score_cache.h>
+#include <catboost/private/libs/options/enums.h>
+
+#include <library/binsaver/bin_saver.h>
+
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+
+namespace NCatboostDistributed {
+
+    /* Split candidate histograms in the form they are sent between workers
+     *  Plain: Stats as is, Data is empty
+     *  Sparse, SparseFloat: Stats keep bucket and leaf counts but no bucket stats, which are
+     *   stored in Data as a compressed list of non-empty buckets
+     */
+    struct TPackedStats4D {
+        EHistogramWireFormat Format = EHistogramWireFormat::Plain;
+        TVector<TStats3D> Stats; // [subCand]
+        TString Data;
+
+    public:
+        SAVELOAD(Format, Stats, Data);
+
+        // approximate serialized size, used for statistics only
+        ui64 GetByteCount() const;
+    };
+
+    TPackedStats4D PackStats(TVector<TStats3D>&& stats, EHistogramWireFormat format);
+    TVector<TStats3D> UnpackStats(TPackedStats4D&& packedStats);
+
+    // serialized size of stats in Plain format
+    ui64 GetPlainByteCount(const TVector<TStats3D>& stats);
+}
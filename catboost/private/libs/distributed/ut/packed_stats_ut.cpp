@@ -0,0 +1,70 @@
+#include <library/unittest/registar.h>
+#include <catboost/private/libs/distributed/packed_stats.h>
+
+#include <library/binsaver/util_stream_io.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/stream/str.h>
+
+using namespace NCatboostDistributed;
+
+// histograms of the shallow levels are mostly empty
+static TVector<TStats3D> GenerateStats(int subCandCount, int bucketCount, int leafCount, ui64 seed) {
+    TFastRng64 rng(seed);
+    TVector<TStats3D> stats(subCandCount);
+    for (auto& stats3D : stats) {
+        stats3D.BucketCount = bucketCount;
+        stats3D.MaxLeafCount = leafCount;
+        stats3D.Stats.resize(bucketCount * leafCount, TBucketStats{0, 0, 0, 0});
+        for (auto& bucket : stats3D.Stats) {
+            if (rng.Uniform(4) == 0) {
+                bucket = TBucketStats{rng.GenRandReal1() - 0.5, rng.GenRandReal1(), rng.GenRandReal1() - 0.5, (double)rng.Uniform(100)};
+            }
+        }
+    }
+    return stats;
+}
+
+static void CheckRoundTrip(EHistogramWireFormat format, double tolerance) {
+    const auto stats = GenerateStats(/*subCandCount*/ 3, /*bucketCount*/ 255, /*leafCount*/ 4, /*seed*/ 0);
+    auto packedStats = PackStats(TVector<TStats3D>(stats), format);
+    if (format != EHistogramWireFormat::Plain) {
+        UNIT_ASSERT(packedStats.GetByteCount() < GetPlainByteCount(stats));
+    }
+
+    TStringStream serialized;
+    SerializeToStream(serialized, packedStats);
+    TPackedStats4D loadedStats;
+    SerializeFromStream(serialized, loadedStats);
+    const auto unpackedStats = UnpackStats(std::move(loadedStats));
+
+    UNIT_ASSERT_VALUES_EQUAL(unpackedStats.size(), stats.size());
+    for (auto subCandIdx : xrange(stats.size())) {
+        const auto& expected = stats[subCandIdx];
+        const auto& actual = unpackedStats[subCandIdx];
+        UNIT_ASSERT_VALUES_EQUAL(actual.BucketCount, expected.BucketCount);
+        UNIT_ASSERT_VALUES_EQUAL(actual.MaxLeafCount, expected.MaxLeafCount);
+        UNIT_ASSERT_VALUES_EQUAL(actual.Stats.size(), expected.Stats.size());
+        for (auto bucketIdx : xrange(expected.Stats.size())) {
+            UNIT_ASSERT_DOUBLES_EQUAL(actual.Stats[bucketIdx].SumWeightedDelta, expected.Stats[bucketIdx].SumWeightedDelta, tolerance);
+            UNIT_ASSERT_DOUBLES_EQUAL(actual.Stats[bucketIdx].SumWeight, expected.Stats[bucketIdx].SumWeight, tolerance);
+            UNIT_ASSERT_DOUBLES_EQUAL(actual.Stats[bucketIdx].SumDelta, expected.Stats[bucketIdx].SumDelta, tolerance);
+            UNIT_ASSERT_VALUES_EQUAL(actual.Stats[bucketIdx].Count, expected.Stats[bucketIdx].Count);
+        }
+    }
+}
+
+Y_UNIT_TEST_SUITE(PackedStatsTest) {
+    Y_UNIT_TEST(Plain) {
+        CheckRoundTrip(EHistogramWireFormat::Plain, 0.0);
+    }
+
+    Y_UNIT_TEST(Sparse) {
+        CheckRoundTrip(EHistogramWireFormat::Sparse, 0.0);
+    }
+
+    Y_UNIT_TEST(SparseFloat) {
+        CheckRoundTrip(EHistogramWireFormat::SparseFloat, 1e-6);
+    }
+}
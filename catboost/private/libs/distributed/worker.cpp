@@ -1,12 +1,15 @@
 #include "worker.h"
+#include "data_types.h"
 
 #include <library/par/par.h>
 #include <library/par/par_util.h>
 
 #include <library/par/par_settings.h>
 
-void RunWorker(ui32 numThreads, ui32 nodePort) {
+void RunWorker(ui32 numThreads, ui32 nodePort, double slowdownFactor, bool useSharedMemory) {
+    NCatboostDistributed::TLocalTensorSearchData::GetRef().TensorSearchTimer.SetSlowdownFactor(slowdownFactor);
     // avoid Netliba
     NPar::TParNetworkSettings::GetRef().RequesterType = NPar::TParNetworkSettings::ERequesterType::NEH;
+    NPar::TParNetworkSettings::GetRef().UseSharedMemoryForLocalHosts = useSharedMemory;
     NPar::RunSlave(numThreads, nodePort);
 }
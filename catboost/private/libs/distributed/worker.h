@@ -2,5 +2,7 @@
 
 #include <util/system/types.h>
 
-void RunWorker(ui32 numThreads, ui32 nodePort);
+// slowdownFactor > 1 throttles tensor search jobs, to test load balancing between workers
+// useSharedMemory: talk to master and workers on the same host through shared memory
+void RunWorker(ui32 numThreads, ui32 nodePort, double slowdownFactor = 1.0, bool useSharedMemory = false);
 
@@ -20,6 +20,24 @@ using namespace NCB;
 
 TVector<TVector<double>> TDocumentImportancesEvaluator::GetDocumentImportances(
     const TProcessedDataProvider& processedData, int logPeriod
+) {
+    TVector<TVector<double>> documentImportances(DocCount);
+    ProcessDocumentImportancesInBlocks(
+        processedData,
+        [&] (ui32 firstDocId, const TVector<TVector<double>>& blockImportances) {
+            Copy(blockImportances.begin(), blockImportances.end(), documentImportances.begin() + firstDocId);
+        },
+        /*maxBlockSizeInBytes*/ Max<ui64>(),
+        logPeriod
+    );
+    return documentImportances;
+}
+
+void TDocumentImportancesEvaluator::ProcessDocumentImportancesInBlocks(
+    const TProcessedDataProvider& processedData,
+    const std::function<void(ui32, const TVector<TVector<double>>&)>& processBlock,
+    ui64 maxBlockSizeInBytes,
+    int logPeriod
 ) {
     TVector<TVector<ui32>> leafIndices(TreeCount);
     auto binarizedFeatures = MakeQuantizedFeaturesForEvaluator(Model, *processedData.ObjectsData.Get());
@@ -28,27 +46,31 @@ TVector<TVector<double>> TDocumentImportancesEvaluator::GetDocumentImportances(
     }, NPar::TLocalExecutor::TExecRangeParams(0, TreeCount), NPar::TLocalExecutor::WAIT_COMPLETE);
 
     UpdateFinalFirstDerivatives(leafIndices, *processedData.TargetData->GetOneDimensionalTarget());
-    TVector<TVector<double>> documentImportances(DocCount, TVector<double>(processedData.GetObjectCount()));
-    const size_t docBlockSize = 1000;
+    const ui32 poolDocCount = processedData.GetObjectCount();
+    const ui64 docImportancesSize = Max<ui64>(1, poolDocCount) * sizeof(double);
+    const size_t docBlockSize = Max<ui64>(1, Min<ui64>(1000, maxBlockSizeInBytes / docImportancesSize));
     TImportanceLogger documentsLogger(DocCount, "documents processed", "Processing documents...", logPeriod);
     TProfileInfo processDocumentsProfile(DocCount);
 
+    TVector<TVector<double>> blockImportances;
     for (size_t start = 0; start < DocCount; start += docBlockSize) {
         const size_t end = Min<size_t>(start + docBlockSize, DocCount);
         processDocumentsProfile.StartIterationBlock();
 
+        blockImportances.resize(end - start);
         LocalExecutor->ExecRange([&] (int docId) {
             // The derivative of leaf values with respect to train doc weight.
             TVector<TVector<TVector<double>>> leafDerivatives(TreeCount, TVector<TVector<double>>(LeavesEstimationIterations)); // [treeCount][LeavesEstimationIterationsCount][leafCount]
             UpdateLeavesDerivatives(docId, &leafDerivatives);
-            GetDocumentImportancesForOneTrainDoc(leafDerivatives, leafIndices, &documentImportances[docId]);
+            blockImportances[docId - start].resize(poolDocCount);
+            GetDocumentImportancesForOneTrainDoc(leafDerivatives, leafIndices, &blockImportances[docId - start]);
         }, NPar::TLocalExecutor::TExecRangeParams(start, end), NPar::TLocalExecutor::WAIT_COMPLETE);
+        processBlock(start, blockImportances);
 
         processDocumentsProfile.FinishIterationBlock(end - start);
         auto profileResults = processDocumentsProfile.GetProfileResults();
         documentsLogger.Log(profileResults);
-        }
-    return documentImportances;
+    }
 }
 
 void TDocumentImportancesEvaluator::UpdateFinalFirstDerivatives(const TVector<TVector<ui32>>& leafIndices, TConstArrayRef<float> target) {
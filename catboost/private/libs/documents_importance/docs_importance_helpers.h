@@ -17,6 +17,8 @@
 #include <util/system/types.h>
 #include <util/system/yassert.h>
 
+#include <functional>
+
 
 /*
  * This is the implementation of the LeafInfluence algorithm from the following paper:
@@ -82,6 +84,17 @@ public:
     // Getting the importance of all train objects for all objects from pool.
     TVector<TVector<double>> GetDocumentImportances(const NCB::TProcessedDataProvider& processedData, int logPeriod = 0);
 
+    /* Importances of consecutive blocks of train objects for all objects from pool, [blockDocCount][poolDocCount].
+     * Importances of a block are evaluated in parallel, the block size is chosen so that a block takes
+     * at most maxBlockSizeInBytes, then processBlock(firstTrainDocId, blockImportances) is called.
+     */
+    void ProcessDocumentImportancesInBlocks(
+        const NCB::TProcessedDataProvider& processedData,
+        const std::function<void(ui32, const TVector<TVector<double>>&)>& processBlock,
+        ui64 maxBlockSizeInBytes,
+        int logPeriod = 0
+    );
+
 private:
     // Evaluate first derivatives at the final approxes
     void UpdateFinalFirstDerivatives(const TVector<TVector<ui32>>& leafIndices, TConstArrayRef<float> target);
@@ -0,0 +1,87 @@
+#include "top_document_importances.h"
+
+#include <util/generic/algorithm.h>
+#include <util/generic/ymath.h>
+
+
+// ties are broken by train object index for determinism
+static bool IsMoreImportant(const std::pair<double, ui32>& lhs, const std::pair<double, ui32>& rhs) {
+    return Abs(lhs.first) > Abs(rhs.first) || (Abs(lhs.first) == Abs(rhs.first) && lhs.second < rhs.second);
+}
+
+TTopDocumentImportances::TTopDocumentImportances(
+    ui32 testDocCount,
+    EDocumentStrengthType docImpMethod,
+    int topSize,
+    EImportanceValuesSign importanceValuesSign
+)
+    : Rows(docImpMethod == EDocumentStrengthType::Average ? 1 : testDocCount)
+    , DocImpMethod(docImpMethod)
+    , TestDocCount(testDocCount)
+    , IsSorted(docImpMethod != EDocumentStrengthType::Raw)
+    , TopSize(topSize)
+    , ImportanceValuesSign(importanceValuesSign)
+{
+}
+
+void TTopDocumentImportances::Add(ui32 row, ui32 trainDocId, double importance) {
+    if ((ImportanceValuesSign == EImportanceValuesSign::Positive && !(importance > 0))
+        || (ImportanceValuesSign == EImportanceValuesSign::Negative && !(importance < 0))) {
+        return;
+    }
+    auto& top = Rows[row];
+    if (top.ysize() < TopSize) {
+        top.emplace_back(importance, trainDocId);
+        if (IsSorted) {
+            PushHeap(top.begin(), top.end(), IsMoreImportant);
+        }
+    } else if (IsSorted && TopSize > 0 && IsMoreImportant({importance, trainDocId}, top.front())) {
+        PopHeap(top.begin(), top.end(), IsMoreImportant);
+        top.back() = {importance, trainDocId};
+        PushHeap(top.begin(), top.end(), IsMoreImportant);
+    }
+}
+
+void TTopDocumentImportances::AddBlock(
+    ui32 firstTrainDocId,
+    const TVector<TVector<double>>& blockImportances,
+    NPar::TLocalExecutor* localExecutor
+) {
+    const ui32 blockDocCount = blockImportances.size();
+    if (DocImpMethod == EDocumentStrengthType::Average) {
+        TVector<double> averageImportances(blockDocCount);
+        localExecutor->ExecRange([&] (int docIdx) {
+            for (ui32 testDocId = 0; testDocId < TestDocCount; ++testDocId) {
+                averageImportances[docIdx] += blockImportances[docIdx][testDocId];
+            }
+            averageImportances[docIdx] /= TestDocCount;
+        }, NPar::TLocalExecutor::TExecRangeParams(0, blockDocCount), NPar::TLocalExecutor::WAIT_COMPLETE);
+        for (ui32 docIdx = 0; docIdx < blockDocCount; ++docIdx) {
+            Add(/*row*/ 0, firstTrainDocId + docIdx, averageImportances[docIdx]);
+        }
+    } else {
+        NPar::TLocalExecutor::TExecRangeParams blockParams(0, TestDocCount);
+        blockParams.SetBlockCountToThreadCount();
+        localExecutor->ExecRange([&] (int testDocId) {
+            for (ui32 docIdx = 0; docIdx < blockDocCount; ++docIdx) {
+                Add(testDocId, firstTrainDocId + docIdx, blockImportances[docIdx][testDocId]);
+            }
+        }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
+    }
+}
+
+TDStrResult TTopDocumentImportances::GetResult() {
+    TDStrResult result(Rows.size());
+    for (ui32 row = 0; row < Rows.size(); ++row) {
+        auto& top = Rows[row];
+        if (IsSorted) {
+            Sort(top.begin(), top.end(), IsMoreImportant);
+        }
+        for (const auto& [importance, trainDocId] : top) {
+            result.Scores[row].push_back(importance);
+            result.Indices[row].push_back(trainDocId);
+        }
+        TVector<std::pair<double, ui32>>().swap(top);
+    }
+    return result;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "docs_importance.h"
+#include "enums.h"
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+#include <utility>
+
+
+/* Keeps top train objects by absolute importance for every test object (PerObject), for the average over
+ * test objects (Average) or the first train objects in the original order (Raw), so that the full
+ * train x test importance matrix is not materialized. Different rows can be updated in parallel.
+ */
+class TTopDocumentImportances {
+public:
+    TTopDocumentImportances(
+        ui32 testDocCount,
+        EDocumentStrengthType docImpMethod,
+        int topSize,
+        EImportanceValuesSign importanceValuesSign
+    );
+
+    void Add(ui32 row, ui32 trainDocId, double importance);
+
+    // blockImportances are [blockDocCount][testDocCount] for train objects starting from firstTrainDocId
+    void AddBlock(
+        ui32 firstTrainDocId,
+        const TVector<TVector<double>>& blockImportances,
+        NPar::TLocalExecutor* localExecutor
+    );
+
+    TDStrResult GetResult();
+
+private:
+    TVector<TVector<std::pair<double, ui32>>> Rows; // heaps with the least important object at front if IsSorted
+    EDocumentStrengthType DocImpMethod;
+    ui32 TestDocCount;
+    bool IsSorted;
+    int TopSize;
+    EImportanceValuesSign ImportanceValuesSign;
+};
@@ -0,0 +1,103 @@
+#include <library/unittest/registar.h>
+#include <catboost/private/libs/documents_importance/top_document_importances.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+#include <util/random/fast.h>
+#include <util/string/builder.h>
+
+#include <numeric>
+
+// selection from the full matrix, as it was done before train objects were processed in blocks
+static TDStrResult SelectFromFullMatrix(
+    const TVector<TVector<double>>& importances, // [trainDocCount][testDocCount]
+    EDocumentStrengthType docImpMethod,
+    int topSize,
+    EImportanceValuesSign importanceValuesSign
+) {
+    const ui32 trainDocCount = importances.size();
+    const ui32 testDocCount = importances[0].size();
+    TVector<TVector<double>> rows; // [rowCount][trainDocCount]
+    if (docImpMethod == EDocumentStrengthType::Average) {
+        rows.assign(1, TVector<double>(trainDocCount, 0.0));
+        for (auto trainDocId : xrange(trainDocCount)) {
+            for (auto testDocId : xrange(testDocCount)) {
+                rows[0][trainDocId] += importances[trainDocId][testDocId];
+            }
+            rows[0][trainDocId] /= testDocCount;
+        }
+    } else {
+        rows.assign(testDocCount, TVector<double>(trainDocCount));
+        for (auto trainDocId : xrange(trainDocCount)) {
+            for (auto testDocId : xrange(testDocCount)) {
+                rows[testDocId][trainDocId] = importances[trainDocId][testDocId];
+            }
+        }
+    }
+
+    TDStrResult result(rows.size());
+    for (auto row : xrange(rows.size())) {
+        const auto& values = rows[row];
+        TVector<ui32> indices(trainDocCount);
+        std::iota(indices.begin(), indices.end(), 0);
+        if (docImpMethod != EDocumentStrengthType::Raw) {
+            StableSort(indices.begin(), indices.end(), [&] (ui32 lhs, ui32 rhs) {
+                return Abs(values[lhs]) > Abs(values[rhs]);
+            });
+        }
+        for (ui32 trainDocId : indices) {
+            if (result.Indices[row].ysize() == topSize) {
+                break;
+            }
+            const double value = values[trainDocId];
+            if ((importanceValuesSign == EImportanceValuesSign::Positive && !(value > 0))
+                || (importanceValuesSign == EImportanceValuesSign::Negative && !(value < 0))) {
+                continue;
+            }
+            result.Indices[row].push_back(trainDocId);
+            result.Scores[row].push_back(value);
+        }
+    }
+    return result;
+}
+
+Y_UNIT_TEST_SUITE(TTopDocumentImportancesTest) {
+    Y_UNIT_TEST(MatchesFullMatrixSelection) {
+        const ui32 trainDocCount = 50;
+        const ui32 testDocCount = 7;
+        const ui32 blockSize = 8; // several blocks, the last one incomplete
+
+        TFastRng64 rng(42);
+        TVector<TVector<double>> importances(trainDocCount, TVector<double>(testDocCount));
+        for (auto& trainDocImportances : importances) {
+            for (auto& importance : trainDocImportances) {
+                // few distinct values to have ties in absolute importance
+                importance = static_cast<int>(rng.Uniform(9)) - 4;
+            }
+        }
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        for (auto docImpMethod : {EDocumentStrengthType::Average, EDocumentStrengthType::PerObject, EDocumentStrengthType::Raw}) {
+            for (auto sign : {EImportanceValuesSign::All, EImportanceValuesSign::Positive, EImportanceValuesSign::Negative}) {
+                for (int topSize : {0, 1, 5, 20, static_cast<int>(trainDocCount)}) {
+                    TTopDocumentImportances topImportances(testDocCount, docImpMethod, topSize, sign);
+                    for (ui32 start = 0; start < trainDocCount; start += blockSize) {
+                        const ui32 end = Min(start + blockSize, trainDocCount);
+                        const TVector<TVector<double>> block(importances.begin() + start, importances.begin() + end);
+                        topImportances.AddBlock(start, block, &localExecutor);
+                    }
+                    const TDStrResult result = topImportances.GetResult();
+                    const TDStrResult expected = SelectFromFullMatrix(importances, docImpMethod, topSize, sign);
+
+                    const TString message = TStringBuilder()
+                        << docImpMethod << ' ' << sign << " top=" << topSize;
+                    UNIT_ASSERT_VALUES_EQUAL_C(result.Indices, expected.Indices, message);
+                    UNIT_ASSERT_VALUES_EQUAL_C(result.Scores, expected.Scores, message);
+                }
+            }
+        }
+    }
+}
@@ -34,6 +34,9 @@ namespace NCB {
         NCB::TPathWithScheme FeatureNamesPath;
 
         ECalcTypeShapValues ShapCalcType = ECalcTypeShapValues::Normal;
+        EShapValuesOutputFormat ShapOutputFormat = EShapValuesOutputFormat::Tsv;
+        ui32 ShapTopFeatureCount = 10;
+        ui32 ShapReadBlockSize = 100000;
 
         void BindParserOpts(NLastGetopt::TOpts& parser);
     };
@@ -583,6 +583,18 @@ void NCatboostOptions::TCatBoostOptions::Validate() const {
     CB_ENSURE(!(!SystemOptions->IsSingleHost() && (BoostingOptions->BoostingType == EBoostingType::Ordered)),
         "Boosting type should be Plain in distributed mode");
 
+    if (GetTaskType() == ETaskType::CPU) {
+        CB_ENSURE(SystemOptions->DevDistributedPipelineGroupCount.Get() > 0,
+            "dev_distributed_pipeline_group_count should be positive");
+    }
+
+    if (GetTaskType() == ETaskType::CPU && SystemOptions->DevDistributedMode.Get() == EDistributedMode::FeatureParallel) {
+        CB_ENSURE(!IsPairwiseScoring(lossFunction),
+            "Feature-parallel distributed mode is not supported for pairwise scoring");
+        CB_ENSURE(ObliviousTreeOptions->LeavesEstimationMethod != ELeavesEstimation::Exact,
+            "Feature-parallel distributed mode is not supported for Exact leaves estimation method");
+    }
+
     if (GetTaskType() == ETaskType::CPU) {
         CB_ENSURE(lossFunction != ELossFunction::QueryCrossEntropy,
                   ELossFunction::QueryCrossEntropy << " loss function is not supported for CPU learning");
@@ -254,6 +254,12 @@ enum class ECalcTypeShapValues {
     Normal
 };
 
+enum class EShapValuesOutputFormat {
+    Tsv,        // for each document and dimension a line of values for all features and expected value
+    Float32,    // binary float32 values in the same order
+    TopKTsv     // for each document and dimension a line of feature:value pairs for top features by absolute value
+};
+
 enum class EObservationsToBootstrap {
     LearnAndTest,
     TestOnly
@@ -286,6 +292,22 @@ enum class ENodeType {
     SingleHost
 };
 
+enum class ENumaMode {
+    None,
+    FeatureParallel // quantized columns and their split candidates are assigned to NUMA nodes, fold data is interleaved
+};
+
+enum class EHistogramWireFormat {
+    Plain,      // all buckets as doubles
+    Sparse,     // non-empty buckets as doubles, compressed
+    SparseFloat // non-empty buckets as floats, compressed, loses precision of bucket sums
+};
+
+enum class EDistributedMode {
+    DataParallel,   // each worker holds a part of learn objects
+    FeatureParallel // each worker holds all learn objects and scores its part of split candidates
+};
+
 enum class EFinalCtrComputationMode {
     Skip,
     Default
@@ -26,6 +26,8 @@ NCatboostOptions::TObliviousTreeLearnerOptions::TObliviousTreeLearnerOptions(ETa
       , SamplingFrequency("sampling_frequency", ESamplingFrequency::PerTree, taskType)
       , ModelSizeReg("model_size_reg", 0.5f, taskType)
       , DevScoreCalcObjBlockSize("dev_score_calc_obj_block_size", 5000000, taskType)
+      , DevSplitScreeningSampleRate("dev_split_screening_sample_rate", 1.0f, taskType)
+      , DevSplitScreeningTopCount("dev_split_screening_top_count", 16, taskType)
       , SparseFeaturesConflictFraction("sparse_features_conflict_fraction", 0.0f, taskType)
       , ObservationsToBootstrap("observations_to_bootstrap", EObservationsToBootstrap::TestOnly, taskType) //it's specific for fold-based scheme, so here and not in bootstrap options
       , FoldSizeLossNormalization("fold_size_loss_normalization", false, taskType)
@@ -59,6 +61,8 @@ void NCatboostOptions::TObliviousTreeLearnerOptions::Load(const NJson::TJsonValu
             &LeavesEstimationBacktrackingType,
             &SamplingFrequency,
             &DevScoreCalcObjBlockSize,
+            &DevSplitScreeningSampleRate,
+            &DevSplitScreeningTopCount,
             &DevExclusiveFeaturesBundleMaxBuckets,
             &SparseFeaturesConflictFraction,
             &MonotoneConstraints,
@@ -81,6 +85,8 @@ void NCatboostOptions::TObliviousTreeLearnerOptions::Save(NJson::TJsonValue* opt
             LeavesEstimationBacktrackingType,
             MaxCtrComplexityForBordersCaching, Rsm, ObservationsToBootstrap, SamplingFrequency,
             DevScoreCalcObjBlockSize,
+            DevSplitScreeningSampleRate,
+            DevSplitScreeningTopCount,
             DevExclusiveFeaturesBundleMaxBuckets,
             SparseFeaturesConflictFraction,
             MonotoneConstraints,
@@ -94,6 +100,7 @@ bool NCatboostOptions::TObliviousTreeLearnerOptions::operator==(const TOblivious
             BootstrapConfig, Rsm, SamplingFrequency, ObservationsToBootstrap, FoldSizeLossNormalization,
             AddRidgeToTargetFunctionFlag, ScoreFunction, GrowPolicy, MaxLeaves, MinDataInLeaf, MaxCtrComplexityForBordersCaching,
             PairwiseNonDiagReg, LeavesEstimationBacktrackingType, DevScoreCalcObjBlockSize,
+            DevSplitScreeningSampleRate, DevSplitScreeningTopCount,
             DevExclusiveFeaturesBundleMaxBuckets, SparseFeaturesConflictFraction,
             MonotoneConstraints, DevLeafwiseApproxes, FeaturePenalties
             ) ==
@@ -102,6 +109,7 @@ bool NCatboostOptions::TObliviousTreeLearnerOptions::operator==(const TOblivious
                 rhs.ObservationsToBootstrap, rhs.FoldSizeLossNormalization, rhs.AddRidgeToTargetFunctionFlag,
                 rhs.ScoreFunction, rhs.GrowPolicy, rhs.MaxLeaves, rhs.MinDataInLeaf, rhs.MaxCtrComplexityForBordersCaching,
                 rhs.PairwiseNonDiagReg, rhs.LeavesEstimationBacktrackingType, rhs.DevScoreCalcObjBlockSize,
+                rhs.DevSplitScreeningSampleRate, rhs.DevSplitScreeningTopCount,
                 rhs.DevExclusiveFeaturesBundleMaxBuckets, rhs.SparseFeaturesConflictFraction,
                 rhs.MonotoneConstraints, rhs.DevLeafwiseApproxes, rhs.FeaturePenalties);
 }
@@ -123,6 +131,11 @@ void NCatboostOptions::TObliviousTreeLearnerOptions::Validate() const {
         CB_ENSURE(MaxLeaves.Get() <= maxLeavesCount, "Maximum leaves count for Lossguide grow policy is " << maxLeavesCount);
     }
     CB_ENSURE(DevScoreCalcObjBlockSize.GetUnchecked() > 0, "DevScoreCalcObjBlockSize must be > 0");
+    CB_ENSURE(
+        (DevSplitScreeningSampleRate.GetUnchecked() > 0.f) && (DevSplitScreeningSampleRate.GetUnchecked() <= 1.f),
+        "DevSplitScreeningSampleRate should be in (0, 1]"
+    );
+    CB_ENSURE(DevSplitScreeningTopCount.GetUnchecked() > 0, "DevSplitScreeningTopCount must be > 0");
     CB_ENSURE(DevExclusiveFeaturesBundleMaxBuckets.Get() < (1U << 16), "DevExclusiveFeaturesBundleMaxBuckets must be less than 65536");
     CB_ENSURE(
         (SparseFeaturesConflictFraction.GetUnchecked() >= 0.f) && (SparseFeaturesConflictFraction.GetUnchecked() < 1.f),
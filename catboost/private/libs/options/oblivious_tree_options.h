@@ -44,6 +44,11 @@ namespace NCatboostOptions {
         // changing this parameter can affect results due to numerical accuracy differences
         TCpuOnlyOption<ui32> DevScoreCalcObjBlockSize;
 
+        // two-stage split search: candidates are screened on a subsample of this rate
+        // and only the best DevSplitScreeningTopCount of them are rescored on the whole sample
+        TCpuOnlyOption<float> DevSplitScreeningSampleRate;
+        TCpuOnlyOption<ui32> DevSplitScreeningTopCount;
+
         TCpuOnlyOption<float> SparseFeaturesConflictFraction;
 
         TGpuOnlyOption<EObservationsToBootstrap> ObservationsToBootstrap;
@@ -347,6 +347,8 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "bayesian_matrix_reg", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "model_size_reg", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "dev_score_calc_obj_block_size", &treeOptions, &seenKeys);
+    CopyOption(plainOptions, "dev_split_screening_sample_rate", &treeOptions, &seenKeys);
+    CopyOption(plainOptions, "dev_split_screening_top_count", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "dev_efb_max_buckets", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "sparse_features_conflict_fraction", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "random_strength", &treeOptions, &seenKeys);
@@ -460,6 +462,15 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "node_type", &systemOptions, &seenKeys);
     CopyOption(plainOptions, "node_port", &systemOptions, &seenKeys);
     CopyOption(plainOptions, "file_with_hosts", &systemOptions, &seenKeys);
+    CopyOption(plainOptions, "dev_numa_mode", &systemOptions, &seenKeys);
+    CopyOption(plainOptions, "dev_numa_fake_node_count", &systemOptions, &seenKeys);
+    CopyOption(plainOptions, "dev_fuse_distributed_round_trips", &systemOptions, &seenKeys);
+    CopyOption(plainOptions, "dev_histogram_wire_format", &systemOptions, &seenKeys);
+    CopyOption(plainOptions, "dev_distributed_mode", &systemOptions, &seenKeys);
+    CopyOption(plainOptions, "dev_distributed_quantization", &systemOptions, &seenKeys);
+    CopyOption(plainOptions, "dev_distributed_pipeline_group_count", &systemOptions, &seenKeys);
+    CopyOption(plainOptions, "dev_distributed_rebalance_period", &systemOptions, &seenKeys);
+    CopyOption(plainOptions, "dev_distributed_shared_memory", &systemOptions, &seenKeys);
 
 
     //rest
@@ -651,6 +662,10 @@ void NCatboostOptions::ConvertOptionsToPlainJson(
 
         DeleteSeenOption(&optionsCopyTree, "dev_score_calc_obj_block_size");
 
+        DeleteSeenOption(&optionsCopyTree, "dev_split_screening_sample_rate");
+
+        DeleteSeenOption(&optionsCopyTree, "dev_split_screening_top_count");
+
         DeleteSeenOption(&optionsCopyTree, "dev_efb_max_buckets");
 
         CopyOption(treeOptions, "sparse_features_conflict_fraction", &plainOptionsJson, &seenKeys);
@@ -910,6 +925,24 @@ void NCatboostOptions::ConvertOptionsToPlainJson(
         CopyOption(systemOptions, "file_with_hosts", &plainOptionsJson, &seenKeys);
         DeleteSeenOption(&optionsCopySystemOptions, "file_with_hosts");
 
+        DeleteSeenOption(&optionsCopySystemOptions, "dev_numa_mode");
+
+        DeleteSeenOption(&optionsCopySystemOptions, "dev_numa_fake_node_count");
+
+        DeleteSeenOption(&optionsCopySystemOptions, "dev_fuse_distributed_round_trips");
+
+        DeleteSeenOption(&optionsCopySystemOptions, "dev_histogram_wire_format");
+
+        DeleteSeenOption(&optionsCopySystemOptions, "dev_distributed_mode");
+
+        DeleteSeenOption(&optionsCopySystemOptions, "dev_distributed_quantization");
+
+        DeleteSeenOption(&optionsCopySystemOptions, "dev_distributed_pipeline_group_count");
+
+        DeleteSeenOption(&optionsCopySystemOptions, "dev_distributed_rebalance_period");
+
+        DeleteSeenOption(&optionsCopySystemOptions, "dev_distributed_shared_memory");
+
         CB_ENSURE(optionsCopySystemOptions.GetMapSafe().empty(), "system_options: key " + optionsCopySystemOptions.GetMapSafe().begin()->first + " wasn't added to plain options.");
         DeleteSeenOption(&optionsCopy, "system_options");
     }
@@ -17,6 +17,15 @@ TSystemOptions::TSystemOptions(ETaskType taskType)
     , NodeType("node_type", ENodeType::SingleHost, taskType)
     , FileWithHosts("file_with_hosts", "hosts.txt", taskType)
     , NodePort("node_port", GetUnusedNodePort(), taskType)
+    , DevNumaMode("dev_numa_mode", ENumaMode::None, taskType)
+    , DevNumaFakeNodeCount("dev_numa_fake_node_count", 0, taskType)
+    , DevFuseDistributedRoundTrips("dev_fuse_distributed_round_trips", true, taskType)
+    , DevHistogramWireFormat("dev_histogram_wire_format", EHistogramWireFormat::Plain, taskType)
+    , DevDistributedMode("dev_distributed_mode", EDistributedMode::DataParallel, taskType)
+    , DevDistributedQuantization("dev_distributed_quantization", false, taskType)
+    , DevDistributedPipelineGroupCount("dev_distributed_pipeline_group_count", 1, taskType)
+    , DevDistributedRebalancePeriod("dev_distributed_rebalance_period", 0, taskType)
+    , DevDistributedSharedMemory("dev_distributed_shared_memory", false, taskType)
 {
     Devices.ChangeLoadUnimplementedPolicy(ELoadUnimplementedPolicy::SkipWithWarning);
     GpuRamPart.ChangeLoadUnimplementedPolicy(ELoadUnimplementedPolicy::SkipWithWarning);
@@ -24,18 +33,34 @@ TSystemOptions::TSystemOptions(ETaskType taskType)
 }
 
 void TSystemOptions::Load(const NJson::TJsonValue& options) {
-    CheckedLoad(options, &NumThreads, &CpuUsedRamLimit, &Devices, &GpuRamPart, &PinnedMemorySize, &NodeType, &FileWithHosts, &NodePort);
+    CheckedLoad(options, &NumThreads, &CpuUsedRamLimit, &Devices, &GpuRamPart, &PinnedMemorySize, &NodeType, &FileWithHosts, &NodePort,
+        &DevNumaMode, &DevNumaFakeNodeCount, &DevFuseDistributedRoundTrips,
+        &DevHistogramWireFormat, &DevDistributedMode, &DevDistributedQuantization,
+        &DevDistributedPipelineGroupCount, &DevDistributedRebalancePeriod,
+        &DevDistributedSharedMemory);
 }
 
 void TSystemOptions::Save(NJson::TJsonValue* options) const {
-    SaveFields(options, NumThreads, CpuUsedRamLimit, Devices, GpuRamPart, PinnedMemorySize, NodeType, FileWithHosts, NodePort);
+    SaveFields(options, NumThreads, CpuUsedRamLimit, Devices, GpuRamPart, PinnedMemorySize, NodeType, FileWithHosts, NodePort,
+        DevNumaMode, DevNumaFakeNodeCount, DevFuseDistributedRoundTrips,
+        DevHistogramWireFormat, DevDistributedMode, DevDistributedQuantization,
+        DevDistributedPipelineGroupCount, DevDistributedRebalancePeriod,
+        DevDistributedSharedMemory);
 }
 
 bool TSystemOptions::operator==(const TSystemOptions& rhs) const {
     return std::tie(NumThreads, CpuUsedRamLimit, Devices,
-                    GpuRamPart, PinnedMemorySize, NodeType, FileWithHosts, NodePort) ==
+                    GpuRamPart, PinnedMemorySize, NodeType, FileWithHosts, NodePort,
+                    DevNumaMode, DevNumaFakeNodeCount, DevFuseDistributedRoundTrips,
+                    DevHistogramWireFormat, DevDistributedMode, DevDistributedQuantization,
+                    DevDistributedPipelineGroupCount, DevDistributedRebalancePeriod,
+                    DevDistributedSharedMemory) ==
            std::tie(rhs.NumThreads, rhs.CpuUsedRamLimit, rhs.Devices,
-                    rhs.GpuRamPart, rhs.PinnedMemorySize, rhs.NodeType, rhs.FileWithHosts, rhs.NodePort);
+                    rhs.GpuRamPart, rhs.PinnedMemorySize, rhs.NodeType, rhs.FileWithHosts, rhs.NodePort,
+                    rhs.DevNumaMode, rhs.DevNumaFakeNodeCount, rhs.DevFuseDistributedRoundTrips,
+                    rhs.DevHistogramWireFormat, rhs.DevDistributedMode, rhs.DevDistributedQuantization,
+                    rhs.DevDistributedPipelineGroupCount, rhs.DevDistributedRebalancePeriod,
+                    rhs.DevDistributedSharedMemory);
 }
 
 bool TSystemOptions::operator!=(const TSystemOptions& rhs) const {
@@ -30,6 +30,27 @@ namespace NCatboostOptions {
         TCpuOnlyOption<TString> FileWithHosts;
         TCpuOnlyOption<ui32> NodePort;
 
+        TCpuOnlyOption<ENumaMode> DevNumaMode;
+        TCpuOnlyOption<ui32> DevNumaFakeNodeCount; // 0 - use detected topology
+
+        // multi-host training: merge consecutive master-worker jobs into single round trips
+        TCpuOnlyOption<bool> DevFuseDistributedRoundTrips;
+        // multi-host training: how workers send split candidate histograms to each other
+        TCpuOnlyOption<EHistogramWireFormat> DevHistogramWireFormat;
+        TCpuOnlyOption<EDistributedMode> DevDistributedMode;
+        // multi-host training: select float feature borders from quantile sketches built by workers
+        TCpuOnlyOption<bool> DevDistributedQuantization;
+        /* multi-host training: split candidates are scored by this many concurrent jobs,
+         * master processes the scores of each job while workers compute the next ones
+         */
+        TCpuOnlyOption<ui32> DevDistributedPipelineGroupCount;
+        /* multi-host training: every this many iterations learn objects are redistributed between workers
+         * in proportion to their measured tensor search throughput, 0 means even split for the whole training
+         */
+        TCpuOnlyOption<ui32> DevDistributedRebalancePeriod;
+        // multi-host training: talk to workers on the same host through shared memory instead of TCP
+        TCpuOnlyOption<bool> DevDistributedSharedMemory;
+
         static ui32 GetUnusedNodePort() { return 0; }
         bool IsMaster() const;
         bool IsSingleHost() const;
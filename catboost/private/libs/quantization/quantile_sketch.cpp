@@ -0,0 +1,218 @@
+#include "quantile_sketch.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/hash_set.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+
+#include <cmath>
+#include <limits>
+
+
+namespace NCB {
+
+    TQuantileSketch::TQuantileSketch(ui32 levelCapacity)
+        : LevelCapacity(levelCapacity)
+        , Levels(1)
+    {
+        CB_ENSURE_INTERNAL(LevelCapacity >= 2, "Quantile sketch level capacity should be at least 2");
+    }
+
+    void TQuantileSketch::Add(float value) {
+        if (std::isnan(value)) {
+            ++NanCount;
+            return;
+        }
+        if (Count == 0) {
+            MinValue = value;
+            MaxValue = value;
+        } else {
+            MinValue = ::Min(MinValue, value);
+            MaxValue = ::Max(MaxValue, value);
+        }
+        ++Count;
+        Levels[0].push_back(value);
+        if (Levels[0].size() >= LevelCapacity) {
+            CompactFullLevels();
+        }
+    }
+
+    void TQuantileSketch::Merge(const TQuantileSketch& rhs) {
+        CB_ENSURE_INTERNAL(
+            LevelCapacity == rhs.LevelCapacity,
+            "Can't merge quantile sketches with different level capacities"
+        );
+        if (rhs.Count != 0) {
+            if (Count == 0) {
+                MinValue = rhs.MinValue;
+                MaxValue = rhs.MaxValue;
+            } else {
+                MinValue = ::Min(MinValue, rhs.MinValue);
+                MaxValue = ::Max(MaxValue, rhs.MaxValue);
+            }
+        }
+        Count += rhs.Count;
+        NanCount += rhs.NanCount;
+        if (Levels.size() < rhs.Levels.size()) {
+            Levels.resize(rhs.Levels.size());
+        }
+        for (auto level : xrange(rhs.Levels.size())) {
+            Levels[level].insert(Levels[level].end(), rhs.Levels[level].begin(), rhs.Levels[level].end());
+        }
+        CompactFullLevels();
+    }
+
+    void TQuantileSketch::CompactFullLevels() {
+        for (size_t level = 0; level < Levels.size(); ++level) {
+            if (Levels[level].size() < LevelCapacity) {
+                continue;
+            }
+            if (level + 1 == Levels.size()) {
+                Levels.emplace_back();
+            }
+            auto& values = Levels[level];
+            Sort(values);
+
+            // odd value count: the largest value stays on this level
+            const size_t pairedCount = values.size() - values.size() % 2;
+            const size_t offset = CompactionCount % 2;
+            ++CompactionCount;
+            auto& nextLevelValues = Levels[level + 1];
+            for (size_t i = offset; i < pairedCount; i += 2) {
+                nextLevelValues.push_back(values[i]);
+            }
+            if (pairedCount != values.size()) {
+                values[0] = values.back();
+                values.resize(1);
+            } else {
+                values.clear();
+            }
+        }
+    }
+
+    void TQuantileSketch::GetWeightedValues(TVector<float>* values, TVector<float>* weights) const {
+        TVector<std::pair<float, float>> weightedValues;
+        for (auto level : xrange(Levels.size())) {
+            const float weight = std::ldexp(1.0f, (int)level);
+            for (float value : Levels[level]) {
+                weightedValues.emplace_back(value, weight);
+            }
+        }
+        Sort(weightedValues);
+
+        values->clear();
+        weights->clear();
+        for (const auto& [value, weight] : weightedValues) {
+            if (!values->empty() && (values->back() == value)) {
+                weights->back() += weight;
+            } else {
+                values->push_back(value);
+                weights->push_back(weight);
+            }
+        }
+    }
+
+
+    // border between the value and the previous one, as for the exact values
+    static float GetBorderBefore(TConstArrayRef<float> sortedValues, size_t idx) {
+        const float border = (sortedValues[idx] + sortedValues[idx - 1]) * .5f;
+        return (border == sortedValues[idx]) ? sortedValues[idx - 1] : border;
+    }
+
+    // borders at ranks (i + 1) * total / (borderCount + 1) of the weighted values
+    static void AddMedianBorders(
+        TConstArrayRef<float> sortedValues,
+        TConstArrayRef<float> weights,
+        int borderCount,
+        THashSet<float>* borders
+    ) {
+        double total = 0;
+        for (auto weight : weights) {
+            total += weight;
+        }
+        size_t idx = 0;
+        double weightBefore = 0; // of values before idx
+        for (auto i : xrange(borderCount)) {
+            const double rank = Min(floor((i + 1) * total / (borderCount + 1)), total - 1);
+            while (weightBefore + weights[idx] <= rank) {
+                weightBefore += weights[idx];
+                ++idx;
+            }
+            if (idx != 0) {
+                borders->insert(GetBorderBefore(sortedValues, idx));
+            }
+        }
+    }
+
+    static void AddUniformBorders(float minValue, float maxValue, int borderCount, THashSet<float>* borders) {
+        for (auto i : xrange(borderCount)) {
+            borders->insert(minValue + (i + 1) * (double(maxValue) - minValue) / (borderCount + 1));
+        }
+    }
+
+    void CalcQuantizationAndNanModeFromSketch(
+        const TQuantileSketch& sketch,
+        const NCatboostOptions::TBinarizationOptions& binarizationOptions,
+        ui32 featureId,
+        ENanMode* nanMode,
+        NSplitSelection::TQuantization* quantization
+    ) {
+        const bool hasNans = sketch.GetNanCount() != 0;
+        CB_ENSURE(
+            (binarizationOptions.NanMode != ENanMode::Forbidden) || !hasNans,
+            "Feature #" << featureId << ": There are nan factors and nan values for "
+            " float features are not allowed. Set nan_mode != Forbidden."
+        );
+
+        int nonNanValuesBorderCount = binarizationOptions.BorderCount;
+        if (hasNans) {
+            *nanMode = binarizationOptions.NanMode;
+            --nonNanValuesBorderCount;
+        } else {
+            *nanMode = ENanMode::Forbidden;
+        }
+
+        *quantization = NSplitSelection::TQuantization();
+        if ((nonNanValuesBorderCount > 0) && (sketch.GetCount() != 0) && (sketch.GetMin() != sketch.GetMax())) {
+            TVector<float> values;
+            TVector<float> weights;
+            sketch.GetWeightedValues(&values, &weights);
+
+            THashSet<float> borders;
+            const EBorderSelectionType borderSelectionType = binarizationOptions.BorderSelectionType;
+            switch (borderSelectionType) {
+                case EBorderSelectionType::Median:
+                    AddMedianBorders(values, weights, nonNanValuesBorderCount, &borders);
+                    break;
+                case EBorderSelectionType::UniformAndQuantiles: {
+                    const int uniformBorderCount = nonNanValuesBorderCount / 2;
+                    AddMedianBorders(values, weights, nonNanValuesBorderCount - uniformBorderCount, &borders);
+                    AddUniformBorders(sketch.GetMin(), sketch.GetMax(), uniformBorderCount, &borders);
+                    break;
+                }
+                case EBorderSelectionType::Uniform:
+                    AddUniformBorders(sketch.GetMin(), sketch.GetMax(), nonNanValuesBorderCount, &borders);
+                    break;
+                default:
+                    borders = BestWeightedSplit(
+                        std::move(values),
+                        weights,
+                        nonNanValuesBorderCount,
+                        borderSelectionType,
+                        /*filterNans*/ false,
+                        /*featuresAreSorted*/ true
+                    );
+            }
+            quantization->Borders.assign(borders.begin(), borders.end());
+            Sort(quantization->Borders);
+        }
+
+        if (*nanMode == ENanMode::Min) {
+            quantization->Borders.insert(quantization->Borders.begin(), std::numeric_limits<float>::lowest());
+        } else if (*nanMode == ENanMode::Max) {
+            quantization->Borders.push_back(std::numeric_limits<float>::max());
+        }
+    }
+}
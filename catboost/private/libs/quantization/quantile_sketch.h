@@ -0,0 +1,76 @@
+#pragma once
+
+#include <catboost/private/libs/options/binarization_options.h>
+
+#include <library/binsaver/bin_saver.h>
+#include <library/cpp/grid_creator/binarization.h>
+
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    /* Mergeable approximate summary of float feature values, KLL-style:
+     *  level h keeps values with weight 2^h, a full level is sorted and every second value
+     *  is promoted to the next level. Offsets of promoted values alternate, so compaction
+     *  is deterministic and the result does not depend on the thread or worker count
+     *  if sketches are merged in the same order.
+     * Rank error is O(log(n / levelCapacity) / levelCapacity) relative to n,
+     *  summary is exact while the value count does not exceed levelCapacity.
+     */
+    class TQuantileSketch {
+    public:
+        explicit TQuantileSketch(ui32 levelCapacity = 4096);
+
+        void Add(float value); // NaNs are only counted
+        void Merge(const TQuantileSketch& rhs);
+
+        // non-NaN values
+        ui64 GetCount() const {
+            return Count;
+        }
+
+        ui64 GetNanCount() const {
+            return NanCount;
+        }
+
+        // exact minimum and maximum of non-NaN values, only valid if GetCount() > 0
+        float GetMin() const {
+            return MinValue;
+        }
+
+        float GetMax() const {
+            return MaxValue;
+        }
+
+        // summary values in ascending order with equal values joined, weights sum to GetCount()
+        void GetWeightedValues(TVector<float>* values, TVector<float>* weights) const;
+
+        SAVELOAD(LevelCapacity, Levels, Count, NanCount, MinValue, MaxValue, CompactionCount);
+
+    private:
+        void CompactFullLevels();
+
+    private:
+        ui32 LevelCapacity;
+        TVector<TVector<float>> Levels;
+        ui64 Count = 0;
+        ui64 NanCount = 0;
+        float MinValue = 0.0f;
+        float MaxValue = 0.0f;
+        ui64 CompactionCount = 0;
+    };
+
+    /* Same nan mode and border selection logic as for the exact values,
+     * EBorderSelectionType semantics are applied to the weighted summary values.
+     * featureId is used for error messages only.
+     */
+    void CalcQuantizationAndNanModeFromSketch(
+        const TQuantileSketch& sketch,
+        const NCatboostOptions::TBinarizationOptions& binarizationOptions,
+        ui32 featureId,
+        ENanMode* nanMode,
+        NSplitSelection::TQuantization* quantization
+    );
+}
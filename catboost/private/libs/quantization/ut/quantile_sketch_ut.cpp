@@ -0,0 +1,154 @@
+#include <catboost/private/libs/quantization/quantile_sketch.h>
+
+#include <library/binsaver/util_stream_io.h>
+#include <library/unittest/registar.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/hash_set.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/stream/buffer.h>
+
+#include <cmath>
+#include <limits>
+
+
+using namespace NCB;
+
+static TVector<float> GenerateValues(size_t count, ui64 seed) {
+    TFastRng64 rng(seed);
+    TVector<float> values;
+    for (auto i : xrange(count)) {
+        Y_UNUSED(i);
+        // repeated values and a long tail
+        values.push_back(rng.Uniform(4) == 0 ? float(rng.Uniform(10)) : float(std::exp(3 * rng.GenRandReal1())));
+    }
+    return values;
+}
+
+static TQuantileSketch MakeSketch(TConstArrayRef<float> values, ui32 levelCapacity) {
+    TQuantileSketch sketch(levelCapacity);
+    for (float value : values) {
+        sketch.Add(value);
+    }
+    return sketch;
+}
+
+static TVector<float> CalcExactBorders(TVector<float> values, int borderCount, EBorderSelectionType type) {
+    THashSet<float> borderSet = BestSplit(values, borderCount, type);
+    TVector<float> borders(borderSet.begin(), borderSet.end());
+    Sort(borders);
+    return borders;
+}
+
+Y_UNIT_TEST_SUITE(TQuantileSketchTest) {
+    Y_UNIT_TEST(ExactWhileSmall) {
+        const auto values = GenerateValues(1000, 0);
+        const auto sketch = MakeSketch(values, 4096);
+
+        ENanMode nanMode;
+        NSplitSelection::TQuantization quantization;
+        CalcQuantizationAndNanModeFromSketch(
+            sketch,
+            NCatboostOptions::TBinarizationOptions(EBorderSelectionType::Median, 32, ENanMode::Min),
+            0,
+            &nanMode,
+            &quantization);
+        UNIT_ASSERT_EQUAL(nanMode, ENanMode::Forbidden);
+        UNIT_ASSERT_VALUES_EQUAL(quantization.Borders, CalcExactBorders(values, 32, EBorderSelectionType::Median));
+
+        for (auto type : {
+                EBorderSelectionType::GreedyLogSum,
+                EBorderSelectionType::MinEntropy,
+                EBorderSelectionType::UniformAndQuantiles,
+                EBorderSelectionType::Uniform})
+        {
+            CalcQuantizationAndNanModeFromSketch(
+                sketch,
+                NCatboostOptions::TBinarizationOptions(type, 32, ENanMode::Min),
+                0,
+                &nanMode,
+                &quantization);
+            UNIT_ASSERT(!quantization.Borders.empty());
+            UNIT_ASSERT(quantization.Borders.size() <= 32);
+            UNIT_ASSERT(IsSorted(quantization.Borders.begin(), quantization.Borders.end()));
+            UNIT_ASSERT(quantization.Borders.front() >= sketch.GetMin());
+            UNIT_ASSERT(quantization.Borders.back() < sketch.GetMax());
+        }
+    }
+
+    Y_UNIT_TEST(MergeIsWeightPreserving) {
+        const auto values = GenerateValues(100000, 1);
+        TQuantileSketch merged(256);
+        for (auto part : xrange(7)) {
+            const size_t begin = values.size() * part / 7;
+            const size_t end = values.size() * (part + 1) / 7;
+            merged.Merge(MakeSketch(TConstArrayRef<float>(values.data() + begin, values.data() + end), 256));
+        }
+        UNIT_ASSERT_VALUES_EQUAL(merged.GetCount(), values.size());
+        UNIT_ASSERT_VALUES_EQUAL(merged.GetMin(), *MinElement(values.begin(), values.end()));
+        UNIT_ASSERT_VALUES_EQUAL(merged.GetMax(), *MaxElement(values.begin(), values.end()));
+
+        TVector<float> summaryValues;
+        TVector<float> weights;
+        merged.GetWeightedValues(&summaryValues, &weights);
+        UNIT_ASSERT(IsSorted(summaryValues.begin(), summaryValues.end()));
+        UNIT_ASSERT(summaryValues.size() < values.size() / 10);
+
+        // ranks of summary values are close to exact ones
+        auto sortedValues = values;
+        Sort(sortedValues);
+        double weightBefore = 0;
+        for (auto i : xrange(summaryValues.size())) {
+            const double exactRank = LowerBound(sortedValues.begin(), sortedValues.end(), summaryValues[i])
+                - sortedValues.begin();
+            UNIT_ASSERT_DOUBLES_EQUAL(weightBefore, exactRank, 0.05 * values.size());
+            weightBefore += weights[i];
+        }
+        UNIT_ASSERT_DOUBLES_EQUAL(weightBefore, values.size(), 0.5);
+    }
+
+    Y_UNIT_TEST(NanModes) {
+        TQuantileSketch sketch;
+        for (float value : {1.0f, 2.0f, std::numeric_limits<float>::quiet_NaN(), 3.0f}) {
+            sketch.Add(value);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetCount(), 3);
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetNanCount(), 1);
+
+        ENanMode nanMode;
+        NSplitSelection::TQuantization quantization;
+        CalcQuantizationAndNanModeFromSketch(
+            sketch,
+            NCatboostOptions::TBinarizationOptions(EBorderSelectionType::Uniform, 2, ENanMode::Max),
+            0,
+            &nanMode,
+            &quantization);
+        UNIT_ASSERT_EQUAL(nanMode, ENanMode::Max);
+        UNIT_ASSERT_VALUES_EQUAL(quantization.Borders, (TVector<float>{2.0f, std::numeric_limits<float>::max()}));
+
+        UNIT_ASSERT_EXCEPTION(
+            CalcQuantizationAndNanModeFromSketch(
+                sketch,
+                NCatboostOptions::TBinarizationOptions(EBorderSelectionType::Uniform, 2, ENanMode::Forbidden),
+                0,
+                &nanMode,
+                &quantization),
+            TCatBoostException);
+    }
+
+    Y_UNIT_TEST(Serialization) {
+        auto sketch = MakeSketch(GenerateValues(10000, 2), 128);
+        TBufferStream stream;
+        SerializeToStream(stream, sketch);
+        TQuantileSketch loaded;
+        SerializeFromStream(stream, loaded);
+
+        TVector<float> values, weights, loadedValues, loadedWeights;
+        sketch.GetWeightedValues(&values, &weights);
+        loaded.GetWeightedValues(&loadedValues, &loadedWeights);
+        UNIT_ASSERT_VALUES_EQUAL(values, loadedValues);
+        UNIT_ASSERT_VALUES_EQUAL(weights, loadedWeights);
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetNanCount(), loaded.GetNanCount());
+    }
+}
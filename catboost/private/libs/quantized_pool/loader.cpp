@@ -407,7 +407,16 @@ void NCB::TCBQuantizedDataLoader::Do(IQuantizedFeaturesDataVisitor* visitor) {
 }
 
 namespace {
+    // sharded pool is expected to be visible from all hosts, distributed workers load their shards themselves
+    struct TShardedFSExistsChecker : public TFSExistsChecker {
+        bool IsSharedFs() const override {
+            return true;
+        }
+    };
+
     TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSQuantizedExistsCheckerReg("quantized");
     TDatasetLoaderFactory::TRegistrator<NCB::TCBQuantizedDataLoader> CBQuantizedDataLoaderReg("quantized");
+    TExistsCheckerFactory::TRegistrator<TShardedFSExistsChecker> FSShardedQuantizedExistsCheckerReg("sharded-quantized");
+    TDatasetLoaderFactory::TRegistrator<NCB::TCBQuantizedDataLoader> CBShardedQuantizedDataLoaderReg("sharded-quantized");
 }
 
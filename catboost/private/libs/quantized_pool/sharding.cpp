@@ -0,0 +1,286 @@
+#include "sharding.h"
+#include "loader.h"
+#include "serialization.h"
+
+#include <catboost/idl/pool/flat/quantized_chunk_t.fbs.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/private/libs/data_util/path_with_scheme.h>
+
+#include <contrib/libs/flatbuffers/include/flatbuffers/flatbuffers.h>
+
+#include <util/folder/path.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
+#include <util/generic/maybe.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+#include <util/memory/blob.h>
+#include <util/stream/file.h>
+#include <util/string/cast.h>
+#include <util/system/fs.h>
+#include <util/system/unaligned_mem.h>
+
+#include <climits>
+
+
+TVector<NCB::TQuantizedPoolShardInfo> NCB::ReadQuantizedPoolShardsIndex(const TString& poolDir) {
+    const auto indexPath = JoinFsPaths(poolDir, QUANTIZED_POOL_SHARDS_INDEX_FILE_NAME);
+    CB_ENSURE(
+        NFs::Exists(indexPath),
+        "Sharded quantized pool " << poolDir << " has no " << QUANTIZED_POOL_SHARDS_INDEX_FILE_NAME);
+
+    TVector<TQuantizedPoolShardInfo> shards;
+    ui64 objectCount = 0;
+    TFileInput input(indexPath);
+    TString line;
+    while (input.ReadLine(line)) {
+        if (line.empty()) {
+            continue;
+        }
+        TStringBuf fileName;
+        TStringBuf shardObjectCount;
+        CB_ENSURE(
+            TStringBuf(line).TrySplit('\t', fileName, shardObjectCount),
+            "Bad line in " << indexPath << ": " << line);
+        shards.push_back({TString(fileName), FromString<ui32>(shardObjectCount)});
+        objectCount += shards.back().ObjectCount;
+    }
+    CB_ENSURE(!shards.empty(), "Sharded quantized pool " << poolDir << " has no shards");
+    CB_ENSURE(
+        objectCount <= (ui64)Max<ui32>(),
+        "CatBoost does not support datasets with more than " << Max<ui32>() << " objects");
+    return shards;
+}
+
+// begins of groups in object order, empty if pool has no GroupId column
+static TVector<ui32> GetGroupBegins(const NCB::TQuantizedPool& pool) {
+    TVector<ui32> groupBegins;
+    const auto groupIdLocalIdx = FindIndex(pool.ColumnTypes, EColumn::GroupId);
+    if (groupIdLocalIdx == NPOS) {
+        return groupBegins;
+    }
+
+    auto chunks = pool.Chunks[groupIdLocalIdx];
+    Sort(chunks, [] (const auto& lhs, const auto& rhs) {
+        return lhs.DocumentOffset < rhs.DocumentOffset;
+    });
+
+    ui32 objectIdx = 0;
+    ui64 previousGroupId = 0;
+    for (const auto& chunk : chunks) {
+        CB_ENSURE(
+            chunk.Chunk->BitsPerDocument() == sizeof(ui64) * CHAR_BIT,
+            "GroupId column should have " << sizeof(ui64) * CHAR_BIT << " bits per value");
+        CB_ENSURE(chunk.DocumentOffset == objectIdx, "GroupId chunks should follow each other without gaps");
+        TUnalignedMemoryIterator<ui64> groupIds(chunk.Chunk->Quants()->data(), chunk.Chunk->Quants()->size());
+        for (; !groupIds.AtEnd(); ++objectIdx) {
+            const ui64 groupId = groupIds.Next();
+            if ((objectIdx == 0) || (groupId != previousGroupId)) {
+                groupBegins.push_back(objectIdx);
+            }
+            previousGroupId = groupId;
+        }
+    }
+    CB_ENSURE(objectIdx == pool.DocumentCount, "GroupId column should have values for all objects");
+    return groupBegins;
+}
+
+TVector<NCB::TIndexRange<ui32>> NCB::SplitObjectsByGroups(
+    TConstArrayRef<ui32> groupBegins,
+    ui32 objectCount,
+    ui32 partCount
+) {
+    CB_ENSURE(partCount > 0, "Part count should be positive");
+    const bool hasGroups = !groupBegins.empty();
+    const ui32 groupCount = hasGroups ? groupBegins.size() : objectCount;
+    CB_ENSURE(
+        groupCount >= partCount,
+        "Pool must contain at least " << partCount << (hasGroups ? " groups" : " objects"));
+    CB_ENSURE_INTERNAL(!hasGroups || groupBegins[0] == 0, "First group should begin at the first object");
+
+    const auto getGroupBegin = [&] (ui32 groupIdx) {
+        if (groupIdx == groupCount) {
+            return objectCount;
+        }
+        return hasGroups ? groupBegins[groupIdx] : groupIdx;
+    };
+
+    const ui64 groupsPerPart = CeilDiv(groupCount, partCount);
+    TVector<TIndexRange<ui32>> partRanges;
+    for (auto partIdx : xrange(partCount)) {
+        const ui32 startGroup = Min<ui64>(groupsPerPart * partIdx, groupCount);
+        const ui32 endGroup = Min<ui64>(startGroup + groupsPerPart, groupCount);
+        partRanges.emplace_back(getGroupBegin(startGroup), getGroupBegin(endGroup));
+    }
+    return partRanges;
+}
+
+TVector<NCB::TIndexRange<ui32>> NCB::SplitQuantizedPoolIntoShards(const TQuantizedPool& pool, ui32 shardCount) {
+    CB_ENSURE(shardCount > 0, "Shard count should be positive");
+    return SplitObjectsByGroups(GetGroupBegins(pool), SafeIntegerCast<ui32>(pool.DocumentCount), shardCount);
+}
+
+NCB::TQuantizedPool NCB::GetQuantizedPoolSlice(const TQuantizedPool& pool, TIndexRange<ui32> objectRange) {
+    TQuantizedPool slice;
+    slice.DocumentCount = objectRange.GetSize();
+    slice.ColumnIndexToLocalIndex = pool.ColumnIndexToLocalIndex;
+    slice.QuantizationSchema = pool.QuantizationSchema;
+    slice.ColumnTypes = pool.ColumnTypes;
+    slice.ColumnNames = pool.ColumnNames;
+    slice.IgnoredColumnIndices = pool.IgnoredColumnIndices;
+    slice.Chunks.resize(pool.ColumnTypes.size());
+
+    flatbuffers::FlatBufferBuilder builder;
+    for (auto localIdx : xrange(pool.ColumnTypes.size())) {
+        for (const auto& chunk : pool.Chunks[localIdx]) {
+            const auto valueBytes = static_cast<size_t>(chunk.Chunk->BitsPerDocument() / CHAR_BIT);
+            CB_ENSURE(valueBytes > 0, "Cannot slice quantized pool with less than " << CHAR_BIT << " bits per value");
+            const size_t chunkEnd = chunk.DocumentOffset + chunk.Chunk->Quants()->size() / valueBytes;
+            const size_t begin = Max<size_t>(chunk.DocumentOffset, objectRange.Begin);
+            const size_t end = Min<size_t>(chunkEnd, objectRange.End);
+            if (begin >= end) {
+                continue;
+            }
+
+            builder.Clear();
+            builder.Finish(NIdl::CreateTQuantizedFeatureChunk(
+                builder,
+                chunk.Chunk->BitsPerDocument(),
+                builder.CreateVector(
+                    chunk.Chunk->Quants()->data() + (begin - chunk.DocumentOffset) * valueBytes,
+                    (end - begin) * valueBytes)));
+            slice.Blobs.push_back(TBlob::Copy(builder.GetBufferPointer(), builder.GetSize()));
+
+            slice.Chunks[localIdx].emplace_back(
+                begin - objectRange.Begin,
+                end - begin,
+                flatbuffers::GetRoot<NIdl::TQuantizedFeatureChunk>(slice.Blobs.back().AsCharPtr()));
+        }
+    }
+    return slice;
+}
+
+void NCB::SaveShardedQuantizedPool(
+    const TQuantizedPool& pool,
+    ui32 shardCount,
+    const TString& poolDir,
+    NPar::TLocalExecutor* localExecutor
+) {
+    const auto shardRanges = SplitQuantizedPoolIntoShards(pool, shardCount);
+    TFsPath(poolDir).MkDirs();
+
+    TVector<TQuantizedPoolShardInfo> shards(shardRanges.size());
+    localExecutor->ExecRangeWithThrow(
+        [&] (int shardIdx) {
+            shards[shardIdx].FileName = "shard_" + ToString(shardIdx) + ".bin";
+            shards[shardIdx].ObjectCount = shardRanges[shardIdx].GetSize();
+
+            const auto shardPool = GetQuantizedPoolSlice(pool, shardRanges[shardIdx]);
+            TFileOutput output(JoinFsPaths(poolDir, shards[shardIdx].FileName));
+            SaveQuantizedPool(shardPool, &output);
+        },
+        0,
+        SafeIntegerCast<int>(shardRanges.size()),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    // a directory with partially written shards can't be loaded
+    TFileOutput index(JoinFsPaths(poolDir, QUANTIZED_POOL_SHARDS_INDEX_FILE_NAME));
+    for (const auto& shard : shards) {
+        index << shard.FileName << '\t' << shard.ObjectCount << '\n';
+    }
+}
+
+namespace {
+    class TShardedQuantizedPoolLoader : public NCB::IQuantizedPoolLoader {
+    public:
+        explicit TShardedQuantizedPoolLoader(const NCB::TPathWithScheme& pathWithScheme)
+            : PathWithScheme(pathWithScheme)
+        {}
+        NCB::TQuantizedPool LoadQuantizedPool(NCB::TLoadQuantizedPoolParameters params) override;
+        TVector<ui8> LoadQuantizedColumn(ui32 columnIdx) override;
+    private:
+        NCB::TPathWithScheme PathWithScheme;
+    };
+}
+
+NCB::TQuantizedPool TShardedQuantizedPoolLoader::LoadQuantizedPool(NCB::TLoadQuantizedPoolParameters params) {
+    const auto shards = NCB::ReadQuantizedPoolShardsIndex(PathWithScheme.Path);
+    const auto& loadRange = params.DatasetSubset.Range;
+
+    TMaybe<NCB::TQuantizedPool> pool;
+    const auto addShard = [&] (ui32 shardIdx, ui32 shardBegin) {
+        const auto shardPath = JoinFsPaths(PathWithScheme.Path, shards[shardIdx].FileName);
+        auto shard = NCB::LoadQuantizedPool(
+            NCB::TPathWithScheme(shardPath, "quantized"),
+            {params.LockMemory, params.Precharge, NCB::TDatasetSubset()});
+        CB_ENSURE(
+            shard.DocumentCount == shards[shardIdx].ObjectCount,
+            "Shard " << shardPath << " has " << shard.DocumentCount << " objects instead of "
+            << shards[shardIdx].ObjectCount);
+        for (auto& chunks : shard.Chunks) {
+            for (auto& chunk : chunks) {
+                chunk.DocumentOffset += shardBegin;
+            }
+        }
+
+        if (!pool) {
+            pool = std::move(shard);
+            return;
+        }
+        CB_ENSURE(
+            shard.ColumnIndexToLocalIndex == pool->ColumnIndexToLocalIndex
+            && shard.ColumnTypes == pool->ColumnTypes
+            && shard.HasStringColumns == pool->HasStringColumns
+            && shard.StringDocIdLocalIndex == pool->StringDocIdLocalIndex
+            && shard.StringGroupIdLocalIndex == pool->StringGroupIdLocalIndex
+            && shard.StringSubgroupIdLocalIndex == pool->StringSubgroupIdLocalIndex
+            && shard.Chunks.size() == pool->Chunks.size(),
+            "Columns of shard " << shardPath << " differ from columns of previous shards");
+        for (auto localIdx : xrange(shard.Chunks.size())) {
+            auto& chunks = pool->Chunks[localIdx];
+            chunks.insert(chunks.end(), shard.Chunks[localIdx].begin(), shard.Chunks[localIdx].end());
+        }
+        for (auto& blob : shard.Blobs) {
+            pool->Blobs.push_back(std::move(blob));
+        }
+        for (auto& chunkStorage : shard.ChunkStorage) {
+            pool->ChunkStorage.push_back(std::move(chunkStorage));
+        }
+    };
+
+    ui32 shardBegin = 0;
+    for (auto shardIdx : xrange(shards.size())) {
+        const ui32 shardEnd = shardBegin + shards[shardIdx].ObjectCount;
+        if ((shardBegin < shardEnd) && (shardBegin < loadRange.End) && (loadRange.Begin < shardEnd)) {
+            addShard(shardIdx, shardBegin);
+        }
+        shardBegin = shardEnd;
+    }
+    if (!pool) {
+        // nothing to load, columns are still needed
+        addShard(0, 0);
+        for (auto& chunks : pool->Chunks) {
+            chunks.clear();
+        }
+    }
+    pool->DocumentCount = shardBegin;
+
+    if (!params.DatasetSubset.HasFeatures) {
+        for (auto localIdx : xrange(pool->ColumnTypes.size())) {
+            const auto columnType = pool->ColumnTypes[localIdx];
+            if (columnType == EColumn::Num || columnType == EColumn::Categ) {
+                pool->Chunks[localIdx].clear();
+            }
+        }
+    }
+
+    return std::move(*pool);
+}
+
+TVector<ui8> TShardedQuantizedPoolLoader::LoadQuantizedColumn(ui32 /*columnIdx*/) {
+    CB_ENSURE_INTERNAL(false, "Schema sharded-quantized does not support columnwise loading");
+}
+
+namespace {
+    NCB::TQuantizedPoolLoaderFactory::TRegistrator<TShardedQuantizedPoolLoader> ShardedQuantizedPoolLoaderReg("sharded-quantized");
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "pool.h"
+
+#include <catboost/private/libs/index_range/index_range.h>
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/strbuf.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+    /* Sharded quantized pool is a directory with shard files and an index file.
+     * Each shard is a quantized pool file (see file_format.md) with the same columns and quantization
+     * schema as the whole pool and objects of a contiguous range, the index lists shards in object order.
+     * It is loaded with scheme `sharded-quantized`, load of an object range maps only intersecting shards.
+     */
+    const TStringBuf QUANTIZED_POOL_SHARDS_INDEX_FILE_NAME = "shards.tsv";
+
+    struct TQuantizedPoolShardInfo {
+        TString FileName; // relative to the pool directory
+        ui32 ObjectCount = 0;
+    };
+
+    TVector<TQuantizedPoolShardInfo> ReadQuantizedPoolShardsIndex(const TString& poolDir);
+
+    /* Splits objects into partCount contiguous ranges of the same count of whole groups (the last ranges
+     * can have less). groupBegins are begins of groups in object order, empty if each object is a group.
+     * Learn data parts of workers in distributed training and shards of pools are split by it,
+     * so that each worker maps only its own shard.
+     */
+    TVector<TIndexRange<ui32>> SplitObjectsByGroups(
+        TConstArrayRef<ui32> groupBegins,
+        ui32 objectCount,
+        ui32 partCount);
+
+    // Group-aligned object ranges, the same as learn data parts of workers with shardCount workers
+    TVector<TIndexRange<ui32>> SplitQuantizedPoolIntoShards(const TQuantizedPool& pool, ui32 shardCount);
+
+    /* Copies data of objects from objectRange to a standalone pool.
+     * String DocId, GroupId and SubgroupId columns are not copied.
+     */
+    TQuantizedPool GetQuantizedPoolSlice(const TQuantizedPool& pool, TIndexRange<ui32> objectRange);
+
+    // Shards are written in parallel, index is written last.
+    void SaveShardedQuantizedPool(
+        const TQuantizedPool& pool,
+        ui32 shardCount,
+        const TString& poolDir,
+        NPar::TLocalExecutor* localExecutor);
+}
@@ -0,0 +1,109 @@
+#include <catboost/private/libs/quantized_pool/pool.h>
+#include <catboost/private/libs/quantized_pool/print.h>
+#include <catboost/private/libs/quantized_pool/serialization.h>
+#include <catboost/private/libs/quantized_pool/sharding.h>
+
+#include <library/threading/local_executor/local_executor.h>
+#include <library/unittest/registar.h>
+
+#include <util/folder/path.h>
+#include <util/folder/tempdir.h>
+#include <util/generic/xrange.h>
+#include <util/stream/str.h>
+#include <util/system/mktemp.h>
+#include <util/system/tempfile.h>
+
+
+using namespace NCB;
+
+// 8 objects in 5 groups: [0, 2), [2, 4), [4, 6), [6, 7), [7, 8)
+static TSrcData MakeSrcData() {
+    TSrcData srcData;
+    srcData.DocumentCount = 8;
+    srcData.LocalIndexToColumnIndex = {0, 1, 2, 3};
+    srcData.PoolQuantizationSchema.FeatureIndices = {0, 1};
+    srcData.PoolQuantizationSchema.Borders = {{0.1f, 0.2f, 0.3f}, {0.25f, 0.5f, 0.75f}};
+    srcData.PoolQuantizationSchema.NanModes = {ENanMode::Forbidden, ENanMode::Min};
+    srcData.GroupIds = TSrcColumn<TGroupId>{EColumn::GroupId, {{1, 1, 2}, {2, 3, 3, 4, 5}}};
+    srcData.FloatFeatures = {
+        TSrcColumn<ui8>{EColumn::Num, {{1, 3, 0, 2}, {0, 1, 2, 3}}},
+        TSrcColumn<ui8>{EColumn::Num, {{2, 3}, {0, 3, 1, 2, 1, 0}}}
+    };
+    srcData.Target = TSrcColumn<float>{EColumn::Label, {{0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f}}};
+    return srcData;
+}
+
+static TString QuantizedPoolToString(const TQuantizedPool& pool) {
+    TString str;
+    TStringOutput output{str};
+    PrintQuantizedPool(pool, {EQuantizedPoolPrintFormat::HumanReadableColumnWise}, &output);
+    return str;
+}
+
+Y_UNIT_TEST_SUITE(ShardingTests) {
+    Y_UNIT_TEST(SplitObjectsByGroups) {
+        const TVector<TIndexRange<ui32>> expectedObjectRanges = {{0, 3}, {3, 6}, {6, 7}};
+        UNIT_ASSERT_EQUAL(SplitObjectsByGroups({}, 7, 3), expectedObjectRanges);
+
+        // more parts than groups per part allow: the last parts are empty
+        const TVector<TIndexRange<ui32>> expectedEmptyTail = {{0, 2}, {2, 4}, {4, 5}, {5, 5}};
+        UNIT_ASSERT_EQUAL(SplitObjectsByGroups({}, 5, 4), expectedEmptyTail);
+
+        const TVector<ui32> groupBegins = {0, 2, 4, 6, 7};
+        const TVector<TIndexRange<ui32>> expectedGroupRanges = {{0, 4}, {4, 7}, {7, 8}};
+        UNIT_ASSERT_EQUAL(SplitObjectsByGroups(groupBegins, 8, 3), expectedGroupRanges);
+
+        UNIT_ASSERT_EXCEPTION(SplitObjectsByGroups(groupBegins, 8, 6), TCatBoostException);
+        UNIT_ASSERT_EXCEPTION(SplitObjectsByGroups({}, 8, 0), TCatBoostException);
+    }
+
+    Y_UNIT_TEST(SplitByGroups) {
+        const TString poolPath = MakeTempName();
+        TTempFile poolFile(poolPath);
+        SaveQuantizedPool(MakeSrcData(), poolPath);
+        const auto pool = LoadQuantizedPool(TPathWithScheme(poolPath, "quantized"), {false, false, TDatasetSubset()});
+
+        const auto shardRanges = SplitQuantizedPoolIntoShards(pool, 3);
+        const TVector<TIndexRange<ui32>> expectedShardRanges = {{0, 4}, {4, 7}, {7, 8}};
+        UNIT_ASSERT_EQUAL(shardRanges, expectedShardRanges);
+
+        UNIT_ASSERT_EXCEPTION(SplitQuantizedPoolIntoShards(pool, 6), TCatBoostException);
+    }
+
+    Y_UNIT_TEST(SaveAndLoad) {
+        const TString poolPath = MakeTempName();
+        TTempFile poolFile(poolPath);
+        SaveQuantizedPool(MakeSrcData(), poolPath);
+        const auto pool = LoadQuantizedPool(TPathWithScheme(poolPath, "quantized"), {false, false, TDatasetSubset()});
+
+        TTempDir shardedPoolDir;
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(2);
+        SaveShardedQuantizedPool(pool, 3, shardedPoolDir(), &localExecutor);
+
+        const auto shards = ReadQuantizedPoolShardsIndex(shardedPoolDir());
+        UNIT_ASSERT_VALUES_EQUAL(shards.size(), 3);
+        UNIT_ASSERT_VALUES_EQUAL(shards[1].ObjectCount, 3);
+
+        const TPathWithScheme shardedPoolPath(shardedPoolDir(), "sharded-quantized");
+        const auto loadedPool = LoadQuantizedPool(shardedPoolPath, {false, false, TDatasetSubset()});
+        UNIT_ASSERT_VALUES_EQUAL(QuantizedPoolToString(loadedPool), QuantizedPoolToString(pool));
+
+        // only the second shard is mapped
+        const auto rangePool = LoadQuantizedPool(shardedPoolPath, {false, false, TDatasetSubset::MakeRange(4, 7)});
+        UNIT_ASSERT_VALUES_EQUAL(rangePool.DocumentCount, 8);
+        UNIT_ASSERT_VALUES_EQUAL(rangePool.Blobs.size(), 1);
+        for (const auto& chunks : rangePool.Chunks) {
+            for (const auto& chunk : chunks) {
+                UNIT_ASSERT_VALUES_EQUAL(chunk.DocumentOffset, 4);
+                UNIT_ASSERT_VALUES_EQUAL(chunk.DocumentCount, 3);
+            }
+        }
+
+        const auto targetPool = LoadQuantizedPool(shardedPoolPath, {false, false, TDatasetSubset::MakeColumns(false)});
+        for (auto localIdx : xrange(targetPool.ColumnTypes.size())) {
+            const bool isFeature = targetPool.ColumnTypes[localIdx] == EColumn::Num;
+            UNIT_ASSERT_VALUES_EQUAL(targetPool.Chunks[localIdx].empty(), isFeature);
+        }
+    }
+}
@@ -153,7 +153,7 @@ def format_crossvalidation(is_inverted, n, k):
     return '{}:{};{}'.format(cv_type, n, k)
 
 
-def execute_dist_train(cmd):
+def execute_dist_train(cmd, worker_options=((), ())):
     hosts_path = yatest.common.test_output_path('hosts.txt')
     with yatest.common.network.PortManager() as pm:
         port0 = pm.get_port()
@@ -163,16 +163,17 @@ def execute_dist_train(cmd):
             hosts.write('localhost:' + str(port1) + '\n')
 
         catboost_path = yatest.common.binary_path("catboost/app/catboost")
-        worker0 = yatest.common.execute((catboost_path, 'run-worker', '--node-port', str(port0),), wait=False)
-        worker1 = yatest.common.execute((catboost_path, 'run-worker', '--node-port', str(port1),), wait=False)
+        worker0 = yatest.common.execute((catboost_path, 'run-worker', '--node-port', str(port0),) + tuple(worker_options[0]), wait=False)
+        worker1 = yatest.common.execute((catboost_path, 'run-worker', '--node-port', str(port1),) + tuple(worker_options[1]), wait=False)
         while pm.is_port_free(port0) or pm.is_port_free(port1):
             time.sleep(1)
 
-        yatest.common.execute(
+        master = yatest.common.execute(
             cmd + ('--node-type', 'Master', '--file-with-hosts', hosts_path,)
         )
         worker0.wait()
         worker1.wait()
+        return master
 
 
 @pytest.fixture(scope="module")
@@ -7,6 +7,7 @@ import filecmp
 import numpy as np
 import timeit
 import json
+import re
 
 import catboost
 
@@ -1076,6 +1077,43 @@ def test_pairwise_reproducibility(loss_function):
     assert filecmp.cmp(eval_1, eval_4)
 
 
+# NUMA nodes only change which threads score split candidates, so the model must be the same
+@pytest.mark.parametrize('pool', ['higgs', 'adult'])
+def test_numa_feature_parallel(pool):
+
+    def run_catboost(eval_path, learn_error_path, other_options=()):
+        cmd = (
+            CATBOOST_PATH,
+            'fit',
+            '--loss-function', 'Logloss',
+            '-f', data_file(pool, 'train_small'),
+            '-t', data_file(pool, 'test_small'),
+            '--column-description', data_file(pool, 'train.cd'),
+            '-i', '20',
+            '-T', '4',
+            '--random-seed', '0',
+            '--prediction-type', 'RawFormulaVal',
+            '--eval-file', eval_path,
+            '--learn-err-log', learn_error_path,
+        ) + other_options
+        return yatest.common.execute(cmd)
+
+    eval_default = yatest.common.test_output_path('test_default.eval')
+    learn_error_default = yatest.common.test_output_path('learn_error_default.tsv')
+    run_catboost(eval_default, learn_error_default)
+
+    eval_numa = yatest.common.test_output_path('test_numa.eval')
+    learn_error_numa = yatest.common.test_output_path('learn_error_numa.tsv')
+    numa_run = run_catboost(
+        eval_numa,
+        learn_error_numa,
+        ('--dev-numa-mode', 'FeatureParallel', '--dev-numa-fake-node-count', '2', '--logging-level', 'Info'))
+    assert 'NUMA-aware training on 2 nodes' in numa_run.std_out.decode('utf-8')
+
+    assert filecmp.cmp(eval_default, eval_numa)
+    assert filecmp.cmp(learn_error_default, learn_error_numa)
+
+
 @pytest.mark.parametrize('boosting_type', BOOSTING_TYPE)
 @pytest.mark.parametrize(
     'dev_score_calc_obj_block_size',
@@ -5191,6 +5229,216 @@ def test_dist_train_yetirank():
         output_file_switch='--test-err-log'))]
 
 
+@pytest.mark.parametrize('loss_function', ['Logloss', 'MultiClass'])
+@pytest.mark.parametrize('leaf_estimation_backtracking', ['No', 'AnyImprovement'])
+def test_dist_train_fused_round_trips(loss_function, leaf_estimation_backtracking):
+    train_cmd = make_deterministic_train_cmd(
+        loss_function=loss_function,
+        pool='higgs',
+        train='train_small',
+        test='test_small',
+        cd='train.cd',
+        other_options=(
+            '--leaf-estimation-iterations', '3',
+            '--leaf-estimation-backtracking', leaf_estimation_backtracking,
+        ))
+
+    eval_paths = []
+    for fuse_round_trips in ['false', 'true']:
+        eval_paths.append(yatest.common.test_output_path('test_{}.eval'.format(fuse_round_trips)))
+        execute_dist_train(train_cmd + (
+            '--dev-fuse-distributed-round-trips', fuse_round_trips,
+            '--eval-file', eval_paths[-1],
+        ))
+
+    assert(filecmp.cmp(eval_paths[0], eval_paths[1]))
+
+
+@pytest.mark.parametrize('loss_function', ['Logloss', 'RMSE', 'MultiClass'])
+def test_dist_train_feature_parallel(loss_function):
+    run_dist_train(make_deterministic_train_cmd(
+        loss_function=loss_function,
+        pool='higgs',
+        train='train_small',
+        test='test_small',
+        cd='train.cd',
+        other_options=('--dev-distributed-mode', 'FeatureParallel')))
+
+
+# sketches of such a small pool are exact, so borders are the same as selected on master
+def test_dist_train_distributed_quantization():
+    run_dist_train(make_deterministic_train_cmd(
+        loss_function='Logloss',
+        pool='higgs',
+        train='train_small',
+        test='test_small',
+        cd='train.cd',
+        other_options=('--feature-border-type', 'Median', '--dev-distributed-quantization', 'true')))
+
+
+def test_dist_train_distributed_quantization_large_pool():
+    # worker parts exceed quantile sketch level capacity, so sketches are compacted and borders are approximate
+    object_count = 40000
+    prng = np.random.RandomState(seed=0)
+    features = np.column_stack((
+        prng.uniform(-1, 1, size=object_count),
+        prng.normal(0, 10, size=object_count),
+        prng.randint(0, 20, size=object_count),  # fewer values than borders, borders are exact
+        prng.exponential(1, size=object_count)))
+    target = (features[:, 0] + features[:, 1] / 10 > 0).astype(int)
+    train_path = yatest.common.test_output_path('train.tsv')
+    cd_path = yatest.common.test_output_path('train.cd')
+    np.savetxt(train_path, np.column_stack((target, features)), fmt='%.6g', delimiter='\t')
+    np.savetxt(cd_path, [[0, 'Target']], fmt='%s', delimiter='\t')
+
+    cmd = (
+        CATBOOST_PATH,
+        'fit',
+        '--loss-function', 'Logloss',
+        '-f', train_path,
+        '--column-description', cd_path,
+        '-i', '5',
+        '-T', '4',
+        '-x', '32',
+    )
+    borders_0_path = yatest.common.test_output_path('borders_0.tsv')
+    yatest.common.execute(cmd + ('--output-borders-file', borders_0_path))
+    borders_1_path = yatest.common.test_output_path('borders_1.tsv')
+    execute_dist_train(cmd + ('--output-borders-file', borders_1_path, '--dev-distributed-quantization', 'true'))
+
+    borders_0 = np.loadtxt(borders_0_path, delimiter='\t', ndmin=2)
+    borders_1 = np.loadtxt(borders_1_path, delimiter='\t', ndmin=2)
+    for feature_idx in range(features.shape[1]):
+        feature_borders_0 = borders_0[borders_0[:, 0] == feature_idx, 1]
+        feature_borders_1 = borders_1[borders_1[:, 0] == feature_idx, 1]
+        assert len(feature_borders_0) == len(feature_borders_1)
+        values = np.sort(features[:, feature_idx].astype(np.float32))
+        ranks_0 = np.searchsorted(values, feature_borders_0.astype(np.float32), side='right') / float(object_count)
+        ranks_1 = np.searchsorted(values, feature_borders_1.astype(np.float32), side='right') / float(object_count)
+        assert np.max(np.abs(ranks_0 - ranks_1)) < 0.02
+
+
+@pytest.mark.parametrize('loss_function', ['Logloss', 'MultiClass'])
+def test_dist_train_pipelined_scoring(loss_function):
+    run_dist_train(make_deterministic_train_cmd(
+        loss_function=loss_function,
+        pool='higgs',
+        train='train_small',
+        test='test_small',
+        cd='train.cd',
+        other_options=('--dev-distributed-pipeline-group-count', '3')))
+
+
+@pytest.mark.parametrize('loss_function', ['Logloss', 'MultiClass'])
+def test_dist_train_shared_memory(loss_function):
+    cmd = make_deterministic_train_cmd(
+        loss_function=loss_function,
+        pool='higgs',
+        train='train_small',
+        test='test_small',
+        cd='train.cd',
+        other_options=('--dev-distributed-shared-memory', 'true', '--logging-level', 'Info'))
+
+    eval_0_path = yatest.common.test_output_path('test_0.eval')
+    yatest.common.execute(cmd + ('--eval-file', eval_0_path,))
+
+    eval_1_path = yatest.common.test_output_path('test_1.eval')
+    master = execute_dist_train(
+        cmd + ('--eval-file', eval_1_path,),
+        worker_options=(('--shared-memory',), ('--shared-memory',)))
+    shm_message_counts = re.findall(r'Messages sent through shared memory: (\d+)', master.std_out.decode('utf-8'))
+    assert len(shm_message_counts) == 1 and int(shm_message_counts[0]) > 0
+
+    eval_0 = np.loadtxt(eval_0_path, dtype='float', delimiter='\t', skiprows=1)
+    eval_1 = np.loadtxt(eval_1_path, dtype='float', delimiter='\t', skiprows=1)
+    assert(np.allclose(eval_0, eval_1, atol=1e-5))
+
+
+def test_dist_train_rebalancing():
+    cmd = make_deterministic_train_cmd(
+        loss_function='Logloss',
+        pool='higgs',
+        train='train_small',
+        test='test_small',
+        cd='train.cd',
+        other_options=('--dev-distributed-rebalance-period', '3'))
+
+    eval_0_path = yatest.common.test_output_path('test_0.eval')
+    yatest.common.execute(cmd + ('--eval-file', eval_0_path,))
+
+    eval_1_path = yatest.common.test_output_path('test_1.eval')
+    master = execute_dist_train(
+        cmd + ('--eval-file', eval_1_path,),
+        worker_options=(('--dev-slowdown-factor', '5'), ()))
+    assert 'Learn objects redistributed between workers' in master.std_out.decode('utf-8')
+
+    eval_0 = np.loadtxt(eval_0_path, dtype='float', delimiter='\t', skiprows=1)
+    eval_1 = np.loadtxt(eval_1_path, dtype='float', delimiter='\t', skiprows=1)
+    assert(np.allclose(eval_0, eval_1, atol=1e-5))
+
+
+# bootstrap weights depend on the learn objects split, so only the quality is compared
+def test_dist_train_rebalancing_with_bootstrap():
+    cmd = (
+        CATBOOST_PATH,
+        'fit',
+        '--loss-function', 'Logloss',
+        '-f', data_file('higgs', 'train_small'),
+        '-t', data_file('higgs', 'test_small'),
+        '--column-description', data_file('higgs', 'train.cd'),
+        '-i', '30',
+        '-T', '4',
+        '--random-seed', '0',
+    )
+
+    metrics = []
+    for rebalance in [False, True]:
+        learn_error_path = yatest.common.test_output_path('learn_error_{}.tsv'.format(rebalance))
+        train_cmd = cmd + ('--learn-err-log', learn_error_path,)
+        if rebalance:
+            master = execute_dist_train(
+                train_cmd + ('--dev-distributed-rebalance-period', '3'),
+                worker_options=(('--dev-slowdown-factor', '5'), ()))
+            assert 'Learn objects redistributed between workers' in master.std_out.decode('utf-8')
+        else:
+            execute_dist_train(train_cmd)
+        metrics.append(np.loadtxt(learn_error_path, dtype='float', delimiter='\t', skiprows=1)[-1][1])
+
+    assert abs(metrics[0] - metrics[1]) < 0.01
+
+
+def test_dist_train_sharded_quantized():
+    sharded_pool_path = yatest.common.test_output_path('train_sharded')
+    yatest.common.execute((
+        CATBOOST_PATH,
+        'reshard-quantized-pool',
+        '--input-path', 'quantized://' + data_file('querywise', 'train_x128_greedylogsum_aqtaa.bin'),
+        '--output-path', sharded_pool_path,
+        '--shard-count', '2',
+    ))
+    assert os.path.exists(os.path.join(sharded_pool_path, 'shards.tsv'))
+
+    cmd = make_deterministic_train_cmd(
+        loss_function='QueryRMSE',
+        pool='querywise',
+        train='train_x128_greedylogsum_aqtaa.bin',
+        test='test',
+        cd='train.cd.query_id',
+        schema='quantized://',
+        other_options=('-x', '128', '--feature-border-type', 'GreedyLogSum'))
+
+    eval_0_path = yatest.common.test_output_path('test_0.eval')
+    yatest.common.execute(cmd + ('--eval-file', eval_0_path,))
+
+    sharded_cmd = tuple('sharded-quantized://' + sharded_pool_path if arg.startswith('quantized://') else arg for arg in cmd)
+    eval_1_path = yatest.common.test_output_path('test_1.eval')
+    execute_dist_train(sharded_cmd + ('--eval-file', eval_1_path,))
+
+    eval_0 = np.loadtxt(eval_0_path, dtype='float', delimiter='\t', skiprows=1)
+    eval_1 = np.loadtxt(eval_1_path, dtype='float', delimiter='\t', skiprows=1)
+    assert(np.allclose(eval_0, eval_1, atol=1e-5))
+
+
 def test_no_target():
     train_path = yatest.common.test_output_path('train')
     cd_path = yatest.common.test_output_path('train.cd')
@@ -5344,6 +5592,78 @@ def test_eval_metrics_with_target_border():
     )
 
 
+@pytest.mark.parametrize('calc_on_parts', [False, True], ids=['calc_on_parts=False', 'calc_on_parts=True'])
+def test_eval_metrics_staged_auc(calc_on_parts):
+    output_model_path = yatest.common.test_output_path('model.bin')
+    test_error_path = yatest.common.test_output_path('test_error.tsv')
+    result_dir = yatest.common.test_output_path('eval_result')
+    cmd = (
+        CATBOOST_PATH,
+        'fit',
+        '--loss-function', 'Logloss',
+        '--eval-metric', 'AUC',
+        '-f', data_file('adult', 'train_small'),
+        '-t', data_file('adult', 'test_small'),
+        '--column-description', data_file('adult', 'train.cd'),
+        '-i', '10',
+        '-w', '0.03',
+        '-T', '4',
+        '-m', output_model_path,
+        '--test-err-log', test_error_path,
+        '--use-best-model', 'false',
+    )
+    yatest.common.execute(cmd)
+
+    cmd = (
+        CATBOOST_PATH,
+        'eval-metrics',
+        '--metrics', 'AUC,Logloss',
+        '--input-path', data_file('adult', 'test_small'),
+        '--column-description', data_file('adult', 'train.cd'),
+        '-m', output_model_path,
+        '--result-dir', result_dir,
+        '-o', 'output.tsv',
+        '--block-size', '100',
+        '--save-stage-timings',
+    ) + (('--calc-on-parts',) if calc_on_parts else ())
+    yatest.common.execute(cmd)
+
+    first_metrics = np.round(np.loadtxt(test_error_path, skiprows=1)[:, 1], 8)
+    second_metrics = np.round(np.loadtxt(os.path.join(result_dir, 'output.tsv'), skiprows=1)[:, 1], 8)
+    assert np.all(first_metrics == second_metrics)
+
+    timings = np.loadtxt(os.path.join(result_dir, 'stage_timings.tsv'), skiprows=1, ndmin=2)
+    assert np.all(timings[:, 0] == np.arange(10))
+    assert np.all(timings[:, 1:] >= 0)
+
+
+def test_approx_auc():
+    test_error_path = yatest.common.test_output_path('test_error.tsv')
+    cmd = (
+        CATBOOST_PATH,
+        'fit',
+        '--loss-function', 'Logloss',
+        '--eval-metric', 'AUC',
+        '--custom-metric', 'AUC:type=Approx;bins=65536',
+        '-f', data_file('adult', 'train_small'),
+        '-t', data_file('adult', 'test_small'),
+        '--column-description', data_file('adult', 'train.cd'),
+        '-i', '10',
+        '-w', '0.03',
+        '-T', '4',
+        '-m', yatest.common.test_output_path('model.bin'),
+        '--test-err-log', test_error_path,
+    )
+    yatest.common.execute(cmd)
+
+    with open(test_error_path) as f:
+        header = f.readline().rstrip('\n').split('\t')
+    test_error = np.loadtxt(test_error_path, skiprows=1)
+    exact_auc = test_error[:, header.index('AUC')]
+    approx_auc = test_error[:, header.index('AUC:type=Approx;bins=65536')]
+    assert np.allclose(exact_auc, approx_auc, atol=1e-3)
+
+
 def test_eval_metrics_with_class_weights():
     return do_test_eval_metrics(
         metric='Logloss',
@@ -6861,6 +7181,95 @@ def test_shap_approximate():
     return [local_canonical_file(output_values_path)]
 
 
+def test_shap_output_formats():
+    output_model_path = yatest.common.test_output_path('model.bin')
+    cmd_fit = [
+        CATBOOST_PATH,
+        'fit',
+        '--loss-function', 'MultiClass',
+        '-f', data_file('cloudness_small', 'train_small'),
+        '--column-description', data_file('cloudness_small', 'train.cd'),
+        '-i', '20',
+        '-T', '4',
+        '-m', output_model_path,
+    ]
+    yatest.common.execute(cmd_fit)
+
+    def calc_shap_values(output_format, read_block_size):
+        output_values_path = yatest.common.test_output_path('shapval_{}_{}'.format(output_format, read_block_size))
+        cmd_shap = [
+            CATBOOST_PATH,
+            'fstr',
+            '-o', output_values_path,
+            '--input-path', data_file('cloudness_small', 'train_small'),
+            '--column-description', data_file('cloudness_small', 'train.cd'),
+            '--fstr-type', 'ShapValues',
+            '--shap-output-format', output_format,
+            '--shap-top-k', '3',
+            '--shap-read-block-size', str(read_block_size),
+            '-T', '4',
+            '-m', output_model_path,
+        ]
+        yatest.common.execute(cmd_shap)
+        return output_values_path
+
+    tsv = np.loadtxt(calc_shap_values('Tsv', 100000), delimiter='\t', ndmin=2)
+    assert filecmp.cmp(calc_shap_values('Tsv', 100000), calc_shap_values('Tsv', 17))
+
+    float32 = np.fromfile(calc_shap_values('Float32', 17), dtype=np.float32).reshape(tsv.shape)
+    assert np.allclose(float32, tsv, rtol=1e-5, atol=1e-5)
+
+    with open(calc_shap_values('TopKTsv', 17)) as top_k:
+        for line, values in zip(top_k, tsv):
+            pairs = [pair.split(':') for pair in line.rstrip('\n').split('\t')]
+            features = [int(feature) for feature, _ in pairs]
+            assert len(features) == 4 and features[-1] == len(values) - 1
+            assert np.allclose([float(value) for _, value in pairs], values[features], rtol=1e-5, atol=1e-5)
+            assert sorted(np.abs(values[features[:-1]])) == sorted(np.abs(values[:-1]))[-3:]
+
+
+def test_sparse_shap_interaction_values():
+    output_model_path = yatest.common.test_output_path('model.bin')
+    cmd_fit = [
+        CATBOOST_PATH,
+        'fit',
+        '--loss-function', 'Logloss',
+        '-f', data_file('higgs', 'train_small'),
+        '--column-description', data_file('higgs', 'train.cd'),
+        '-i', '20',
+        '-T', '4',
+        '-m', output_model_path,
+    ]
+    yatest.common.execute(cmd_fit)
+
+    def calc_fstr(fstr_type):
+        output_values_path = yatest.common.test_output_path(fstr_type)
+        cmd_fstr = [
+            CATBOOST_PATH,
+            'fstr',
+            '-o', output_values_path,
+            '--input-path', data_file('higgs', 'train_small'),
+            '--column-description', data_file('higgs', 'train.cd'),
+            '--fstr-type', fstr_type,
+            '-T', '4',
+            '-m', output_model_path,
+        ]
+        yatest.common.execute(cmd_fstr)
+        return output_values_path
+
+    shap_values = np.loadtxt(calc_fstr('ShapValues'), delimiter='\t', ndmin=2)
+    interactions = np.loadtxt(calc_fstr('ShapInteractionValues'), delimiter='\t', ndmin=2)
+    assert np.all(interactions[:, 1] <= interactions[:, 2])
+
+    # SHAP value of a feature is the sum of its interaction values
+    interactions_sum = np.zeros((shap_values.shape[0], shap_values.shape[1] - 1))
+    for document_idx, first_feature, second_feature, value in interactions:
+        interactions_sum[int(document_idx), int(first_feature)] += value
+        if first_feature != second_feature:
+            interactions_sum[int(document_idx), int(second_feature)] += value
+    assert np.allclose(interactions_sum, shap_values[:, :-1], rtol=1e-5, atol=1e-5)
+
+
 @pytest.mark.parametrize('bagging_temperature', ['0', '1'])
 @pytest.mark.parametrize('sampling_unit', SAMPLING_UNIT_TYPES)
 @pytest.mark.parametrize(
@@ -1,6 +1,6 @@
-from .core import FeaturesData, EFstrType, Pool, CatBoost, CatBoostClassifier, CatBoostRegressor, CatBoostError, cv, train, sum_models, _have_equal_features, to_regressor, to_classifier, MultiLabelCustomMetric  # noqa
+from .core import FeaturesData, EFstrType, Pool, CatBoost, CatBoostClassifier, CatBoostRegressor, CatBoostError, cv, train, sum_models, _have_equal_features, _calc_cat_feature_hash, to_regressor, to_classifier, MultiLabelCustomMetric  # noqa
 from .version import VERSION as __version__  # noqa
-__all__ = ['FeaturesData', 'EFstrType', 'Pool', 'CatBoost', 'CatBoostClassifier', 'CatBoostRegressor', 'CatBoostError', 'CatboostError', 'cv', 'train', 'sum_models', '_have_equal_features', \
+__all__ = ['FeaturesData', 'EFstrType', 'Pool', 'CatBoost', 'CatBoostClassifier', 'CatBoostRegressor', 'CatBoostError', 'CatboostError', 'cv', 'train', 'sum_models', '_have_equal_features', '_calc_cat_feature_hash', \
            'to_regressor', 'to_classifier', 'MultiLabelCustomMetric']
 
 # API compatibility alias.
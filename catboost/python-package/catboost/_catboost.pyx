@@ -171,6 +171,12 @@ cdef extern from "catboost/python-package/catboost/helpers.h":
     cdef void SetPythonInterruptHandler() nogil
     cdef void ResetPythonInterruptHandler() nogil
     cdef void ThrowCppExceptionWithMessage(const TString&) nogil
+    cdef void MapCategoricalCodesToHashes[TCode](
+        TConstArrayRef[TCode] codes,
+        TConstArrayRef[ui32] categoriesHashes,
+        ui32 flatFeatureIdx,
+        TVector[ui32]* hashes
+    ) nogil except +ProcessException
 
 
 cdef extern from "library/threading/local_executor/local_executor.h" namespace "NPar":
@@ -1411,6 +1417,32 @@ cdef extern from "catboost/python-package/catboost/helpers.h":
         TVector[TVector[double]] ComputeScores() except +ProcessException
         void AddPool(const TDataProvider& srcData) except +ProcessException
 
+    cdef TVector[TVector[double]] ApplyModelOnDenseMatrix(
+        const TFullModel& model,
+        TConstArrayRef[float] floatFeatures,
+        size_t floatFeatureCount,
+        TConstArrayRef[i32] catFeatures,
+        size_t catFeatureCount,
+        size_t objectCount,
+        EPredictionType predictionType,
+        int treeBegin,
+        int treeEnd,
+        int threadCount
+    ) nogil except +ProcessException
+
+    cdef TVector[TVector[double]] ApplyModelOnDenseMatrix(
+        const TFullModel& model,
+        TConstArrayRef[double] floatFeatures,
+        size_t floatFeatureCount,
+        TConstArrayRef[i32] catFeatures,
+        size_t catFeatureCount,
+        size_t objectCount,
+        EPredictionType predictionType,
+        int treeBegin,
+        int treeEnd,
+        int threadCount
+    ) nogil except +ProcessException
+
     cdef TJsonValue GetTrainingOptions(
         const TJsonValue& plainOptions,
         const TDataMetaInfo& trainDataMetaInfo,
@@ -2565,9 +2597,9 @@ cdef object _set_features_order_data_pd_data_frame_sparse_column(
     return new_data_holders
 
 
-cdef _set_features_order_data_pd_data_frame_categorical_column(
+cdef _get_categories_as_hashed_cat_values(
     ui32 flat_feature_idx,
-    object column_values, # pd.Categorical, but Cython requires cimport to provide type here
+    np.ndarray categories_values,
     TString* factor_string,
 
     # array of [dst_value_for_cateory0, dst_value_for_category1 ...]
@@ -2575,20 +2607,12 @@ cdef _set_features_order_data_pd_data_frame_categorical_column(
 
     IRawFeaturesOrderDataVisitor* builder_visitor
 ):
-    cdef np.ndarray categories_values = column_values.categories.values
     cdef ui32 categories_values_size = categories_values.shape[0]
 
-    cdef np.ndarray categories_codes = column_values.codes
-    cdef ui32 doc_count = categories_codes.shape[0]
-
     # access through TArrayRef is faster
     cdef TArrayRef[ui32] categories_as_hashed_cat_values_ref
-    cdef TVector[ui32] hashed_cat_values
 
     cdef ui32 category_idx
-    cdef ui32 doc_idx
-    cdef i32 category_code
-
 
     # TODO(akhropov): make yresize accessible in Cython
     categories_as_hashed_cat_values[0].resize(categories_values_size)
@@ -2608,18 +2632,51 @@ cdef _set_features_order_data_pd_data_frame_categorical_column(
             factor_string[0]
         )
 
-    # TODO(akhropov): make yresize accessible in Cython
-    hashed_cat_values.resize(doc_count)
-    for doc_idx in range(doc_count):
-        category_code = categories_codes[doc_idx]
-        if category_code == -1:
-            raise CatBoostError(
-                'Invalid type for cat_feature[object_idx={},feature_idx={}]=NaN :'
-                ' cat_features must be integer or string, real number values and NaN values'
-                ' should be converted to string.'.format(doc_idx, flat_feature_idx)
-            )
 
-        hashed_cat_values[doc_idx] = categories_as_hashed_cat_values_ref[category_code]
+cdef _add_cat_feature_from_codes(
+    ui32 flat_feature_idx,
+    np.ndarray codes, # integer codes of categories, -1 for missing values
+    const TVector[ui32]& categories_as_hashed_cat_values,
+    IRawFeaturesOrderDataVisitor* builder_visitor
+):
+    cdef TVector[ui32] hashed_cat_values
+    cdef TConstArrayRef[ui32] categories_as_hashed_cat_values_ref = <TConstArrayRef[ui32]>categories_as_hashed_cat_values
+
+    # codes are used in place, they are contiguous already for pandas.Categorical and pandas.factorize results
+    cdef const np.int8_t[::1] codes_i8
+    cdef const np.int16_t[::1] codes_i16
+    cdef const np.int32_t[::1] codes_i32
+    cdef const np.int64_t[::1] codes_i64
+    cdef TConstArrayRef[np.int8_t] codes_i8_ref
+    cdef TConstArrayRef[np.int16_t] codes_i16_ref
+    cdef TConstArrayRef[np.int32_t] codes_i32_ref
+    cdef TConstArrayRef[np.int64_t] codes_i64_ref
+
+    if codes.dtype not in (np.int8, np.int16, np.int32):
+        codes = codes.astype(np.int64, copy=False)
+    codes = np.ascontiguousarray(codes)
+
+    if codes.shape[0] != 0:
+        if codes.dtype == np.int8:
+            codes_i8 = codes
+            codes_i8_ref = TConstArrayRef[np.int8_t](&codes_i8[0], codes_i8.shape[0])
+            with nogil:
+                MapCategoricalCodesToHashes[np.int8_t](codes_i8_ref, categories_as_hashed_cat_values_ref, flat_feature_idx, &hashed_cat_values)
+        elif codes.dtype == np.int16:
+            codes_i16 = codes
+            codes_i16_ref = TConstArrayRef[np.int16_t](&codes_i16[0], codes_i16.shape[0])
+            with nogil:
+                MapCategoricalCodesToHashes[np.int16_t](codes_i16_ref, categories_as_hashed_cat_values_ref, flat_feature_idx, &hashed_cat_values)
+        elif codes.dtype == np.int32:
+            codes_i32 = codes
+            codes_i32_ref = TConstArrayRef[np.int32_t](&codes_i32[0], codes_i32.shape[0])
+            with nogil:
+                MapCategoricalCodesToHashes[np.int32_t](codes_i32_ref, categories_as_hashed_cat_values_ref, flat_feature_idx, &hashed_cat_values)
+        else:
+            codes_i64 = codes
+            codes_i64_ref = TConstArrayRef[np.int64_t](&codes_i64[0], codes_i64.shape[0])
+            with nogil:
+                MapCategoricalCodesToHashes[np.int64_t](codes_i64_ref, categories_as_hashed_cat_values_ref, flat_feature_idx, &hashed_cat_values)
 
     builder_visitor[0].AddCatFeature(
         flat_feature_idx,
@@ -2627,6 +2684,46 @@ cdef _set_features_order_data_pd_data_frame_categorical_column(
     )
 
 
+cdef _set_features_order_data_pd_data_frame_categorical_column(
+    ui32 flat_feature_idx,
+    object column_values, # pd.Categorical, but Cython requires cimport to provide type here
+    TString* factor_string,
+
+    # array of [dst_value_for_cateory0, dst_value_for_category1 ...]
+    TVector[ui32]* categories_as_hashed_cat_values,
+
+    IRawFeaturesOrderDataVisitor* builder_visitor
+):
+    # only categories are converted to strings and hashed, per-object codes are mapped in C++
+    _get_categories_as_hashed_cat_values(
+        flat_feature_idx,
+        column_values.categories.values,
+        factor_string,
+        categories_as_hashed_cat_values,
+        builder_visitor
+    )
+    _add_cat_feature_from_codes(
+        flat_feature_idx,
+        column_values.codes,
+        categories_as_hashed_cat_values[0],
+        builder_visitor
+    )
+
+
+# pandas.factorize is used only for columns with values of a single type, for mixed types it could merge values
+# with different string representations (like 1 and 1.0) that are processed differently in the generic path
+_FACTORIZABLE_CAT_COLUMN_INFERRED_TYPES = frozenset(['string', 'bytes', 'integer'])
+
+cdef bool_t _is_factorizable_cat_column(np.ndarray column_values) except *:
+    return (
+        (column_values.dtype.kind in 'iu')
+        or (
+            (column_values.dtype == object)
+            and (pd.api.types.infer_dtype(column_values, skipna=False) in _FACTORIZABLE_CAT_COLUMN_INFERRED_TYPES)
+        )
+    )
+
+
 # returns new data holders array
 cdef object _set_features_order_data_pd_data_frame(
     data_frame,
@@ -2682,7 +2779,23 @@ cdef object _set_features_order_data_pd_data_frame(
             )
         else:
             column_values = column_data.values
-            if is_cat_feature_mask[flat_feature_idx]:
+            if is_cat_feature_mask[flat_feature_idx] and _is_factorizable_cat_column(column_values):
+                # string representations are computed and hashed once per distinct value
+                codes, uniques = pd.factorize(column_values)
+                _get_categories_as_hashed_cat_values(
+                    flat_feature_idx,
+                    np.asarray(uniques),
+                    &factor_string,
+                    &categories_as_hashed_cat_values,
+                    builder_visitor
+                )
+                _add_cat_feature_from_codes(
+                    flat_feature_idx,
+                    codes,
+                    categories_as_hashed_cat_values,
+                    builder_visitor
+                )
+            elif is_cat_feature_mask[flat_feature_idx]:
                 string_factor_data.clear()
                 for doc_idx in range(doc_count):
                     get_cat_factor_bytes_representation(
@@ -3152,11 +3265,51 @@ cdef _set_data_from_generic_matrix(
                     get_float_feature(doc_idx, feature_idx, factor)
                 )
 
-cdef _set_data(data, const TFeaturesLayout* features_layout, IRawObjectsOrderDataVisitor* builder_visitor):
+@cython.boundscheck(False)
+@cython.wraparound(False)
+def _set_data_np_num(
+    np.ndarray[numpy_num_dtype, ndim=2] num_feature_values,
+    Py_ObjectsOrderBuilderVisitor py_builder_visitor
+):
+
+    """
+        for matrices with float features only, values are cast to float (through double, as in generic path)
+        without per-element Python objects
+
+        older buffer interface is used instead of memory views because of
+        https://github.com/cython/cython/issues/1772, https://github.com/cython/cython/issues/2485
+    """
+
+    cdef IRawObjectsOrderDataVisitor* builder_visitor
+    py_builder_visitor.get_raw_objects_order_data_visitor(&builder_visitor)
+
+    cdef ui32 doc_count = <ui32>(num_feature_values.shape[0])
+    cdef ui32 feature_count = <ui32>(num_feature_values.shape[1])
+
+    # all features are float, so per-type feature indices are the same as flat feature indices
+    cdef TVector[float] doc_features
+    doc_features.resize(feature_count)
+
+    cdef ui32 doc_idx
+    cdef ui32 feature_idx
+    for doc_idx in range(doc_count):
+        for feature_idx in range(feature_count):
+            doc_features[feature_idx] = <float><double>num_feature_values[doc_idx, feature_idx]
+        builder_visitor[0].AddAllFloatFeatures(doc_idx, <TConstArrayRef[float]>doc_features)
+
+cdef _set_data(data, const TFeaturesLayout* features_layout, Py_ObjectsOrderBuilderVisitor py_builder_visitor):
+    cdef IRawObjectsOrderDataVisitor* builder_visitor
+    py_builder_visitor.get_raw_objects_order_data_visitor(&builder_visitor)
+
     if isinstance(data, FeaturesData):
         _set_data_np(data.num_feature_data, data.cat_feature_data, builder_visitor)
     elif isinstance(data, np.ndarray) and data.dtype == np.float32:
         _set_data_np(data, None, builder_visitor)
+    elif (isinstance(data, np.ndarray)
+          and (data.ndim == 2)
+          and (data.dtype in numpy_num_dtype_list)
+          and (features_layout[0].GetFloatFeatureCount() == features_layout[0].GetExternalFeatureCount())):
+        _set_data_np_num(data, py_builder_visitor)
     elif isinstance(data, SPARSE_MATRIX_TYPES):
         _set_objects_order_data_scipy_sparse_matrix(data, features_layout, builder_visitor)
     else:
@@ -3569,7 +3722,7 @@ cdef class _PoolBase:
         )
         builder_visitor[0].StartNextBlock(_get_object_count(data))
 
-        _set_data(data, data_meta_info.FeaturesLayout.Get(), builder_visitor)
+        _set_data(data, data_meta_info.FeaturesLayout.Get(), py_builder_visitor)
 
         if label is not None:
             self._set_label_objects_order(label, py_builder_visitor)
@@ -4341,6 +4494,109 @@ cdef class _CatBoost:
 
         return transform_predictions(pred, predictionType, thread_count, self.__model)
 
+    cpdef _has_only_float_features(self):
+        return (
+            self.__model.ModelTrees.Get().GetCatFeatures().size() == 0
+            and self.__model.ModelTrees.Get().GetTextFeatures().size() == 0
+        )
+
+    cpdef _base_predict_on_dense_matrix(
+        self,
+        np.ndarray float_features,
+        cat_features,
+        str prediction_type,
+        int ntree_start,
+        int ntree_end,
+        int thread_count
+    ):
+        # float_features is a 2-dimensional float32 or float64 array of float features values in the model's
+        # float features order, cat_features is None or a 2-dimensional int32 or uint32 array of hashed
+        # categorical features values in the model's categorical features order
+        cdef TVector[TVector[double]] pred
+        cdef EPredictionType predictionType = string_to_prediction_type(prediction_type)
+
+        # features are used in place if they are C-contiguous already
+        cdef const np.float32_t[:, ::1] float_features_f32
+        cdef const np.float64_t[:, ::1] float_features_f64
+        cdef const np.int32_t[:, ::1] cat_features_i32
+        cdef TConstArrayRef[float] float_features_f32_ref
+        cdef TConstArrayRef[double] float_features_f64_ref
+        cdef TConstArrayRef[i32] cat_features_ref
+
+        cdef size_t object_count
+        cdef size_t float_feature_count
+        cdef size_t cat_feature_count = 0
+
+        if float_features.ndim != 2:
+            raise CatBoostError('float_features must be a 2-dimensional array')
+        object_count = float_features.shape[0]
+        float_feature_count = float_features.shape[1]
+
+        thread_count = UpdateThreadCount(thread_count)
+
+        if cat_features is not None:
+            cat_features = np.asarray(cat_features)
+            if cat_features.dtype == np.uint32:
+                cat_features = cat_features.view(np.int32)
+            if (cat_features.ndim != 2) or (cat_features.dtype != np.int32):
+                raise CatBoostError('cat_features must be a 2-dimensional int32 or uint32 array of hashed values')
+            if cat_features.shape[0] != object_count:
+                raise CatBoostError(
+                    'cat_features object count ({}) is not equal to float_features object count ({})'.format(
+                        cat_features.shape[0],
+                        object_count
+                    )
+                )
+            cat_features_i32 = np.ascontiguousarray(cat_features)
+            cat_feature_count = cat_features_i32.shape[1]
+            if object_count * cat_feature_count != 0:
+                cat_features_ref = TConstArrayRef[i32](&cat_features_i32[0, 0], object_count * cat_feature_count)
+
+        if float_features.dtype == np.float32:
+            float_features_f32 = np.ascontiguousarray(float_features)
+            if object_count * float_feature_count != 0:
+                float_features_f32_ref = TConstArrayRef[float](
+                    &float_features_f32[0, 0],
+                    object_count * float_feature_count
+                )
+            with nogil:
+                pred = ApplyModelOnDenseMatrix(
+                    dereference(self.__model),
+                    float_features_f32_ref,
+                    float_feature_count,
+                    cat_features_ref,
+                    cat_feature_count,
+                    object_count,
+                    predictionType,
+                    ntree_start,
+                    ntree_end,
+                    thread_count
+                )
+        elif float_features.dtype == np.float64:
+            float_features_f64 = np.ascontiguousarray(float_features)
+            if object_count * float_feature_count != 0:
+                float_features_f64_ref = TConstArrayRef[double](
+                    &float_features_f64[0, 0],
+                    object_count * float_feature_count
+                )
+            with nogil:
+                pred = ApplyModelOnDenseMatrix(
+                    dereference(self.__model),
+                    float_features_f64_ref,
+                    float_feature_count,
+                    cat_features_ref,
+                    cat_feature_count,
+                    object_count,
+                    predictionType,
+                    ntree_start,
+                    ntree_end,
+                    thread_count
+                )
+        else:
+            raise CatBoostError('float_features must have float32 or float64 dtype')
+
+        return transform_predictions(pred, predictionType, thread_count, self.__model)
+
     cpdef _staged_predict_iterator(self, _PoolBase pool, str prediction_type, int ntree_start, int ntree_end, int eval_period, int thread_count, verbose):
         thread_count = UpdateThreadCount(thread_count);
         stagedPredictIterator = _StagedPredictIterator(prediction_type, ntree_start, ntree_end, eval_period, thread_count, verbose)
@@ -5386,6 +5642,13 @@ cpdef _library_init():
     LibraryInit()
 
 
+cpdef _calc_cat_feature_hash(value):
+    # the same hash that is used for categorical features values in Pool
+    cdef TString value_string
+    get_id_object_bytes_string_representation(value, &value_string)
+    return CalcCatFeatureHash(<TStringBuf>value_string)
+
+
 cpdef compute_wx_test(baseline, test):
     cdef TVector[double] baselineVec
     cdef TVector[double] testVec
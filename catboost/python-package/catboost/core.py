@@ -82,6 +82,7 @@ _MetadataHashProxy = _catboost._MetadataHashProxy
 _NumpyAwareEncoder = _catboost._NumpyAwareEncoder
 FeaturesData = _catboost.FeaturesData
 _have_equal_features = _catboost._have_equal_features
+_calc_cat_feature_hash = _catboost._calc_cat_feature_hash
 SPARSE_MATRIX_TYPES = _catboost.SPARSE_MATRIX_TYPES
 MultiLabelCustomMetric = _catboost.MultiLabelCustomMetric
 
@@ -1254,6 +1255,9 @@ class _CatBoostBase(object):
     def _base_predict(self, pool, prediction_type, ntree_start, ntree_end, thread_count, verbose):
         return self._object._base_predict(pool, prediction_type, ntree_start, ntree_end, thread_count, verbose)
 
+    def _base_predict_on_dense_matrix(self, float_features, cat_features, prediction_type, ntree_start, ntree_end, thread_count):
+        return self._object._base_predict_on_dense_matrix(float_features, cat_features, prediction_type, ntree_start, ntree_end, thread_count)
+
     def _staged_predict_iterator(self, pool, prediction_type, ntree_start, ntree_end, eval_period, thread_count, verbose):
         return self._object._staged_predict_iterator(pool, prediction_type, ntree_start, ntree_end, eval_period, thread_count, verbose)
 
@@ -1848,10 +1852,35 @@ class CatBoost(_CatBoostBase):
         if prediction_type not in ('Class', 'RawFormulaVal', 'Probability', 'LogProbability', 'Exponent'):
             raise CatBoostError("Invalid value of prediction_type={}: must be Class, RawFormulaVal, Probability, LogProbability, Exponent.".format(prediction_type))
 
+    def _is_dense_float_matrix_predict_applicable(self, data):
+        # float numpy arrays are applied directly, without Pool creation, if their columns are the model's
+        # float features
+        return (
+            isinstance(data, np.ndarray)
+            and data.dtype in (np.float32, np.float64)
+            and data.ndim in (1, 2)
+            and self.is_fitted()
+            and self.tree_count_ is not None
+            and self._object._has_only_float_features()
+        )
+
     def _predict(self, data, prediction_type, ntree_start, ntree_end, thread_count, verbose, parent_method_name):
         verbose = verbose or self.get_param('verbose')
         if verbose is None:
             verbose = False
+        if self._is_dense_float_matrix_predict_applicable(data):
+            self._validate_prediction_type(prediction_type)
+            data_is_single_object = data.ndim == 1
+            predictions = self._base_predict_on_dense_matrix(
+                data.reshape(1, -1) if data_is_single_object else data,
+                None,
+                prediction_type,
+                ntree_start,
+                ntree_end,
+                thread_count
+            )
+            return predictions[0] if data_is_single_object else predictions
+
         data, data_is_single_object = self._process_predict_input_data(data, parent_method_name, thread_count)
         self._validate_prediction_type(prediction_type)
 
@@ -3575,6 +3604,16 @@ class CatBoostClassifier(CatBoost):
         Used only for learning speed tuning.
         Changing this parameter can affect results due to numerical accuracy differences
 
+    dev_split_screening_sample_rate : float, [default=1.0]
+        CPU only. Enables two-stage split search for symmetric trees if < 1:
+        all split candidates are scored on a subsample of this rate,
+        then the best of them are rescored on the whole sample. Should be in (0, 1].
+        Used only for learning speed tuning.
+
+    dev_split_screening_top_count : int, [default=16]
+        CPU only. Number of split candidates rescored on the whole sample in two-stage split search.
+        Should be > 0
+
     dev_efb_max_buckets : int, [default=1024]
         CPU only. Maximum bucket count in exclusive features bundle. Should be in an integer between 0 and 65536.
         Used only for learning speed tuning.
@@ -3796,6 +3835,8 @@ class CatBoostClassifier(CatBoost):
         sampling_unit=None,
         sampling_frequency=None,
         dev_score_calc_obj_block_size=None,
+        dev_split_screening_sample_rate=None,
+        dev_split_screening_top_count=None,
         dev_efb_max_buckets=None,
         sparse_features_conflict_fraction=None,
         max_depth=None,
@@ -4350,6 +4391,8 @@ class CatBoostRegressor(CatBoost):
         sampling_frequency=None,
         sampling_unit=None,
         dev_score_calc_obj_block_size=None,
+        dev_split_screening_sample_rate=None,
+        dev_split_screening_top_count=None,
         dev_efb_max_buckets=None,
         sparse_features_conflict_fraction=None,
         max_depth=None,
@@ -1,12 +1,22 @@
 #include "helpers.h"
 
+#include <catboost/libs/eval_result/eval_helpers.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/interrupt.h>
 #include <catboost/libs/helpers/matrix.h>
 #include <catboost/libs/helpers/query_info_helper.h>
+#include <catboost/libs/model/cpu/quantization.h>
 #include <catboost/private/libs/options/plain_options_helper.h>
 #include <catboost/private/libs/target/data_providers.h>
 
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/cast.h>
+#include <util/generic/utility.h>
+#include <util/generic/xrange.h>
+
+#include <cmath>
+
 
 extern "C" PyObject* PyCatboostExceptionType;
 
@@ -166,6 +176,205 @@ TVector<double> EvalMetricsForUtils(
     return metricResults;
 }
 
+static TConstArrayRef<float> GetFloatValues(TConstArrayRef<float> values, TVector<float>* /*buffer*/) {
+    return values;
+}
+
+static TConstArrayRef<float> GetFloatValues(TConstArrayRef<double> values, TVector<float>* buffer) {
+    buffer->yresize(values.size());
+    for (auto i : xrange(values.size())) {
+        (*buffer)[i] = static_cast<float>(values[i]);
+    }
+    return *buffer;
+}
+
+template <class TFloatValue>
+static void ApplyModelOnDenseMatrixBlock(
+    const TFullModel& model,
+    TConstArrayRef<TFloatValue> floatFeatures,
+    size_t floatFeatureCount,
+    TConstArrayRef<i32> catFeatures,
+    size_t catFeatureCount,
+    size_t objectBegin,
+    size_t objectEnd,
+    int treeBegin,
+    int treeEnd,
+    TArrayRef<double> approxesFlat
+) {
+    const size_t approxDimension = model.GetDimensionsCount();
+    const size_t subBlockSize = NCB::NModelEvaluation::FORMULA_EVALUATION_BLOCK_SIZE * 8;
+
+    TVector<float> floatBuffer;
+    TVector<TConstArrayRef<float>> floatFeaturesRefs;
+    TVector<TConstArrayRef<int>> catFeaturesRefs;
+    for (size_t subBlockBegin = objectBegin; subBlockBegin < objectEnd; subBlockBegin += subBlockSize) {
+        const size_t subBlockEnd = Min(objectEnd, subBlockBegin + subBlockSize);
+
+        floatFeaturesRefs.clear();
+        if (floatFeatureCount) {
+            const auto floatValues = GetFloatValues(
+                floatFeatures.Slice(subBlockBegin * floatFeatureCount, (subBlockEnd - subBlockBegin) * floatFeatureCount),
+                &floatBuffer);
+            for (auto objectIdx : xrange(subBlockEnd - subBlockBegin)) {
+                floatFeaturesRefs.push_back(floatValues.Slice(objectIdx * floatFeatureCount, floatFeatureCount));
+            }
+        }
+        catFeaturesRefs.clear();
+        if (catFeatureCount) {
+            for (auto objectIdx : xrange(subBlockBegin, subBlockEnd)) {
+                catFeaturesRefs.push_back(catFeatures.Slice(objectIdx * catFeatureCount, catFeatureCount));
+            }
+        }
+        model.Calc(
+            floatFeaturesRefs,
+            catFeaturesRefs,
+            treeBegin,
+            treeEnd,
+            approxesFlat.Slice(subBlockBegin * approxDimension, (subBlockEnd - subBlockBegin) * approxDimension));
+    }
+}
+
+template <class TFloatValue>
+static TVector<TVector<double>> ApplyModelOnDenseMatrixImpl(
+    const TFullModel& model,
+    TConstArrayRef<TFloatValue> floatFeatures,
+    size_t floatFeatureCount,
+    TConstArrayRef<i32> catFeatures,
+    size_t catFeatureCount,
+    size_t objectCount,
+    EPredictionType predictionType,
+    int treeBegin,
+    int treeEnd,
+    int threadCount
+) {
+    CB_ENSURE_INTERNAL(floatFeatures.size() == objectCount * floatFeatureCount, "bad float features size");
+    CB_ENSURE_INTERNAL(catFeatures.size() == objectCount * catFeatureCount, "bad cat features size");
+    CB_ENSURE(
+        catFeatureCount || !model.HasCategoricalFeatures(),
+        "Model has categorical features but no categorical features provided");
+
+    const int treeCount = SafeIntegerCast<int>(model.GetTreeCount());
+    if (treeBegin == 0 && treeEnd == 0) {
+        treeEnd = treeCount;
+    }
+    CB_ENSURE(0 <= treeBegin && treeBegin <= treeCount, "Out of range treeBegin=" << treeBegin);
+    CB_ENSURE(0 <= treeEnd && treeEnd <= treeCount, "Out of range treeEnd=" << treeEnd);
+    CB_ENSURE(treeBegin < treeEnd, "Empty tree range [" << treeBegin << ", " << treeEnd << ")");
+
+    const size_t approxDimension = model.GetDimensionsCount();
+    TVector<double> approxesFlat;
+    approxesFlat.yresize(objectCount * approxDimension);
+
+    // the same block sizes as in ApplyModelMulti, small batches are evaluated in the calling thread
+    const size_t minBlockSize = ceil(10000.0 / sqrt(treeEnd - treeBegin + 1));
+    const int blockCount = Max<int>(1, Min<size_t>(threadCount, (objectCount + minBlockSize - 1) / minBlockSize));
+
+    THolder<NPar::TLocalExecutor> executor;
+    if (blockCount == 1) {
+        ApplyModelOnDenseMatrixBlock(
+            model,
+            floatFeatures,
+            floatFeatureCount,
+            catFeatures,
+            catFeatureCount,
+            0,
+            objectCount,
+            treeBegin,
+            treeEnd,
+            approxesFlat);
+    } else {
+        executor = MakeHolder<NPar::TLocalExecutor>();
+        executor->RunAdditionalThreads(blockCount - 1);
+        NPar::TLocalExecutor::TExecRangeParams blockParams(0, SafeIntegerCast<int>(objectCount));
+        blockParams.SetBlockCount(blockCount);
+        executor->ExecRangeWithThrow(
+            [&] (int blockId) {
+                const size_t blockBegin = blockParams.FirstId + blockId * blockParams.GetBlockSize();
+                const size_t blockEnd = Min<size_t>(blockParams.LastId, blockBegin + blockParams.GetBlockSize());
+                ApplyModelOnDenseMatrixBlock(
+                    model,
+                    floatFeatures,
+                    floatFeatureCount,
+                    catFeatures,
+                    catFeatureCount,
+                    blockBegin,
+                    blockEnd,
+                    treeBegin,
+                    treeEnd,
+                    approxesFlat);
+            },
+            0,
+            blockParams.GetBlockCount(),
+            NPar::TLocalExecutor::WAIT_COMPLETE);
+    }
+
+    TVector<TVector<double>> approxes(approxDimension);
+    if (approxDimension == 1) {
+        approxes[0].swap(approxesFlat);
+    } else {
+        for (auto dim : xrange(approxDimension)) {
+            approxes[dim].yresize(objectCount);
+            for (auto objectIdx : xrange(objectCount)) {
+                approxes[dim][objectIdx] = approxesFlat[approxDimension * objectIdx + dim];
+            }
+        }
+    }
+    if (predictionType == EPredictionType::InternalRawFormulaVal) {
+        return approxes;
+    }
+    return PrepareEvalForInternalApprox(predictionType, model, approxes, executor.Get());
+}
+
+TVector<TVector<double>> ApplyModelOnDenseMatrix(
+    const TFullModel& model,
+    TConstArrayRef<float> floatFeatures,
+    size_t floatFeatureCount,
+    TConstArrayRef<i32> catFeatures,
+    size_t catFeatureCount,
+    size_t objectCount,
+    EPredictionType predictionType,
+    int treeBegin,
+    int treeEnd,
+    int threadCount
+) {
+    return ApplyModelOnDenseMatrixImpl(
+        model,
+        floatFeatures,
+        floatFeatureCount,
+        catFeatures,
+        catFeatureCount,
+        objectCount,
+        predictionType,
+        treeBegin,
+        treeEnd,
+        threadCount);
+}
+
+TVector<TVector<double>> ApplyModelOnDenseMatrix(
+    const TFullModel& model,
+    TConstArrayRef<double> floatFeatures,
+    size_t floatFeatureCount,
+    TConstArrayRef<i32> catFeatures,
+    size_t catFeatureCount,
+    size_t objectCount,
+    EPredictionType predictionType,
+    int treeBegin,
+    int treeEnd,
+    int threadCount
+) {
+    return ApplyModelOnDenseMatrixImpl(
+        model,
+        floatFeatures,
+        floatFeatureCount,
+        catFeatures,
+        catFeatureCount,
+        objectCount,
+        predictionType,
+        treeBegin,
+        treeEnd,
+        threadCount);
+}
+
 NJson::TJsonValue GetTrainingOptions(
     const NJson::TJsonValue& plainJsonParams,
     const NCB::TDataMetaInfo& trainDataMetaInfo,
@@ -7,6 +7,7 @@
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/mem_usage.h>
 #include <catboost/libs/metrics/metric.h>
+#include <catboost/libs/model/model.h>
 #include <catboost/private/libs/options/loss_description.h>
 #include <catboost/private/libs/options/plain_options_helper.h>
 #include <catboost/private/libs/target/data_providers.h>
@@ -146,6 +147,37 @@ private:
     TMetricsPlotCalcer MetricPlotCalcer;
 };
 
+/* Applies model to row-major matrices of float features and hashed categorical features
+ * (catFeatures can be empty if model has no categorical features) without creating a data provider.
+ * Result has the same layout as ApplyModelMulti's result.
+ * Does not need Python objects, so it is called without GIL.
+ */
+TVector<TVector<double>> ApplyModelOnDenseMatrix(
+    const TFullModel& model,
+    TConstArrayRef<float> floatFeatures,
+    size_t floatFeatureCount,
+    TConstArrayRef<i32> catFeatures,
+    size_t catFeatureCount,
+    size_t objectCount,
+    EPredictionType predictionType,
+    int treeBegin,
+    int treeEnd,
+    int threadCount
+);
+
+TVector<TVector<double>> ApplyModelOnDenseMatrix(
+    const TFullModel& model,
+    TConstArrayRef<double> floatFeatures,
+    size_t floatFeatureCount,
+    TConstArrayRef<i32> catFeatures,
+    size_t catFeatureCount,
+    size_t objectCount,
+    EPredictionType predictionType,
+    int treeBegin,
+    int treeEnd,
+    int threadCount
+);
+
 NJson::TJsonValue GetTrainingOptions(
     const NJson::TJsonValue& plainJsonParams,
     const NCB::TDataMetaInfo& trainDataMetaInfo,
@@ -157,3 +189,29 @@ NJson::TJsonValue GetPlainJsonWithAllOptions(
     bool hasCatFeatures,
     bool hasTextFeatures
 );
+
+/* Maps codes of pandas.Categorical (or pandas.factorize) to hashed values of their categories.
+ * Does not need Python objects, so it is called without GIL.
+ * Negative codes denote missing values that are not allowed for categorical features.
+ */
+template <class TCode>
+void MapCategoricalCodesToHashes(
+    TConstArrayRef<TCode> codes,
+    TConstArrayRef<ui32> categoriesHashes,
+    ui32 flatFeatureIdx,
+    TVector<ui32>* hashes
+) {
+    hashes->yresize(codes.size());
+    for (size_t objectIdx = 0; objectIdx < codes.size(); ++objectIdx) {
+        const TCode code = codes[objectIdx];
+        CB_ENSURE(
+            code >= 0,
+            "Invalid type for cat_feature[object_idx=" << objectIdx << ",feature_idx=" << flatFeatureIdx << "]=NaN :"
+            " cat_features must be integer or string, real number values and NaN values"
+            " should be converted to string.");
+        CB_ENSURE_INTERNAL(
+            static_cast<size_t>(code) < categoriesHashes.size(),
+            "category code " << static_cast<i64>(code) << " is out of range");
+        (*hashes)[objectIdx] = categoriesHashes[code];
+    }
+}
@@ -24,6 +24,7 @@ from catboost import (
     sum_models,
     train,
     _have_equal_features,
+    _calc_cat_feature_hash,
     to_regressor,
     to_classifier,)
 from catboost.eval.catboost_evaluation import CatboostEvaluation, EvalType
@@ -741,6 +742,36 @@ def test_equivalence_of_pools_from_pandas_dataframe_with_different_cat_features_
         assert _have_equal_features(pool_from_df, pool_from_new_df)
 
 
+def test_equivalence_of_pools_from_pandas_dataframe_columnar_and_generic_paths():
+    n_objects = 1000
+    rng = np.random.RandomState(0)
+    df = DataFrame()
+    df['num_feat_0'] = rng.randint(0, 10, size=n_objects)
+    df['num_feat_1'] = rng.random_sample(n_objects)
+    df['cat_feat_2'] = rng.choice(['a', 'b', 'c'], size=n_objects).astype(object)  # factorized strings
+    df['cat_feat_3'] = rng.randint(-5, 5, size=n_objects)  # factorized integers
+    df['cat_feat_4'] = Categorical(['v%i' % i for i in rng.randint(0, 300, size=n_objects)])  # int16 codes
+    df['cat_feat_5'] = [['x', 1][i % 2] for i in range(n_objects)]  # mixed types, generic path
+
+    labels = rng.randint(0, 2, size=n_objects)
+    cat_features = ['cat_feat_%i' % i for i in range(2, 6)]
+
+    pool_from_df = Pool(df, labels, cat_features=cat_features)
+    pool_from_list = Pool(
+        df.astype(object).values.tolist(),
+        labels,
+        cat_features=list(range(2, 6)),
+        feature_names=list(df.columns)
+    )
+    assert _have_equal_features(pool_from_df, pool_from_list)
+
+    with pytest.raises(CatBoostError):
+        Pool(DataFrame({'cat_feat': Categorical(['a', None, 'b'])}), [0, 1, 0], cat_features=[0])
+
+    num_data = rng.randint(-1000, 1000, size=(n_objects, 4))  # C-contiguous int64, typed objects order path
+    assert _have_equal_features(Pool(num_data, labels), Pool(num_data.tolist(), labels))
+
+
 def test_pool_with_external_feature_names():
     for cd_has_feature_names in [False, True]:
         if cd_has_feature_names:
@@ -1108,6 +1139,81 @@ def test_predict_and_predict_proba_on_single_object(problem):
             assert np.array_equal(pred_probabilities[test_object_idx], model.predict_proba(test_data.values[test_object_idx]))
 
 
+@pytest.mark.parametrize('problem', ['MultiClass', 'RMSE'])
+def test_predict_on_float_numpy_array_equals_to_predict_on_pool(problem):
+    rng = np.random.RandomState(0)
+    features = rng.rand(300, 5)
+    if problem == 'MultiClass':
+        model = CatBoostClassifier(iterations=20, loss_function='MultiClass', thread_count=4)
+        target = ((features[:, 0] + features[:, 1]) * 2).astype(int)
+        prediction_types = ['RawFormulaVal', 'Class', 'Probability', 'LogProbability']
+    else:
+        model = CatBoostRegressor(iterations=20, thread_count=4)
+        target = features[:, 0] + features[:, 1] * features[:, 2]
+        prediction_types = ['RawFormulaVal', 'Exponent']
+    model.fit(features, target)
+
+    for prediction_type in prediction_types:
+        for ntree_start, ntree_end in [(0, 0), (5, 15)]:
+            expected = model.predict(
+                Pool(features),
+                prediction_type=prediction_type,
+                ntree_start=ntree_start,
+                ntree_end=ntree_end
+            )
+            for data in [features, features.astype(np.float32), np.asfortranarray(features)]:
+                assert np.array_equal(
+                    expected,
+                    model.predict(data, prediction_type=prediction_type, ntree_start=ntree_start, ntree_end=ntree_end)
+                )
+            assert np.array_equal(
+                expected[7],
+                model.predict(features[7], prediction_type=prediction_type, ntree_start=ntree_start, ntree_end=ntree_end)
+            )
+
+    with pytest.raises(CatBoostError):
+        model.predict(features[:, :1])
+
+
+def test_predict_on_dense_matrix_with_hashed_cat_features():
+    rng = np.random.RandomState(0)
+    object_count = 300
+    float_features = rng.rand(object_count, 2)
+    cat_values = np.array([
+        rng.choice(['a', 'b'], size=object_count),  # one-hot encoded
+        rng.choice(['x{}'.format(i) for i in range(10)], size=object_count),  # ctrs
+    ]).T
+    data = DataFrame({'f0': float_features[:, 0], 'c0': cat_values[:, 0], 'f1': float_features[:, 1], 'c1': cat_values[:, 1]})
+    target = float_features[:, 0] + (cat_values[:, 0] == 'a') + (cat_values[:, 1] < 'x5')
+    pool = Pool(data, target, cat_features=['c0', 'c1'])
+
+    model = CatBoostRegressor(iterations=20, one_hot_max_size=2, thread_count=4)
+    model.fit(pool)
+
+    cat_hashes = np.array(
+        [[_calc_cat_feature_hash(value) for value in row] for row in cat_values],
+        dtype=np.uint32
+    )
+    for prediction_type in ['RawFormulaVal', 'Exponent']:
+        expected = model.predict(pool, prediction_type=prediction_type)
+        for features, hashes in [
+            (float_features, cat_hashes),
+            (float_features.astype(np.float32), cat_hashes.view(np.int32)),
+            (np.asfortranarray(float_features), np.asfortranarray(cat_hashes)),
+        ]:
+            assert np.array_equal(
+                expected,
+                model._base_predict_on_dense_matrix(features, hashes, prediction_type, 0, 0, -1)
+            )
+
+    with pytest.raises(CatBoostError):
+        model._base_predict_on_dense_matrix(float_features, cat_hashes[:-1], 'RawFormulaVal', 0, 0, -1)
+    with pytest.raises(CatBoostError):
+        model._base_predict_on_dense_matrix(float_features, cat_hashes[:, 0], 'RawFormulaVal', 0, 0, -1)
+    with pytest.raises(CatBoostError):
+        model._base_predict_on_dense_matrix(float_features, cat_hashes.astype(np.int64), 'RawFormulaVal', 0, 0, -1)
+
+
 def test_model_pickling(task_type):
     train_pool = Pool(TRAIN_FILE, column_description=CD_FILE)
     test_pool = Pool(TEST_FILE, column_description=CD_FILE)
@@ -3,6 +3,7 @@
 #include "compression.h"
 #include "par_log.h"
 #include "par_settings.h"
+#include "par_shm.h"
 #include "par_locked_hash.h"
 
 #include <library/cpp/digest/crc32c/crc32c.h>
@@ -481,6 +482,18 @@ namespace NPar {
         switch (settings.RequesterType) {
             case TParNetworkSettings::ERequesterType::NEH:
                 DEBUG_LOG << "Creating NEH requester" << Endl;
+                if (settings.UseSharedMemoryForLocalHosts) {
+                    auto nehRequester = MakeIntrusive<TNehRequester>(
+                        listenPort,
+                        processQueryCancelCallback,
+                        processQueryCallback,
+                        processReplyCallback);
+                    return CreateSharedMemoryRequester(
+                        std::move(nehRequester),
+                        std::move(processQueryCancelCallback),
+                        std::move(processQueryCallback),
+                        std::move(processReplyCallback));
+                }
                 return MakeIntrusive<TNehRequester>(
                     listenPort,
                     std::move(processQueryCancelCallback),
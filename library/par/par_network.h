@@ -42,6 +42,14 @@ namespace NPar {
             return CachedNehAddr;
         }
 
+        const TString& GetAddress() const {
+            return Address;
+        }
+
+        TPortNum GetPort() const {
+            return Port;
+        }
+
         const NNetliba_v12::TUdpAddress& GetNetlibaAddr() const {
             with_lock (NetlibaAddrLock) {
                 if (NetlibaAddr.Empty()) {
@@ -500,7 +500,8 @@ namespace NPar {
                         queryFullTime += (TInstant::Now() - queryInfoPtr->QueryCreationTime).SecondsFloat();
                         queryInfoPtr->Proc->GotResponse(queryInfoPtr->Id, &netEvent.Response->Data);
                     } else {
-                        Y_FAIL();
+                        Singleton<TParLogger>()->OutputLogTailToCout();
+                        Y_FAIL("query %s failed", GetGuidAsString(netEvent.Response->ReqId).c_str());
                     }
                 }
             }
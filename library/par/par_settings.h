@@ -11,6 +11,10 @@ namespace NPar {
                 DEBUG_LOG << "USE_NEH environment variable detected" << Endl;
                 RequesterType = ERequesterType::NEH;
             }
+            if (GetEnv("PAR_USE_SHARED_MEMORY") == "1") {
+                DEBUG_LOG << "PAR_USE_SHARED_MEMORY environment variable detected" << Endl;
+                UseSharedMemoryForLocalHosts = true;
+            }
         }
 
         enum class ERequesterType {
@@ -20,6 +24,8 @@ namespace NPar {
         };
 
         ERequesterType RequesterType = ERequesterType::AutoDetect;
+        // NEH requester passes messages to processes on the same host through shared memory, see par_shm.h
+        bool UseSharedMemoryForLocalHosts = false;
         static TParNetworkSettings& GetRef() {
             return *Singleton<TParNetworkSettings>();
         }
@@ -0,0 +1,516 @@
+#include "par_shm.h"
+#include "par_locked_hash.h"
+#include "par_log.h"
+
+#include <library/threading/atomic/bool.h>
+
+#include <util/generic/hash.h>
+#include <util/generic/yexception.h>
+#include <util/string/builder.h>
+#include <util/system/error.h>
+#include <util/system/getpid.h>
+#include <util/system/guard.h>
+#include <util/system/hostname.h>
+#include <util/system/mutex.h>
+#include <util/system/spin_wait.h>
+#include <util/thread/factory.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#if defined(_linux_)
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace NPar {
+    static std::atomic<ui64> SharedMemoryMessageCount = 0;
+
+    ui64 GetSharedMemoryMessageCount() {
+        return SharedMemoryMessageCount.load();
+    }
+
+#if defined(_linux_)
+    namespace {
+        constexpr ui32 MailboxMagic = 0x50524d42;
+        constexpr ui64 MailboxSlotCount = SharedMemoryMailboxCapacity;
+        constexpr TDuration PeerCheckPeriod = TDuration::Seconds(1);
+
+        enum class EShmMessageKind : ui32 {
+            Query,
+            Reply,
+            Cancel,
+            Failure // the query could not be read by the peer
+        };
+
+        // start of a message segment, url and data follow
+        struct TShmMessageHeader {
+            ui64 UrlSize;
+            ui64 DataSize;
+        };
+
+        // only queries and replies have message segments
+        struct TShmMailboxSlot {
+            EShmMessageKind Kind;
+            ui32 SenderPort;
+            ui64 MessageId;
+            TGUID ReqId;
+        };
+
+        /* Bounded queue of messages to the owner of the mailbox, lives in shared memory.
+         * Producers push under the spin lock, the only consumer pops without it.
+         * The lock word is the pid of the producer holding it, so the lock of a dead producer can be taken over.
+         */
+        struct TShmMailbox {
+            std::atomic<ui32> Magic; // reset by the owner when it stops receiving
+            std::atomic<ui32> OwnerPid;
+            std::atomic<ui32> ProducerLock;
+            std::atomic<int> Sequence; // futex word, incremented after each push
+            std::atomic<ui64> Head;
+            std::atomic<ui64> Tail;
+            TShmMailboxSlot Slots[MailboxSlotCount];
+        };
+
+        static_assert(std::atomic<ui32>::is_always_lock_free, "shared memory atomics must be lock free");
+        static_assert(std::atomic<int>::is_always_lock_free, "shared memory atomics must be lock free");
+        static_assert(std::atomic<ui64>::is_always_lock_free, "shared memory atomics must be lock free");
+        static_assert(sizeof(std::atomic<int>) == sizeof(int), "futex word must be an int");
+
+        static inline int SysFutex(int* uaddr, int op, int val, const struct timespec* timeout) {
+            return syscall(SYS_futex, uaddr, op, val, timeout, nullptr, 0);
+        }
+
+        // processes do not share the address space, so non-private futex operations are used
+        static inline void FutexWake(std::atomic<int>* addr) {
+            SysFutex(reinterpret_cast<int*>(addr), FUTEX_WAKE, 1, nullptr);
+        }
+
+        static inline void FutexWait(std::atomic<int>* addr, int val, TDuration timeout) {
+            struct timespec ts;
+            ts.tv_sec = timeout.Seconds();
+            ts.tv_nsec = timeout.NanoSecondsOfSecond();
+            SysFutex(reinterpret_cast<int*>(addr), FUTEX_WAIT, val, &ts);
+        }
+
+        static TString GetMailboxName(ui32 port) {
+            return TStringBuilder() << "/par_mailbox_" << port;
+        }
+
+        static TString GetMessageName(ui32 senderPort, ui64 messageId) {
+            return TStringBuilder() << "/par_message_" << senderPort << "_" << messageId;
+        }
+
+        static bool IsProcessAlive(ui32 pid) {
+            return kill(pid, 0) == 0 || errno == EPERM;
+        }
+
+        static bool IsMailboxAlive(const TShmMailbox& mailbox) {
+            return mailbox.Magic.load(std::memory_order_acquire) == MailboxMagic
+                && IsProcessAlive(mailbox.OwnerPid.load(std::memory_order_relaxed));
+        }
+
+        static bool IsLocalHost(const TString& address) {
+            return address == "localhost" || address == "127.0.0.1" || address == "::1"
+                || address == HostName() || address == FQDNHostName();
+        }
+
+        class TMappedSegment: public TNonCopyable {
+        public:
+            TMappedSegment(void* data, size_t size)
+                : Data(data)
+                , Size(size)
+            {
+            }
+
+            ~TMappedSegment() {
+                munmap(Data, Size);
+            }
+
+            void* GetData() const {
+                return Data;
+            }
+
+        private:
+            void* Data;
+            size_t Size;
+        };
+
+        // nullptr if there is no such segment
+        static THolder<TMappedSegment> OpenSegment(const TString& name, int flags, int prot, size_t size = 0) {
+            const int fd = shm_open(name.c_str(), flags, 0600);
+            if (fd < 0) {
+                Y_ENSURE(errno == ENOENT, "shm_open " << name << " failed: " << LastSystemErrorText());
+                return nullptr;
+            }
+            if (flags & O_CREAT) {
+                Y_ENSURE(ftruncate(fd, size) == 0, "ftruncate " << name << " failed: " << LastSystemErrorText());
+            } else {
+                struct stat st;
+                Y_ENSURE(fstat(fd, &st) == 0, "fstat " << name << " failed: " << LastSystemErrorText());
+                size = st.st_size;
+            }
+            void* data = size ? mmap(nullptr, size, prot, MAP_SHARED, fd, 0) : nullptr;
+            close(fd);
+            Y_ENSURE(!size || data != MAP_FAILED, "mmap " << name << " failed: " << LastSystemErrorText());
+            return MakeHolder<TMappedSegment>(data, size);
+        }
+    }
+
+    class TSharedMemoryRequester: public IRequester {
+    public:
+        TSharedMemoryRequester(
+            TIntrusivePtr<IRequester> fallbackRequester,
+            TProcessQueryCancelCallback queryCancelCallback,
+            TProcessQueryCallback queryCallback,
+            TProcessReplyCallback replyCallback,
+            TDuration sendTimeout)
+            : FallbackRequester(std::move(fallbackRequester))
+            , QueryCancelCallback(std::move(queryCancelCallback))
+            , QueryCallback(std::move(queryCallback))
+            , ReplyCallback(std::move(replyCallback))
+            , ListenPort(FallbackRequester->GetListenPort())
+            , Pid(GetPID())
+            , SendTimeout(sendTimeout)
+        {
+            const TString mailboxName = GetMailboxName(ListenPort);
+            shm_unlink(mailboxName.c_str()); // left by a crashed process
+            MailboxSegment = OpenSegment(mailboxName, O_CREAT | O_EXCL | O_RDWR, PROT_READ | PROT_WRITE, sizeof(TShmMailbox));
+            Y_ENSURE(MailboxSegment, "Can't create shared memory mailbox " << mailboxName);
+            Mailbox = new (MailboxSegment->GetData()) TShmMailbox();
+            Mailbox->OwnerPid.store(Pid, std::memory_order_relaxed);
+            Mailbox->Magic.store(MailboxMagic, std::memory_order_release);
+            PAR_DEBUG_LOG << "Receiving local requests at shared memory mailbox " << mailboxName << Endl;
+
+            ReceiverThread = SystemThreadFactory()->Run([this]() {
+                ReceiveLoopFunction();
+            });
+        }
+
+        ~TSharedMemoryRequester() override {
+            Mailbox->Magic.store(0, std::memory_order_release);
+            Running = false;
+            FutexWake(&Mailbox->Sequence);
+            ReceiverThread->Join();
+            shm_unlink(GetMailboxName(ListenPort).c_str());
+        }
+
+        TAutoPtr<TNetworkResponse> Request(const TNetworkAddress& address, const TString& url, TVector<char>* data) override {
+            return FallbackRequester->Request(address, url, data);
+        }
+
+        void SendRequest(const TGUID& reqId, const TNetworkAddress& address, const TString& url, TVector<char>* data) override {
+            TShmMailbox* peerMailbox = GetPeerMailbox(address);
+            if (!peerMailbox) {
+                FallbackRequester->SendRequest(reqId, address, url, data);
+                return;
+            }
+            RequestsInfo.EmplaceValue(reqId, address.GetPort());
+            PAR_DEBUG_LOG << "From " << ListenPort << " sending request " << GetGuidAsString(reqId) << " to local port " << address.GetPort()
+                          << " service " << url << " data len: " << (data ? data->size() : 0) << Endl;
+            if (!SendMessage(address.GetPort(), peerMailbox, EShmMessageKind::Query, reqId, url, data)
+                && RequestsInfo.EraseValueIfPresent(reqId))
+            {
+                ReplyFailed(reqId);
+            }
+        }
+
+        void CancelRequest(const TGUID& reqId) override {
+            ui32 port = 0;
+            if (!RequestsInfo.ExtractValueIfPresent(reqId, port)) {
+                FallbackRequester->CancelRequest(reqId);
+                return;
+            }
+            if (TShmMailbox* peerMailbox = GetPeerMailbox(port)) {
+                SendMessage(port, peerMailbox, EShmMessageKind::Cancel, reqId, TString(), nullptr); // a gone peer needs no cancel
+            }
+            TAutoPtr<TNetworkResponse> response = new TNetworkResponse();
+            response->Status = TNetworkResponse::EStatus::Canceled;
+            response->ReqId = reqId;
+            ReplyCallback(response);
+        }
+
+        void SendResponse(const TGUID& reqId, TVector<char>* data) override {
+            ui32 port = 0;
+            if (!IncomingRequestsInfo.ExtractValueIfPresent(reqId, port)) {
+                FallbackRequester->SendResponse(reqId, data);
+                return;
+            }
+            TShmMailbox* peerMailbox = GetPeerMailbox(port);
+            if (!peerMailbox) {
+                WARNING_LOG << "Reply " << GetGuidAsString(reqId) << " is dropped, local requester on port " << port << " is gone" << Endl;
+                return;
+            }
+            PAR_DEBUG_LOG << "From " << ListenPort << " sending reply for " << GetGuidAsString(reqId) << " data len: " << (data ? data->size() : 0) << Endl;
+            SendMessage(port, peerMailbox, EShmMessageKind::Reply, reqId, TString(), data);
+        }
+
+        int GetListenPort() const override {
+            return ListenPort;
+        }
+
+    private:
+        TShmMailbox* GetPeerMailbox(const TNetworkAddress& address) {
+            return IsLocalHost(address.GetAddress()) ? GetPeerMailbox(address.GetPort()) : nullptr;
+        }
+
+        /* Peers without a mailbox are not cached, they may use another requester or not have started yet.
+         * Mailboxes of gone peers are not unmapped, other threads may still use them, a restarted peer gets a new mapping.
+         */
+        TShmMailbox* GetPeerMailbox(ui32 port) {
+            with_lock (PeerMailboxesLock) {
+                auto it = PeerMailboxes.find(port);
+                if (it != PeerMailboxes.end()) {
+                    auto* mailbox = static_cast<TShmMailbox*>(it->second->GetData());
+                    if (IsMailboxAlive(*mailbox)) {
+                        return mailbox;
+                    }
+                    RetiredMailboxSegments.push_back(std::move(it->second));
+                    PeerMailboxes.erase(it);
+                }
+                auto segment = OpenSegment(GetMailboxName(port), O_RDWR, PROT_READ | PROT_WRITE);
+                if (!segment) {
+                    return nullptr;
+                }
+                auto* mailbox = static_cast<TShmMailbox*>(segment->GetData());
+                if (!IsMailboxAlive(*mailbox)) {
+                    return nullptr;
+                }
+                PeerMailboxes.emplace(port, std::move(segment));
+                return mailbox;
+            }
+        }
+
+        bool TryPush(TShmMailbox* peerMailbox, const TShmMailboxSlot& slot) {
+            ui32 lockOwner = 0;
+            if (!peerMailbox->ProducerLock.compare_exchange_strong(lockOwner, Pid, std::memory_order_acquire)) {
+                if (IsProcessAlive(lockOwner)
+                    || !peerMailbox->ProducerLock.compare_exchange_strong(lockOwner, Pid, std::memory_order_acquire))
+                {
+                    return false;
+                }
+                PAR_DEBUG_LOG << "At " << ListenPort << " took over mailbox lock of dead process " << lockOwner << Endl;
+            }
+            const ui64 tail = peerMailbox->Tail.load(std::memory_order_relaxed);
+            const bool hasSpace = tail - peerMailbox->Head.load(std::memory_order_acquire) < MailboxSlotCount;
+            if (hasSpace) {
+                peerMailbox->Slots[tail % MailboxSlotCount] = slot;
+                peerMailbox->Tail.store(tail + 1, std::memory_order_release);
+            }
+            peerMailbox->ProducerLock.store(0, std::memory_order_release);
+            return hasSpace;
+        }
+
+        /* Returns false if the peer is gone or its mailbox stays locked or full for SendTimeout,
+         * the message is dropped then.
+         */
+        bool SendMessage(ui32 peerPort, TShmMailbox* peerMailbox, EShmMessageKind kind, const TGUID& reqId, const TString& url, TVector<char>* data) {
+            const bool hasSegment = (kind == EShmMessageKind::Query) || (kind == EShmMessageKind::Reply);
+            const ui64 messageId = hasSegment ? MessageCounter.fetch_add(1) : 0;
+            const TString messageName = GetMessageName(ListenPort, messageId);
+            if (hasSegment) {
+                const size_t dataSize = data ? data->size() : 0;
+                const size_t messageSize = sizeof(TShmMessageHeader) + url.size() + dataSize;
+                shm_unlink(messageName.c_str()); // left by a crashed process
+                auto segment = OpenSegment(messageName, O_CREAT | O_EXCL | O_RDWR, PROT_READ | PROT_WRITE, messageSize);
+                Y_ENSURE(segment, "Can't create shared memory message " << messageName);
+                char* dst = static_cast<char*>(segment->GetData());
+                const TShmMessageHeader header{url.size(), dataSize};
+                memcpy(dst, &header, sizeof(header));
+                memcpy(dst + sizeof(header), url.data(), url.size());
+                if (dataSize) {
+                    memcpy(dst + sizeof(header) + url.size(), data->data(), dataSize);
+                }
+            }
+            if (data) {
+                TVector<char>().swap(*data);
+            }
+
+            const TShmMailboxSlot slot{kind, ListenPort, messageId, reqId};
+            const TInstant deadline = SendTimeout.ToDeadLine();
+            TSpinWait spinWait;
+            while (!TryPush(peerMailbox, slot)) {
+                const bool isPeerAlive = IsMailboxAlive(*peerMailbox);
+                if (!isPeerAlive || Now() > deadline) {
+                    WARNING_LOG << "From " << ListenPort << " message " << GetGuidAsString(reqId) << " to local port " << peerPort
+                                << " is dropped: " << (isPeerAlive ? "mailbox is full" : "peer is gone") << Endl;
+                    if (hasSegment) {
+                        shm_unlink(messageName.c_str());
+                    }
+                    return false;
+                }
+                spinWait.Sleep(); // locked or full
+            }
+            SharedMemoryMessageCount.fetch_add(1);
+            peerMailbox->Sequence.fetch_add(1, std::memory_order_release);
+            FutexWake(&peerMailbox->Sequence);
+            return true;
+        }
+
+        void ReplyFailed(const TGUID& reqId) {
+            TAutoPtr<TNetworkResponse> response = new TNetworkResponse;
+            response->ReqId = reqId;
+            response->Status = TNetworkResponse::EStatus::Failed;
+            ReplyCallback(response);
+        }
+
+        // requests to gone peers get failed responses, as the network requester fails requests to hosts that do not answer pings
+        void FailRequestsToGonePeers() {
+            THashMap<ui32, TVector<TGUID>> requestsByPort;
+            RequestsInfo.LockedIterateValues([&requestsByPort](const TGUID& reqId, ui32& port) {
+                requestsByPort[port].push_back(reqId);
+            });
+            for (const auto& [port, reqIds] : requestsByPort) {
+                if (GetPeerMailbox(port)) {
+                    continue;
+                }
+                WARNING_LOG << "At " << ListenPort << " local requester on port " << port << " is gone, "
+                            << reqIds.size() << " requests to it failed" << Endl;
+                for (const auto& reqId : reqIds) {
+                    if (RequestsInfo.EraseValueIfPresent(reqId)) {
+                        ReplyFailed(reqId);
+                    }
+                }
+            }
+        }
+
+        void ReceiveLoopFunction() {
+            TInstant nextPeerCheck = PeerCheckPeriod.ToDeadLine();
+            while (Running) {
+                const int sequence = Mailbox->Sequence.load(std::memory_order_acquire);
+                const ui64 head = Mailbox->Head.load(std::memory_order_relaxed);
+                if (head == Mailbox->Tail.load(std::memory_order_acquire)) {
+                    if (Now() > nextPeerCheck) {
+                        FailRequestsToGonePeers();
+                        nextPeerCheck = PeerCheckPeriod.ToDeadLine();
+                    }
+                    FutexWait(&Mailbox->Sequence, sequence, TDuration::MilliSeconds(100));
+                    continue;
+                }
+                const TShmMailboxSlot slot = Mailbox->Slots[head % MailboxSlotCount];
+                Mailbox->Head.store(head + 1, std::memory_order_release);
+                ProcessMessage(slot);
+            }
+        }
+
+        // false if the segment is lost, e.g. removed by a restarted sender
+        bool ReadMessage(const TShmMailboxSlot& slot, TString* url, TVector<char>* data) {
+            const TString messageName = GetMessageName(slot.SenderPort, slot.MessageId);
+            auto segment = OpenSegment(messageName, O_RDONLY, PROT_READ);
+            if (!segment) {
+                WARNING_LOG << "At " << ListenPort << " shared memory message " << messageName
+                            << " for " << GetGuidAsString(slot.ReqId) << " is lost" << Endl;
+                return false;
+            }
+            shm_unlink(messageName.c_str());
+
+            const char* src = static_cast<const char*>(segment->GetData());
+            TShmMessageHeader header;
+            memcpy(&header, src, sizeof(header));
+            url->assign(src + sizeof(header), header.UrlSize);
+            const char* dataBegin = src + sizeof(header) + header.UrlSize;
+            data->assign(dataBegin, dataBegin + header.DataSize);
+            return true;
+        }
+
+        void ProcessMessage(const TShmMailboxSlot& slot) {
+            TString url;
+            TVector<char> data;
+            switch (slot.Kind) {
+                case EShmMessageKind::Query: {
+                    if (!ReadMessage(slot, &url, &data)) {
+                        if (TShmMailbox* peerMailbox = GetPeerMailbox(slot.SenderPort)) {
+                            SendMessage(slot.SenderPort, peerMailbox, EShmMessageKind::Failure, slot.ReqId, TString(), nullptr);
+                        }
+                        return;
+                    }
+                    PAR_DEBUG_LOG << "At " << ListenPort << " got local request " << GetGuidAsString(slot.ReqId) << " service: " << url << " data len: " << data.size() << Endl;
+                    TAutoPtr<TNetworkRequest> request = new TNetworkRequest;
+                    request->ReqId = slot.ReqId;
+                    request->Url = url;
+                    request->Data = std::move(data);
+                    IncomingRequestsInfo.EmplaceValue(slot.ReqId, slot.SenderPort);
+                    QueryCallback(request);
+                    break;
+                }
+                case EShmMessageKind::Reply: {
+                    const bool isRead = ReadMessage(slot, &url, &data);
+                    if (!RequestsInfo.EraseValueIfPresent(slot.ReqId)) {
+                        return;
+                    }
+                    if (!isRead) {
+                        ReplyFailed(slot.ReqId);
+                        return;
+                    }
+                    TAutoPtr<TNetworkResponse> response = new TNetworkResponse;
+                    response->ReqId = slot.ReqId;
+                    response->Data = std::move(data);
+                    response->Status = TNetworkResponse::EStatus::Ok;
+                    ReplyCallback(response);
+                    break;
+                }
+                case EShmMessageKind::Cancel:
+                    if (!IncomingRequestsInfo.EraseValueIfPresent(slot.ReqId)) {
+                        return;
+                    }
+                    QueryCancelCallback(slot.ReqId);
+                    break;
+                case EShmMessageKind::Failure:
+                    if (RequestsInfo.EraseValueIfPresent(slot.ReqId)) {
+                        ReplyFailed(slot.ReqId);
+                    }
+                    break;
+            }
+        }
+
+    private:
+        TIntrusivePtr<IRequester> FallbackRequester;
+        TProcessQueryCancelCallback QueryCancelCallback;
+        TProcessQueryCallback QueryCallback;
+        TProcessReplyCallback ReplyCallback;
+        const ui32 ListenPort;
+        const ui32 Pid;
+        const TDuration SendTimeout;
+
+        THolder<TMappedSegment> MailboxSegment;
+        TShmMailbox* Mailbox = nullptr;
+        std::atomic<ui64> MessageCounter = 0;
+
+        TMutex PeerMailboxesLock;
+        THashMap<ui32, THolder<TMappedSegment>> PeerMailboxes;
+        TVector<THolder<TMappedSegment>> RetiredMailboxSegments;
+
+        TSpinLockedKeyValueStorage<TGUID, ui32, TGUIDHash> RequestsInfo;         // sent to local peers, value is peer port
+        TSpinLockedKeyValueStorage<TGUID, ui32, TGUIDHash> IncomingRequestsInfo; // got from local peers, value is peer port
+        NAtomic::TBool Running = true;
+        TAutoPtr<IThreadFactory::IThread> ReceiverThread;
+    };
+#endif
+
+    TIntrusivePtr<IRequester> CreateSharedMemoryRequester(
+        TIntrusivePtr<IRequester> fallbackRequester,
+        IRequester::TProcessQueryCancelCallback queryCancelCallback,
+        IRequester::TProcessQueryCallback queryCallback,
+        IRequester::TProcessReplyCallback replyCallback,
+        TDuration sendTimeout)
+    {
+#if defined(_linux_)
+        DEBUG_LOG << "Creating shared memory requester for local hosts" << Endl;
+        return MakeIntrusive<TSharedMemoryRequester>(
+            std::move(fallbackRequester),
+            std::move(queryCancelCallback),
+            std::move(queryCallback),
+            std::move(replyCallback),
+            sendTimeout);
+#else
+        Y_UNUSED(queryCancelCallback, queryCallback, replyCallback, sendTimeout);
+        WARNING_LOG << "Shared memory requester is supported only on Linux, using network for local hosts" << Endl;
+        return fallbackRequester;
+#endif
+    }
+}
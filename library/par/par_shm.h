@@ -0,0 +1,31 @@
+#pragma once
+
+#include "par_network.h"
+
+#include <util/datetime/base.h>
+
+namespace NPar {
+    // messages that can wait in the mailbox of a shared memory requester
+    constexpr ui64 SharedMemoryMailboxCapacity = 4096;
+
+    /* Requester that passes queries, replies and cancels to peers on the same host through POSIX shared memory
+     * instead of the network stack. Each process owns a mailbox segment named after its listen port,
+     * message bodies are placed in separate segments that the receiver unlinks after reading,
+     * the receiver thread sleeps on a futex in the mailbox.
+     * Peers without a mailbox, remote peers and sync requests are served by fallbackRequester,
+     * which must be created with the same callbacks.
+     * Sending waits at most sendTimeout for space in a full peer mailbox. Requests to peers that have stopped
+     * or died (the mailbox owner pid is checked) get responses with EStatus::Failed.
+     * Only messages are passed, processes do not share other data.
+     * Returns fallbackRequester on platforms without shared memory transport.
+     */
+    TIntrusivePtr<IRequester> CreateSharedMemoryRequester(
+        TIntrusivePtr<IRequester> fallbackRequester,
+        IRequester::TProcessQueryCancelCallback queryCancelCallback,
+        IRequester::TProcessQueryCallback queryCallback,
+        IRequester::TProcessReplyCallback replyCallback,
+        TDuration sendTimeout = TDuration::Minutes(1));
+
+    // messages sent through shared memory by the requesters of this process
+    ui64 GetSharedMemoryMessageCount();
+}
@@ -0,0 +1,214 @@
+#include <library/par/par_shm.h>
+
+#include <library/unittest/registar.h>
+#include <library/unittest/tests_data.h>
+
+#include <util/generic/xrange.h>
+#include <util/system/event.h>
+#include <util/system/guard.h>
+#include <util/system/mutex.h>
+
+#include <atomic>
+
+using namespace NPar;
+
+namespace {
+    // provides the listen port and counts messages that do not go through shared memory
+    class TFallbackRequester: public IRequester {
+    public:
+        explicit TFallbackRequester(int listenPort)
+            : ListenPort(listenPort)
+        {
+        }
+
+        TAutoPtr<TNetworkResponse> Request(const NPar::TNetworkAddress&, const TString&, TVector<char>*) override {
+            ++MessageCount;
+            return nullptr;
+        }
+
+        void SendRequest(const TGUID&, const NPar::TNetworkAddress&, const TString&, TVector<char>*) override {
+            ++MessageCount;
+        }
+
+        void CancelRequest(const TGUID&) override {
+            ++MessageCount;
+        }
+
+        void SendResponse(const TGUID&, TVector<char>*) override {
+            ++MessageCount;
+        }
+
+        int GetListenPort() const override {
+            return ListenPort;
+        }
+
+    public:
+        std::atomic<int> MessageCount = 0;
+
+    private:
+        const int ListenPort;
+    };
+
+    // shared memory requester with the events it got
+    struct TPeer {
+        TMutex Lock;
+        TVector<TNetworkRequest> Queries;
+        TVector<TNetworkResponse> Responses;
+        TVector<TGUID> Cancels;
+        TManualEvent QueriesAllowed;
+
+        // destroyed first, the receiver thread uses the members above
+        TIntrusivePtr<TFallbackRequester> Fallback;
+        TIntrusivePtr<IRequester> Requester;
+
+    public:
+        TPeer(int listenPort, TDuration sendTimeout = TDuration::Minutes(1)) {
+            QueriesAllowed.Signal();
+            Fallback = MakeIntrusive<TFallbackRequester>(listenPort);
+            Requester = CreateSharedMemoryRequester(
+                Fallback,
+                [this](const TGUID& reqId) {
+                    with_lock (Lock) {
+                        Cancels.push_back(reqId);
+                    }
+                },
+                [this](TAutoPtr<TNetworkRequest>& request) {
+                    QueriesAllowed.WaitI();
+                    with_lock (Lock) {
+                        Queries.push_back(*request);
+                    }
+                },
+                [this](TAutoPtr<TNetworkResponse> response) {
+                    with_lock (Lock) {
+                        Responses.push_back(*response);
+                    }
+                },
+                sendTimeout);
+        }
+
+        NPar::TNetworkAddress GetAddress() const {
+            return NPar::TNetworkAddress("localhost", Requester->GetListenPort());
+        }
+
+        template <class TCondition>
+        void WaitFor(TCondition condition) {
+            const TInstant deadline = TDuration::Seconds(30).ToDeadLine();
+            while (true) {
+                with_lock (Lock) {
+                    if (condition()) {
+                        return;
+                    }
+                }
+                UNIT_ASSERT_C(Now() < deadline, "event is not received");
+                Sleep(TDuration::MilliSeconds(1));
+            }
+        }
+    };
+
+    TGUID MakeGuid() {
+        TGUID guid;
+        CreateGuid(&guid);
+        return guid;
+    }
+}
+
+Y_UNIT_TEST_SUITE(TSharedMemoryRequesterTest) {
+    Y_UNIT_TEST(SendReplyCancel) {
+        TPortManager portManager;
+        TPeer master(portManager.GetPort());
+        TPeer worker(portManager.GetPort());
+        const ui64 messageCountBefore = GetSharedMemoryMessageCount();
+
+        const TGUID queryId = MakeGuid();
+        TVector<char> data = {'a', 'b', 'c'};
+        master.Requester->SendRequest(queryId, worker.GetAddress(), "map", &data);
+        worker.WaitFor([&]() { return worker.Queries.size() == 1; });
+        UNIT_ASSERT_EQUAL(worker.Queries[0].ReqId, queryId);
+        UNIT_ASSERT_VALUES_EQUAL(worker.Queries[0].Url, "map");
+        UNIT_ASSERT_EQUAL(worker.Queries[0].Data, TVector<char>({'a', 'b', 'c'}));
+
+        TVector<char> reply = {'d', 'e'};
+        worker.Requester->SendResponse(queryId, &reply);
+        master.WaitFor([&]() { return master.Responses.size() == 1; });
+        UNIT_ASSERT_EQUAL(master.Responses[0].ReqId, queryId);
+        UNIT_ASSERT_EQUAL(master.Responses[0].Status, TNetworkResponse::EStatus::Ok);
+        UNIT_ASSERT_EQUAL(master.Responses[0].Data, TVector<char>({'d', 'e'}));
+
+        const TGUID canceledQueryId = MakeGuid();
+        master.Requester->SendRequest(canceledQueryId, worker.GetAddress(), "map", nullptr);
+        worker.WaitFor([&]() { return worker.Queries.size() == 2; });
+        master.Requester->CancelRequest(canceledQueryId);
+        master.WaitFor([&]() { return master.Responses.size() == 2; });
+        UNIT_ASSERT_EQUAL(master.Responses[1].ReqId, canceledQueryId);
+        UNIT_ASSERT_EQUAL(master.Responses[1].Status, TNetworkResponse::EStatus::Canceled);
+        worker.WaitFor([&]() { return worker.Cancels.size() == 1; });
+        UNIT_ASSERT_EQUAL(worker.Cancels[0], canceledQueryId);
+
+        // the reply to a canceled query is dropped
+        worker.Requester->SendResponse(canceledQueryId, nullptr);
+
+        UNIT_ASSERT_VALUES_EQUAL(GetSharedMemoryMessageCount() - messageCountBefore, 4u);
+        UNIT_ASSERT_VALUES_EQUAL(master.Fallback->MessageCount.load(), 0);
+        UNIT_ASSERT_VALUES_EQUAL(worker.Fallback->MessageCount.load(), 1);
+    }
+
+    Y_UNIT_TEST(RemoteAndUnknownPeersUseFallback) {
+        TPortManager portManager;
+        TPeer master(portManager.GetPort());
+        const auto unknownPort = portManager.GetPort();
+        master.Requester->SendRequest(MakeGuid(), NPar::TNetworkAddress("remote.host.invalid", master.Requester->GetListenPort()), "map", nullptr);
+        master.Requester->SendRequest(MakeGuid(), NPar::TNetworkAddress("localhost", unknownPort), "map", nullptr);
+        UNIT_ASSERT_VALUES_EQUAL(master.Fallback->MessageCount.load(), 2);
+    }
+
+    Y_UNIT_TEST(FullMailbox) {
+        TPortManager portManager;
+        TPeer master(portManager.GetPort(), TDuration::MilliSeconds(100));
+        TPeer worker(portManager.GetPort());
+
+        // the worker receiver thread is blocked in the first query, the other queries fill the mailbox
+        worker.QueriesAllowed.Reset();
+        master.Requester->SendRequest(MakeGuid(), worker.GetAddress(), "map", nullptr);
+        Sleep(TDuration::MilliSeconds(100));
+        for (auto i : xrange(SharedMemoryMailboxCapacity)) {
+            Y_UNUSED(i);
+            master.Requester->SendRequest(MakeGuid(), worker.GetAddress(), "map", nullptr);
+        }
+        with_lock (master.Lock) {
+            UNIT_ASSERT(master.Responses.empty());
+        }
+
+        const TGUID droppedQueryId = MakeGuid();
+        master.Requester->SendRequest(droppedQueryId, worker.GetAddress(), "map", nullptr);
+        with_lock (master.Lock) {
+            UNIT_ASSERT_VALUES_EQUAL(master.Responses.size(), 1);
+            UNIT_ASSERT_EQUAL(master.Responses[0].ReqId, droppedQueryId);
+            UNIT_ASSERT_EQUAL(master.Responses[0].Status, TNetworkResponse::EStatus::Failed);
+        }
+
+        worker.QueriesAllowed.Signal();
+        worker.WaitFor([&]() { return worker.Queries.size() == SharedMemoryMailboxCapacity + 1; });
+        UNIT_ASSERT_VALUES_EQUAL(master.Fallback->MessageCount.load(), 0);
+    }
+
+    Y_UNIT_TEST(GonePeer) {
+        TPortManager portManager;
+        TPeer master(portManager.GetPort());
+        auto worker = MakeHolder<TPeer>(portManager.GetPort());
+        const NPar::TNetworkAddress workerAddress = worker->GetAddress();
+
+        const TGUID queryId = MakeGuid();
+        master.Requester->SendRequest(queryId, workerAddress, "map", nullptr);
+        worker->WaitFor([&]() { return worker->Queries.size() == 1; });
+        worker.Destroy();
+
+        // the query is not answered, the master finds out that the worker is gone
+        master.WaitFor([&]() { return master.Responses.size() == 1; });
+        UNIT_ASSERT_EQUAL(master.Responses[0].ReqId, queryId);
+        UNIT_ASSERT_EQUAL(master.Responses[0].Status, TNetworkResponse::EStatus::Failed);
+
+        // the worker has no mailbox now
+        master.Requester->SendRequest(MakeGuid(), workerAddress, "map", nullptr);
+        UNIT_ASSERT_VALUES_EQUAL(master.Fallback->MessageCount.load(), 1);
+    }
+}